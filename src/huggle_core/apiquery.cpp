@@ -12,13 +12,16 @@
 #include <QFile>
 #include <QtNetwork>
 #include <QUrl>
+#include "apiquerycache.hpp"
 #include "apiqueryresult.hpp"
 #include "configuration.hpp"
 #include "syslog.hpp"
+#include "trafficcapture.hpp"
 #include "revertquery.hpp"
 #include "exception.hpp"
 #include "localization.hpp"
 #include "generic.hpp"
+#include "networkscheduler.hpp"
 #include "wikisite.hpp"
 
 using namespace Huggle;
@@ -105,9 +108,16 @@ QString ApiQuery::constructParameterLessUrl()
     return url + this->getAssertPartSuffix();
 }
 
+bool ApiQuery::isAnonymous()
+{
+    // global wiki has no project configuration
+    WikiSite *site = this->GetSite();
+    return site != nullptr && site->ProjectConfig != nullptr && site->ProjectConfig->Anonymous;
+}
+
 QString ApiQuery::getAssertPartSuffix()
 {
-    if (this->EnforceLogin && !Configuration::HuggleConfiguration->DeveloperMode)
+    if (this->EnforceLogin && !Configuration::HuggleConfiguration->DeveloperMode && !this->isAnonymous())
     {
         // we need to use this so that mediawiki will fail if we aren't logged in
         return "&assert=user";
@@ -144,6 +154,8 @@ void ApiQuery::SetCustomActionPart(QString action, bool editing, bool enforce_lo
     this->EnforceLogin = enforce_login;
     this->IsContinuous = is_continuous;
     this->EditingQuery = editing;
+    if (editing)
+        this->Priority = QueryPriority_UserAction;
 }
 
 void ApiQuery::SetToken(Token token, QString name, QString value)
@@ -224,6 +236,25 @@ static void WriteIn(ApiQuery *q, QNetworkReply *reply)
     }
 }
 
+static void Record(ApiQuery *q, QNetworkReply *reply, const QByteArray &data)
+{
+    TrafficRecord record;
+    record.Site = q->GetSite()->Name;
+    record.Method = q->UsingPOST ? "POST" : "GET";
+    record.URL = reply->request().url().toEncoded();
+    // hidden queries contain passwords, so we never store them
+    record.Hidden = q->HiddenQuery;
+    if (q->UsingPOST && !q->HiddenQuery)
+        record.Body = q->Parameters.toUtf8();
+    record.Data = data;
+    record.Duration = q->GetNetworkTime();
+    record.HttpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    record.Error = reply->error();
+    if (reply->error())
+        record.ErrorString = reply->errorString();
+    TrafficRecorder::Recorder->RecordRequest(record);
+}
+
 static void WriteOut(ApiQuery *q, QNetworkRequest *request)
 {
     if (!hcfg->QueryDebugging)
@@ -250,9 +281,27 @@ void ApiQuery::finished()
         throw new Huggle::NullPointerException("loc ApiQuery::Result", BOOST_CURRENT_FUNCTION);
     if (this->reply == nullptr)
         throw new Huggle::NullPointerException("loc ApiQuery::reply", BOOST_CURRENT_FUNCTION);
+    if (NetworkScheduler::HuggleScheduler)
+    {
+        if (NetworkScheduler::HuggleScheduler->Retry(this, this->reply))
+        {
+            // the query was returned to queue, so we drop this reply and wait for the next one
+            this->queued = true;
+            this->temp.clear();
+            this->reply->deleteLater();
+            this->reply = nullptr;
+            return;
+        }
+        NetworkScheduler::HuggleScheduler->Release(this);
+    }
+    // cached results of pages we just changed are no longer valid
+    if (this->EditingQuery && ApiQueryCache::HuggleCache)
+        ApiQueryCache::HuggleCache->InvalidateQuery(this);
     ApiQueryResult *result = (ApiQueryResult*)this->Result;
     this->temp += this->reply->readAll();
     result->Data = QString(this->temp);
+    if (TrafficRecorder::Recorder)
+        Record(this, this->reply, this->temp);
     Query::bytesReceived += static_cast<unsigned long>(this->temp.size());
     // remove the temporary data so that we save the ram
     this->temp.clear();
@@ -263,6 +312,7 @@ void ApiQuery::finished()
         this->reply->deleteLater();
         this->reply = nullptr;
         this->status = StatusDone;
+        this->shareResult();
         this->processFailure();
         return;
     }
@@ -278,6 +328,7 @@ void ApiQuery::finished()
     WriteIn(this, this->reply);
     this->reply->deleteLater();
     this->reply = nullptr;
+    this->shareResult();
     if (result->Data.isEmpty() || result->IsFailed())
     {
         this->status = StatusInError;
@@ -290,6 +341,28 @@ void ApiQuery::finished()
     this->processCallback();
 }
 
+void ApiQuery::shareResult()
+{
+    if (!this->cacheKey.isEmpty() && ApiQueryCache::HuggleCache)
+        ApiQueryCache::HuggleCache->Complete(this);
+}
+
+void ApiQuery::finishShared(const QString &data, bool failed, int error, const QString &reason)
+{
+    this->Result->Data = data;
+    if (failed)
+    {
+        this->Result->SetError(error, reason);
+        this->status = StatusInError;
+        this->processFailure();
+        return;
+    }
+    if (this->RequestFormat == XML)
+        ((ApiQueryResult*)this->Result)->Process();
+    this->status = StatusDone;
+    this->processCallback();
+}
+
 void ApiQuery::Process()
 {
     if (this->status != Query::StatusNull)
@@ -312,6 +385,11 @@ void ApiQuery::Process()
     }
 
     this->temp.clear();
+    // queries that no one is waiting for yield to the database replicas when they are lagged, parameters are kept
+    // when query is processed again after it timed out, so we must not append it twice
+    if (this->Priority >= QueryPriority_Prefetch && !this->EditingQuery && hcfg->SystemConfig_MaxLag > 0 &&
+            !("&" + this->Parameters).contains("&maxlag="))
+        this->Parameters += "&maxlag=" + QString::number(hcfg->SystemConfig_MaxLag);
     foreach(QString value, this->params.values())
         this->Parameters += "&" + value + "=" + QUrl::toPercentEncoding(this->params[value]);
     if (this->Parameters.startsWith("&"))
@@ -322,19 +400,8 @@ void ApiQuery::Process()
     if (!this->URL.size() && !this->UsingPOST)
         this->constructUrl();
     this->status = StatusProcessing;
-    QUrl url;
     if (this->UsingPOST)
-    {
         this->URL = this->constructParameterLessUrl();
-        url = QUrl::fromEncoded(this->URL.toUtf8());
-    } else
-    {
-        url = QUrl::fromEncoded(this->URL.toUtf8());
-    }
-    QNetworkRequest request(url);
-    request.setRawHeader("User-Agent", Configuration::HuggleConfiguration->WebRequest_UserAgent);
-    if (this->UsingPOST)
-        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
     if (Configuration::HuggleConfiguration->SystemConfig_DryMode && this->EditingQuery)
     {
         this->Result->Data = "DM (didn't run a query)";
@@ -344,6 +411,32 @@ void ApiQuery::Process()
                                 ") " + this->URL + "\ndata: " + QUrl::fromPercentEncoding(this->Parameters.toUtf8()));
         return;
     }
+    if (this->Cacheable && ApiQueryCache::HuggleCache && ApiQueryCache::HuggleCache->Fetch(this))
+        return;
+    this->send();
+}
+
+void ApiQuery::send()
+{
+    if (NetworkScheduler::HuggleScheduler)
+    {
+        // scheduler may dispatch the query right away, which resets this
+        this->queued = true;
+        NetworkScheduler::HuggleScheduler->Enqueue(this);
+    } else
+        this->dispatch();
+}
+
+void ApiQuery::dispatch()
+{
+    // execution time and timeout shouldn't include the time spent in queue
+    this->queued = false;
+    this->StartTime = QDateTime::currentDateTime();
+    this->networkTimer.start();
+    QNetworkRequest request(QUrl::fromEncoded(this->URL.toUtf8()));
+    request.setRawHeader("User-Agent", Configuration::HuggleConfiguration->WebRequest_UserAgent);
+    if (this->UsingPOST)
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
     // Calculate size of outgoing request
     int request_size = 0;
     QList<QByteArray> headerList = request.rawHeaderList();
@@ -370,6 +463,23 @@ void ApiQuery::Process()
 
 void ApiQuery::Kill()
 {
+    bool waiting = false;
+    if (this->status == StatusProcessing && !this->cacheKey.isEmpty() && ApiQueryCache::HuggleCache)
+        waiting = ApiQueryCache::HuggleCache->Detach(this);
+    if (!waiting && this->status == StatusProcessing && this->reply == nullptr && NetworkScheduler::HuggleScheduler)
+        waiting = NetworkScheduler::HuggleScheduler->Remove(this);
+    if (waiting)
+    {
+        // query was still waiting in queue or for result of another query
+        this->queued = false;
+        if (this->Result == nullptr)
+            this->Result = new ApiQueryResult();
+        this->Result->SetError(HUGGLE_EKILLED, "Killed");
+        this->status = StatusKilled;
+        return;
+    }
+    if (this->reply != nullptr && NetworkScheduler::HuggleScheduler)
+        NetworkScheduler::HuggleScheduler->Release(this);
     if (this->reply != nullptr)
     {
         QObject::disconnect(this->reply, SIGNAL(finished()), this, SLOT(finished()));
@@ -394,6 +504,28 @@ void ApiQuery::Kill()
     }
 }
 
+QString ApiQuery::QueryStatusToString()
+{
+    if (this->status == StatusProcessing && this->CustomStatus.isEmpty() && this->reply == nullptr && NetworkScheduler::HuggleScheduler
+            && NetworkScheduler::HuggleScheduler->IsQueued(this))
+        return "Queued (" + NetworkScheduler::PriorityToString(this->Priority) + ")";
+    return Query::QueryStatusToString();
+}
+
+bool ApiQuery::IsProcessed()
+{
+    if (this->queued && this->status == StatusProcessing)
+        return false;
+    return Query::IsProcessed();
+}
+
+qint64 ApiQuery::GetNetworkTime()
+{
+    if (!this->networkTimer.isValid())
+        return 0;
+    return this->networkTimer.elapsed();
+}
+
 QString ApiQuery::GetURL()
 {
     this->constructUrl();
@@ -430,6 +562,7 @@ void ApiQuery::SetAction(const Action action)
         case ActionLogin:
             this->actionPart = "login";
             this->EnforceLogin = false;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionLogout:
             this->actionPart = "logout";
@@ -443,18 +576,22 @@ void ApiQuery::SetAction(const Action action)
         case ActionRollback:
             this->actionPart = "rollback";
             this->EditingQuery = true;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionDelete:
             this->actionPart = "delete";
             this->EditingQuery = true;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionUndelete:
             this->actionPart = "undelete";
             this->EditingQuery = true;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionBlock:
             this->actionPart = "block";
             this->EditingQuery = true;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionParse:
             this->actionPart = "parse";
@@ -462,23 +599,28 @@ void ApiQuery::SetAction(const Action action)
         case ActionProtect:
             this->actionPart = "protect";
             this->EditingQuery = true;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionEdit:
             this->actionPart = "edit";
             this->EditingQuery = true;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionPatrol:
             this->actionPart = "patrol";
             this->EditingQuery = true;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionReview: // FlaggedRevs
             this->actionPart = "review";
             this->EditingQuery = true;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionUnwatch:
         case ActionWatch:
             this->actionPart = "watch";
             this->EditingQuery = true;
+            this->Priority = QueryPriority_UserAction;
             return;
         case ActionCustom:
             return;
@@ -15,9 +15,11 @@
 
 #include <QString>
 #include <QObject>
+#include <QElapsedTimer>
 #include "collectable_smartptr.hpp"
 #include "query.hpp"
 #include "mediawikiobject.hpp"
+#include "networkscheduler.hpp"
 class QNetworkReply;
 
 namespace Huggle
@@ -92,7 +94,12 @@ namespace Huggle
             QString QueryTargetToString();
             //! Returns a type of query as a string
             QString QueryTypeToString();
+            QString QueryStatusToString();
+            //! Timeout of query only runs once it was dispatched, queries waiting in NetworkScheduler are never timed out
+            bool IsProcessed();
             QString GetURL();
+            //! Milliseconds since the request was sent to network, time spent in queue of NetworkScheduler is not included
+            qint64 GetNetworkTime();
             void SetParam(QString name, QString value);
             void SetToken(Token token, QString name = "", QString value = "");
             bool EnforceLogin = true;
@@ -112,14 +119,30 @@ namespace Huggle
             QString Target = "none";
             //! You can change this to url of different wiki than a project
             QString OverrideWiki = "";
+            //! Priority in which the query is sent to network, editing queries are user actions by default
+            QueryPriority Priority = QueryPriority_PostProcessing;
+            //! If true, result may be taken from ApiQueryCache or shared with identical query that is running
+
+            //! Only use this for read only queries where result that is few seconds old is good enough
+            bool Cacheable = false;
         private slots:
             void readData();
             void finished();
         private:
+            //! Hand the query over to NetworkScheduler, or send it right away if there is none
+            void send();
+            //! Send the request, this is called by NetworkScheduler once there is a free slot for this query
+            void dispatch();
+            //! Finish the query using data that were retrieved by another query
+            void finishShared(const QString &data, bool failed, int error = 0, const QString &reason = "");
+            //! Pass the result to ApiQueryCache so that queries attached to this one can be finished
+            void shareResult();
             //! Generate api url
             void constructUrl();
             QString constructParameterLessUrl();
             QString getAssertPartSuffix();
+            //! Site is used without logging in, so there is no point in asserting that user is logged in
+            bool isAnonymous();
             //! Check if return format is supported by huggle
             bool formatIsCurrentlySupported();
             //! This is only needed when you are using rollback
@@ -130,6 +153,14 @@ namespace Huggle
             QByteArray temp;
             //! Reply from qnet
             QNetworkReply *reply = nullptr;
+            //! True while the query is waiting in queue of NetworkScheduler
+            bool queued = false;
+            //! Started when the request is dispatched, restarted when it's dispatched again after retry
+            QElapsedTimer networkTimer;
+            //! Key of this query in ApiQueryCache, empty if the query wasn't looked up there
+            QString cacheKey;
+            friend class ApiQueryCache;
+            friend class NetworkScheduler;
     };
 
     inline bool ApiQuery::formatIsCurrentlySupported()
@@ -0,0 +1,209 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "apiquerycache.hpp"
+#include <QUrl>
+#include "apiquery.hpp"
+#include "apiqueryresult.hpp"
+#include "configuration.hpp"
+#include "syslog.hpp"
+#include "wikisite.hpp"
+
+using namespace Huggle;
+
+ApiQueryCache *ApiQueryCache::HuggleCache = nullptr;
+
+QString ApiQueryCache::GetKey(ApiQuery *query)
+{
+    QString url = query->URL;
+    int separator = url.indexOf("?");
+    QStringList parameters = url.mid(separator + 1).split("&", QString::SkipEmptyParts);
+    int index = 0;
+    while (index < parameters.count())
+    {
+        // maxlag depends only on priority of query, it doesn't change the result
+        if (parameters.at(index).startsWith("maxlag="))
+        {
+            parameters.removeAt(index);
+            continue;
+        }
+        index++;
+    }
+    parameters.sort();
+    return query->GetSite()->Name + "|" + url.left(separator) + "?" + parameters.join("&");
+}
+
+QStringList ApiQueryCache::GetSubjects(const QString &site, const QString &parameters)
+{
+    QStringList subjects;
+    foreach (QString parameter, parameters.split("&", QString::SkipEmptyParts))
+    {
+        int separator = parameter.indexOf("=");
+        if (separator < 0)
+            continue;
+        QString name = parameter.left(separator);
+        QString prefix;
+        if (name == "titles" || name == "title" || name == "page")
+            prefix = site + "|";
+        else if (name == "ususers" || name == "user")
+            prefix = site + "|~user:";
+        else
+            continue;
+        QString value = QUrl::fromPercentEncoding(parameter.mid(separator + 1).toUtf8());
+        foreach (QString title, value.split("|", QString::SkipEmptyParts))
+            subjects.append(prefix + title.replace("_", " ").trimmed());
+    }
+    return subjects;
+}
+
+ApiQueryCache::ApiQueryCache()
+{
+    this->results.setMaxCost(qMax(1, hcfg->SystemConfig_ApiCacheSize));
+}
+
+bool ApiQueryCache::Fetch(ApiQuery *query)
+{
+    if (hcfg->SystemConfig_ApiCacheTTL <= 0 || query->UsingPOST || query->EditingQuery)
+        return false;
+    QString key = GetKey(query);
+    query->cacheKey = key;
+    Entry *entry = this->results.object(key);
+    if (entry != nullptr)
+    {
+        if (entry->Time.addSecs(hcfg->SystemConfig_ApiCacheTTL) >= QDateTime::currentDateTime())
+        {
+            this->hits++;
+            query->finishShared(entry->Data, false);
+            return true;
+        }
+        this->results.remove(key);
+    }
+    if (this->running.contains(key))
+    {
+        this->coalesced++;
+        this->waiting[key].append(query);
+        return true;
+    }
+    this->misses++;
+    this->running.insert(key, query);
+    return false;
+}
+
+void ApiQueryCache::Complete(ApiQuery *query)
+{
+    QString key = query->cacheKey;
+    if (this->running.value(key) != query)
+        return;
+    this->running.remove(key);
+    QList<ApiQuery*> attached = this->waiting.take(key);
+    QueryResult *result = query->Result;
+    bool failed = result->IsFailed() || result->Data.isEmpty();
+    if (!failed)
+    {
+        Entry *entry = new Entry();
+        entry->Data = result->Data;
+        entry->Subjects = GetSubjects(query->GetSite()->Name, query->URL.mid(query->URL.indexOf("?") + 1));
+        entry->Time = QDateTime::currentDateTime();
+        this->results.setMaxCost(qMax(1, hcfg->SystemConfig_ApiCacheSize));
+        this->results.insert(key, entry);
+    }
+    foreach (ApiQuery *item, attached)
+        item->finishShared(result->Data, failed, result->ErrorCode, result->ErrorMessage);
+}
+
+bool ApiQueryCache::Detach(ApiQuery *query)
+{
+    QString key = query->cacheKey;
+    if (this->waiting.contains(key) && this->waiting[key].removeOne(query))
+    {
+        if (this->waiting[key].isEmpty())
+            this->waiting.remove(key);
+        return true;
+    }
+    if (this->running.value(key) != query)
+        return false;
+    this->running.remove(key);
+    if (!this->waiting.contains(key))
+        return false;
+    // someone still needs the result, so one of the attached queries is sent instead
+    QList<ApiQuery*> attached = this->waiting.take(key);
+    ApiQuery *next = attached.takeFirst();
+    this->running.insert(key, next);
+    if (!attached.isEmpty())
+        this->waiting.insert(key, attached);
+    next->send();
+    return false;
+}
+
+void ApiQueryCache::InvalidatePage(WikiSite *site, QString page)
+{
+    QString subject = site->Name + "|" + page.replace("_", " ").trimmed();
+    foreach (QString key, this->results.keys())
+    {
+        Entry *entry = this->results.object(key);
+        if (entry != nullptr && entry->Subjects.contains(subject))
+            this->results.remove(key);
+    }
+}
+
+void ApiQueryCache::InvalidateQuery(ApiQuery *query)
+{
+    QStringList subjects = GetSubjects(query->GetSite()->Name, query->Parameters);
+    if (subjects.isEmpty())
+        return;
+    foreach (QString key, this->results.keys())
+    {
+        Entry *entry = this->results.object(key);
+        if (entry == nullptr)
+            continue;
+        foreach (QString subject, subjects)
+        {
+            if (entry->Subjects.contains(subject))
+            {
+                this->results.remove(key);
+                break;
+            }
+        }
+    }
+}
+
+void ApiQueryCache::Clear()
+{
+    this->results.clear();
+}
+
+unsigned long ApiQueryCache::GetHits()
+{
+    return this->hits;
+}
+
+unsigned long ApiQueryCache::GetMisses()
+{
+    return this->misses;
+}
+
+unsigned long ApiQueryCache::GetCoalesced()
+{
+    return this->coalesced;
+}
+
+double ApiQueryCache::GetHitRate()
+{
+    unsigned long total = this->hits + this->misses + this->coalesced;
+    if (total == 0)
+        return 0;
+    return static_cast<double>(this->hits + this->coalesced) * 100 / total;
+}
+
+QString ApiQueryCache::GetStatistics()
+{
+    return QString::number(this->hits) + " hits, " + QString::number(this->coalesced) + " coalesced, " + QString::number(this->misses) +
+           " misses (" + QString::number(this->GetHitRate(), 'f', 1) + "% not sent), " + QString::number(this->results.count()) + " cached";
+}
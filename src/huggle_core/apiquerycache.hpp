@@ -0,0 +1,89 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef APIQUERYCACHE_HPP
+#define APIQUERYCACHE_HPP
+
+#include "definitions.hpp"
+
+#include <QCache>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace Huggle
+{
+    class ApiQuery;
+    class WikiSite;
+
+    //! Cache of results of read only api queries
+
+    //! Edits that are made by same user or to same page in a short time need the same information, so instead
+    //! of asking mediawiki for it again, queries which are marked as cacheable are first looked up here. If a
+    //! fresh result is available it's used right away, if an identical query is already running, the query is
+    //! attached to it and receives a copy of its result once it's finished, so that only one request is sent.
+    //! Results are kept only for a short time and are dropped whenever huggle itself changes the page they
+    //! are about.
+    class HUGGLE_EX_CORE ApiQueryCache
+    {
+        public:
+            static ApiQueryCache *HuggleCache;
+            //! Return normalized key of query, parameters are sorted so that their order doesn't matter
+            static QString GetKey(ApiQuery *query);
+            //! Return list of pages and users that the parameters of query refer to
+            static QStringList GetSubjects(const QString &site, const QString &parameters);
+
+            ApiQueryCache();
+            /*!
+             * \brief Fetch tries to finish the query using cache or to attach it to identical query that is running
+             * \param query Query that is being processed, its url must be already constructed
+             * \return true if the query doesn't need to be sent, false if caller needs to send it
+             */
+            bool Fetch(ApiQuery *query);
+            //! Called by query that was sent to network once it's finished, result is stored and shared with attached queries
+            void Complete(ApiQuery *query);
+            /*!
+             * \brief Detach is called when query is killed, if it had other queries attached to it, one of them is sent instead
+             * \return true if query was attached to another query, so it had no request of its own
+             */
+            bool Detach(ApiQuery *query);
+            //! Remove all results related to this page, this is called every time huggle changes something on wiki
+            void InvalidatePage(WikiSite *site, QString page);
+            void InvalidateQuery(ApiQuery *query);
+            void Clear();
+            unsigned long GetHits();
+            unsigned long GetMisses();
+            //! Number of queries that were attached to identical query instead of being sent
+            unsigned long GetCoalesced();
+            //! Percentage of cacheable queries that didn't need to be sent
+            double GetHitRate();
+            QString GetStatistics();
+        private:
+            class Entry
+            {
+                public:
+                    QString Data;
+                    QStringList Subjects;
+                    QDateTime Time;
+            };
+            QCache<QString, Entry> results;
+            //! Queries that were sent to network, indexed by their key
+            QHash<QString, ApiQuery*> running;
+            //! Queries which wait for result of running query with same key
+            QHash<QString, QList<ApiQuery*> > waiting;
+            unsigned long hits = 0;
+            unsigned long misses = 0;
+            unsigned long coalesced = 0;
+    };
+}
+
+#endif // APIQUERYCACHE_HPP
@@ -10,8 +10,10 @@
 
 #include "apiqueryresult.hpp"
 #include <QtXml>
+#include <new>
 #include "configuration.hpp"
 #include "exception.hpp"
+#include "memorypool.hpp"
 #include "syslog.hpp"
 
 using namespace Huggle;
@@ -19,15 +21,31 @@ using namespace Huggle;
 ApiQueryResult::ApiQueryResult()
 {
     this->Root = nullptr;
+    this->arena = new MemoryArena();
 }
 
 ApiQueryResult::~ApiQueryResult()
 {
     this->Nodes.clear();
-    delete this->Root;
+    if (this->Root)
+        this->destroyNodes(this->Root);
+    delete this->arena;
 }
 
-static void ProcessChildXMLNodes(ApiQueryResultNode *hiearchy_root, ApiQueryResult *result, QDomNodeList nodes)
+ApiQueryResultNode *ApiQueryResult::createNode()
+{
+    return new (this->arena->Allocate(sizeof(ApiQueryResultNode))) ApiQueryResultNode();
+}
+
+void ApiQueryResult::destroyNodes(ApiQueryResultNode *node)
+{
+    foreach (ApiQueryResultNode *child, node->ChildNodes)
+        this->destroyNodes(child);
+    // memory itself is released with the arena
+    node->~ApiQueryResultNode();
+}
+
+void ApiQueryResult::processChildXMLNodes(ApiQueryResultNode *hiearchy_root, const QDomNodeList &nodes)
 {
     int id = 0;
     while (id < nodes.count())
@@ -37,7 +55,7 @@ static void ProcessChildXMLNodes(ApiQueryResultNode *hiearchy_root, ApiQueryResu
             continue;
         if (element.tagName() != "warnings")
         {
-            ApiQueryResultNode *node = new ApiQueryResultNode();
+            ApiQueryResultNode *node = this->createNode();
             hiearchy_root->ChildNodes.append(node);
             node->Name = element.tagName();
             int attr = 0;
@@ -50,17 +68,17 @@ static void ProcessChildXMLNodes(ApiQueryResultNode *hiearchy_root, ApiQueryResu
                 else
                     Syslog::HuggleLogs->WarningLog("Invalid xml node (present multiple times) " + ca.name() + " in " + element.tagName());
             }
-            result->Nodes.append(node);
+            this->Nodes.append(node);
             if (element.childNodes().count())
-                ProcessChildXMLNodes(node, result, element.childNodes());
+                this->processChildXMLNodes(node, element.childNodes());
 
             node->Value = element.text();
             if (node->Name == "error")
             {
                 QString code = node->GetAttribute("code");
-                result->SetError(HUGGLE_EUNKNOWN, "code: " + code + " details: " + node->Value);
+                this->SetError(HUGGLE_EUNKNOWN, "code: " + code + " details: " + node->Value);
                 HUGGLE_DEBUG1("Query failed: " + code + " details: " + node->Value);
-                HUGGLE_DEBUG(result->Data, 8);
+                HUGGLE_DEBUG(this->Data, 8);
             }
         }
         if (element.tagName() == "warnings" && !hcfg->SystemConfig_SuppressWarnings)
@@ -71,9 +89,9 @@ static void ProcessChildXMLNodes(ApiQueryResultNode *hiearchy_root, ApiQueryResu
             {
                 QDomElement warning = element.childNodes().at(cn++).toElement();
                 Syslog::HuggleLogs->WarningLog("API query (" + warning.tagName() + "): " + warning.text());
-                result->Warning = warning.text();
+                this->Warning = warning.text();
             }
-            HUGGLE_DEBUG(result->Data, 5);
+            HUGGLE_DEBUG(this->Data, 5);
         }
     }
 }
@@ -87,9 +105,9 @@ void ApiQueryResult::Process()
 
     QDomDocument result;
     result.setContent(this->Data);
-    this->Root = new ApiQueryResultNode();
+    this->Root = this->createNode();
     this->Root->Name = "Huggle_ApiQueryResultRoot";
-    ProcessChildXMLNodes(this->Root, this, result.childNodes());
+    this->processChildXMLNodes(this->Root, result.childNodes());
 }
 
 ApiQueryResultNode *ApiQueryResult::GetNode(QString node_name)
@@ -134,11 +152,6 @@ ApiQueryResultNode::ApiQueryResultNode()
     this->Name = "Huggle_None";
 }
 
-ApiQueryResultNode::~ApiQueryResultNode()
-{
-    HUGGLE_CLEAR_PQ_LIST(this->ChildNodes);
-}
-
 QString ApiQueryResultNode::GetAttribute(QString name, QString default_val)
 {
     if (!this->Attributes.contains(name))
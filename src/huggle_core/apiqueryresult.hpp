@@ -17,15 +17,21 @@
 #include <QHash>
 #include "queryresult.hpp"
 
+class QDomNodeList;
+
 namespace Huggle
 {
+    class MemoryArena;
+
     //! Key/value node for data from API queries
+
+    //! Nodes are allocated from arena of ApiQueryResult that created them and destroyed together with it,
+    //! a node doesn't own its child nodes
     //! \todo Currently value is provided even for nodes that shouldn't have it
     class HUGGLE_EX_CORE ApiQueryResultNode
     {
           public:
             ApiQueryResultNode();
-            ~ApiQueryResultNode();
             /*!
             * \brief GetAttribute Return the specified attribute if it exists, otherwise return the default
             * \param name Name of attribute
@@ -84,6 +90,12 @@ namespace Huggle
             QString Warning;
             //! If any error was encountered during the query
             bool HasErrors = false;
+        private:
+            void processChildXMLNodes(ApiQueryResultNode *hiearchy_root, const QDomNodeList &nodes);
+            ApiQueryResultNode *createNode();
+            void destroyNodes(ApiQueryResultNode *node);
+            //! Memory of all nodes, so that whole tree is released at once
+            MemoryArena *arena;
     };
 }
 
@@ -0,0 +1,136 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "bulkrevert.hpp"
+#include "configuration.hpp"
+#include "projectconfiguration.hpp"
+#include "syslog.hpp"
+#include "userconfiguration.hpp"
+#include "wikipage.hpp"
+#include "wikisite.hpp"
+#include "wikiuser.hpp"
+#include "wikiutil.hpp"
+#include <QHash>
+#include <QTimer>
+
+using namespace Huggle;
+
+BulkRevert::BulkRevert(QList<Collectable_SmartPtr<WikiEdit>> edits, QString summary, QString warning_type, QObject *parent) : QObject(parent)
+{
+    this->Summary = summary;
+    this->WarningType = warning_type;
+    // newest edit of every page, the older ones are reverted together with it
+    QHash<QString, Collectable_SmartPtr<WikiEdit>> newest;
+    foreach (Collectable_SmartPtr<WikiEdit> edit, edits)
+    {
+        if (edit == nullptr || edit->NewPage || edit->RevID == WIKI_UNKNOWN_REVID || !edit->IsPostProcessed())
+            continue;
+        QString key = edit->GetSite()->Name + "|" + edit->Page->PageName;
+        if (!newest.contains(key) || newest[key]->RevID < edit->RevID)
+            newest.insert(key, edit);
+    }
+    this->edits = newest.values();
+}
+
+BulkRevert::~BulkRevert()
+{
+    delete this->timer;
+}
+
+bool BulkRevert::Process()
+{
+    if (this->edits.isEmpty() || this->timer != nullptr)
+        return false;
+    this->startTime = QDateTime::currentDateTime();
+    foreach (Collectable_SmartPtr<WikiEdit> edit, this->edits)
+    {
+        bool rollback = !edit->GetSite()->GetProjectConfig()->Token_Rollback.isEmpty();
+        Collectable_SmartPtr<RevertQuery> revert = WikiUtil::RevertEdit(edit, this->Summary, false, rollback);
+        revert->Date = this->startTime;
+        revert->Process();
+        this->reverts.append(revert);
+    }
+    HUGGLE_DEBUG("Bulk revert of " + QString::number(this->reverts.count()) + " pages edited by " + this->GetUser()->Username + " started", 1);
+    this->timer = new QTimer(this);
+    connect(this->timer, SIGNAL(timeout()), this, SLOT(OnTick()));
+    this->timer->start(HUGGLE_TIMER);
+    return true;
+}
+
+bool BulkRevert::IsFinished()
+{
+    return this->finished;
+}
+
+int BulkRevert::GetCount()
+{
+    return this->edits.count();
+}
+
+QList<Collectable_SmartPtr<WikiEdit>> BulkRevert::GetEdits()
+{
+    return this->edits;
+}
+
+int BulkRevert::GetReverted()
+{
+    return this->reverted;
+}
+
+int BulkRevert::GetFailed()
+{
+    return this->failed;
+}
+
+qint64 BulkRevert::GetWallTime()
+{
+    if (!this->finished)
+        return this->startTime.msecsTo(QDateTime::currentDateTime());
+    return this->wallTime;
+}
+
+WikiEdit *BulkRevert::GetLatestReverted()
+{
+    return this->latestReverted;
+}
+
+WikiUser *BulkRevert::GetUser()
+{
+    if (this->edits.isEmpty())
+        return nullptr;
+    return this->edits.first()->User;
+}
+
+void BulkRevert::OnTick()
+{
+    foreach (Collectable_SmartPtr<RevertQuery> revert, this->reverts)
+    {
+        if (!revert->IsProcessed())
+            return;
+    }
+    this->timer->stop();
+    this->wallTime = this->startTime.msecsTo(QDateTime::currentDateTime());
+    foreach (Collectable_SmartPtr<RevertQuery> revert, this->reverts)
+    {
+        if (revert->IsFailed())
+        {
+            this->failed++;
+            continue;
+        }
+        this->reverted++;
+        WikiEdit *edit = revert->GetEdit();
+        if (this->latestReverted == nullptr || this->latestReverted->Time < edit->Time)
+            this->latestReverted = edit;
+    }
+    this->reverts.clear();
+    this->finished = true;
+    HUGGLE_DEBUG("Bulk revert of pages edited by " + this->GetUser()->Username + " finished in " + QString::number(this->wallTime) + "ms", 1);
+    emit this->Finished(this);
+}
@@ -0,0 +1,80 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef BULKREVERT_HPP
+#define BULKREVERT_HPP
+
+#include "definitions.hpp"
+
+#include <QDateTime>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include "collectable_smartptr.hpp"
+#include "revertquery.hpp"
+#include "wikiedit.hpp"
+
+class QTimer;
+
+namespace Huggle
+{
+    //! Reverts edits that one user made to many pages, so that they can be warned only once for all of them
+
+    //! Every page is reverted by its own RevertQuery and all of them are started at once, number of requests
+    //! which are running on the site at the same time is kept within its limit by network scheduler, so the
+    //! reverts overlap instead of waiting for each other. They all use the rollback token that is already
+    //! known for the site. Finished() is emitted once the last revert is done, the caller is then supposed
+    //! to send single warning for all pages that were reverted.
+    class HUGGLE_EX_CORE BulkRevert : public QObject
+    {
+            Q_OBJECT
+        public:
+            /*!
+             * \param edits Edits made by one user, rollback reverts all consecutive edits of user to a page, so only
+             *              the newest edit of every page is reverted. Caller needs to hold them since the moment
+             *              they were taken from WikiEdit::EditList, otherwise GC may delete them meanwhile.
+             * \param warning_type Type of warning that should be sent once reverts are finished
+             */
+            BulkRevert(QList<Collectable_SmartPtr<WikiEdit>> edits, QString summary, QString warning_type, QObject *parent = nullptr);
+            ~BulkRevert();
+            //! Start all reverts, returns false if there is nothing that could be reverted
+            bool Process();
+            bool IsFinished();
+            //! Number of pages that are being reverted
+            int GetCount();
+            //! Edits which are going to be reverted, one for every page
+            QList<Collectable_SmartPtr<WikiEdit>> GetEdits();
+            int GetReverted();
+            int GetFailed();
+            //! Milliseconds from start of first revert to the end of last one
+            qint64 GetWallTime();
+            //! Newest of edits which were reverted successfuly, warning should refer to this one
+            WikiEdit *GetLatestReverted();
+            WikiUser *GetUser();
+            QString Summary;
+            QString WarningType;
+        signals:
+            void Finished(BulkRevert *bulk);
+        private slots:
+            void OnTick();
+        private:
+            QList<Collectable_SmartPtr<WikiEdit>> edits;
+            QList<Collectable_SmartPtr<RevertQuery>> reverts;
+            Collectable_SmartPtr<WikiEdit> latestReverted;
+            QTimer *timer = nullptr;
+            QDateTime startTime;
+            qint64 wallTime = 0;
+            int reverted = 0;
+            int failed = 0;
+            bool finished = false;
+    };
+}
+
+#endif // BULKREVERT_HPP
@@ -25,6 +25,8 @@ unsigned long Collectable::LockCt = 0;
 
 unsigned long Collectable::LastCID = 0;
 QMutex *Collectable::WideLock = new QMutex(QMutex::Recursive);
+QHash<QString, int> Collectable::InternedConsumers;
+QStringList Collectable::InternedConsumerNames;
 
 Collectable::Collectable()
 {
@@ -41,6 +43,8 @@ Collectable::Collectable()
     this->_collectableLocked = false;
     this->_collectableManaged = false;
     this->_collectableRefs = 0;
+    this->consumerMask = 0;
+    this->dynamicConsumerCount = 0;
     this->_collectableQL = new QMutex(QMutex::Recursive);
 }
 
@@ -51,13 +55,14 @@ Collectable::~Collectable()
         Huggle::Exception::ThrowSoftException("Request to delete managed entity", BOOST_CURRENT_FUNCTION);
     }
     this->Unlock();
+    delete this->dynamicConsumers;
     delete this->_collectableQL;
 }
 
 bool Collectable::SafeDelete()
 {
     HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
-    if (this->_collectableRefs == 0 && this->Consumers.count() == 0 && this->iConsumers.count() == 0)
+    if (!this->HasSomeConsumers())
     {
         if (GC::gc != nullptr)
         {
@@ -91,45 +96,55 @@ void Collectable::SetReclaimable()
 
 void Collectable::DecRef()
 {
-    if (!this->_collectableRefs)
+    unsigned int refs = this->_collectableRefs.load();
+    do
     {
-        throw new Huggle::Exception("Decrementing negative reference", BOOST_CURRENT_FUNCTION);
-    }
-    this->_collectableRefs--;
+        if (!refs)
+            throw new Huggle::Exception("Decrementing negative reference", BOOST_CURRENT_FUNCTION);
+    } while (!this->_collectableRefs.compare_exchange_weak(refs, refs - 1));
 }
 
 void Collectable::RegisterConsumer(int consumer)
 {
-    this->Lock();
-    if (this->IsManaged() && !this->HasSomeConsumers() && !this->ReclaimingAllowed)
+    if (consumer < 0 || consumer >= HUGGLE_COLLECTABLE_BITS)
     {
-        this->Unlock();
-        throw new Huggle::Exception("You can't reclaim this managed resource", BOOST_CURRENT_FUNCTION);
-    }
-    if (!this->iConsumers.contains(consumer))
-    {
-        this->iConsumers.append(consumer);
+        this->registerDynamicConsumer(InternConsumer(ConsumerIdToString(consumer)));
+        return;
     }
+    if (this->IsManaged() && !this->HasSomeConsumers() && !this->ReclaimingAllowed)
+        throw new Huggle::Exception("You can't reclaim this managed resource", BOOST_CURRENT_FUNCTION);
+    this->consumerMask.fetch_or(Q_UINT64_C(1) << consumer);
     this->SetManaged();
-    this->Unlock();
 }
 
 void Collectable::UnregisterConsumer(int consumer)
 {
-    this->Lock();
+    if (consumer < 0 || consumer >= HUGGLE_COLLECTABLE_BITS)
+    {
+        this->unregisterDynamicConsumer(InternConsumer(ConsumerIdToString(consumer)));
+        return;
+    }
     if (this->IsManaged() && !this->HasSomeConsumers())
     {
-        this->Unlock();
         Syslog::HuggleLogs->DebugLog("You are working with class that was already scheduled for collection!");
         //throw new Huggle::Exception("You are working with class that was already scheduled for collection",
         //                            BOOST_CURRENT_FUNCTION);
     }
-    this->iConsumers.removeOne(consumer);
+    this->consumerMask.fetch_and(~(Q_UINT64_C(1) << consumer));
     this->SetManaged();
-    this->Unlock();
 }
 
 void Collectable::RegisterConsumer(const QString consumer)
+{
+    this->registerDynamicConsumer(InternConsumer(consumer));
+}
+
+void Collectable::UnregisterConsumer(const QString consumer)
+{
+    this->unregisterDynamicConsumer(InternConsumer(consumer));
+}
+
+void Collectable::registerDynamicConsumer(int consumer)
 {
     this->Lock();
     if (this->IsManaged() && !this->HasSomeConsumers() && !this->ReclaimingAllowed)
@@ -137,13 +152,18 @@ void Collectable::RegisterConsumer(const QString consumer)
         this->Unlock();
         throw new Huggle::Exception("You can't reclaim this managed resource", BOOST_CURRENT_FUNCTION);
     }
-    this->Consumers.append(consumer);
-    this->Consumers.removeDuplicates();
+    if (this->dynamicConsumers == nullptr)
+        this->dynamicConsumers = new QList<int>();
+    if (!this->dynamicConsumers->contains(consumer))
+    {
+        this->dynamicConsumers->append(consumer);
+        this->dynamicConsumerCount++;
+    }
     this->SetManaged();
     this->Unlock();
 }
 
-void Collectable::UnregisterConsumer(const QString consumer)
+void Collectable::unregisterDynamicConsumer(int consumer)
 {
     this->Lock();
     if (this->IsManaged() && !this->HasSomeConsumers())
@@ -152,11 +172,24 @@ void Collectable::UnregisterConsumer(const QString consumer)
         Huggle::Exception::ThrowSoftException("You are working with class that was already scheduled for collection",
                                               BOOST_CURRENT_FUNCTION);
     }
-    this->Consumers.removeOne(consumer);
+    if (this->dynamicConsumers != nullptr && this->dynamicConsumers->removeOne(consumer))
+        this->dynamicConsumerCount--;
     this->SetManaged();
     this->Unlock();
 }
 
+int Collectable::InternConsumer(const QString &consumer)
+{
+    QMutexLocker locker(Collectable::WideLock);
+    QHash<QString, int>::const_iterator id = Collectable::InternedConsumers.constFind(consumer);
+    if (id != Collectable::InternedConsumers.constEnd())
+        return id.value();
+    int result = Collectable::InternedConsumerNames.count();
+    Collectable::InternedConsumerNames.append(consumer);
+    Collectable::InternedConsumers.insert(consumer, result);
+    return result;
+}
+
 QString Collectable::ConsumerIdToString(const int id)
 {
     switch (id)
@@ -171,6 +204,16 @@ QString Collectable::ConsumerIdToString(const int id)
             return "EditQuery";
         case HUGGLECONSUMER_REVERTQUERY:
             return "RevertQuery";
+        case HUGGLECONSUMER_PROCESSOR:
+            return "Processor";
+        case HUGGLECONSUMER_MAINPEND:
+            return "MainPend";
+        case HUGGLECONSUMER_QP_UNCHECKED:
+            return "QP::Unchecked";
+        case HUGGLECONSUMER_QP_REVERTBUFFER:
+            return "QP::RevertBuffer";
+        case HUGGLECONSUMER_JS_POOL:
+            return "JS::Pool";
     }
     return "Unknown consumer: " + QString::number(id);
 }
@@ -206,16 +249,21 @@ QString Collectable::DebugHgc()
         {
             result += QString::number(this->_collectableRefs) + " unknown references\n";
         }
-        int Item=0;
-        while (Item < this->Consumers.count())
+        this->_collectableQL->lock();
+        if (this->dynamicConsumers != nullptr)
         {
-            result +=("GC: " + QString::number(this->CollectableID()) + " " + this->Consumers.at(Item)) + "\n";
-            Item++;
+            Collectable::WideLock->lock();
+            foreach (int consumer, *this->dynamicConsumers)
+                result +=("GC: " + QString::number(this->CollectableID()) + " " + Collectable::InternedConsumerNames.at(consumer)) + "\n";
+            Collectable::WideLock->unlock();
         }
-        Item=0;
-        while (Item < this->iConsumers.count())
+        this->_collectableQL->unlock();
+        quint64 mask = this->consumerMask.load();
+        int Item=0;
+        while (Item < HUGGLE_COLLECTABLE_BITS)
         {
-            result +=("GC: " + QString::number(this->CollectableID()) + " " + ConsumerIdToString( this->iConsumers.at(Item)) ) + "\n";
+            if (mask & (Q_UINT64_C(1) << Item))
+                result +=("GC: " + QString::number(this->CollectableID()) + " " + ConsumerIdToString(Item)) + "\n";
             Item++;
         }
     } else
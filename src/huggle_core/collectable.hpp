@@ -17,6 +17,8 @@
 
 #include "definitions.hpp"
 
+#include <atomic>
+#include <QHash>
 #include <QMutex>
 #include <QList>
 #include <QString>
@@ -36,6 +38,10 @@ namespace Huggle
     //! can be only deleted by garbage collector when no consumers are using it. Basically every
     //! object that has 0 consumers, will be deleted.
 
+    //! Integer consumers lower than HUGGLE_COLLECTABLE_BITS are bits of atomic mask, so that registering them
+    //! and checking whether object has some consumers doesn't need any lock. String consumers are interned
+    //! to integers and stored in small list that is only allocated when object has some.
+
     //! \image html ../documentation/gc01.png
     class HUGGLE_EX_CORE Collectable
     {
@@ -127,32 +133,39 @@ namespace Huggle
              * \return
              */
             unsigned long CollectableID();
+            //! Returns true if object is used by something, this function doesn't lock anything
             bool HasSomeConsumers();
         private:
             static QString ConsumerIdToString(const int id);
+            //! Return unique number for a string consumer, same string always gets same number
+            static int InternConsumer(const QString &consumer);
             static QMutex *WideLock;
             static unsigned long LastCID;
+            static QHash<QString, int> InternedConsumers;
+            static QStringList InternedConsumerNames;
 
             void SetManaged();
+            void registerDynamicConsumer(int consumer);
+            void unregisterDynamicConsumer(int consumer);
             unsigned long CID;
             //! Internal variable that contains a cache whether object is managed
-            bool _collectableManaged;
-            //! List of string consumers that are using this object
-
-            //! Every consumer needs to use unique string that identifies them
-            QStringList Consumers;
+            std::atomic<bool> _collectableManaged;
             //! Changing to true will prevent an exception from being thrown if you register consumer after deleting last consumer
 
             //! Doing so may result in unpredictable crashes, because object should never be accessed after last consumer was removed
             bool ReclaimingAllowed;
-            //! List of int consumers that are using this object
+            //! Mask of int consumers that are using this object
 
             //! Every consumer needs to use a unique int that identifies them
             //! if you aren't sure what number to use, or if you are working
             //! in extension you should use string instead
-            QList<int> iConsumers;
+            std::atomic<quint64> consumerMask;
+            //! Interned string consumers and int consumers that don't fit into mask, allocated on first use
+            QList<int> *dynamicConsumers = nullptr;
+            //! Number of items in dynamicConsumers, so that it can be checked without locking
+            std::atomic<int> dynamicConsumerCount;
             QMutex *_collectableQL;
-            unsigned int _collectableRefs;
+            std::atomic<unsigned int> _collectableRefs;
             bool _collectableLocked;
     };
 
@@ -164,7 +177,7 @@ namespace Huggle
 
     inline bool Collectable::HasSomeConsumers()
     {
-        return (this->_collectableRefs > 0 || this->iConsumers.count() > 0 || this->Consumers.count() > 0);
+        return (this->_collectableRefs.load() > 0 || this->consumerMask.load() != 0 || this->dynamicConsumerCount.load() > 0);
     }
 
     inline void Collectable::IncRef()
@@ -191,6 +191,8 @@ void Configuration::NormalizeConf(WikiSite *site)
 
     if (site->ProjectConfig->MessageHeadings == HeadingsPageName || site->ProjectConfig->MessageHeadings == HeadingsNone)
         site->UserConfig->EnforceMonthsAsHeaders = false;
+    // user config may override some of the project options, so scoring needs to see the final values
+    site->PublishSnapshot();
 }
 
 // These macros saves us some typing
@@ -258,6 +260,7 @@ void Configuration::LoadSystemConfig(QString fn)
         RC(Font);
         RCN(FontSize);
         RCN(QueueSize);
+        RCN(QueueUnpackedDiffs);
         if (key == "GlobalConfigurationWikiAddress")
         {
             hcfg->GlobalConfigurationWikiAddress = option.attribute("text");
@@ -311,9 +314,23 @@ void Configuration::LoadSystemConfig(QString fn)
             continue;
         }
         RCN(RingLogMaxSize);
+        RCB(LocalDiffs);
+        RCN(RevisionCacheSize);
+        RCN(RevisionCacheMemory);
+        RCN(HistoryCacheSize);
+        RCN(KnownHeadTTL);
+        RCN(PrefetchDiffs);
+        RCN(PrefetchMemoryLimit);
+        RCB(ConfigCache);
+        RCN(MaxConcurrentQueries);
+        RCN(MaxLag);
+        RCN(ApiCacheTTL);
+        RCN(ApiCacheSize);
         RC(GlobalConfigYAML);
         RCB(DynamicColsInList);
         RCB(UnsafeExts);
+        RCB(ScriptWorkers);
+        RCN(ScriptHookTimeout);
         RCB(WarnUserSpaceRoll);
         RCB(EnableUpdates);
         RCB(NotifyBeta);
@@ -409,7 +426,10 @@ void Configuration::SaveSystemConfig()
     INSERT_CONFIG_B(UsingSSL);
     INSERT_CONFIG_B(ScoreDebug);
     INSERT_CONFIG_N(QueueSize);
+    INSERT_CONFIG_N(QueueUnpackedDiffs);
     INSERT_CONFIG_B(UnsafeExts);
+    INSERT_CONFIG_B(ScriptWorkers);
+    INSERT_CONFIG_N(ScriptHookTimeout);
     INSERT_CONFIG(GlobalConfigYAML);
     InsertConfig("GlobalConfigurationWikiAddress", hcfg->GlobalConfigurationWikiAddress, writer);
     InsertConfig("IRCIdent", hcfg->IRCIdent, writer);
@@ -429,6 +449,18 @@ void Configuration::SaveSystemConfig()
     INSERT_CONFIG_B(WarnUserSpaceRoll);
     INSERT_CONFIG_N(WikiRC);
     INSERT_CONFIG_B(CatScansAndWatched);
+    INSERT_CONFIG_B(LocalDiffs);
+    INSERT_CONFIG_N(RevisionCacheSize);
+    INSERT_CONFIG_N(RevisionCacheMemory);
+    INSERT_CONFIG_N(HistoryCacheSize);
+    INSERT_CONFIG_N(KnownHeadTTL);
+    INSERT_CONFIG_N(PrefetchDiffs);
+    INSERT_CONFIG_N(PrefetchMemoryLimit);
+    INSERT_CONFIG_B(ConfigCache);
+    INSERT_CONFIG_N(MaxConcurrentQueries);
+    INSERT_CONFIG_N(MaxLag);
+    INSERT_CONFIG_N(ApiCacheTTL);
+    INSERT_CONFIG_N(ApiCacheSize);
     INSERT_CONFIG_N(PlaySoundQueueScore);
     INSERT_CONFIG_B(PlaySoundOnQueue);
     INSERT_CONFIG_B(ParallelLogin);
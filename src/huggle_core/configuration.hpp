@@ -278,9 +278,36 @@ namespace Huggle
             //! If this is true we execute login automatically for expired session
             bool            SystemConfig_Autorelog = true;
             bool            SystemConfig_CatScansAndWatched = true;
+            //! If true huggle computes diffs of frequently edited pages locally instead of asking mediawiki
+            bool            SystemConfig_LocalDiffs = true;
+            //! Maximum number of pages for which we remember text of latest revisions
+            int             SystemConfig_RevisionCacheSize = 200;
+            //! Maximum size of revision texts remembered for those pages in MB, big pages are dropped sooner
+            int             SystemConfig_RevisionCacheMemory = 32;
+            //! Maximum number of pages and users whose history is kept in memory, 0 disables it
+            int             SystemConfig_HistoryCacheSize = 500;
+            //! Number of seconds for which the newest revision of page seen in feed is trusted, so that revert
+            //! doesn't need to ask mediawiki about newer edits first, 0 disables it
+            int             SystemConfig_KnownHeadTTL = 60;
+            //! Number of edits on top of queue whose diffs are rendered in background, 0 disables it
+            int             SystemConfig_PrefetchDiffs = 2;
+            //! Maximum size of diffs rendered in background in kB
+            int             SystemConfig_PrefetchMemoryLimit = 8192;
+            //! Configuration pages are stored on disk and only revalidated using their revision id
+            bool            SystemConfig_ConfigCache = true;
+            //! Maximum number of api queries running at same time on one site
+            int             SystemConfig_MaxConcurrentQueries = 6;
+            //! Value of maxlag parameter sent with low priority queries, 0 disables it
+            int             SystemConfig_MaxLag = 5;
+            //! Number of seconds for which results of read only queries made by post processing are reused, 0 disables the cache
+            int             SystemConfig_ApiCacheTTL = 20;
+            //! Maximum number of results stored in api cache
+            int             SystemConfig_ApiCacheSize = 500;
             bool            SystemConfig_DryMode = false;
             //! Maximum number of queue stuff
             int             SystemConfig_QueueSize = 200;
+            //! Number of edits on top of queue which keep the diff text uncompressed, 0 keeps all of them uncompressed
+            int             SystemConfig_QueueUnpackedDiffs = 20;
             bool            Fuzzy = false;
             //! Size of feed
             int             SystemConfig_ProviderCache = 200;
@@ -331,8 +358,6 @@ namespace Huggle
             //! Whether huggle check for an update on startup
             bool            SystemConfig_EnableUpdates = true;
             bool            SystemConfig_NotifyBeta = false;
-            //! If true huggle will perform a sanity check of its language files on startup
-            bool            SystemConfig_LanguageSanity = false;
             bool            SystemConfig_ParallelLogin = false;
             bool            SystemConfig_RequestDelay = false;
             bool            SystemConfig_SuppressWarnings = true;
@@ -360,6 +385,10 @@ namespace Huggle
             bool            SystemConfig_PlaySoundOnQueue = false;
             long            SystemConfig_PlaySoundQueueScore = 800;
             bool            SystemConfig_UnsafeExts = false;
+            //! Scripts that allow it run their score and queue hooks in their own threads
+            bool            SystemConfig_ScriptWorkers = false;
+            //! Milliseconds that hook running in script worker has to finish, after that it's interrupted
+            int             SystemConfig_ScriptHookTimeout = 500;
             //! This is index for login form so that we can remember which was last wiki user logged to
 
             //! We are storing index instead of wiki name, because in case it was a wiki that later
@@ -459,6 +488,12 @@ namespace Huggle
             bool        NewMessage = false;
             QString     QueryDebugPath = "querydump.dat";
             bool        QueryDebugging = false;
+            //! Path where all feed and api traffic is recorded, see TrafficRecorder
+            QString     TrafficRecordPath;
+            //! Path of capture that is served instead of network, see TrafficReplay
+            QString     TrafficReplayPath;
+            //! How much faster than recorded the capture is replayed, 0 means as fast as possible
+            double      TrafficReplaySpeed = 1;
             QStringList   IgnoredExtensions;
             //! Operating system that is sent to update server
             QString     Platform;
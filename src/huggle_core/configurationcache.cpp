@@ -0,0 +1,131 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "configurationcache.hpp"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include "apiquery.hpp"
+#include "apiqueryresult.hpp"
+#include "configuration.hpp"
+#include "generic.hpp"
+#include "syslog.hpp"
+#include "wikisite.hpp"
+
+using namespace Huggle;
+
+unsigned int ConfigurationCache::hits = 0;
+unsigned int ConfigurationCache::misses = 0;
+
+QString ConfigurationCache::GetPath()
+{
+    QString path = Configuration::GetConfigurationPath() + "cache" + QDir::separator();
+    QDir dir(path);
+    if (!dir.exists())
+        dir.mkpath(path);
+    return path;
+}
+
+bool ConfigurationCache::Get(WikiSite *site, const QString &page, Entry *entry)
+{
+    if (!hcfg->SystemConfig_ConfigCache)
+        return false;
+    QFile file(getFileName(site, page));
+    if (!file.exists() || !file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(&file);
+    quint32 version;
+    QString name;
+    stream >> version;
+    if (version != HUGGLE_CONFIG_CACHE_VERSION)
+    {
+        HUGGLE_DEBUG1("Ignoring cache file of " + page + " because it has unsupported version " + QString::number(version));
+        return false;
+    }
+    stream >> name >> entry->PageID >> entry->RevID >> entry->Text;
+    file.close();
+    // Make sure it's not a collision of hash and that the file is not truncated
+    if (stream.status() != QDataStream::Ok || name != site->Name + "|" + page)
+        return false;
+    return true;
+}
+
+void ConfigurationCache::Store(WikiSite *site, const QString &page, qint64 page_id, revid_ht revid, const QString &text)
+{
+    if (!hcfg->SystemConfig_ConfigCache)
+        return;
+    QFile file(getFileName(site, page));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        Syslog::HuggleLogs->WarningLog("Unable to write configuration cache to " + file.fileName());
+        return;
+    }
+    QDataStream stream(&file);
+    stream << static_cast<quint32>(HUGGLE_CONFIG_CACHE_VERSION) << QString(site->Name + "|" + page) << page_id << revid << text;
+    file.close();
+}
+
+bool ConfigurationCache::StoreFromQuery(WikiSite *site, const QString &page, ApiQuery *query)
+{
+    ApiQueryResultNode *page_node = query->GetApiQueryResult()->GetNode("page");
+    ApiQueryResultNode *rev = query->GetApiQueryResult()->GetNode("rev");
+    if (page_node == nullptr || rev == nullptr || !page_node->Attributes.contains("pageid") || !rev->Attributes.contains("revid"))
+        return false;
+    Store(site, page, page_node->GetAttribute("pageid").toLongLong(), rev->GetAttribute("revid").toLongLong(), rev->Value);
+    return true;
+}
+
+void ConfigurationCache::Remove(WikiSite *site, const QString &page)
+{
+    QFile::remove(getFileName(site, page));
+}
+
+revid_ht ConfigurationCache::GetLatestRevID(ApiQuery *query, qint64 page_id)
+{
+    QString id = QString::number(page_id);
+    foreach (ApiQueryResultNode *page, query->GetApiQueryResult()->GetNodes("page"))
+    {
+        if (page->GetAttribute("pageid") == id && page->Attributes.contains("lastrevid"))
+            return page->GetAttribute("lastrevid").toLongLong();
+    }
+    return WIKI_UNKNOWN_REVID;
+}
+
+bool ConfigurationCache::IsCurrent(ApiQuery *query, const Entry &entry)
+{
+    if (query->IsFailed() || entry.RevID == WIKI_UNKNOWN_REVID)
+        return false;
+    return GetLatestRevID(query, entry.PageID) == entry.RevID;
+}
+
+void ConfigurationCache::RecordHit()
+{
+    hits++;
+}
+
+void ConfigurationCache::RecordMiss()
+{
+    misses++;
+}
+
+unsigned int ConfigurationCache::GetHits()
+{
+    return hits;
+}
+
+unsigned int ConfigurationCache::GetMisses()
+{
+    return misses;
+}
+
+QString ConfigurationCache::getFileName(WikiSite *site, const QString &page)
+{
+    return GetPath() + Generic::MD5(site->Name + "|" + page) + ".dat";
+}
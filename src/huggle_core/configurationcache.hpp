@@ -0,0 +1,79 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef CONFIGURATIONCACHE_HPP
+#define CONFIGURATIONCACHE_HPP
+
+#include "definitions.hpp"
+
+#include <QString>
+
+// Increase this when format of cache files change, older files are then ignored
+#define HUGGLE_CONFIG_CACHE_VERSION 1
+
+namespace Huggle
+{
+    class ApiQuery;
+    class WikiSite;
+
+    //! Cache of configuration pages stored on disk
+
+    //! Project configuration and user configuration of every site are stored together with id of the page
+    //! and id of revision they were retrieved from. On next start huggle only checks if the latest revision
+    //! of the page is still the same (using prop=info, which is a very small query) and if it is, the text
+    //! is loaded from disk instead of downloading it again. Global configuration is not cached, it's always
+    //! downloaded.
+    class HUGGLE_EX_CORE ConfigurationCache
+    {
+        public:
+            class Entry
+            {
+                public:
+                    qint64 PageID = 0;
+                    revid_ht RevID = WIKI_UNKNOWN_REVID;
+                    QString Text;
+            };
+
+            //! Returns path to folder that contains the cache files, suffixed with slash
+            static QString GetPath();
+            /*!
+             * \brief Get retrieves the cached page
+             * \param site Site the page belongs to
+             * \param page Name of the page
+             * \param entry Pointer to structure which is filled with data
+             * \return true if page was found in cache
+             */
+            static bool Get(WikiSite *site, const QString &page, Entry *entry);
+            static void Store(WikiSite *site, const QString &page, qint64 page_id, revid_ht revid, const QString &text);
+            /*!
+             * \brief StoreFromQuery stores the page from result of query that retrieved it with rvprop=ids|content
+             * \return true if result contained all necessary data
+             */
+            static bool StoreFromQuery(WikiSite *site, const QString &page, ApiQuery *query);
+            static void Remove(WikiSite *site, const QString &page);
+            /*!
+             * \brief GetLatestRevID parses result of prop=info query for given page id
+             * \return last revision id of the page or WIKI_UNKNOWN_REVID if it's not present in result
+             */
+            static revid_ht GetLatestRevID(ApiQuery *query, qint64 page_id);
+            //! Returns true if cached page is still current according to prop=info query
+            static bool IsCurrent(ApiQuery *query, const Entry &entry);
+            static void RecordHit();
+            static void RecordMiss();
+            static unsigned int GetHits();
+            static unsigned int GetMisses();
+        private:
+            static QString getFileName(WikiSite *site, const QString &page);
+            static unsigned int hits;
+            static unsigned int misses;
+    };
+}
+
+#endif // CONFIGURATIONCACHE_HPP
@@ -11,9 +11,13 @@
 #include "core.hpp"
 #include <QtXml>
 #include <QFile>
+#include <QElapsedTimer>
 #include <QPluginLoader>
+#include <QRunnable>
+#include <QThreadPool>
 #include <huggle_l10n/huggle_l10n.hpp>
 #include "configuration.hpp"
+#include "diffengine.hpp"
 #include "exception.hpp"
 #include "exceptionhandler.hpp"
 #include "events.hpp"
@@ -24,13 +28,20 @@
 #include "hugglequeuefilter.hpp"
 #include "iextension.hpp"
 #include "localization.hpp"
+#include "memorypool.hpp"
+#include "networkscheduler.hpp"
+#include "apiquerycache.hpp"
+#include "historycache.hpp"
 #include "hooks.hpp"
 #include "sleeper.hpp"
 #include "resources.hpp"
+#include "revisiontextcache.hpp"
 #include "query.hpp"
 #include "querypool.hpp"
+#include "replaynetworkmanager.hpp"
 #include "scripting/script.hpp"
 #include "syslog.hpp"
+#include "trafficcapture.hpp"
 #include "wikiedit.hpp"
 #include "wikipage.hpp"
 #include "wikisite.hpp"
@@ -41,6 +52,30 @@ using namespace Huggle;
 // definitions
 Core    *Core::HuggleCore = nullptr;
 
+//! Maps one extension library into memory, this is done in thread pool, instance is created later in main thread
+class ExtensionLibrary : public QRunnable
+{
+    public:
+        ExtensionLibrary(QString path)
+        {
+            this->Path = path;
+            this->Loader = new QPluginLoader(path);
+            // results are read by ExtensionLoad after the pool is finished
+            this->setAutoDelete(false);
+        }
+        void run()
+        {
+            QElapsedTimer timer;
+            timer.start();
+            this->Loaded = this->Loader->load();
+            this->LoadTime = timer.elapsed();
+        }
+        QString Path;
+        QPluginLoader *Loader;
+        qint64 LoadTime = 0;
+        bool Loaded = false;
+};
+
 void Core::Init()
 {
     // This goes first otherwise we can't throw exceptions
@@ -66,7 +101,28 @@ void Core::Init()
 #endif
     this->gc = new Huggle::GC();
     GC::gc = this->gc;
-    Query::NetworkManager = new QNetworkAccessManager();
+    if (!hcfg->TrafficReplayPath.isEmpty())
+    {
+        QString error;
+        TrafficReplay::Replay = new TrafficReplay(hcfg->TrafficReplaySpeed);
+        if (!TrafficReplay::Replay->Load(hcfg->TrafficReplayPath, &error))
+            throw new Huggle::Exception("Unable to load traffic capture " + hcfg->TrafficReplayPath + ": " + error, BOOST_CURRENT_FUNCTION);
+        Syslog::HuggleLogs->Log("Replaying traffic from " + hcfg->TrafficReplayPath + ", network will not be used");
+        Query::NetworkManager = new ReplayNetworkAccessManager(TrafficReplay::Replay);
+    } else
+    {
+        Query::NetworkManager = new QNetworkAccessManager();
+    }
+    if (!hcfg->TrafficRecordPath.isEmpty())
+    {
+        QString error;
+        TrafficRecorder::Recorder = new TrafficRecorder();
+        if (!TrafficRecorder::Recorder->Open(hcfg->TrafficRecordPath, &error))
+            throw new Huggle::Exception("Unable to open " + hcfg->TrafficRecordPath + ": " + error, BOOST_CURRENT_FUNCTION);
+        Syslog::HuggleLogs->Log("Recording traffic to " + hcfg->TrafficRecordPath);
+    }
+    NetworkScheduler::HuggleScheduler = new NetworkScheduler();
+    ApiQueryCache::HuggleCache = new ApiQueryCache();
     QueryPool::HugglePool = new QueryPool();
     this->HGQP = QueryPool::HugglePool;
     this->HuggleSyslog = Syslog::HuggleLogs;
@@ -90,6 +146,9 @@ void Core::Init()
     {
         Configuration::LoadSystemConfig(QCoreApplication::applicationDirPath() + HUGGLE_CONF);
     }
+    RevisionTextCache::HuggleRevisionTexts = new RevisionTextCache(hcfg->SystemConfig_RevisionCacheSize,
+                                                                           static_cast<qint64>(hcfg->SystemConfig_RevisionCacheMemory) * 1024 * 1024);
+    HistoryCache::HuggleHistory = new HistoryCache(hcfg->SystemConfig_HistoryCacheSize, hcfg->SystemConfig_KnownHeadTTL);
     hcfg->WebRequest_UserAgent = QString("Huggle/" + QString(HUGGLE_VERSION) + " (http://en.wikipedia.org/wiki/WP:Huggle; " + hcfg->HuggleVersion + ")").toUtf8();
     HUGGLE_DEBUG1("UserAgent: " + QString(hcfg->WebRequest_UserAgent));
     // Create a global wiki, now that we loaded the configuration which is only place where it can be changed
@@ -227,6 +286,7 @@ void Core::ExtensionLoad()
             }
         }
 #endif
+        QList<ExtensionLibrary*> libraries;
         foreach (QString ename, extensions)
         {
             if (hcfg->IgnoredExtensions.contains(ename))
@@ -241,55 +301,68 @@ void Core::ExtensionLoad()
             }
             QString name = ename.toLower();
             if (name.endsWith(".so") || name.endsWith(".dll") || name.endsWith(".dylib"))
+                libraries.append(new ExtensionLibrary(ename));
+        }
+        // libraries don't depend on each other, so they are all mapped at once, the instances are
+        // created here in main thread afterwards so that they live in same thread as the rest of huggle
+        QThreadPool pool;
+        foreach (ExtensionLibrary *library, libraries)
+            pool.start(library);
+        pool.waitForDone();
+        foreach (ExtensionLibrary *library, libraries)
+        {
+            QString ename = library->Path;
+            QPluginLoader *extension = library->Loader;
+            if (library->Loaded)
             {
-                QPluginLoader *extension = new QPluginLoader(ename);
-                if (extension->load())
+                QElapsedTimer register_time;
+                register_time.start();
+                QObject* root = extension->instance();
+                if (root)
                 {
-                    QObject* root = extension->instance();
-                    if (root)
+                    iExtension *interface = qobject_cast<iExtension*>(root);
+                    if (!interface)
+                    {
+                        Huggle::Syslog::HuggleLogs->Log("Unable to cast the library to extension: " + ename);
+                    }
+                    else if (interface->CompiledFor() != QString(HUGGLE_VERSION))
                     {
-                        iExtension *interface = qobject_cast<iExtension*>(root);
-                        if (!interface)
+                        Huggle::Syslog::HuggleLogs->WarningLog("Extension " + ename + " was compiled for huggle " + interface->CompiledFor() + " which is not compatible, unloading");
+                        delete interface;
+                    } else
+                    {
+                        interface->huggle__internal_SetPath(ename);
+                        if (interface->RequestNetwork())
+                        {
+                            interface->Networking = Query::NetworkManager;
+                        }
+                        if (interface->RequestConfiguration())
+                        {
+                            interface->Configuration = Configuration::HuggleConfiguration;
+                        }
+                        if (interface->RequestCore())
                         {
-                            Huggle::Syslog::HuggleLogs->Log("Unable to cast the library to extension: " + ename);
+                            interface->HuggleCore = Core::HuggleCore;
                         }
-                        else if (interface->CompiledFor() != QString(HUGGLE_VERSION))
+                        interface->Localization = Localizations::HuggleLocalizations;
+                        if (interface->Register())
                         {
-                            Huggle::Syslog::HuggleLogs->WarningLog("Extension " + ename + " was compiled for huggle " + interface->CompiledFor() + " which is not compatible, unloading");
-                            delete interface;
+                            Core::Extensions.append(interface);
+                            Huggle::Syslog::HuggleLogs->Log("Successfully loaded: " + ename + " (library " + QString::number(library->LoadTime) +
+                                                            "ms, register " + QString::number(register_time.elapsed()) + "ms)");
                         }
+                        else
                         {
-                            interface->huggle__internal_SetPath(ename);
-                            if (interface->RequestNetwork())
-                            {
-                                interface->Networking = Query::NetworkManager;
-                            }
-                            if (interface->RequestConfiguration())
-                            {
-                                interface->Configuration = Configuration::HuggleConfiguration;
-                            }
-                            if (interface->RequestCore())
-                            {
-                                interface->HuggleCore = Core::HuggleCore;
-                            }
-                            interface->Localization = Localizations::HuggleLocalizations;
-                            if (interface->Register())
-                            {
-                                Core::Extensions.append(interface);
-                                Huggle::Syslog::HuggleLogs->Log("Successfully loaded: " + ename);
-                            }
-                            else
-                            {
-                                Huggle::Syslog::HuggleLogs->Log("Unable to register: " + ename);
-                            }
+                            Huggle::Syslog::HuggleLogs->Log("Unable to register: " + ename);
                         }
                     }
-                } else
-                {
-                    Huggle::Syslog::HuggleLogs->Log("Failed to load (reason: " + extension->errorString() + "): " + ename);
-                    delete extension;
                 }
+            } else
+            {
+                Huggle::Syslog::HuggleLogs->Log("Failed to load (reason: " + extension->errorString() + "): " + ename);
+                delete extension;
             }
+            delete library;
         }
     } else
     {
@@ -343,6 +416,17 @@ void Core::Shutdown()
     delete this->HGQP;
     this->HGQP = nullptr;
     QueryPool::HugglePool = nullptr;
+    if (DiffEngine::GetHits() + DiffEngine::GetMisses() > 0)
+    {
+        Syslog::HuggleLogs->Log("Local diffs: " + QString::number(DiffEngine::GetHits()) + " computed locally, " +
+                                QString::number(DiffEngine::GetMisses()) + " retrieved from mediawiki (hit rate " +
+                                QString::number(DiffEngine::GetHitRate(), 'f', 1) + "%), saved approximately " +
+                                QString::number(DiffEngine::GetSavedTime()) + "ms");
+    }
+    delete RevisionTextCache::HuggleRevisionTexts;
+    RevisionTextCache::HuggleRevisionTexts = nullptr;
+    delete HistoryCache::HuggleHistory;
+    HistoryCache::HuggleHistory = nullptr;
     // Now stop the garbage collector and wait for it to finish
     GC::gc->Stop();
     Syslog::HuggleLogs->Log("SHUTDOWN: waiting for garbage collector to finish");
@@ -371,7 +455,26 @@ void Core::Shutdown()
     HuggleQueueFilter::Delete();
     GC::gc = nullptr;
     this->gc = nullptr;
+    Syslog::HuggleLogs->DebugLog("Network queues: " + NetworkScheduler::HuggleScheduler->GetStatistics());
+    Syslog::HuggleLogs->DebugLog("Api cache: " + ApiQueryCache::HuggleCache->GetStatistics());
+    Syslog::HuggleLogs->DebugLog("Memory pools:\n" + MemoryPool::GetStatistics());
+    delete ApiQueryCache::HuggleCache;
+    ApiQueryCache::HuggleCache = nullptr;
+    delete NetworkScheduler::HuggleScheduler;
+    NetworkScheduler::HuggleScheduler = nullptr;
     delete Query::NetworkManager;
+    if (TrafficRecorder::Recorder)
+    {
+        Syslog::HuggleLogs->DebugLog("Traffic recorder: " + QString::number(TrafficRecorder::Recorder->GetRecordCount()) + " records");
+        delete TrafficRecorder::Recorder;
+        TrafficRecorder::Recorder = nullptr;
+    }
+    if (TrafficReplay::Replay)
+    {
+        Syslog::HuggleLogs->Log("Traffic replay: " + TrafficReplay::Replay->GetStatistics());
+        delete TrafficReplay::Replay;
+        TrafficReplay::Replay = nullptr;
+    }
     delete Configuration::HuggleConfiguration;
     // We need to change these to null so that functions that would want to access there later during destruction of Qt derived
     // HW objects would know that they are no longer available and wouldn't crash huggle
@@ -387,47 +490,18 @@ void Core::Shutdown()
     QCoreApplication::quit();
 }
 
-void Core::TestLanguages()
-{
-    if (Configuration::HuggleConfiguration->SystemConfig_LanguageSanity)
-    {
-        Language *english = Localizations::HuggleLocalizations->LocalizationData.at(Localizations::EnglishID);
-        QList<QString> keys = english->Messages.keys();
-        int language = 1;
-        while (language < Localizations::HuggleLocalizations->LocalizationData.count())
-        {
-            Language *l = Localizations::HuggleLocalizations->LocalizationData.at(language);
-            int x = 0;
-            while (x < keys.count())
-            {
-                if (!l->Messages.contains(keys.at(x)))
-                {
-                    Syslog::HuggleLogs->WarningLog("Language " + l->LanguageName + " is missing key " + keys.at(x));
-                } else if (english->Messages[keys.at(x)] == l->Messages[keys.at(x)])
-                {
-                    Syslog::HuggleLogs->WarningLog("Language " + l->LanguageName + " has key " + keys.at(x)
-                            + " but its content is identical to english version");
-                }
-                x++;
-            }
-            language++;
-        }
-    }
-}
-
 void Core::LoadLocalizations()
 {
     Localizations::HuggleLocalizations = new Localizations();
     if (Configuration::HuggleConfiguration->SystemConfig_SafeMode)
     {
-        Localizations::HuggleLocalizations->LocalInit("en"); // English, when in safe mode
+        Localizations::HuggleLocalizations->LoadCatalog(QStringList("en")); // English, when in safe mode
         Huggle::Syslog::HuggleLogs->Log("Skipping load of other languages, because of safe mode");
         return;
     }
-    QStringList localizations = Huggle_l10n::GetLocalizations();
-    foreach (QString localization_name, localizations)
-        Localizations::HuggleLocalizations->LocalInit(localization_name);
-    this->TestLanguages();
+    // only english is loaded now, preferred language isn't known until the configuration is read
+    if (!Localizations::HuggleLocalizations->LoadCatalog(Huggle_l10n::GetLocalizations()))
+        Localizations::HuggleLocalizations->LocalInit("en");
 }
 
 void Core::InstallNewExceptionHandler(ExceptionHandler *eh)
@@ -76,7 +76,6 @@ namespace Huggle
             void ExtensionLoad();
             //! Terminate the process, call this after you release all resources and finish all queries
             void Shutdown();
-            void TestLanguages();
             void LoadDB();
             qint64 GetUptimeInSeconds();
             void LoadLocalizations();
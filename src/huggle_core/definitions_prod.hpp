@@ -88,6 +88,10 @@ namespace std { typedef decltype(nullptr) nullptr_t; }
     #define HUGGLE_USE_MT_GC               "mt"
 #endif
 
+// Uncomment this to allocate edits, pages, users and api result nodes directly from the heap instead of
+// memory pools, this is useful when you are looking for memory errors with valgrind or address sanitizer
+// #define HUGGLE_NO_MEMORY_POOL
+
 // #define HUGGLE_PROFILING
 
 // uncomment this if you want to enable python support
@@ -0,0 +1,427 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "diffengine.hpp"
+#include <QHash>
+
+using namespace Huggle;
+
+QMutex DiffEngine::statsLock;
+unsigned long DiffEngine::hits = 0;
+unsigned long DiffEngine::misses = 0;
+qint64 DiffEngine::localTime = 0;
+qint64 DiffEngine::remoteTime = 0;
+unsigned long DiffEngine::remoteCount = 0;
+
+DiffEngine::Operation::Operation(OperationType type, int old_index, int new_index)
+{
+    this->Type = type;
+    this->OldIndex = old_index;
+    this->NewIndex = new_index;
+}
+
+bool DiffEngine::Myers(const QVector<int> &a, const QVector<int> &b, int max_d, QList<Operation> *result)
+{
+    int n = a.size();
+    int m = b.size();
+    int max = n + m;
+    if (max == 0)
+        return true;
+    if (max_d > max)
+        max_d = max;
+    int offset = max + 1;
+    QVector<int> v(2 * max + 3, 0);
+    // We store only the part of V that was used in each step, so that memory is O(D^2) rather than O(D*(N+M))
+    QList< QVector<int> > trace;
+    int d = 0;
+    bool finished = false;
+    while (d <= max_d && !finished)
+    {
+        trace.append(v.mid(offset - d - 1, 2 * d + 3));
+        int k = -d;
+        while (k <= d)
+        {
+            int x;
+            if (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]))
+                x = v[offset + k + 1];
+            else
+                x = v[offset + k - 1] + 1;
+            int y = x - k;
+            while (x < n && y < m && a[x] == b[y])
+            {
+                x++;
+                y++;
+            }
+            v[offset + k] = x;
+            if (x >= n && y >= m)
+            {
+                finished = true;
+                break;
+            }
+            k += 2;
+        }
+        if (!finished)
+            d++;
+    }
+    if (!finished)
+        return false;
+
+    // Walk the trace backwards to reconstruct the edit script
+    QList<Operation> script;
+    int x = n;
+    int y = m;
+    while (d >= 0)
+    {
+        const QVector<int> &prev = trace.at(d);
+        int k = x - y;
+        int prev_k;
+        if (k == -d || (k != d && prev[k - 1 + d + 1] < prev[k + 1 + d + 1]))
+            prev_k = k + 1;
+        else
+            prev_k = k - 1;
+        int prev_x = prev[prev_k + d + 1];
+        int prev_y = prev_x - prev_k;
+        while (x > prev_x && y > prev_y)
+        {
+            script.prepend(Operation(OperationEqual, x - 1, y - 1));
+            x--;
+            y--;
+        }
+        if (d > 0)
+        {
+            if (x == prev_x)
+                script.prepend(Operation(OperationInsert, -1, y - 1));
+            else
+                script.prepend(Operation(OperationDelete, x - 1, -1));
+        }
+        x = prev_x;
+        y = prev_y;
+        d--;
+    }
+    result->append(script);
+    return true;
+}
+
+QStringList DiffEngine::Tokenize(const QString &line)
+{
+    QStringList tokens;
+    int start = 0;
+    int length = line.length();
+    while (start < length)
+    {
+        int end = start + 1;
+        QChar c = line.at(start);
+        if (c.isLetterOrNumber())
+        {
+            while (end < length && line.at(end).isLetterOrNumber())
+                end++;
+        } else if (c.isSpace())
+        {
+            while (end < length && line.at(end).isSpace())
+                end++;
+        }
+        tokens.append(line.mid(start, end - start));
+        start = end;
+    }
+    return tokens;
+}
+
+QString DiffEngine::Escape(const QString &text)
+{
+    QString result = text;
+    result.replace("&", "&amp;");
+    result.replace("<", "&lt;");
+    result.replace(">", "&gt;");
+    return result;
+}
+
+static QVector<int> Intern(const QStringList &list, QHash<QString, int> *ids)
+{
+    QVector<int> result;
+    result.reserve(list.size());
+    foreach (QString item, list)
+    {
+        QHash<QString, int>::const_iterator i = ids->constFind(item);
+        if (i != ids->constEnd())
+        {
+            result.append(i.value());
+        } else
+        {
+            int id = ids->size();
+            ids->insert(item, id);
+            result.append(id);
+        }
+    }
+    return result;
+}
+
+static QString MarkerCell(QString marker)
+{
+    return "<td class=\"diff-marker\">" + marker + "</td>";
+}
+
+static QString ContextRow(const QString &line)
+{
+    QString cell = "<td class=\"diff-context\"><div>" + DiffEngine::Escape(line) + "</div></td>";
+    return "<tr>" + MarkerCell("&#160;") + cell + MarkerCell("&#160;") + cell + "</tr>\n";
+}
+
+static QString DeletedCell(const QString &html)
+{
+    return MarkerCell(QString(QChar(0x2212))) + "<td class=\"diff-deletedline\"><div>" + html + "</div></td>";
+}
+
+static QString AddedCell(const QString &html)
+{
+    return MarkerCell("+") + "<td class=\"diff-addedline\"><div>" + html + "</div></td>";
+}
+
+static QString EmptyCell()
+{
+    return "<td colspan=\"2\" class=\"diff-empty\">&#160;</td>";
+}
+
+//! Produce a row for a line that was changed, with changes highlighted on word level
+static QString ChangedRow(const QString &old_line, const QString &new_line)
+{
+    QStringList old_tokens = DiffEngine::Tokenize(old_line);
+    QStringList new_tokens = DiffEngine::Tokenize(new_line);
+    QHash<QString, int> ids;
+    QVector<int> a = Intern(old_tokens, &ids);
+    QVector<int> b = Intern(new_tokens, &ids);
+    QList<DiffEngine::Operation> script;
+    QString old_html, new_html;
+    if (!DiffEngine::Myers(a, b, HUGGLE_DIFF_MAX_WORD_D, &script))
+    {
+        // lines are too different, so let's just highlight them as a whole
+        old_html = "<del class=\"diffchange diffchange-inline\">" + DiffEngine::Escape(old_line) + "</del>";
+        new_html = "<ins class=\"diffchange diffchange-inline\">" + DiffEngine::Escape(new_line) + "</ins>";
+        return "<tr>" + DeletedCell(old_html) + AddedCell(new_html) + "</tr>\n";
+    }
+    QString deleted, inserted;
+    foreach (DiffEngine::Operation op, script)
+    {
+        switch (op.Type)
+        {
+            case DiffEngine::OperationDelete:
+                deleted += old_tokens.at(op.OldIndex);
+                break;
+            case DiffEngine::OperationInsert:
+                inserted += new_tokens.at(op.NewIndex);
+                break;
+            case DiffEngine::OperationEqual:
+                if (!deleted.isEmpty())
+                {
+                    old_html += "<del class=\"diffchange diffchange-inline\">" + DiffEngine::Escape(deleted) + "</del>";
+                    deleted.clear();
+                }
+                if (!inserted.isEmpty())
+                {
+                    new_html += "<ins class=\"diffchange diffchange-inline\">" + DiffEngine::Escape(inserted) + "</ins>";
+                    inserted.clear();
+                }
+                old_html += DiffEngine::Escape(old_tokens.at(op.OldIndex));
+                new_html += DiffEngine::Escape(new_tokens.at(op.NewIndex));
+                break;
+        }
+    }
+    if (!deleted.isEmpty())
+        old_html += "<del class=\"diffchange diffchange-inline\">" + DiffEngine::Escape(deleted) + "</del>";
+    if (!inserted.isEmpty())
+        new_html += "<ins class=\"diffchange diffchange-inline\">" + DiffEngine::Escape(inserted) + "</ins>";
+    return "<tr>" + DeletedCell(old_html) + AddedCell(new_html) + "</tr>\n";
+}
+
+QString DiffEngine::Diff(const QString &old_text, const QString &new_text, bool *failed)
+{
+    if (failed)
+        *failed = false;
+    QStringList old_lines = old_text.split("\n");
+    QStringList new_lines = new_text.split("\n");
+    QHash<QString, int> ids;
+    QVector<int> a = Intern(old_lines, &ids);
+    QVector<int> b = Intern(new_lines, &ids);
+
+    // Strip the common prefix and suffix first, typical edit changes only few lines
+    // in the middle of a page so this saves most of the work
+    int prefix = 0;
+    while (prefix < a.size() && prefix < b.size() && a[prefix] == b[prefix])
+        prefix++;
+    int suffix = 0;
+    while (suffix < a.size() - prefix && suffix < b.size() - prefix && a[a.size() - suffix - 1] == b[b.size() - suffix - 1])
+        suffix++;
+
+    QList<Operation> script;
+    int x = 0;
+    while (x < prefix)
+    {
+        script.append(Operation(OperationEqual, x, x));
+        x++;
+    }
+    QList<Operation> middle;
+    if (!Myers(a.mid(prefix, a.size() - prefix - suffix), b.mid(prefix, b.size() - prefix - suffix), HUGGLE_DIFF_MAX_LINE_D, &middle))
+    {
+        if (failed)
+            *failed = true;
+        return "";
+    }
+    foreach (Operation op, middle)
+    {
+        if (op.OldIndex >= 0)
+            op.OldIndex += prefix;
+        if (op.NewIndex >= 0)
+            op.NewIndex += prefix;
+        script.append(op);
+    }
+    x = 0;
+    while (x < suffix)
+    {
+        script.append(Operation(OperationEqual, a.size() - suffix + x, b.size() - suffix + x));
+        x++;
+    }
+
+    // Figure out which parts of script are visible (changes plus their context)
+    int count = script.size();
+    QVector<bool> visible(count, false);
+    bool changed = false;
+    x = 0;
+    while (x < count)
+    {
+        if (script.at(x).Type != OperationEqual)
+        {
+            changed = true;
+            int from = qMax(0, x - HUGGLE_DIFF_CONTEXT);
+            int to = qMin(count - 1, x + HUGGLE_DIFF_CONTEXT);
+            while (from <= to)
+                visible[from++] = true;
+        }
+        x++;
+    }
+    if (!changed)
+        return "";
+
+    QString result;
+    int old_line = 0;
+    int new_line = 0;
+    x = 0;
+    while (x < count)
+    {
+        if (!visible[x])
+        {
+            if (script.at(x).Type != OperationInsert)
+                old_line++;
+            if (script.at(x).Type != OperationDelete)
+                new_line++;
+            x++;
+            continue;
+        }
+        // Beginning of a new block
+        result += "<tr><td colspan=\"2\" class=\"diff-lineno\">Line " + QString::number(old_line + 1) + ":</td>\n"
+                  "<td colspan=\"2\" class=\"diff-lineno\">Line " + QString::number(new_line + 1) + ":</td></tr>\n";
+        while (x < count && visible[x])
+        {
+            const Operation &op = script.at(x);
+            if (op.Type == OperationEqual)
+            {
+                result += ContextRow(old_lines.at(op.OldIndex));
+                old_line++;
+                new_line++;
+                x++;
+                continue;
+            }
+            QStringList deleted, inserted;
+            while (x < count && script.at(x).Type != OperationEqual)
+            {
+                if (script.at(x).Type == OperationDelete)
+                {
+                    deleted.append(old_lines.at(script.at(x).OldIndex));
+                    old_line++;
+                } else
+                {
+                    inserted.append(new_lines.at(script.at(x).NewIndex));
+                    new_line++;
+                }
+                x++;
+            }
+            int line = 0;
+            while (line < deleted.size() && line < inserted.size())
+            {
+                result += ChangedRow(deleted.at(line), inserted.at(line));
+                line++;
+            }
+            int rest = line;
+            while (rest < deleted.size())
+                result += "<tr>" + DeletedCell(Escape(deleted.at(rest++))) + EmptyCell() + "</tr>\n";
+            rest = line;
+            while (rest < inserted.size())
+                result += "<tr>" + EmptyCell() + AddedCell(Escape(inserted.at(rest++))) + "</tr>\n";
+        }
+    }
+    return result;
+}
+
+void DiffEngine::RecordHit(qint64 time)
+{
+    statsLock.lock();
+    hits++;
+    localTime += time;
+    statsLock.unlock();
+}
+
+void DiffEngine::RecordMiss()
+{
+    statsLock.lock();
+    misses++;
+    statsLock.unlock();
+}
+
+void DiffEngine::RecordRemoteTime(qint64 time)
+{
+    statsLock.lock();
+    remoteTime += time;
+    remoteCount++;
+    statsLock.unlock();
+}
+
+unsigned long DiffEngine::GetHits()
+{
+    statsLock.lock();
+    unsigned long result = hits;
+    statsLock.unlock();
+    return result;
+}
+
+unsigned long DiffEngine::GetMisses()
+{
+    statsLock.lock();
+    unsigned long result = misses;
+    statsLock.unlock();
+    return result;
+}
+
+double DiffEngine::GetHitRate()
+{
+    statsLock.lock();
+    double rate = 0;
+    if (hits + misses > 0)
+        rate = (static_cast<double>(hits) / static_cast<double>(hits + misses)) * 100;
+    statsLock.unlock();
+    return rate;
+}
+
+qint64 DiffEngine::GetSavedTime()
+{
+    statsLock.lock();
+    qint64 saved = 0;
+    if (remoteCount > 0)
+        saved = ((remoteTime / static_cast<qint64>(remoteCount)) * static_cast<qint64>(hits)) - localTime;
+    statsLock.unlock();
+    return saved;
+}
@@ -0,0 +1,97 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef DIFFENGINE_HPP
+#define DIFFENGINE_HPP
+
+#include "definitions.hpp"
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Maximum number of edit steps (changed lines) we are willing to compute locally, bigger diffs
+// are left to mediawiki because the browser would choke on them anyway
+#define HUGGLE_DIFF_MAX_LINE_D          800
+#define HUGGLE_DIFF_MAX_WORD_D          400
+// Number of unchanged lines displayed around each change, same as mediawiki
+#define HUGGLE_DIFF_CONTEXT             2
+
+namespace Huggle
+{
+    //! Local diff engine that produces same table markup as action=compare of mediawiki
+
+    //! Diff is computed on lines using Myers O(ND) algorithm, changed lines which can be paired
+    //! are then refined on word level so that the output contains inline <ins> and <del> markers
+    //! just like the diff rendered by the server. Result of Diff() can be directly stored in
+    //! WikiEdit::DiffText and rendered by GenericBrowser::DisplayDiff.
+    class HUGGLE_EX_CORE DiffEngine
+    {
+        public:
+            enum OperationType
+            {
+                OperationEqual,
+                OperationDelete,
+                OperationInsert
+            };
+
+            //! One step of edit script, indexes point to the source sequences
+            class Operation
+            {
+                public:
+                    Operation(OperationType type = OperationEqual, int old_index = -1, int new_index = -1);
+                    OperationType Type;
+                    int OldIndex;
+                    int NewIndex;
+            };
+
+            /*!
+             * \brief Diff computes a diff of 2 texts
+             * \param old_text Text of older revision
+             * \param new_text Text of newer revision
+             * \param failed Set to true in case the diff was too big to be computed locally
+             * \return Html table rows compatible with output of action=compare
+             */
+            static QString Diff(const QString &old_text, const QString &new_text, bool *failed = nullptr);
+            //! Compute an edit script of 2 sequences of interned tokens, returns false if limit of steps was exceeded
+            static bool Myers(const QVector<int> &a, const QVector<int> &b, int max_d, QList<Operation> *result);
+            //! Split a line to words and separators, concatenating the result gives the original line
+            static QStringList Tokenize(const QString &line);
+            static QString Escape(const QString &text);
+
+            ////////////////////////////////////////////
+            // Statistics
+            ////////////////////////////////////////////
+
+            //! Diff was computed locally, time is how long it took in ms
+            static void RecordHit(qint64 time);
+            //! Diff had to be requested from mediawiki
+            static void RecordMiss();
+            //! Register how long it took mediawiki to return a diff, this is used to estimate time we saved
+            static void RecordRemoteTime(qint64 time);
+            static unsigned long GetHits();
+            static unsigned long GetMisses();
+            //! Returns percentage of diffs that were computed locally
+            static double GetHitRate();
+            //! Estimate of ms that were saved by not having to wait for mediawiki
+            static qint64 GetSavedTime();
+        private:
+            static QMutex statsLock;
+            static unsigned long hits;
+            static unsigned long misses;
+            static qint64 localTime;
+            static qint64 remoteTime;
+            static unsigned long remoteCount;
+    };
+}
+
+#endif // DIFFENGINE_HPP
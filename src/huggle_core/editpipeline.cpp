@@ -0,0 +1,155 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "editpipeline.hpp"
+#include <QDateTime>
+#include "configuration.hpp"
+#include "hooks.hpp"
+#include "hugglefeed.hpp"
+#include "hugglequeuefilter.hpp"
+#include "querypool.hpp"
+#include "scripting/scriptworker.hpp"
+#include "wikiedit.hpp"
+#include "wikisite.hpp"
+
+using namespace Huggle;
+
+EditPipeline::EditPipeline()
+{
+
+}
+
+EditPipeline::~EditPipeline()
+{
+    foreach (WikiEdit *edit, this->pending)
+        edit->UnregisterConsumer(HUGGLECONSUMER_MAINPEND);
+    this->pending.clear();
+    this->pendingSince.clear();
+    qDeleteAll(this->scriptJobs);
+    this->scriptJobs.clear();
+}
+
+void EditPipeline::RetrieveEdits(const QList<WikiSite*> &sites)
+{
+    bool full = true;
+    // take one edit from every site in turn, so that a busy wiki doesn't hold the others back
+    while (full)
+    {
+        full = false;
+        foreach (WikiSite *wiki, sites)
+        {
+            if (wiki->Provider == nullptr || !wiki->Provider->ContainsEdit())
+                continue;
+
+            // we take the edit and start post processing it
+            WikiEdit *edit = wiki->Provider->RetrieveEdit();
+            if (edit != nullptr)
+            {
+                QueryPool::HugglePool->PostProcessEdit(edit);
+                edit->RegisterConsumer(HUGGLECONSUMER_MAINPEND);
+                edit->DecRef();
+                this->pending.append(edit);
+                this->pendingSince.append(QDateTime::currentMSecsSinceEpoch());
+                this->Retrieved++;
+            }
+
+            if (!full && wiki->Provider->ContainsEdit())
+                full = true;
+        }
+    }
+}
+
+QList<WikiEdit*> EditPipeline::TakeReadyEdits()
+{
+    QList<WikiEdit*> ready;
+    int c = 0;
+    while (c < this->pending.count())
+    {
+        WikiEdit *edit = this->pending.at(c);
+        if (!edit->IsReady() || !edit->IsPostProcessed())
+        {
+            c++;
+            continue;
+        }
+        bool rejected = false;
+        if (hcfg->SystemConfig_ScriptWorkers)
+        {
+            ScriptHookJob *job = this->scriptJobs.value(edit, nullptr);
+            if (job == nullptr)
+            {
+                job = new ScriptHookJob(edit);
+                this->scriptJobs.insert(edit, job);
+            }
+            if (!job->IsFinished())
+            {
+                c++;
+                continue;
+            }
+            rejected = job->IsRejected();
+            this->scriptJobs.remove(edit);
+            delete job;
+        }
+        Hooks::WikiEdit_ScoreJS(edit);
+        qint64 latency = QDateTime::currentMSecsSinceEpoch() - this->pendingSince.at(c);
+        this->totalLatency += latency;
+        if (latency > this->maximumLatency)
+            this->maximumLatency = latency;
+        // We need to check the edit against filter once more, because some of the checks work
+        // only on post processed edits
+        if (!rejected && edit->GetSite()->CurrentFilter->Matches(edit))
+        {
+            edit->IncRef();
+            ready.append(edit);
+            this->Ready++;
+        } else
+        {
+            this->Filtered++;
+        }
+        this->pending.removeAt(c);
+        this->pendingSince.removeAt(c);
+        edit->UnregisterConsumer(HUGGLECONSUMER_MAINPEND);
+    }
+    return ready;
+}
+
+void EditPipeline::FinalizePostProcessing()
+{
+    int index = 0;
+    while (index < QueryPool::HugglePool->ProcessingEdits.count())
+    {
+        WikiEdit *edit = QueryPool::HugglePool->ProcessingEdits.at(index);
+        if (edit->finalizePostProcessing())
+        {
+            QueryPool::HugglePool->ProcessingEdits.removeAt(index);
+            edit->UnregisterConsumer(HUGGLECONSUMER_CORE_POSTPROCESS);
+        } else
+        {
+            index++;
+        }
+    }
+}
+
+int EditPipeline::GetPendingCount()
+{
+    return this->pending.count();
+}
+
+qint64 EditPipeline::GetAverageLatency()
+{
+    unsigned long long processed = this->Ready + this->Filtered;
+    if (processed == 0)
+        return 0;
+    return this->totalLatency / static_cast<qint64>(processed);
+}
+
+qint64 EditPipeline::GetMaximumLatency()
+{
+    return this->maximumLatency;
+}
@@ -0,0 +1,64 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef EDITPIPELINE_HPP
+#define EDITPIPELINE_HPP
+
+#include "definitions.hpp"
+
+#include <QHash>
+#include <QList>
+
+namespace Huggle
+{
+    class ScriptHookJob;
+    class WikiEdit;
+    class WikiSite;
+
+    //! Moves edits from feed providers through post processing and scoring to the queue
+
+    //! Edits that are taken from providers are post processed and kept here until all information
+    //! about them is available, then they are scored by scripts and checked against the filter of
+    //! their site once more, because some of the checks work only on post processed edits.
+    //! Scripts that run in workers get the edit first, it waits here until they answer.
+    //! This doesn't depend on user interface, so it's used by main window as well as by daemon.
+    class HUGGLE_EX_CORE EditPipeline
+    {
+        public:
+            EditPipeline();
+            ~EditPipeline();
+            //! Take all edits that providers of these sites have in their buffers and start post processing them
+            void RetrieveEdits(const QList<WikiSite*> &sites);
+            //! Returns edits that are post processed, scored and which match the filter of their site
+
+            //! Every returned edit holds one reference that belongs to the caller, who must release it using DecRef()
+            QList<WikiEdit*> TakeReadyEdits();
+            //! Finish post processing of edits for which all the queries are done
+            void FinalizePostProcessing();
+            int GetPendingCount();
+            //! Average time in milliseconds from retrieving the edit from provider until it's ready
+            qint64 GetAverageLatency();
+            qint64 GetMaximumLatency();
+            unsigned long long Retrieved = 0;
+            unsigned long long Ready = 0;
+            //! Edits which didn't match the filter once they were post processed or which were rejected by script
+            unsigned long long Filtered = 0;
+        private:
+            //! Hooks of pending edits that are running in script workers
+            QHash<WikiEdit*, ScriptHookJob*> scriptJobs;
+            QList<WikiEdit*> pending;
+            //! Time when every pending edit was retrieved, in same order as pending edits
+            QList<qint64> pendingSince;
+            qint64 totalLatency = 0;
+            qint64 maximumLatency = 0;
+    };
+}
+
+#endif // EDITPIPELINE_HPP
@@ -21,6 +21,9 @@
 
 class QMutex;
 
+// Integer consumers are stored as bits of a 64 bit mask, so built-in ids need to stay lower than
+// HUGGLE_COLLECTABLE_BITS, bigger ids still work but they are as slow as string consumers
+#define HUGGLE_COLLECTABLE_BITS                 64
 #define HUGGLECONSUMER_WIKIEDIT                 0
 #define HUGGLECONSUMER_QUEUE                    1
 #define HUGGLECONSUMER_CORE_POSTPROCESS         2
@@ -40,9 +43,9 @@ class QMutex;
 #define HUGGLECONSUMER_QP_MODS                  14
 #define HUGGLECONSUMER_REVERTQUERYTMR           16
 #define HUGGLECONSUMER_CALLBACK                 20
+#define HUGGLECONSUMER_JS_POOL                  21
+#define HUGGLECONSUMER_CORE                     22
 #define HUGGLECONSUMER_PYTHON                   60
-#define HUGGLECONSUMER_JS_POOL                  100
-#define HUGGLECONSUMER_CORE                     800
 
 // some macros so that people hate us
 #define GC_DECREF(collectable) if (collectable) collectable->DecRef(); collectable=nullptr
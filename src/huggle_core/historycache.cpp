@@ -0,0 +1,322 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "historycache.hpp"
+#include "apiqueryresult.hpp"
+#include "wikisite.hpp"
+
+using namespace Huggle;
+
+HistoryRevision HistoryRevision::FromApiNode(ApiQueryResultNode *node, const QString &page)
+{
+    HistoryRevision revision;
+    revision.RevID = node->GetAttribute("revid", QString::number(WIKI_UNKNOWN_REVID)).toLongLong();
+    revision.ParentID = node->GetAttribute("parentid", QString::number(WIKI_UNKNOWN_REVID)).toLongLong();
+    revision.Page = node->GetAttribute("title", page);
+    revision.User = node->GetAttribute("user");
+    revision.Timestamp = node->GetAttribute("timestamp");
+    revision.Summary = node->GetAttribute("comment");
+    revision.Size = node->GetAttribute("size", "-1").toLong();
+    revision.Top = node->Attributes.contains("top");
+    foreach (ApiQueryResultNode *tags, node->ChildNodes)
+    {
+        if (tags->Name != "tags")
+            continue;
+        foreach (ApiQueryResultNode *tag, tags->ChildNodes)
+            revision.Tags.append(tag->Value);
+    }
+    return revision;
+}
+
+HistoryCache *HistoryCache::HuggleHistory = nullptr;
+
+HistoryCache::HistoryCache(int max_items, int head_ttl)
+{
+    this->MaxItems = max_items;
+    this->HeadTTL = head_ttl;
+}
+
+void HistoryCache::Record(WikiSite *site, const HistoryRevision &revision)
+{
+    if (revision.RevID == WIKI_UNKNOWN_REVID || this->MaxItems < 1)
+        return;
+    QString page_key = makeKey(site, revision.Page);
+    QString user_key = makeKey(site, revision.User);
+    this->lock.lock();
+    Entry &page = this->pages[page_key];
+    if (revision.RevID > page.Latest)
+        page.Latest = revision.RevID;
+    if (revision.ParentID == 0 && page.Founder.isEmpty())
+        page.Founder = revision.User;
+    bool top = revision.RevID >= page.Latest;
+    insertSorted(page, revision);
+    this->use(this->pageOrder, this->pages, page_key);
+    // revision newer than the head we know about means the feed missed it, it's not confirmed as newest though
+    QHash<QString, Head>::iterator head = this->heads.find(page_key);
+    if (head != this->heads.end() && revision.RevID > head.value().RevID)
+        head.value().RevID = revision.RevID;
+    // contributions are only useful when we have the older ones as well, so we don't start new lists here
+    if (this->users.contains(user_key))
+    {
+        HistoryRevision contribution = revision;
+        contribution.Top = top;
+        insertSorted(this->users[user_key], contribution);
+        this->use(this->userOrder, this->users, user_key);
+    }
+    this->lock.unlock();
+}
+
+void HistoryCache::RecordHead(WikiSite *site, const QString &page, revid_ht revid)
+{
+    if (revid == WIKI_UNKNOWN_REVID || this->HeadTTL < 1)
+        return;
+    QString key = makeKey(site, page);
+    this->lock.lock();
+    this->setHead(key, revid, QDateTime::currentDateTime());
+    this->lock.unlock();
+}
+
+void HistoryCache::InsertHistory(WikiSite *site, const QString &page, const QList<HistoryRevision> &revisions)
+{
+    if (revisions.isEmpty() || this->MaxItems < 1)
+        return;
+    QString key = makeKey(site, page);
+    this->lock.lock();
+    Entry &entry = this->pages[key];
+    // edits that came from feed while the history was being downloaded are newer than what mediawiki gave us
+    QList<HistoryRevision> newer;
+    foreach (HistoryRevision revision, entry.Revisions)
+    {
+        if (revision.RevID > revisions.first().RevID)
+            newer.append(revision);
+    }
+    entry.Revisions = newer + revisions;
+    truncate(entry);
+    entry.Fetched = QDateTime::currentDateTime();
+    if (entry.Revisions.first().RevID > entry.Latest)
+        entry.Latest = entry.Revisions.first().RevID;
+    if (revisions.last().ParentID == 0)
+        entry.Founder = revisions.last().User;
+    if (this->HeadTTL > 0)
+        this->setHead(key, entry.Latest, entry.Fetched);
+    this->use(this->pageOrder, this->pages, key);
+    this->lock.unlock();
+}
+
+void HistoryCache::InsertContributions(WikiSite *site, const QString &user, const QList<HistoryRevision> &revisions, bool whole)
+{
+    if (this->MaxItems < 1)
+        return;
+    QString key = makeKey(site, user);
+    this->lock.lock();
+    Entry &entry = this->users[key];
+    entry.Revisions = revisions;
+    entry.Whole = whole;
+    truncate(entry);
+    entry.Fetched = QDateTime::currentDateTime();
+    this->use(this->userOrder, this->users, key);
+    this->lock.unlock();
+}
+
+bool HistoryCache::GetHistory(WikiSite *site, const QString &page, int limit, QList<HistoryRevision> *revisions)
+{
+    QString key = makeKey(site, page);
+    this->lock.lock();
+    QHash<QString, Entry>::const_iterator entry = this->pages.constFind(key);
+    if (entry == this->pages.constEnd() || !this->isFresh(entry.value()))
+    {
+        this->lock.unlock();
+        return false;
+    }
+    const QList<HistoryRevision> &known = entry.value().Revisions;
+    int count = qMin(limit, known.count());
+    // if we have less revisions than requested, we must have everything up to the creation of page
+    bool hit = count > 0 && (count == limit || known.at(count - 1).ParentID == 0);
+    int i = 0;
+    while (hit && i < count - 1)
+    {
+        hit = known.at(i).ParentID == known.at(i + 1).RevID;
+        i++;
+    }
+    if (hit)
+    {
+        *revisions = known.mid(0, count);
+        this->use(this->pageOrder, this->pages, key);
+    }
+    this->lock.unlock();
+    return hit;
+}
+
+bool HistoryCache::GetContributions(WikiSite *site, const QString &user, int limit, QList<HistoryRevision> *revisions)
+{
+    QString key = makeKey(site, user);
+    this->lock.lock();
+    QHash<QString, Entry>::const_iterator entry = this->users.constFind(key);
+    if (entry == this->users.constEnd() || !this->isFresh(entry.value()))
+    {
+        this->lock.unlock();
+        return false;
+    }
+    const QList<HistoryRevision> &known = entry.value().Revisions;
+    int count = qMin(limit, known.count());
+    if (count < limit && !entry.value().Whole)
+    {
+        this->lock.unlock();
+        return false;
+    }
+    revisions->clear();
+    int i = 0;
+    while (i < count)
+    {
+        HistoryRevision contribution = known.at(i++);
+        // someone else could have edited the page since we retrieved the contributions
+        QHash<QString, Entry>::const_iterator page = this->pages.constFind(makeKey(site, contribution.Page));
+        if (page != this->pages.constEnd() && page.value().Latest > contribution.RevID)
+            contribution.Top = false;
+        revisions->append(contribution);
+    }
+    this->use(this->userOrder, this->users, key);
+    this->lock.unlock();
+    return true;
+}
+
+bool HistoryCache::GetRevision(WikiSite *site, const QString &page, const QString &user, revid_ht revid, HistoryRevision *revision)
+{
+    if (revid == WIKI_UNKNOWN_REVID)
+        return false;
+    this->lock.lock();
+    // revisions of page are checked first, contributions are there for edits opened from user info
+    QList<HistoryRevision> known = this->pages.value(makeKey(site, page)).Revisions + this->users.value(makeKey(site, user)).Revisions;
+    this->lock.unlock();
+    foreach (HistoryRevision candidate, known)
+    {
+        if (candidate.RevID == revid)
+        {
+            *revision = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HistoryCache::GetHead(WikiSite *site, const QString &page, revid_ht *revid)
+{
+    this->lock.lock();
+    QHash<QString, Head>::const_iterator head = this->heads.constFind(makeKey(site, page));
+    bool known = head != this->heads.constEnd() && head.value().Seen.secsTo(QDateTime::currentDateTime()) < this->HeadTTL;
+    if (known)
+        *revid = head.value().RevID;
+    this->lock.unlock();
+    return known;
+}
+
+bool HistoryCache::GetFounder(WikiSite *site, const QString &page, QString *founder)
+{
+    this->lock.lock();
+    QHash<QString, Entry>::const_iterator entry = this->pages.constFind(makeKey(site, page));
+    bool known = entry != this->pages.constEnd() && !entry.value().Founder.isEmpty();
+    if (known)
+        *founder = entry.value().Founder;
+    this->lock.unlock();
+    return known;
+}
+
+void HistoryCache::SetFounder(WikiSite *site, const QString &page, const QString &founder)
+{
+    if (founder.isEmpty() || this->MaxItems < 1)
+        return;
+    QString key = makeKey(site, page);
+    this->lock.lock();
+    this->pages[key].Founder = founder;
+    this->use(this->pageOrder, this->pages, key);
+    this->lock.unlock();
+}
+
+void HistoryCache::Clear()
+{
+    this->lock.lock();
+    this->pages.clear();
+    this->users.clear();
+    this->heads.clear();
+    this->pageOrder.clear();
+    this->userOrder.clear();
+    this->lock.unlock();
+}
+
+int HistoryCache::Count()
+{
+    this->lock.lock();
+    int count = this->pages.count() + this->users.count();
+    this->lock.unlock();
+    return count;
+}
+
+QString HistoryCache::makeKey(WikiSite *site, const QString &name)
+{
+    return site->Name + "|" + name;
+}
+
+void HistoryCache::insertSorted(Entry &entry, const HistoryRevision &revision)
+{
+    int i = 0;
+    while (i < entry.Revisions.count() && entry.Revisions.at(i).RevID > revision.RevID)
+        i++;
+    if (i < entry.Revisions.count() && entry.Revisions.at(i).RevID == revision.RevID)
+        entry.Revisions[i] = revision;
+    else
+        entry.Revisions.insert(i, revision);
+    truncate(entry);
+}
+
+void HistoryCache::truncate(Entry &entry)
+{
+    while (entry.Revisions.count() > HUGGLE_HISTORY_CACHE_REVS)
+    {
+        entry.Revisions.removeLast();
+        entry.Whole = false;
+    }
+}
+
+bool HistoryCache::isFresh(const Entry &entry)
+{
+    return entry.Fetched.isValid() && entry.Fetched.secsTo(QDateTime::currentDateTime()) < HUGGLE_HISTORY_CACHE_TTL;
+}
+
+void HistoryCache::use(QList<QString> &order, QHash<QString, Entry> &items, const QString &key)
+{
+    order.removeOne(key);
+    order.append(key);
+    while (order.count() > this->MaxItems)
+        items.remove(order.takeFirst());
+}
+
+void HistoryCache::setHead(const QString &key, revid_ht revid, const QDateTime &seen)
+{
+    Head &head = this->heads[key];
+    // feeds don't need to deliver edits in order, older revision can't replace the newer one
+    if (revid < head.RevID)
+        return;
+    head.RevID = revid;
+    head.Seen = seen;
+    if (this->heads.count() <= HUGGLE_HISTORY_CACHE_HEADS)
+        return;
+    QDateTime now = QDateTime::currentDateTime();
+    QHash<QString, Head>::iterator i = this->heads.begin();
+    while (i != this->heads.end())
+    {
+        if (i.value().Seen.secsTo(now) >= this->HeadTTL)
+            i = this->heads.erase(i);
+        else
+            ++i;
+    }
+    // feed is faster than we expected, forget everything rather than scanning all heads on every edit
+    if (this->heads.count() > HUGGLE_HISTORY_CACHE_HEADS)
+        this->heads.clear();
+}
@@ -0,0 +1,136 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef HISTORYCACHE_HPP
+#define HISTORYCACHE_HPP
+
+#include "definitions.hpp"
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+// Revisions we keep for one page or one user, when more is needed the history is downloaded again
+#define HUGGLE_HISTORY_CACHE_REVS 100
+// Number of seconds after which history retrieved from mediawiki is no longer trusted, the feed might have missed some edits
+#define HUGGLE_HISTORY_CACHE_TTL 600
+// Pages for which we remember the newest revision, when there is more of them the expired ones are dropped
+#define HUGGLE_HISTORY_CACHE_HEADS 5000
+
+namespace Huggle
+{
+    class ApiQueryResultNode;
+    class WikiSite;
+
+    //! Meta data of single revision, as returned by prop=revisions or list=usercontribs
+    class HUGGLE_EX_CORE HistoryRevision
+    {
+        public:
+            //! Parse rev or item node, page is used when node doesn't contain the title
+            static HistoryRevision FromApiNode(ApiQueryResultNode *node, const QString &page = "");
+            revid_ht RevID = WIKI_UNKNOWN_REVID;
+            //! Previous revision of the page, 0 if this revision created it
+            revid_ht ParentID = WIKI_UNKNOWN_REVID;
+            QString Page;
+            QString User;
+            //! Timestamp in format used by mediawiki
+            QString Timestamp;
+            QString Summary;
+            QStringList Tags;
+            //! Size of page after this revision, -1 if not known
+            long Size = -1;
+            //! Used only in contributions, true if nobody edited the page after this revision
+            bool Top = false;
+    };
+
+    //! Page histories and user contributions shared by history widget, user info widget and post processing
+
+    //! Histories which were downloaded once are kept up to date using edits that are coming from the
+    //! feed, every post processed edit is recorded here. A page history is only returned when its revisions
+    //! form unbroken chain of parent ids, so a missed edit in the middle turns a hit into a new download.
+    class HUGGLE_EX_CORE HistoryCache
+    {
+        public:
+            static HistoryCache *HuggleHistory;
+
+            HistoryCache(int max_items = 500, int head_ttl = 60);
+            //! Record a revision that was seen in feed or retrieved during post processing
+            void Record(WikiSite *site, const HistoryRevision &revision);
+            //! Record an edit that just arrived from a live feed, so that it's the newest revision of its page
+            void RecordHead(WikiSite *site, const QString &page, revid_ht revid);
+            /*!
+             * \brief GetHead returns the newest revision of page, if it was confirmed by feed or mediawiki recently
+             *
+             * The result is only as good as the feed it came from, so anything that writes to the page based on
+             * it must still let mediawiki detect the conflict
+             */
+            bool GetHead(WikiSite *site, const QString &page, revid_ht *revid);
+            //! Replace history of page with revisions retrieved from mediawiki, sorted from newest
+            void InsertHistory(WikiSite *site, const QString &page, const QList<HistoryRevision> &revisions);
+            /*!
+             * \brief InsertContributions replaces contributions of user with list retrieved from mediawiki
+             * \param whole True if the list contains all contributions of this user
+             */
+            void InsertContributions(WikiSite *site, const QString &user, const QList<HistoryRevision> &revisions, bool whole);
+            //! Returns true and fills in the latest revisions of page if history is known
+            bool GetHistory(WikiSite *site, const QString &page, int limit, QList<HistoryRevision> *revisions);
+            //! Returns true and fills in the latest contributions of user if they are known
+            bool GetContributions(WikiSite *site, const QString &user, int limit, QList<HistoryRevision> *revisions);
+            //! Find a revision of page, user is used to search in their contributions as well
+            bool GetRevision(WikiSite *site, const QString &page, const QString &user, revid_ht revid, HistoryRevision *revision);
+            bool GetFounder(WikiSite *site, const QString &page, QString *founder);
+            void SetFounder(WikiSite *site, const QString &page, const QString &founder);
+            void Clear();
+            int Count();
+            int MaxItems;
+            //! Number of seconds for which the newest revision of page is trusted, 0 disables GetHead
+            int HeadTTL;
+        private:
+            class Head
+            {
+                public:
+                    revid_ht RevID = WIKI_UNKNOWN_REVID;
+                    //! Time when RevID was confirmed to be the newest one
+                    QDateTime Seen;
+            };
+            class Entry
+            {
+                public:
+                    //! Revisions sorted from newest
+                    QList<HistoryRevision> Revisions;
+                    //! Time when revisions were retrieved from mediawiki, null if we only know those from feed
+                    QDateTime Fetched;
+                    //! Newest revision of page we know about, used to figure out if contributions are still on top
+                    revid_ht Latest = WIKI_UNKNOWN_REVID;
+                    QString Founder;
+                    //! Contributions only, there are no older contributions than those we have
+                    bool Whole = false;
+            };
+            static QString makeKey(WikiSite *site, const QString &name);
+            static void insertSorted(Entry &entry, const HistoryRevision &revision);
+            static void truncate(Entry &entry);
+            bool isFresh(const Entry &entry);
+            void use(QList<QString> &order, QHash<QString, Entry> &items, const QString &key);
+            void setHead(const QString &key, revid_ht revid, const QDateTime &seen);
+            QHash<QString, Entry> pages;
+            //! Heads are kept apart from pages, every edit in feed has one and they would push the histories out
+            QHash<QString, Head> heads;
+            QHash<QString, Entry> users;
+            //! Keys in order in which they were used, most recent at the end
+            QList<QString> pageOrder;
+            QList<QString> userOrder;
+            QMutex lock;
+    };
+}
+
+#endif // HISTORYCACHE_HPP
@@ -121,7 +121,8 @@ bool Huggle::Hooks::OnEditLoadToQueue(Huggle::WikiEdit *edit)
     }
     foreach (Script *s, Script::GetScripts())
     {
-        if (s->IsWorking())
+        // scripts with worker already filtered the edit in pipeline
+        if (s->IsWorking() && s->GetWorker() == nullptr)
             if (!s->Hook_EditLoadToQueue(edit))
                 return false;
     }
@@ -173,7 +174,7 @@ void Huggle::Hooks::WikiEdit_ScoreJS(Huggle::WikiEdit *edit)
 {
     foreach (Script *s, Script::GetScripts())
     {
-        if (s->IsWorking())
+        if (s->IsWorking() && s->GetWorker() == nullptr)
         {
             int score = s->Hook_EditRescore(edit);
             if (!score)
@@ -11,6 +11,9 @@
 #include "configuration.hpp"
 #include "hugglefeed.hpp"
 #include "exception.hpp"
+#include "historycache.hpp"
+#include "wikiedit.hpp"
+#include "wikipage.hpp"
 #include "wikisite.hpp"
 
 using namespace Huggle;
@@ -150,6 +153,13 @@ void HuggleFeed::IncrementEdits()
     this->getLatestStatisticsBlock()->Edits++;
 }
 
+void HuggleFeed::recordHead(WikiEdit *edit)
+{
+    if (HistoryCache::HuggleHistory == nullptr || edit->Page == nullptr)
+        return;
+    HistoryCache::HuggleHistory->RecordHead(edit->GetSite(), edit->Page->PageName, edit->RevID);
+}
+
 void HuggleFeed::IncrementReverts()
 {
     if (!this->IsWorking())
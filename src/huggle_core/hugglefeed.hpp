@@ -21,6 +21,7 @@
 #define HUGGLE_FEED_PROVIDER_IRC          0
 #define HUGGLE_FEED_PROVIDER_WIKI         1
 #define HUGGLE_FEED_PROVIDER_XMLRPC       2
+#define HUGGLE_FEED_PROVIDER_REPLAY       3
 
 namespace Huggle
 {
@@ -90,6 +91,8 @@ namespace Huggle
             HuggleQueueFilter *Filter;
         protected:
             static QList<HuggleFeed*> providerList;
+            //! Remember that the edit is now the newest revision of its page, only live feeds should call this
+            void recordHead(WikiEdit *edit);
             void rotateStats();
             StatisticsBlock *getLatestStatisticsBlock();
             //! Number of edits made since you logged in
@@ -18,6 +18,7 @@
 #include "hugglequeuefilter.hpp"
 #include "querypool.hpp"
 #include "syslog.hpp"
+#include "trafficcapture.hpp"
 #include "wikiedit.hpp"
 #include "wikipage.hpp"
 #include "wikisite.hpp"
@@ -105,6 +106,7 @@ void HuggleFeedProviderIRC::InsertEdit(WikiEdit *edit)
 
     // Increase the number of edits that were made since provider is up, this is used for statistics
     this->IncrementEdits();
+    this->recordHead(edit);
     // We need to pre process edit so that we have all its properties ready for queue filter
     QueryPool::HugglePool->PreProcessEdit(edit);
     // We only insert it to buffer in case that current filter matches the edit, this is probably not needed
@@ -133,30 +135,39 @@ void HuggleFeedProviderIRC::InsertEdit(WikiEdit *edit)
 
 void HuggleFeedProviderIRC::ParseEdit(QString line)
 {
+    if (TrafficRecorder::Recorder)
+        TrafficRecorder::Recorder->RecordFeedLine(this->GetSite(), this->GetID(), line.toUtf8());
     // skip edits if provider is disabled
     if (this->isPaused)
     {
         return;
     }
+    WikiEdit *edit = DecodeLine(line, this->GetSite());
+    if (edit != nullptr)
+        this->InsertEdit(edit);
+}
+
+WikiEdit *HuggleFeedProviderIRC::DecodeLine(QString line, WikiSite *site)
+{
     if (!line.contains(QString(QChar(003)) + "07"))
     {
         HUGGLE_DEBUG("Invalid line (no07):" + line, 1);
-        return;
+        return nullptr;
     }
     line = line.mid(line.indexOf(QString(QChar(003)) + "07") + 3);
     if (!line.contains(QString(QChar(003)) + "14"))
     {
         HUGGLE_DEBUG("Invalid line (no14):" + line, 1);
-        return;
+        return nullptr;
     }
     WikiEdit *edit = new WikiEdit();
-    edit->Page = new WikiPage(line.mid(0, line.indexOf(QString(QChar(003)) + "14")), this->GetSite());
+    edit->Page = new WikiPage(line.mid(0, line.indexOf(QString(QChar(003)) + "14")), site);
     edit->IncRef();
     if (!line.contains(QString(QChar(003)) + "4 "))
     {
         HUGGLE_DEBUG("Invalid line (no:x4:" + line, 1);
         edit->DecRef();
-        return;
+        return nullptr;
     }
     line = line.mid(line.indexOf(QString(QChar(003)) + "4 ") + 2);
     QString flags = line.mid(0, line.indexOf(QChar(003)));
@@ -180,7 +191,7 @@ void HuggleFeedProviderIRC::ParseEdit(QString line)
         flags.contains("add")      || flags.contains("selfadd"))
     {
         edit->DecRef();
-        return;
+        return nullptr;
     }
     if (!edit->NewPage)
     {
@@ -188,7 +199,7 @@ void HuggleFeedProviderIRC::ParseEdit(QString line)
         {
             HUGGLE_DEBUG("Invalid line (flags: " + flags + ") (no diff):" + line, 1);
             edit->DecRef();
-            return;
+            return nullptr;
         }
 
         line = line.mid(line.indexOf("?diff=") + 6);
@@ -197,7 +208,7 @@ void HuggleFeedProviderIRC::ParseEdit(QString line)
         {
             HUGGLE_DEBUG("Invalid line (no &):" + line, 1);
             edit->DecRef();
-            return;
+            return nullptr;
         }
         edit->Diff = line.mid(0, line.indexOf("&")).toLongLong();
         edit->RevID = line.mid(0, line.indexOf("&")).toLongLong();
@@ -206,36 +217,36 @@ void HuggleFeedProviderIRC::ParseEdit(QString line)
     {
         HUGGLE_DEBUG("Invalid line (no oldid?):" + line, 1);
         edit->DecRef();
-        return;
+        return nullptr;
     }
     line = line.mid(line.indexOf("oldid=") + 6);
     if (!line.contains(QString(QChar(003))))
     {
         HUGGLE_DEBUG("Invalid line (no termin):" + line, 1);
         edit->DecRef();
-        return;
+        return nullptr;
     }
     edit->OldID = line.mid(0, line.indexOf(QString(QChar(003)))).toInt();
     if (!line.contains(QString(QChar(003)) + "03"))
     {
         HUGGLE_DEBUG("Invalid line, no user: " + line, 1);
         edit->DecRef();
-        return;
+        return nullptr;
     }
     line = line.mid(line.indexOf(QString(QChar(003)) + "03") + 3);
     if (!line.contains(QString(QChar(3))))
     {
         HUGGLE_DEBUG("Invalid line (no termin):" + line, 1);
         edit->DecRef();
-        return;
+        return nullptr;
     }
     QString name = line.mid(0, line.indexOf(QString(QChar(3))));
     if (name.length() <= 0)
     {
         edit->DecRef();
-        return;
+        return nullptr;
     }
-    edit->User = new WikiUser(name, this->GetSite());
+    edit->User = new WikiUser(name, site);
     if (line.contains(QString(QChar(3)) + " ("))
     {
         line = line.mid(line.indexOf(QString(QChar(3)) + " (") + 3);
@@ -274,7 +285,7 @@ void HuggleFeedProviderIRC::ParseEdit(QString line)
             edit->Summary = line.mid(0, line.indexOf(QString(QChar(3))));
         }
     }
-    this->InsertEdit(edit);
+    return edit;
 }
 
 bool HuggleFeedProviderIRC::IsStopped()
@@ -51,6 +51,8 @@ namespace Huggle
             bool Restart() { this->Stop(); return this->Start(); }
             void InsertEdit(WikiEdit *edit);
             void ParseEdit(QString line);
+            //! Creates an edit from line of irc feed, returns null if line is not an edit, caller needs to release its reference
+            static WikiEdit *DecodeLine(QString line, WikiSite *site);
             bool IsStopped();
             int FeedPriority() { return 10; }
             int GetID() { return HUGGLE_FEED_PROVIDER_IRC; }
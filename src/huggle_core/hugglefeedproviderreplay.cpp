@@ -0,0 +1,172 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "hugglefeedproviderreplay.hpp"
+#include <QTimer>
+#include <QtXml>
+#include "configuration.hpp"
+#include "exception.hpp"
+#include "hugglefeedproviderirc.hpp"
+#include "hugglefeedproviderxml.hpp"
+#include "hugglequeuefilter.hpp"
+#include "querypool.hpp"
+#include "syslog.hpp"
+#include "trafficcapture.hpp"
+#include "wikiedit.hpp"
+#include "wikisite.hpp"
+
+using namespace Huggle;
+
+// When replaying at maximum speed we only decode new lines once the consumer took most of the previous ones,
+// so that edits are not dropped because of full cache
+#define REPLAY_MAX_SPEED_BUFFER 10
+
+HuggleFeedProviderReplay::HuggleFeedProviderReplay(WikiSite *site, TrafficReplay *replay) : HuggleFeed(site)
+{
+    this->replay = replay;
+    this->timer = new QTimer();
+    connect(this->timer, SIGNAL(timeout()), this, SLOT(OnTick()));
+}
+
+HuggleFeedProviderReplay::~HuggleFeedProviderReplay()
+{
+    delete this->timer;
+    while (this->buffer.count() > 0)
+    {
+        this->buffer.at(0)->DecRef();
+        this->buffer.removeAt(0);
+    }
+}
+
+bool HuggleFeedProviderReplay::Start()
+{
+    if (!this->replay->HasFeedLines(this->GetSite()->Name))
+        Syslog::HuggleLogs->WarningLog("Traffic capture contains no feed of " + this->GetSite()->Name);
+    this->timer->start(10);
+    return true;
+}
+
+bool HuggleFeedProviderReplay::IsPaused()
+{
+    return this->isPaused;
+}
+
+void HuggleFeedProviderReplay::Resume()
+{
+    this->isPaused = false;
+}
+
+void HuggleFeedProviderReplay::Pause()
+{
+    this->isPaused = true;
+}
+
+bool HuggleFeedProviderReplay::IsWorking()
+{
+    return this->timer->isActive();
+}
+
+void HuggleFeedProviderReplay::Stop()
+{
+    this->timer->stop();
+}
+
+bool HuggleFeedProviderReplay::ContainsEdit()
+{
+    return this->buffer.count() > 0;
+}
+
+bool HuggleFeedProviderReplay::IsStopped()
+{
+    return !this->timer->isActive();
+}
+
+unsigned long long HuggleFeedProviderReplay::GetBytesReceived()
+{
+    return this->bytesRcvd;
+}
+
+unsigned long long HuggleFeedProviderReplay::GetBytesSent()
+{
+    return 0;
+}
+
+WikiEdit *HuggleFeedProviderReplay::RetrieveEdit()
+{
+    if (this->buffer.size() == 0)
+        return nullptr;
+
+    WikiEdit *edit = this->buffer.at(0);
+    this->buffer.removeAt(0);
+    return edit;
+}
+
+QString HuggleFeedProviderReplay::ToString()
+{
+    return "Replay";
+}
+
+void HuggleFeedProviderReplay::OnTick()
+{
+    // feed keeps running while paused, same as live feed does, the edits are just dropped
+    TrafficRecord record;
+    while ((this->replay->Speed > 0 || this->buffer.size() < REPLAY_MAX_SPEED_BUFFER) &&
+           this->replay->TakeFeedLine(this->GetSite()->Name, &record))
+    {
+        this->bytesRcvd += static_cast<unsigned long long>(record.Data.size());
+        if (!this->isPaused)
+            this->decode(record);
+    }
+}
+
+void HuggleFeedProviderReplay::decode(const TrafficRecord &record)
+{
+    WikiEdit *edit = nullptr;
+    if (record.Provider == HUGGLE_FEED_PROVIDER_IRC)
+    {
+        edit = HuggleFeedProviderIRC::DecodeLine(QString::fromUtf8(record.Data), this->GetSite());
+    } else if (record.Provider == HUGGLE_FEED_PROVIDER_XMLRPC)
+    {
+        QDomDocument input;
+        input.setContent(QString::fromUtf8(record.Data));
+        bool valid;
+        edit = HuggleFeedProviderXml::DecodeEdit(input.firstChild().toElement(), this->GetSite(), &valid);
+    } else
+    {
+        HUGGLE_DEBUG1("Unknown provider in traffic capture: " + QString::number(record.Provider));
+    }
+    if (edit != nullptr)
+        this->insertEdit(edit);
+}
+
+void HuggleFeedProviderReplay::insertEdit(WikiEdit *edit)
+{
+    if (edit == nullptr)
+        throw new Huggle::NullPointerException("WikiEdit *edit", BOOST_CURRENT_FUNCTION);
+
+    this->IncrementEdits();
+    QueryPool::HugglePool->PreProcessEdit(edit);
+    if (edit->GetSite()->CurrentFilter->Matches(edit))
+    {
+        if (this->buffer.size() > hcfg->SystemConfig_ProviderCache)
+        {
+            while (this->buffer.size() > (hcfg->SystemConfig_ProviderCache - 10))
+            {
+                this->buffer.at(0)->DecRef();
+                this->buffer.removeAt(0);
+            }
+            Huggle::Syslog::HuggleLogs->WarningLog("insufficient space in replay cache, increase ProviderCache size, otherwise you will be losing edits");
+        }
+        this->buffer.append(edit);
+    } else
+    {
+        edit->DecRef();
+    }
+}
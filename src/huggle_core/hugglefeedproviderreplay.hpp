@@ -0,0 +1,63 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef HUGGLEFEEDPROVIDERREPLAY_HPP
+#define HUGGLEFEEDPROVIDERREPLAY_HPP
+
+#include "definitions.hpp"
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include "hugglefeed.hpp"
+
+class QTimer;
+
+namespace Huggle
+{
+    class TrafficRecord;
+    class TrafficReplay;
+
+    //! Provider which feeds edits recorded in traffic capture, see TrafficReplay
+    class HUGGLE_EX_CORE HuggleFeedProviderReplay : public QObject, public HuggleFeed
+    {
+            Q_OBJECT
+        public:
+            HuggleFeedProviderReplay(WikiSite *site, TrafficReplay *replay);
+            ~HuggleFeedProviderReplay();
+            bool Start();
+            bool IsPaused();
+            int GetID() { return HUGGLE_FEED_PROVIDER_REPLAY; }
+            void Resume();
+            void Pause();
+            bool IsWorking();
+            void Stop();
+            bool Restart() { this->Stop(); return this->Start(); }
+            bool ContainsEdit();
+            bool IsStopped();
+            int FeedPriority() { return 0; }
+            unsigned long long GetBytesReceived();
+            unsigned long long GetBytesSent();
+            WikiEdit *RetrieveEdit();
+            QString ToString();
+        private slots:
+            void OnTick();
+        private:
+            void decode(const TrafficRecord &record);
+            void insertEdit(WikiEdit *edit);
+            TrafficReplay *replay;
+            QTimer *timer;
+            QList<WikiEdit*> buffer;
+            unsigned long long bytesRcvd = 0;
+            bool isPaused = false;
+    };
+}
+
+#endif // HUGGLEFEEDPROVIDERREPLAY_HPP
@@ -219,6 +219,8 @@ void HuggleFeedProviderWiki::processEdit(QDomElement item)
             edit->RevID = WIKI_UNKNOWN_REVID;
 
     }
+    if (item.attributes().contains("old_revid"))
+        edit->OldID = item.attribute("old_revid").toLongLong();
     if (item.attributes().contains("minor"))
         edit->IsMinor = true;
     edit->IncRef();
@@ -267,6 +269,7 @@ void HuggleFeedProviderWiki::processLog(QDomElement item)
 void HuggleFeedProviderWiki::insertEdit(WikiEdit *edit)
 {
     this->IncrementEdits();
+    this->recordHead(edit);
     QueryPool::HugglePool->PreProcessEdit(edit);
     if (edit->GetSite()->CurrentFilter->Matches(edit))
     {
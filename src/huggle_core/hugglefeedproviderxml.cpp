@@ -17,6 +17,7 @@
 #include "generic.hpp"
 #include "wikipage.hpp"
 #include "syslog.hpp"
+#include "trafficcapture.hpp"
 #include "wikiedit.hpp"
 #include "wikiuser.hpp"
 #include "wikisite.hpp"
@@ -227,6 +228,7 @@ void HuggleFeedProviderXml::insertEdit(WikiEdit *edit)
 
     // Increase the number of edits that were made since provider is up, this is used for statistics
     this->IncrementEdits();
+    this->recordHead(edit);
     // We need to pre process edit so that we have all its properties ready for queue filter
     QueryPool::HugglePool->PreProcessEdit(edit);
     // We only insert it to buffer in case that current filter matches the edit, this is probably not needed
@@ -272,7 +274,6 @@ void HuggleFeedProviderXml::processBufs()
         QDomDocument input;
         input.setContent(data);
         QDomElement element = input.firstChild().toElement();
-        QDateTime ts;
         QString name = element.nodeName();
         if (name == "error")
         {
@@ -300,61 +301,69 @@ void HuggleFeedProviderXml::processBufs()
             continue;
         }
 
+        if (TrafficRecorder::Recorder)
+            TrafficRecorder::Recorder->RecordFeedLine(this->GetSite(), this->GetID(), data.toUtf8());
+
         if (this->IsPaused())
             continue;
 
-        WikiEdit *edit;
-        QString type;
-
-        if (!element.attributes().contains("type"))
-            goto invalid;
+        bool valid;
+        WikiEdit *edit = DecodeEdit(element, this->GetSite(), &valid);
+        if (!valid)
+            Syslog::HuggleLogs->WarningLog("Invalid Xml from RC feed: " + data);
+        else if (edit != nullptr)
+            this->insertEdit(edit);
+    }
+}
 
-        type = element.attribute("type");
-        if (type != "edit" && type != "new")
-        {
-            // we are not interested in this
-            continue;
-        }
+WikiEdit *HuggleFeedProviderXml::DecodeEdit(const QDomElement &element, WikiSite *site, bool *valid)
+{
+    *valid = false;
+    if (!element.attributes().contains("type"))
+        return nullptr;
 
-        // let's verify if all necessary elements are present
-        if (!element.attributes().contains("server_name") ||
-            !element.attributes().contains("revid") ||
-            !element.attributes().contains("type") ||
-            !element.attributes().contains("title") ||
-            !element.attributes().contains("user"))
-        {
-            goto invalid;
-        }
+    QString type = element.attribute("type");
+    *valid = true;
+    if (type != "edit" && type != "new")
+    {
+        // we are not interested in this
+        return nullptr;
+    }
 
-        // if server name doesn't match we drop edit
-        if (this->GetSite()->XmlRcsName != element.attribute("server_name"))
-        {
-            HUGGLE_DEBUG1("Invalid server: " + this->GetSite()->XmlRcsName + " isn't " + element.attribute("server_name"));
-            continue;
-        }
+    // let's verify if all necessary elements are present
+    if (!element.attributes().contains("server_name") ||
+        !element.attributes().contains("revid") ||
+        !element.attributes().contains("type") ||
+        !element.attributes().contains("title") ||
+        !element.attributes().contains("user"))
+    {
+        *valid = false;
+        return nullptr;
+    }
 
-        // now we can create an edit
-        edit = new WikiEdit();
-        edit->Page = new WikiPage(element.attribute("title"), this->GetSite());
-        edit->IncRef();
-        edit->Bot = Generic::SafeBool(element.attribute("bot"));
-        edit->NewPage = (element.attribute("type") == "new");
-        edit->IsMinor = Generic::SafeBool(element.attribute("minor"));
-        edit->RevID = element.attribute("revid").toLong();
-        edit->User = new WikiUser(element.attribute("user"), this->GetSite());
-        edit->Summary = element.attribute("summary");
-        if (element.attributes().contains("length_new")
-               && element.attributes().contains("length_old"))
-        {
-            long size = element.attribute("length_new").toLong() - element.attribute("length_old").toLong();
-            edit->SetSize(size);
-        }
-        edit->OldID = element.attribute("oldid").toInt();
-        ts.setTime_t(element.attribute("timestamp").toUInt());
-        this->insertEdit(edit);
-        continue;
+    // if server name doesn't match we drop edit
+    if (site->XmlRcsName != element.attribute("server_name"))
+    {
+        HUGGLE_DEBUG1("Invalid server: " + site->XmlRcsName + " isn't " + element.attribute("server_name"));
+        return nullptr;
+    }
 
-        invalid:
-            Syslog::HuggleLogs->WarningLog("Invalid Xml from RC feed: " + data);
+    // now we can create an edit
+    WikiEdit *edit = new WikiEdit();
+    edit->Page = new WikiPage(element.attribute("title"), site);
+    edit->IncRef();
+    edit->Bot = Generic::SafeBool(element.attribute("bot"));
+    edit->NewPage = (type == "new");
+    edit->IsMinor = Generic::SafeBool(element.attribute("minor"));
+    edit->RevID = element.attribute("revid").toLong();
+    edit->User = new WikiUser(element.attribute("user"), site);
+    edit->Summary = element.attribute("summary");
+    if (element.attributes().contains("length_new")
+           && element.attributes().contains("length_old"))
+    {
+        long size = element.attribute("length_new").toLong() - element.attribute("length_old").toLong();
+        edit->SetSize(size);
     }
+    edit->OldID = element.attribute("oldid").toInt();
+    return edit;
 }
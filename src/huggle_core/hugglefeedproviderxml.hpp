@@ -22,6 +22,8 @@
 #include <QTcpSocket>
 #include "hugglefeed.hpp"
 
+class QDomElement;
+
 namespace Huggle
 {
     class HUGGLE_EX_CORE HuggleFeedProviderXml : public QObject, public HuggleFeed
@@ -45,6 +47,14 @@ namespace Huggle
             unsigned long long GetBytesSent();
             WikiEdit *RetrieveEdit();
             QString ToString();
+            /*!
+             * \brief DecodeEdit creates an edit from element sent by XmlRcs
+             * \param element Parsed xml element
+             * \param site Site the provider is subscribed to, edits of other sites are dropped
+             * \param valid Set to false if the element is malformed
+             * \return New edit with a reference that caller needs to release, or null if there is no edit we are interested in
+             */
+            static WikiEdit *DecodeEdit(const QDomElement &element, WikiSite *site, bool *valid);
         private slots:
             void OnError(QAbstractSocket::SocketError er);
             void OnReceive();
@@ -15,8 +15,11 @@
 #include "generic.hpp"
 #include "userconfiguration.hpp"
 #include "projectconfiguration.hpp"
+#include "projectconfigurationsnapshot.hpp"
 #include "syslog.hpp"
 #include "wikisite.hpp"
+#include <QMutex>
+#include <QRegularExpression>
 #include <yaml-cpp/yaml.h>
 
 using namespace Huggle;
@@ -183,148 +186,147 @@ QString HuggleParser::GetKeyFromSSItem(QString item)
     return item;
 }
 
-static int DateMark(QString page, WikiSite *site)
+// Number of parsed talk pages for which we remember the warning level
+#define HUGGLE_LEVEL_CACHE_SIZE 2000
+
+static QHash<QString, byte_ht> levelCache;
+//! Keys of levelCache in order in which they were inserted
+static QList<QString> levelCacheOrder;
+static QMutex levelCacheLock;
+
+// Returns start of next match that starts at offset or later, matches may overlap so that none is skipped
+static int nextMatch(const QRegularExpression &expression, const QString &text, int offset, QRegularExpressionMatch *match)
 {
-    HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
-    int m = 0;
-    int position = 0;
-    QString mark = "";
-    while (m < site->GetProjectConfig()->Parser_Date_Suffix.count())
+    if (expression.pattern().isEmpty() || offset > text.length())
+        return -1;
+    // text was already checked to be valid utf-16 by the first call, there is no need to do it for every match
+    *match = expression.match(text, offset, QRegularExpression::NormalMatch, offset > 0 ? QRegularExpression::DontCheckSubjectStringMatchOption
+                                                                                       : QRegularExpression::NoMatchOption);
+    if (!match->hasMatch())
+        return -1;
+    return match->capturedStart();
+}
+
+// Parse date of signature from text that precedes its date suffix, for example "[[User:Foo|Foo]] 12:00, 1 April 2014"
+static QDate signatureDate(const QStringRef &text, const ProjectConfigurationSnapshot *conf)
+{
+    QStringRef signature = text.trimmed();
+    int prefix = signature.lastIndexOf(conf->DatePrefix);
+    if (prefix < 0)
+        return QDate();
+    QStringRef time = signature.mid(prefix + conf->DatePrefix.length()).trimmed();
+    // day and year are first and last words, everything between is a month, because on some wikis months have spaces in name
+    int first_space = time.indexOf(' ');
+    int last_space = time.lastIndexOf(' ');
+    if (first_space < 0 || first_space == last_space)
     {
-        QString m_ = site->GetProjectConfig()->Parser_Date_Suffix.at(m);
-        if (page.contains(m_))
-        {
-            int mp = page.lastIndexOf(m_);
-            if (mp > position)
-            {
-                mark = m_;
-                position = mp;
-            }
-        }
-        m++;
+        HUGGLE_DEBUG("Unable to split month: " + time.toString(), 12);
+        return QDate();
     }
-    return position;
+    QStringRef day = time.left(first_space);
+    // e.g. dewiki's days end with dot
+    if (day.endsWith('.'))
+        day = day.left(day.length() - 1);
+    byte_ht month = conf->GetMonth(time.mid(first_space + 1, last_space - first_space - 1).trimmed().toString());
+    if (month < 1)
+        return QDate();
+    QDate date = QDate::fromString(day.toString() + " " + QString::number(month) + " " + time.mid(last_space + 1).toString(), "d M yyyy");
+    if (!date.isValid())
+        HUGGLE_DEBUG("Invalid date: " + time.toString(), 1);
+    return date;
 }
 
 byte_ht HuggleParser::GetLevel(QString page, QDate bt, WikiSite *site)
 {
     HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
-    if (Configuration::HuggleConfiguration->SystemConfig_TrimOldWarnings)
+    std::shared_ptr<const ProjectConfigurationSnapshot> conf = site->GetSnapshot();
+    byte_ht level = 0;
+    QRegularExpressionMatch warning;
+    if (!Configuration::HuggleConfiguration->SystemConfig_TrimOldWarnings)
     {
-        // we need to get rid of old warnings now
-        QStringList sections;
-        // windows fix
-        page.replace("\r", "");
-        while (page.length() > 1)
+        int position = nextMatch(conf->WarningTemplates, page, 0, &warning);
+        while (position >= 0 && level < 4)
         {
-            while (page[0] == '\n')
-            {
-                // remove all leading extra lines on page
-                page = page.mid(1);
-            }
-            if (!page.contains("\n\n"))
-            {
-                // no sections
-                sections.append(page);
-                break;
-            }
-            // get to bottom of it
-            int bottom = 0;
-            bottom = page.indexOf("\n\n");
-            QString section = page.mid(0, bottom);
-            page = page.mid(bottom + 2);
-            sections.append(section);
-        }
-
-        // now we browse all sections and remove these with no current date
-        int CurrentIndex = 0;
-        page = "";
-        while (CurrentIndex < sections.count())
-        {
-            int dp = DateMark(sections.at(CurrentIndex), site);
-            // we need to find a date in this section
-            if (!dp)
-            {
-                // there is none
-                CurrentIndex++;
-                continue;
-            }
-            QString section = sections.at(CurrentIndex);
-            section = section.mid(0, dp).trimmed();
-            if (!section.contains(site->GetProjectConfig()->Parser_Date_Prefix))
-            {
-                // this is some borked date let's remove it
-                CurrentIndex++;
-                continue;
-            }
-            QString time = section.mid(section.lastIndexOf(site->GetProjectConfig()->Parser_Date_Prefix) + site->GetProjectConfig()->Parser_Date_Prefix.length());
-            // now we need this uberhack so that we can get a month name from localized version
-            // let's hope that month is a word in a middle of string
-            time = time.trimmed();
-            QString month_name = "";
-            QStringList parts_time = time.split(' ');
-            if (parts_time.count() < 3)
-            {
-                // this is invalid string
-                HUGGLE_DEBUG("Unable to split month: " + time, 12);
-                CurrentIndex++;
-                continue;
-            }
-            QString day = parts_time.at(0);
-            // e.g. dewiki's days end with dot
-            if(day.endsWith('.'))
-                day = day.mid(0, day.length() - 1);
-            // on some wikis months have spaces in name
-            int i = 1;
-            while (i < parts_time.count() - 1)
-            {
-                month_name += parts_time.at(i) + " ";
-                i++;
-            }
-            month_name = month_name.trimmed();
-            byte_ht month = HuggleParser::GetIDOfMonth(month_name, site);
-
-             // let's create a new time string from converted one, just to make sure it will be parsed properly
-            if (month > 0)
-            {
-                time = day + " " + QString::number(month) + " " + parts_time.last();
-            } else
-            {
-                time = day + " " + parts_time.at(1); + " " + parts_time.last();
-            }
-            QDate date = QDate::fromString(time, "d M yyyy");
-            if (!date.isValid())
-            {
-                HUGGLE_DEBUG("Invalid date: " + time, 1);
-                CurrentIndex++;
-                continue;
-            } else
-            {
-                // now check if it's at least 1 month old
-                if (bt.addDays(site->ProjectConfig->TemplateAge) > date)
-                {
-                    // we don't want to parse this thing
-                    CurrentIndex++;
-                    continue;
-                }
-            }
-            page += sections.at(CurrentIndex) + "\n";
-            CurrentIndex++;
+            level = qMax(level, conf->GetWarningLevel(warning));
+            position = nextMatch(conf->WarningTemplates, page, position + 1, &warning);
         }
+        return level;
     }
-    byte_ht level = 4;
-    while (level > 0)
+    // windows fix
+    page.replace("\r", "");
+    // Page is split to sections by empty lines, only warnings in sections which were signed recently count. Signatures
+    // and templates are both found going forward through the text, so each of them is visited only once.
+    QRegularExpressionMatch suffix;
+    int next_suffix = nextMatch(conf->DateSuffixes, page, 0, &suffix);
+    int next_warning = nextMatch(conf->WarningTemplates, page, 0, &warning);
+    int length = page.length();
+    int start = 0;
+    while (length - start > 1 && level < 4)
     {
-        foreach (QString df, site->ProjectConfig->WarningDefs)
+        // skip all leading extra lines of section
+        while (start < length && page.at(start) == '\n')
+            start++;
+        int end = page.indexOf("\n\n", start);
+        if (end < 0)
+            end = length;
+        // find the last date in this section
+        int date_mark = -1;
+        while (next_suffix >= 0 && next_suffix < end)
         {
-            if (HuggleParser::GetKeyFromSSItem(df).toInt() == level && page.contains(HuggleParser::GetValueFromSSItem(df)))
-            {
-                return level;
-            }
+            if (next_suffix > start && suffix.capturedEnd() <= end)
+                date_mark = next_suffix;
+            next_suffix = nextMatch(conf->DateSuffixes, page, next_suffix + 1, &suffix);
         }
-        level--;
+        bool current = false;
+        if (date_mark > 0)
+        {
+            QDate date = signatureDate(page.midRef(start, date_mark - start), conf.get());
+            // warnings older than TemplateAge days are ignored
+            current = date.isValid() && bt.addDays(conf->TemplateAge) <= date;
+        }
+        while (next_warning >= 0 && next_warning < end)
+        {
+            if (current && warning.capturedEnd() <= end)
+                level = qMax(level, conf->GetWarningLevel(warning));
+            next_warning = nextMatch(conf->WarningTemplates, page, next_warning + 1, &warning);
+        }
+        start = end + 2;
+    }
+    return level;
+}
+
+byte_ht HuggleParser::GetLevel(QString page, QDate bt, WikiSite *site, QString user, revid_ht revid)
+{
+    if (revid == WIKI_UNKNOWN_REVID)
+        return HuggleParser::GetLevel(page, bt, site);
+    QString key = site->Name + "|" + user + "|" + QString::number(revid) + "|" + QString::number(bt.toJulianDay());
+    levelCacheLock.lock();
+    if (levelCache.contains(key))
+    {
+        byte_ht level = levelCache.value(key);
+        levelCacheLock.unlock();
+        return level;
+    }
+    levelCacheLock.unlock();
+    byte_ht level = HuggleParser::GetLevel(page, bt, site);
+    levelCacheLock.lock();
+    if (!levelCache.contains(key))
+    {
+        levelCache.insert(key, level);
+        levelCacheOrder.append(key);
+        while (levelCacheOrder.count() > HUGGLE_LEVEL_CACHE_SIZE)
+            levelCache.remove(levelCacheOrder.takeFirst());
     }
-    return 0;
+    levelCacheLock.unlock();
+    return level;
+}
+
+void HuggleParser::ClearLevelCache()
+{
+    levelCacheLock.lock();
+    levelCache.clear();
+    levelCacheOrder.clear();
+    levelCacheLock.unlock();
 }
 
 QStringList HuggleParser::ConfigurationParse_QL(QString key, QString content, bool CS)
@@ -110,9 +110,18 @@ namespace Huggle
         /*!
          * \brief Process content of talk page in order to figure which user level they have
          * \param page The content of talk page
+         * \param bt Date from which the age of warnings is computed
          * \return Level
          */
         HUGGLE_EX_CORE byte_ht GetLevel(QString page, QDate bt, Huggle::WikiSite *site);
+        /*!
+         * \brief Same as GetLevel but the result is remembered for given revision of talk page, so
+         *  that it's parsed only once no matter how many edits the user makes until it changes
+         * \param revid Revision of talk page, if it's not known, the page is always parsed
+         */
+        HUGGLE_EX_CORE byte_ht GetLevel(QString page, QDate bt, Huggle::WikiSite *site, QString user, revid_ht revid);
+        //! Forget all remembered warning levels, needs to be called when configuration of a site changes
+        HUGGLE_EX_CORE void ClearLevelCache();
     }
 }
 
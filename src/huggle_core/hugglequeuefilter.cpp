@@ -99,14 +99,7 @@ bool HuggleQueueFilter::Matches(WikiEdit *edit)
         if (this->TalkPage == HuggleQueueFilterMatchRequire && !edit->Page->IsTalk())
             return false;
     }
-    int i = 0;
-    while (i < Configuration::HuggleConfiguration->ProjectConfig->IgnorePatterns.count())
-    {
-        if (edit->Page->PageName.contains(Configuration::HuggleConfiguration->ProjectConfig->IgnorePatterns.at(i)))
-            return false;
-        i++;
-    }
-    if (Configuration::HuggleConfiguration->ProjectConfig->Ignores.contains(edit->Page->PageName))
+    if (edit->GetSite()->GetSnapshot()->IsIgnored(edit->Page->PageName))
         return false;
     if (this->WL != HuggleQueueFilterMatchIgnore)
     {
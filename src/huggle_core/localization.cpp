@@ -10,7 +10,9 @@
 
 #include "definitions.hpp"
 #include <QtXml>
+#include <QDataStream>
 #include <QFile>
+#include <QMutexLocker>
 // localizations.hpp must be included after global headers
 // there is some collision in _l macro on OSX
 #include "localization.hpp"
@@ -18,6 +20,7 @@
 #include "configuration.hpp"
 #include "generic.hpp"
 #include "syslog.hpp"
+#include <huggle_l10n/l10ncatalog.hpp>
 
 using namespace Huggle;
 unsigned int Localizations::EnglishID = 0;
@@ -38,56 +41,196 @@ Localizations::~Localizations()
     }
 }
 
-Language *Localizations::MakeLanguage(QString text, QString name)
+bool Localizations::LoadCatalog(QStringList languages, QString path)
+{
+    if (path.isEmpty())
+        path = HUGGLE_L10N_CATALOG_PATH;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        Syslog::HuggleLogs->ErrorLog("Unable to open localization catalog " + path);
+        return false;
+    }
+    QMutexLocker locker(&this->lock);
+    this->catalog = file.readAll();
+    file.close();
+    QDataStream stream(this->catalog);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version, count;
+    stream >> magic >> version;
+    if (magic != HUGGLE_L10N_CATALOG_MAGIC || version != HUGGLE_L10N_CATALOG_VERSION)
+    {
+        Syslog::HuggleLogs->ErrorLog("Localization catalog " + path + " has unsupported format");
+        this->catalog.clear();
+        return false;
+    }
+    // ids of keys are positions in catalog, so the catalog must be read before any custom language is loaded
+    stream >> this->keys >> count;
+    this->keyIDs.clear();
+    int id = 0;
+    while (id < this->keys.count())
+    {
+        this->keyIDs.insert(this->keys.at(id), id);
+        id++;
+    }
+    QHash<QString, Language*> catalog_languages;
+    while (count-- > 0 && stream.status() == QDataStream::Ok)
+    {
+        quint32 offset;
+        Language *language = new Language("");
+        stream >> language->LanguageName >> language->LanguageID >> language->IsRTL >> offset;
+        language->catalogOffset = offset;
+        catalog_languages.insert(language->LanguageName, language);
+    }
+    this->catalogData = stream.device()->pos();
+    if (stream.status() != QDataStream::Ok)
+    {
+        Syslog::HuggleLogs->ErrorLog("Localization catalog " + path + " is corrupted");
+        qDeleteAll(catalog_languages);
+        this->catalog.clear();
+        return false;
+    }
+    if (!languages.contains("en"))
+        languages.append("en");
+    foreach (QString name, languages)
+    {
+        if (name == "en")
+            Localizations::EnglishID = this->LocalizationData.count();
+        if (catalog_languages.contains(name))
+            this->LocalizationData.append(catalog_languages.take(name));
+        else
+            this->LocalizationData.append(new Language(name));
+    }
+    qDeleteAll(catalog_languages);
+    // english is needed as a fallback for every other language
+    this->load(this->LocalizationData.at(Localizations::EnglishID));
+    return true;
+}
+
+void Localizations::LocalInit(QString name)
+{
+    QMutexLocker locker(&this->lock);
+    foreach (Language *language, this->LocalizationData)
+    {
+        if (language->LanguageName == name)
+            return;
+    }
+    if (name == "en")
+    {
+        // we need to remember ID of this language
+        Localizations::EnglishID = this->LocalizationData.count();
+    }
+    this->LocalizationData.append(new Language(name));
+}
+
+Language *Localizations::GetLanguage(QString name)
+{
+    QMutexLocker locker(&this->lock);
+    return this->getLanguage(name);
+}
+
+Language *Localizations::getLanguage(const QString &name)
+{
+    if (this->lastLanguage != nullptr && this->lastLanguage->LanguageName == name)
+        return this->lastLanguage;
+    foreach (Language *language, this->LocalizationData)
+    {
+        if (language->LanguageName == name)
+        {
+            if (!language->IsLoaded)
+                this->load(language);
+            this->lastLanguage = language;
+            return language;
+        }
+    }
+    return nullptr;
+}
+
+void Localizations::load(Language *language)
+{
+    language->IsLoaded = true;
+    if (!Configuration::HuggleConfiguration->SystemConfig_SafeMode)
+    {
+        // custom localization files in home folder replace the built-in ones, we don't want to load them in safe mode
+        QString path = Configuration::GetLocalizationDataPath() + language->LanguageName;
+        bool xml = !QFile().exists(path + ".txt");
+        QFile file(path + (xml ? ".xml" : ".txt"));
+        if (file.exists() && file.open(QIODevice::ReadOnly))
+        {
+            HUGGLE_DEBUG1("Loading custom localization " + file.fileName());
+            if (xml)
+                this->loadXML(language, QString(file.readAll()));
+            else
+                this->loadText(language, QString(file.readAll()));
+            return;
+        }
+    }
+    if (language->catalogOffset < 0 || this->catalog.isEmpty())
+    {
+        HUGGLE_DEBUG("Language " + language->LanguageName + " isn't in localization catalog", 1);
+        return;
+    }
+    QDataStream stream(this->catalog);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.device()->seek(this->catalogData + language->catalogOffset);
+    quint32 count;
+    stream >> count;
+    language->Messages.resize(this->keys.count());
+    while (count-- > 0 && stream.status() == QDataStream::Ok)
+    {
+        quint32 key;
+        quint8 flags;
+        QByteArray text;
+        stream >> key >> flags >> text;
+        if (!Configuration::HuggleConfiguration->Fuzzy && (flags & HUGGLE_L10N_FLAG_FUZZY))
+            continue;
+        if (key < static_cast<quint32>(language->Messages.size()))
+            language->Messages[key] = QString::fromUtf8(text);
+    }
+}
+
+void Localizations::setMessage(Language *language, QString key, QString text)
+{
+    int id = this->keyIDs.value(key, -1);
+    if (id < 0)
+    {
+        id = this->keys.count();
+        this->keys.append(key);
+        this->keyIDs.insert(key, id);
+    }
+    if (language->Messages.size() <= id)
+        language->Messages.resize(this->keys.count());
+    if (language->Messages.at(id).isEmpty())
+        language->Messages[id] = text;
+}
+
+void Localizations::loadText(Language *language, QString text)
 {
-    Language *l = new Language(name);
     QStringList keys = text.split("\n");
     int p = 0;
     while (p < keys.count())
     {
         QString line = keys.at(p);
+        p++;
         if (line.length() == 0)
-        {
-            p++;
             continue;
-        }
         QChar first_char_ = line[0];
-        if ((first_char_ == '/' && line.startsWith("//")) || first_char_ == '<')
-        {
-            // this is comment in language file
-            p++;
+        // lines starting with at symbol are using identical text purposefuly, english version is used for them
+        if ((first_char_ == '/' && line.startsWith("//")) || first_char_ == '<' || first_char_ == '@')
             continue;
-        }
-        if (keys.at(p).contains(":"))
+        if (line.contains(":"))
         {
             int index_ = line.indexOf(":");
-            QString key = line.mid(0, index_);
-            QString lang = line.mid(index_+1).trimmed();
-            if (first_char_ == '@')
-            {
-                // this language is using identical text purposefuly so we replace
-                // text with at symbol which means "use english locs"
-                l->Messages.insert(key, "@");
-                p++;
-                continue;
-            }
-            // remove all spaces
-            lang = lang.trimmed();
-            if (!l->Messages.contains(key))
-                l->Messages.insert(key, lang);
+            this->setMessage(language, line.mid(0, index_), line.mid(index_ + 1).trimmed());
         }
-        p++;
     }
-    if (l->Messages.contains("name"))
-    {
-        l->LanguageID = l->Messages["name"];
-    }
-    return l;
+    int name = this->keyIDs.value("name", -1);
+    if (name >= 0 && name < language->Messages.size() && !language->Messages.at(name).isEmpty())
+        language->LanguageID = language->Messages.at(name);
 }
 
-Language *Localizations::MakeLanguageUsingXML(QString text, QString name)
+void Localizations::loadXML(Language *language, QString text)
 {
-    Language *l = new Language(name);
     QDomDocument in_;
     in_.setContent(text);
     QDomNodeList keys = in_.elementsByTagName("string");
@@ -98,74 +241,41 @@ Language *Localizations::MakeLanguageUsingXML(QString text, QString name)
         i++;
         if (!item.attributes().contains("name"))
         {
-            HUGGLE_DEBUG("Language " + name + " contains key with no name", 1);
+            HUGGLE_DEBUG("Language " + language->LanguageName + " contains key with no name", 1);
             continue;
         }
         QString n_ = item.attribute("name");
         if (n_ == "isrtl")
         {
-            l->IsRTL = Generic::SafeBool(item.text());
-            continue;
-        }
-        if (l->Messages.contains(n_))
-        {
-            Syslog::HuggleLogs->WarningLog("Language " + name + " contains more than 1 definition for " + n_);
+            language->IsRTL = Generic::SafeBool(item.text());
             continue;
         }
         if (!Configuration::HuggleConfiguration->Fuzzy && item.attributes().contains("fuzzy") && item.attribute("fuzzy") == "true")
         {
-            HUGGLE_DEBUG("Fuzzy key ignored: " + name + " " + n_, 12);
+            HUGGLE_DEBUG("Fuzzy key ignored: " + language->LanguageName + " " + n_, 12);
             continue;
         }
-        l->Messages.insert(item.attribute("name"), item.text().replace("\\\"", "\"").replace("\\'", "'"));
+        this->setMessage(language, n_, item.text().replace("\\\"", "\"").replace("\\'", "'"));
     }
-    if (l->Messages.contains("name"))
-    {
-        l->LanguageID = l->Messages["name"];
-    }
-    return l;
+    int name = this->keyIDs.value("name", -1);
+    if (name >= 0 && name < language->Messages.size() && !language->Messages.at(name).isEmpty())
+        language->LanguageID = language->Messages.at(name);
 }
 
-void Localizations::LocalInit(QString name, bool xml)
+QString Localizations::localize(const QString &key)
 {
-    QFile *f;
-    if (name == "en")
-    {
-        // we need to remember ID of this language
-        Localizations::EnglishID = this->LocalizationData.count();
-    }
-    if (Configuration::HuggleConfiguration->SystemConfig_SafeMode)
-    {
-        // we don't want to load custom files in safe mode
-        f = new QFile(":/huggle/text/Localization/" + name + ".xml");
-    } else
-    {
-        if (QFile().exists(Configuration::GetLocalizationDataPath() + name + ".txt"))
-        {
-            // there is a custom localization file in directory
-            f = new QFile(Configuration::GetLocalizationDataPath() + name + ".txt");
-            xml = false;
-        } else if (QFile().exists(Configuration::GetLocalizationDataPath() + name + ".xml"))
-        {
-            f = new QFile(Configuration::GetLocalizationDataPath() + name + ".xml");
-        } else
-        {
-            if (!xml)
-            {
-                f = new QFile(":/huggle/text/Localization/" + name + ".txt");
-            } else
-            {
-                f = new QFile(":/huggle/text/Localization/" + name + ".xml");
-            }
-        }
-    }
-    f->open(QIODevice::ReadOnly);
-    if (!xml)
-        this->LocalizationData.append(Localizations::MakeLanguage(QString(f->readAll()), name));
-    else
-        this->LocalizationData.append(Localizations::MakeLanguageUsingXML(QString(f->readAll()), name));
-    f->close();
-    delete f;
+    int id = this->keyIDs.value(key, -1);
+    if (id < 0)
+        return QString();
+    Language *language = this->getLanguage(this->PreferredLanguage);
+    if (language != nullptr && id < language->Messages.size() && !language->Messages.at(id).isEmpty())
+        return language->Messages.at(id);
+    if (this->PreferredLanguage == LANG_QQX || Localizations::EnglishID >= static_cast<unsigned int>(this->LocalizationData.count()))
+        return QString();
+    Language *english = this->LocalizationData.at(Localizations::EnglishID);
+    if (id < english->Messages.size())
+        return english->Messages.at(id);
+    return QString();
 }
 
 QString Localizations::Localize(QString key)
@@ -184,55 +294,30 @@ QString Localizations::Localize(QString key, QStringList parameters)
             id = id.mid(0, id.length() - 2);
         }
     }
-    if (this->LocalizationData.count() > 0)
+    this->lock.lock();
+    QString text = this->localize(id);
+    this->lock.unlock();
+    if (!text.isEmpty())
     {
-        int c=0;
-        while (c<this->LocalizationData.count())
-        {
-            if (this->LocalizationData.at(c)->LanguageName == this->PreferredLanguage)
-            {
-                Language *l = this->LocalizationData.at(c);
-                if (l->Messages.contains(id))
-                {
-                    QString text = l->Messages[id];
-                    int x = 0;
-                    while (x<parameters.count())
-                    {
-                        text = text.replace("$" + QString::number(x + 1), parameters.at(x));
-                        x++;
-                    }
-                    return text;
-                }
-                // performance tweak
-                break;
-            }
-            c++;
-        }
-
-        // performance wise check this last
-        if (this->PreferredLanguage == LANG_QQX)
+        int x = 0;
+        while (x<parameters.count())
         {
-            QString result = "("+key;
-            int x = 0;
-            while (x<parameters.count())
-            {
-                result += "|$" + QString::number(x + 1) + "=" + parameters.at(x);
-                x++;
-            }
-            result = result + ")";
-            return result;
+            text = text.replace("$" + QString::number(x + 1), parameters.at(x));
+            x++;
         }
-        if (this->LocalizationData.at(Localizations::EnglishID)->Messages.contains(id))
+        return text;
+    }
+    if (this->PreferredLanguage == LANG_QQX)
+    {
+        QString result = "("+key;
+        int x = 0;
+        while (x<parameters.count())
         {
-            QString text = this->LocalizationData.at(Localizations::EnglishID)->Messages[id];
-            int x = 0;
-            while (x<parameters.count())
-            {
-                text = text.replace("$" + QString::number(x + 1), parameters.at(x));
-                x++;
-            }
-            return text;
+            result += "|$" + QString::number(x + 1) + "=" + parameters.at(x);
+            x++;
         }
+        result = result + ")";
+        return result;
     }
     if (hcfg->Verbosity > 0)
         Syslog::HuggleLogs->WarningLog("There is no such a localization key: " + key);
@@ -248,7 +333,24 @@ QString Localizations::Localize(QString key, QString par1, QString par2)
 
 bool Localizations::KeyExists(QString key)
 {
-    return this->LocalizationData.at(Localizations::EnglishID)->Messages.contains(key);
+    QMutexLocker locker(&this->lock);
+    int id = this->keyIDs.value(key, -1);
+    if (id < 0 || Localizations::EnglishID >= static_cast<unsigned int>(this->LocalizationData.count()))
+        return false;
+    Language *english = this->LocalizationData.at(Localizations::EnglishID);
+    return id < english->Messages.size() && !english->Messages.at(id).isEmpty();
+}
+
+int Localizations::GetKeyID(QString key)
+{
+    QMutexLocker locker(&this->lock);
+    return this->keyIDs.value(key, -1);
+}
+
+QStringList Localizations::GetKeys()
+{
+    QMutexLocker locker(&this->lock);
+    return this->keys;
 }
 
 QString Localizations::Localize(QString key, QString parameter)
@@ -260,18 +362,9 @@ QString Localizations::Localize(QString key, QString parameter)
 
 bool Localizations::IsRTL()
 {
-    bool rtl = false;
-    int c = 0;
-    while (c<this->LocalizationData.count())
-    {
-        if (this->LocalizationData.at(c)->LanguageName == this->PreferredLanguage)
-        {
-            Language *l = this->LocalizationData.at(c);
-            rtl = l->IsRTL;
-        }
-        c++;
-    }
-    return rtl;
+    QMutexLocker locker(&this->lock);
+    Language *language = this->getLanguage(this->PreferredLanguage);
+    return language != nullptr && language->IsRTL;
 }
 
 Language::Language(QString name)
@@ -16,10 +16,14 @@
 // localization tool
 #define _l Huggle::Localizations::HuggleLocalizations->Localize
 
+#include <QByteArray>
+#include <QHash>
 #include <QStringList>
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <QMutex>
+#include <QVector>
 
 namespace Huggle
 {
@@ -37,7 +41,14 @@ namespace Huggle
             //! Long identifier of language that is seen by user
             QString LanguageID;
             bool IsRTL = false;
-            QMap<QString, QString> Messages;
+            //! Messages are loaded when language is used for first time, before that only name is known
+            bool IsLoaded = false;
+            //! Texts indexed by id of their key, empty string means that language doesn't contain the key
+            QVector<QString> Messages;
+        private:
+            //! Position of messages in the catalog, -1 if language isn't in catalog
+            qint64 catalogOffset = -1;
+            friend class Localizations;
     };
 
     //! This class is used to localize strings
@@ -57,19 +68,33 @@ namespace Huggle
             Localizations();
             ~Localizations();
             /*!
-             * \brief Initializes a localization with given name
+             * \brief Reads list of languages from localization catalog which is compiled during build
+             *
+             * Only english is loaded immediately, other languages are loaded when they are needed
+             * \param languages Names of languages that should be available, in the order they are displayed to user
+             * \param path Path to catalog
+             * \return false if catalog couldn't be read
+             */
+            bool LoadCatalog(QStringList languages, QString path = "");
+            /*!
+             * \brief Makes a language available, even if it isn't in catalog
              *
-             * This function will create a new localization object using built-in localization file
-             * using Core::MakeLanguage() and insert that to language list
-             * \param name Name of a localization that is a name of language without txt suffix in localization folder
+             * Messages are loaded from custom file in localization folder, if there is such a file, or from catalog
+             * \param name Name of a localization that is a name of language without xml suffix in localization folder
              */
-            void LocalInit(QString name, bool xml = true);
+            void LocalInit(QString name);
+            //! Returns language with given name, loads its messages if they weren't loaded yet
+            Language *GetLanguage(QString name);
             QString Localize(QString key);
             QString Localize(QString key, QStringList parameters);
             QString Localize(QString key, QString parameter);
             QString Localize(QString key, QString par1, QString par2);
             //! Check if key exists by looking it up in default language hash, returns true even if key doesn't exist in preferred language
             bool KeyExists(QString key);
+            //! Returns id of key which is an index in Language::Messages, -1 if no language contains it
+            int GetKeyID(QString key);
+            //! Keys of all messages, index of key is its id
+            QStringList GetKeys();
 			
             //! Check whether the preferred language is RightToLeft language.
             bool IsRTL();
@@ -78,8 +103,21 @@ namespace Huggle
             //! Language selected by user this is only a language of interface
             QString PreferredLanguage;
         private:
-            static Language *MakeLanguage(QString text, QString name);
-            static Language *MakeLanguageUsingXML(QString text, QString name);
+            void load(Language *language);
+            void loadText(Language *language, QString text);
+            void loadXML(Language *language, QString text);
+            void setMessage(Language *language, QString key, QString text);
+            Language *getLanguage(const QString &name);
+            QString localize(const QString &key);
+            QByteArray catalog;
+            //! Position where messages start in catalog
+            qint64 catalogData = 0;
+            QStringList keys;
+            QHash<QString, int> keyIDs;
+            //! Language which was used last time, so that it doesn't need to be searched for every message
+            Language *lastLanguage = nullptr;
+            //! Languages are loaded while localizing a message, which may happen on any thread
+            QMutex lock;
     };
 }
 
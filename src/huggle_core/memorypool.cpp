@@ -0,0 +1,185 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "memorypool.hpp"
+#include <new>
+
+using namespace Huggle;
+
+// Every allocation from slab or arena is aligned to this, so that any object can be stored in it, it's
+// not taken from max_align_t because older compilers only have it in global namespace
+#define HUGGLE_POOL_ALIGN static_cast<size_t>(16)
+
+static size_t alignSize(size_t size)
+{
+    return (size + HUGGLE_POOL_ALIGN - 1) & ~(HUGGLE_POOL_ALIGN - 1);
+}
+
+static QMutex *poolsLock()
+{
+    static QMutex lock;
+    return &lock;
+}
+
+static QList<MemoryPool*> *pools()
+{
+    static QList<MemoryPool*> list;
+    return &list;
+}
+
+QString MemoryPool::GetStatistics()
+{
+    QMutexLocker locker(poolsLock());
+    QString result;
+    foreach (MemoryPool *pool, *pools())
+        result += pool->ToString() + "\n";
+    return result.trimmed();
+}
+
+MemoryPool::MemoryPool(const QString &name, size_t object_size, int objects_per_slab)
+{
+    this->Name = name;
+    // every free slot must be able to hold the pointer to next one
+    this->objectSize = alignSize(qMax(object_size, sizeof(Slot)));
+    this->slabSize = objects_per_slab;
+    QMutexLocker locker(poolsLock());
+    pools()->append(this);
+}
+
+MemoryPool::~MemoryPool()
+{
+    {
+        QMutexLocker locker(poolsLock());
+        pools()->removeAll(this);
+    }
+    // objects leaked at exit may still be deleted later by static destructors of other modules
+    if (this->Living > 0)
+        return;
+    foreach (char *slab, this->slabs)
+        ::operator delete(slab);
+}
+
+void *MemoryPool::Allocate(size_t size)
+{
+#ifdef HUGGLE_NO_MEMORY_POOL
+    return ::operator new(size);
+#else
+    if (alignSize(size) != this->objectSize)
+    {
+        QMutexLocker locker(&this->lock);
+        this->HeapAllocations++;
+        return ::operator new(size);
+    }
+    QMutexLocker locker(&this->lock);
+    if (this->freeSlots == nullptr)
+    {
+        char *slab = static_cast<char*>(::operator new(this->objectSize * static_cast<size_t>(this->slabSize)));
+        this->slabs.append(slab);
+        this->HeapAllocations++;
+        // link the slots in order of addresses so that objects allocated in sequence sit next to each other
+        int slot = this->slabSize;
+        while (slot-- > 0)
+        {
+            Slot *free_slot = reinterpret_cast<Slot*>(slab + this->objectSize * static_cast<size_t>(slot));
+            free_slot->Next = this->freeSlots;
+            this->freeSlots = free_slot;
+        }
+    }
+    Slot *result = this->freeSlots;
+    this->freeSlots = result->Next;
+    this->Allocations++;
+    if (++this->Living > this->PeakLiving)
+        this->PeakLiving = this->Living;
+    return result;
+#endif
+}
+
+void MemoryPool::Free(void *ptr, size_t size)
+{
+    if (ptr == nullptr)
+        return;
+#ifdef HUGGLE_NO_MEMORY_POOL
+    Q_UNUSED(size);
+    ::operator delete(ptr);
+#else
+    if (alignSize(size) != this->objectSize)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    QMutexLocker locker(&this->lock);
+    Slot *slot = static_cast<Slot*>(ptr);
+    slot->Next = this->freeSlots;
+    this->freeSlots = slot;
+    this->Living--;
+#endif
+}
+
+QString MemoryPool::ToString()
+{
+    QMutexLocker locker(&this->lock);
+    return this->Name + ": living " + QString::number(this->Living) + " peak " + QString::number(this->PeakLiving) + " allocations " +
+           QString::number(this->Allocations) + " heap allocations " + QString::number(this->HeapAllocations) + " slabs " +
+           QString::number(this->slabs.count()) + " (" + QString::number(this->slabs.count() * this->slabSize * this->objectSize / 1024) + "kB)";
+}
+
+MemoryArena::MemoryArena(size_t chunk_size)
+{
+    this->chunkSize = chunk_size;
+    this->used = chunk_size;
+}
+
+MemoryArena::~MemoryArena()
+{
+    this->Clear();
+}
+
+void *MemoryArena::Allocate(size_t size)
+{
+    size = alignSize(size);
+#ifdef HUGGLE_NO_MEMORY_POOL
+    char *object = static_cast<char*>(::operator new(size));
+    this->chunks.append(object);
+    this->allocated += size;
+    return object;
+#else
+    if (size > this->chunkSize)
+    {
+        // large objects get their own chunk, which is inserted before the current one so that we keep filling it
+        char *large = static_cast<char*>(::operator new(size));
+        this->chunks.insert(qMax(0, this->chunks.count() - 1), large);
+        this->allocated += size;
+        return large;
+    }
+    if (this->used + size > this->chunkSize)
+    {
+        this->chunks.append(static_cast<char*>(::operator new(this->chunkSize)));
+        this->allocated += this->chunkSize;
+        this->used = 0;
+    }
+    void *result = this->chunks.last() + this->used;
+    this->used += size;
+    return result;
+#endif
+}
+
+void MemoryArena::Clear()
+{
+    foreach (char *chunk, this->chunks)
+        ::operator delete(chunk);
+    this->chunks.clear();
+    this->used = this->chunkSize;
+    this->allocated = 0;
+}
+
+unsigned long long MemoryArena::GetSize()
+{
+    return this->allocated;
+}
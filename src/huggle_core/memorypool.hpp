@@ -0,0 +1,84 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef MEMORYPOOL_HPP
+#define MEMORYPOOL_HPP
+
+#include "definitions.hpp"
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <cstddef>
+
+namespace Huggle
+{
+    //! Allocator of objects of same size, which takes memory from large slabs
+
+    //! Every edit comes with its own page, user and a number of api results, which are all freed
+    //! few minutes later, allocating them from a general heap makes it fragmented over time. Pool
+    //! keeps freed slots in a list and reuses them for next objects, slabs are never returned to
+    //! heap, so the memory used by the pool is equal to maximal number of living objects.
+    //! Pool is thread safe, because objects are often deleted by GC thread.
+    class HUGGLE_EX_CORE MemoryPool
+    {
+        public:
+            //! Returns statistics of all pools that exist
+            static QString GetStatistics();
+
+            MemoryPool(const QString &name, size_t object_size, int objects_per_slab = 128);
+            //! Slabs are released only if there is no living object in them
+            ~MemoryPool();
+            //! Objects of different size than the pool was made for (derived classes) are allocated on heap
+            void *Allocate(size_t size);
+            void Free(void *ptr, size_t size);
+            QString ToString();
+            QString Name;
+            //! Number of objects that were ever allocated from the pool
+            unsigned long long Allocations = 0;
+            //! Allocations that had to get memory from heap, one per slab or one per object of different size
+            unsigned long long HeapAllocations = 0;
+            unsigned long long Living = 0;
+            unsigned long long PeakLiving = 0;
+        private:
+            struct Slot
+            {
+                Slot *Next;
+            };
+            QMutex lock;
+            Slot *freeSlots = nullptr;
+            QList<char*> slabs;
+            size_t objectSize;
+            int slabSize;
+    };
+
+    //! Bump allocator which releases all memory at once when it's destroyed
+
+    //! Used for objects that always die together, such as nodes of one api result. Destructors of
+    //! objects are not called by the arena, owner of the objects needs to call them. Arena is not thread safe.
+    class HUGGLE_EX_CORE MemoryArena
+    {
+        public:
+            MemoryArena(size_t chunk_size = 8192);
+            ~MemoryArena();
+            void *Allocate(size_t size);
+            //! Releases all memory, objects allocated from arena must be destroyed before that
+            void Clear();
+            //! Number of bytes that were taken from heap
+            unsigned long long GetSize();
+        private:
+            QList<char*> chunks;
+            size_t chunkSize;
+            size_t used;
+            unsigned long long allocated = 0;
+    };
+}
+
+#endif // MEMORYPOOL_HPP
@@ -22,6 +22,7 @@
 #include "wikisite.hpp"
 #include "wikiutil.hpp"
 #include "wikiuser.hpp"
+#include <QRegularExpression>
 #include <QUrl>
 
 using namespace Huggle;
@@ -253,6 +254,7 @@ void Message::PreflightCheck()
         this->_Status = MessageStatus_RetrievingTalkPage;
         // we need to retrieve the talk page
         this->query = WikiUtil::RetrieveWikiPageContents(this->User->GetTalk(), this->User->GetSite());
+        this->query->Priority = QueryPriority_Warning;
         // inform user what is going on
         HUGGLE_QP_APPEND(this->query);
         this->query->Target = _l("main-user-retrieving-tp", this->User->Username);
@@ -282,6 +284,7 @@ void Message::ProcessSend()
         }
     }
     this->query = new ApiQuery(ActionEdit, this->User->GetSite());
+    this->query->Priority = QueryPriority_Warning;
     // prevent message from being sent twice
     this->query->RetryOnTimeoutFailure = false;
     this->query->Timeout = 60;
@@ -370,7 +373,7 @@ QString Message::Append(QString text, QString OriginalText, QString Label)
         // there is nothing to insert this to
         return OriginalText += "\n\n" + text + "\n\n";
     }
-    QRegExp regex("\\s*==\\s*" + QRegExp::escape(Label) + "\\s*==");
+    QRegularExpression regex("\\s*==\\s*" + QRegularExpression::escape(Label) + "\\s*==");
     if (!OriginalText.contains(regex))
     {
         // there is no section to append to
@@ -381,7 +384,8 @@ QString Message::Append(QString text, QString OriginalText, QString Label)
         OriginalText += "== " + Label + " ==\n\n" + text;
         return OriginalText;
     }
-    QRegExp header("^\\s*==.*==\\s*$");
+    // QRegExp used to match new lines with the dot, keep it that way
+    static const QRegularExpression header("^\\s*==.*==\\s*$", QRegularExpression::DotMatchesEverythingOption);
     int Post = Text.lastIndexOf(regex);
     // we need to check if there is any other section after this one
     QString Section = OriginalText.mid(Post);
@@ -0,0 +1,297 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "networkscheduler.hpp"
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+#include <QUrl>
+#include "apiquery.hpp"
+#include "configuration.hpp"
+#include "syslog.hpp"
+
+using namespace Huggle;
+
+NetworkScheduler *NetworkScheduler::HuggleScheduler = nullptr;
+
+QString NetworkScheduler::PriorityToString(QueryPriority priority)
+{
+    switch (priority)
+    {
+        case QueryPriority_UserAction:
+            return "user actions";
+        case QueryPriority_Warning:
+            return "warnings";
+        case QueryPriority_PostProcessing:
+            return "post processing";
+        case QueryPriority_Prefetch:
+            return "prefetch";
+        case QueryPriority_Background:
+            return "background";
+    }
+    return "unknown";
+}
+
+NetworkScheduler::NetworkScheduler(QObject *parent) : QObject(parent)
+{
+    int priority = 0;
+    while (priority < HUGGLE_QUERY_PRIORITY_COUNT)
+    {
+        this->waitTotal[priority] = 0;
+        this->waitMax[priority] = 0;
+        this->waitCount[priority] = 0;
+        priority++;
+    }
+    this->timer = new QTimer(this);
+    this->timer->setSingleShot(true);
+    connect(this->timer, SIGNAL(timeout()), this, SLOT(OnTimer()));
+}
+
+NetworkScheduler::~NetworkScheduler()
+{
+    delete this->timer;
+}
+
+void NetworkScheduler::Enqueue(ApiQuery *query)
+{
+    Entry entry;
+    entry.Item = query;
+    entry.Host = QUrl(query->URL).host();
+    entry.Priority = query->Priority;
+    entry.EnqueueTime = QDateTime::currentDateTime();
+    entry.LastPromotion = entry.EnqueueTime;
+    this->enqueue(entry);
+    this->dispatch();
+}
+
+bool NetworkScheduler::Remove(ApiQuery *query)
+{
+    int priority = 0;
+    while (priority < HUGGLE_QUERY_PRIORITY_COUNT)
+    {
+        int index = 0;
+        while (index < this->queues[priority].count())
+        {
+            if (this->queues[priority].at(index).Item == query)
+            {
+                this->queues[priority].removeAt(index);
+                return true;
+            }
+            index++;
+        }
+        priority++;
+    }
+    return false;
+}
+
+void NetworkScheduler::Release(ApiQuery *query)
+{
+    if (!this->running.contains(query))
+        return;
+    Entry entry = this->running.take(query);
+    Host &host = this->hosts[entry.Host];
+    host.Running--;
+    // the site is able to handle our requests again
+    host.BackoffLevel = 0;
+    this->dispatch();
+}
+
+bool NetworkScheduler::Retry(ApiQuery *query, QNetworkReply *reply)
+{
+    if (!this->running.contains(query))
+        return false;
+    int http_status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    bool maxlag = reply->rawHeader("MediaWiki-API-Error") == "maxlag";
+    if (http_status != 429 && http_status != 503 && !maxlag)
+        return false;
+    Entry entry = this->running.take(query);
+    Host &host = this->hosts[entry.Host];
+    host.Running--;
+    if (entry.Retries >= HUGGLE_SCHEDULER_MAX_RETRIES)
+    {
+        HUGGLE_DEBUG1("Giving up on query " + QString::number(query->QueryID()) + " after " + QString::number(entry.Retries) + " retries");
+        this->dispatch();
+        return false;
+    }
+    // Use the delay requested by server, if there is none, back off exponentially
+    int delay = reply->rawHeader("Retry-After").toInt();
+    if (delay <= 0)
+        delay = 1 << qMin(host.BackoffLevel, 6);
+    delay = qMin(delay, HUGGLE_SCHEDULER_MAX_BACKOFF);
+    host.BackoffLevel++;
+    QDateTime now = QDateTime::currentDateTime();
+    host.BackoffUntil = now.addSecs(delay);
+    HUGGLE_DEBUG(entry.Host + " asked us to slow down (" + (maxlag ? QString("maxlag") : "HTTP " + QString::number(http_status)) +
+                 "), retrying in " + QString::number(delay) + " seconds", 2);
+    entry.Retries++;
+    entry.NotBefore = host.BackoffUntil;
+    this->enqueue(entry);
+    this->dispatch();
+    return true;
+}
+
+bool NetworkScheduler::IsQueued(ApiQuery *query)
+{
+    int priority = 0;
+    while (priority < HUGGLE_QUERY_PRIORITY_COUNT)
+    {
+        foreach (const Entry &entry, this->queues[priority])
+        {
+            if (entry.Item == query)
+                return true;
+        }
+        priority++;
+    }
+    return false;
+}
+
+int NetworkScheduler::GetQueueSize(QueryPriority priority)
+{
+    int size = 0;
+    int current = 0;
+    while (current < HUGGLE_QUERY_PRIORITY_COUNT)
+    {
+        foreach (const Entry &entry, this->queues[current])
+        {
+            if (entry.Priority == priority)
+                size++;
+        }
+        current++;
+    }
+    return size;
+}
+
+qint64 NetworkScheduler::GetAverageWait(QueryPriority priority)
+{
+    if (this->waitCount[priority] == 0)
+        return 0;
+    return this->waitTotal[priority] / static_cast<qint64>(this->waitCount[priority]);
+}
+
+qint64 NetworkScheduler::GetMaximumWait(QueryPriority priority)
+{
+    return this->waitMax[priority];
+}
+
+QString NetworkScheduler::GetStatistics()
+{
+    QStringList classes;
+    int priority = 0;
+    while (priority < HUGGLE_QUERY_PRIORITY_COUNT)
+    {
+        QueryPriority p = static_cast<QueryPriority>(priority++);
+        classes << PriorityToString(p) + ": " + QString::number(this->GetQueueSize(p)) + " queued, avg wait " +
+                   QString::number(this->GetAverageWait(p)) + "ms, max " + QString::number(this->GetMaximumWait(p)) + "ms";
+    }
+    return classes.join("; ");
+}
+
+void NetworkScheduler::OnTimer()
+{
+    this->dispatch();
+}
+
+void NetworkScheduler::enqueue(const Entry &entry)
+{
+    this->queues[entry.Priority].append(entry);
+}
+
+void NetworkScheduler::promote()
+{
+    QDateTime limit = QDateTime::currentDateTime().addMSecs(-HUGGLE_SCHEDULER_AGING);
+    // class 0 can't be promoted any higher
+    int priority = 1;
+    while (priority < HUGGLE_QUERY_PRIORITY_COUNT)
+    {
+        int index = 0;
+        while (index < this->queues[priority].count())
+        {
+            if (this->queues[priority].at(index).LastPromotion < limit)
+            {
+                Entry entry = this->queues[priority].takeAt(index);
+                entry.LastPromotion = QDateTime::currentDateTime();
+                this->queues[priority - 1].append(entry);
+                continue;
+            }
+            index++;
+        }
+        priority++;
+    }
+}
+
+void NetworkScheduler::dispatch()
+{
+    if (this->dispatching)
+        return;
+    this->dispatching = true;
+    this->promote();
+    QDateTime now = QDateTime::currentDateTime();
+    QDateTime next_wakeup;
+    int limit = qMax(1, hcfg->SystemConfig_MaxConcurrentQueries);
+    int priority = 0;
+    while (priority < HUGGLE_QUERY_PRIORITY_COUNT)
+    {
+        bool interactive = priority <= QueryPriority_Warning;
+        int index = 0;
+        while (index < this->queues[priority].count())
+        {
+            const Entry &entry = this->queues[priority].at(index);
+            Host &host = this->hosts[entry.Host];
+            QDateTime blocked_until = entry.NotBefore;
+            if (!interactive && host.BackoffUntil > blocked_until)
+                blocked_until = host.BackoffUntil;
+            if (blocked_until.isValid() && blocked_until > now)
+            {
+                if (!next_wakeup.isValid() || blocked_until < next_wakeup)
+                    next_wakeup = blocked_until;
+                index++;
+                continue;
+            }
+            // the last slot is reserved for user actions and warnings
+            if (host.Running >= (interactive ? limit : qMax(1, limit - 1)))
+            {
+                index++;
+                continue;
+            }
+            Entry dispatched = this->queues[priority].takeAt(index);
+            host.Running++;
+            qint64 wait = dispatched.EnqueueTime.msecsTo(now);
+            this->waitTotal[dispatched.Priority] += wait;
+            this->waitCount[dispatched.Priority]++;
+            if (wait > this->waitMax[dispatched.Priority])
+                this->waitMax[dispatched.Priority] = wait;
+            this->running.insert(dispatched.Item, dispatched);
+            dispatched.Item->dispatch();
+        }
+        priority++;
+    }
+    // queries that are not yet promoted need to be checked again later
+    int waiting = 0;
+    priority = 1;
+    while (priority < HUGGLE_QUERY_PRIORITY_COUNT)
+        waiting += this->queues[priority++].count();
+    if (waiting > 0)
+    {
+        QDateTime aging = now.addMSecs(HUGGLE_SCHEDULER_AGING);
+        if (!next_wakeup.isValid() || aging < next_wakeup)
+            next_wakeup = aging;
+    }
+    if (next_wakeup.isValid())
+        this->schedule(next_wakeup);
+    this->dispatching = false;
+}
+
+void NetworkScheduler::schedule(const QDateTime &time)
+{
+    int delay = static_cast<int>(qMax(static_cast<qint64>(0), QDateTime::currentDateTime().msecsTo(time)));
+    if (this->timer->isActive() && this->timer->remainingTime() <= delay)
+        return;
+    this->timer->start(delay);
+}
@@ -0,0 +1,126 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef NETWORKSCHEDULER_HPP
+#define NETWORKSCHEDULER_HPP
+
+#include "definitions.hpp"
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+// Number of priority classes, see QueryPriority
+#define HUGGLE_QUERY_PRIORITY_COUNT    5
+// Time in ms after which a waiting query is moved to the next higher class, so that busy classes can't starve lower ones
+#define HUGGLE_SCHEDULER_AGING         4000
+// Maximum time in seconds we back off from a site that is asking us to slow down
+#define HUGGLE_SCHEDULER_MAX_BACKOFF   60
+// How many times a query can be returned to queue because of maxlag or rate limit before it's left to fail
+#define HUGGLE_SCHEDULER_MAX_RETRIES   5
+
+class QNetworkReply;
+class QTimer;
+
+namespace Huggle
+{
+    class ApiQuery;
+
+    //! Priority of api query, lower value is more important
+    enum QueryPriority
+    {
+        //! Actions explicitly requested by user (rollback, block, delete, login)
+        QueryPriority_UserAction = 0,
+        //! Messages delivered to users
+        QueryPriority_Warning = 1,
+        //! Information needed to display and score edits in queue
+        QueryPriority_PostProcessing = 2,
+        //! Information that is nice to have, but no one is waiting for it
+        QueryPriority_Prefetch = 3,
+        //! Maintenance, such as watching and patrolling
+        QueryPriority_Background = 4
+    };
+
+    //! Scheduler which decides in which order api queries are sent to the network
+
+    //! Queries are sorted into priority classes, every site has a limit of queries that can be running
+    //! at the same time (one slot is always reserved for user actions and warnings), so that a rollback
+    //! doesn't wait behind hundreds of queries made by post processing. If a site responds with HTTP 429
+    //! or maxlag error, the query is returned to queue and non-interactive classes back off from that site.
+    class HUGGLE_EX_CORE NetworkScheduler : public QObject
+    {
+            Q_OBJECT
+        public:
+            static NetworkScheduler *HuggleScheduler;
+            static QString PriorityToString(QueryPriority priority);
+
+            NetworkScheduler(QObject *parent = nullptr);
+            ~NetworkScheduler();
+            //! Insert query to the queue of its class, it's dispatched as soon as there is a free slot for it
+            void Enqueue(ApiQuery *query);
+            //! Remove query from queue, returns true if it was waiting there
+            bool Remove(ApiQuery *query);
+            //! Free the slot of query that was dispatched, this must be called once its request is finished or aborted
+            void Release(ApiQuery *query);
+            /*!
+             * \brief Retry checks if the site asked us to slow down and if so, returns the query back to queue
+             * \param query Query that was dispatched
+             * \param reply Finished reply of that query
+             * \return true if query was requeued and content of reply should be ignored
+             */
+            bool Retry(ApiQuery *query, QNetworkReply *reply);
+            bool IsQueued(ApiQuery *query);
+            int GetQueueSize(QueryPriority priority);
+            //! Average time in ms which dispatched queries of this class spent in queue
+            qint64 GetAverageWait(QueryPriority priority);
+            qint64 GetMaximumWait(QueryPriority priority);
+            //! Returns short text describing queues of all classes
+            QString GetStatistics();
+        private slots:
+            void OnTimer();
+        private:
+            class Host
+            {
+                public:
+                    int Running = 0;
+                    int BackoffLevel = 0;
+                    QDateTime BackoffUntil;
+            };
+            class Entry
+            {
+                public:
+                    ApiQuery *Item = nullptr;
+                    QString Host;
+                    QueryPriority Priority = QueryPriority_PostProcessing;
+                    QDateTime EnqueueTime;
+                    QDateTime LastPromotion;
+                    QDateTime NotBefore;
+                    int Retries = 0;
+            };
+            void enqueue(const Entry &entry);
+            void promote();
+            void dispatch();
+            void schedule(const QDateTime &time);
+            //! Queues indexed by class, entries may be promoted to higher class than their own priority
+            QList<Entry> queues[HUGGLE_QUERY_PRIORITY_COUNT];
+            QHash<ApiQuery*, Entry> running;
+            QHash<QString, Host> hosts;
+            qint64 waitTotal[HUGGLE_QUERY_PRIORITY_COUNT];
+            qint64 waitMax[HUGGLE_QUERY_PRIORITY_COUNT];
+            unsigned long waitCount[HUGGLE_QUERY_PRIORITY_COUNT];
+            QTimer *timer;
+            //! Prevents recursion in case a query is finished right when it's dispatched
+            bool dispatching = false;
+    };
+}
+
+#endif // NETWORKSCHEDULER_HPP
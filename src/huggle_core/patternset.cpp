@@ -0,0 +1,114 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "patternset.hpp"
+#include "syslog.hpp"
+
+using namespace Huggle;
+
+PatternSet::PatternSet()
+{
+
+}
+
+PatternSet::PatternSet(const QStringList &patterns, bool literal)
+{
+    static const QRegularExpression back_reference("\\\\([1-9]|g)");
+    this->patterns = patterns;
+    QStringList alternatives;
+    int index = 0;
+    foreach (QString pattern, patterns)
+    {
+        if (literal)
+            pattern = QRegularExpression::escape(pattern);
+        QRegularExpression expression(pattern);
+        if (pattern.isEmpty() || !expression.isValid())
+        {
+            if (!pattern.isEmpty())
+                HUGGLE_WARNING("Ignoring invalid pattern " + pattern + ": " + expression.errorString());
+            this->groups.append("");
+            index++;
+            continue;
+        }
+        if (pattern.contains(back_reference))
+        {
+            expression.setPatternOptions(QRegularExpression::OptimizeOnFirstUsageOption);
+            this->standalone.append(expression);
+            this->standaloneIndexes.append(index);
+            this->groups.append("");
+            index++;
+            continue;
+        }
+        QString group = "p" + QString::number(index++);
+        this->groups.append(group);
+        alternatives.append("(?<" + group + ">" + pattern + ")");
+    }
+    if (!alternatives.isEmpty())
+    {
+        this->combined = QRegularExpression(alternatives.join("|"), QRegularExpression::OptimizeOnFirstUsageOption);
+        this->hasCombined = this->combined.isValid();
+        if (!this->hasCombined)
+            HUGGLE_WARNING("Unable to compile pattern set: " + this->combined.errorString());
+    }
+}
+
+bool PatternSet::Matches(const QString &text) const
+{
+    if (this->hasCombined && this->combined.match(text).hasMatch())
+        return true;
+    foreach (const QRegularExpression &expression, this->standalone)
+    {
+        if (expression.match(text).hasMatch())
+            return true;
+    }
+    return false;
+}
+
+int PatternSet::Match(const QString &text) const
+{
+    int best = -1;
+    int best_start = -1;
+    if (this->hasCombined)
+    {
+        // alternation already picks the leftmost match and the first alternative at that position
+        QRegularExpressionMatch match = this->combined.match(text);
+        if (match.hasMatch())
+        {
+            int index = 0;
+            while (index < this->groups.count())
+            {
+                if (!this->groups.at(index).isEmpty() && match.capturedStart(this->groups.at(index)) >= 0)
+                {
+                    best = index;
+                    best_start = match.capturedStart();
+                    break;
+                }
+                index++;
+            }
+        }
+    }
+    int index = 0;
+    while (index < this->standalone.count())
+    {
+        QRegularExpressionMatch match = this->standalone.at(index).match(text);
+        if (match.hasMatch())
+        {
+            int start = match.capturedStart();
+            int original = this->standaloneIndexes.at(index);
+            if (best < 0 || start < best_start || (start == best_start && original < best))
+            {
+                best = original;
+                best_start = start;
+            }
+        }
+        index++;
+    }
+    return best;
+}
@@ -0,0 +1,74 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef PATTERNSET_HPP
+#define PATTERNSET_HPP
+
+#include "definitions.hpp"
+
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+namespace Huggle
+{
+    //! List of regular expressions compiled into a single one
+
+    //! Instead of matching a text against every pattern from configuration one by one, all patterns are
+    //! joined to one alternation where each of them is a named capture group, so the text is scanned only
+    //! once and the name of the group that captured tells which pattern matched. The expression is optimized
+    //! (and JIT compiled if pcre supports it) on first use. Patterns with back references can't be joined,
+    //! because their group numbers would change, so these are matched separately.
+    //! Instance is never modified after it's constructed, so it's safe to match from multiple threads.
+    class HUGGLE_EX_CORE PatternSet
+    {
+        public:
+            PatternSet();
+            /*!
+             * \brief PatternSet compiles the patterns
+             * \param patterns List of regular expressions, invalid ones are skipped with a warning
+             * \param literal If true the patterns are plain strings which are escaped first
+             */
+            PatternSet(const QStringList &patterns, bool literal = false);
+            //! Returns true if some of the patterns is contained in text
+            bool Matches(const QString &text) const;
+            //! Returns index (in original list) of the pattern that matched the text, or -1 if none did
+
+            //! If more patterns match, the one which matches earliest in the text wins, when they start at same
+            //! position the one which comes first in the original list wins. Patterns matched separately follow
+            //! the same rule, so the result doesn't depend on how the patterns were compiled.
+            int Match(const QString &text) const;
+            //! Returns the original patterns
+            QStringList GetPatterns() const;
+            bool IsEmpty() const;
+        private:
+            QStringList patterns;
+            QRegularExpression combined;
+            //! Names of capture groups in combined expression, indexed by position in original list, empty for standalone patterns
+            QStringList groups;
+            //! Patterns matched separately, stored with their index in original list
+            QList<QRegularExpression> standalone;
+            QList<int> standaloneIndexes;
+            bool hasCombined = false;
+    };
+
+    inline bool PatternSet::IsEmpty() const
+    {
+        return !this->hasCombined && this->standalone.isEmpty();
+    }
+
+    inline QStringList PatternSet::GetPatterns() const
+    {
+        return this->patterns;
+    }
+}
+
+#endif // PATTERNSET_HPP
@@ -449,13 +449,6 @@ bool ProjectConfiguration::Parse(QString config, QString *reason, WikiSite *site
         this->AlternativeMonths.insert(month_, QStringList());
         month_++;
     }
-    this->_revertPatterns.clear();
-    int xx = 0;
-    while (xx < this->RevertPatterns.count())
-    {
-        this->_revertPatterns.append(QRegExp(this->RevertPatterns.at(xx)));
-        xx++;
-    }
     if (!HuggleQueueFilter::Filters.contains(site))
     {
         HuggleQueueFilter::Filters.insert(site, new QList<HuggleQueueFilter*>());
@@ -499,6 +492,7 @@ bool ProjectConfiguration::Parse(QString config, QString *reason, WikiSite *site
     }
 
     this->Sanitize();
+    site->PublishSnapshot();
     return true;
 }
 
@@ -814,13 +808,6 @@ bool ProjectConfiguration::ParseYAML(QString yaml_src, QString *reason, WikiSite
     }
 
     this->RevertPatterns = HuggleParser::YAML2QStringList("revert-patterns", yaml);
-    this->_revertPatterns.clear();
-    int xx = 0;
-    while (xx < this->RevertPatterns.count())
-    {
-        this->_revertPatterns.append(QRegExp(this->RevertPatterns.at(xx)));
-        xx++;
-    }
     if (!HuggleQueueFilter::Filters.contains(site))
     {
         HuggleQueueFilter::Filters.insert(site, new QList<HuggleQueueFilter*>());
@@ -864,6 +851,7 @@ bool ProjectConfiguration::ParseYAML(QString yaml_src, QString *reason, WikiSite
     }
 
     this->Sanitize();
+    site->PublishSnapshot();
     return true;
 }
 
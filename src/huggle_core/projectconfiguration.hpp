@@ -97,6 +97,9 @@ namespace Huggle
             ~ProjectConfiguration();
             QDateTime ServerTime();
             //! Parse all information from local config, this function is used in login
+
+            //! Configuration is overwritten in place and snapshot of the site is published once it's done,
+            //! so reload is only safe for threads that use WikiSite::GetSnapshot(), see ProjectConfigurationSnapshot
             bool Parse(QString config, QString *reason, WikiSite *site);
             bool ParseYAML(QString yaml_src, QString *reason, WikiSite *site);
             void RequestLogin();
@@ -123,6 +126,8 @@ namespace Huggle
             //! Set to false when you are logged out for some reason
             bool            IsLoggedIn = false;
             bool            RequestingLogin = false;
+            //! Site is used without any account, for example by daemon, so queries must not assert that user is logged in
+            bool            Anonymous = false;
             //! Minimal version of huggle required to use it
             QString         MinimalVersion = HUGGLE_VERSION;
             bool            UseIrc = false;
@@ -278,8 +283,6 @@ namespace Huggle
             QHash<QString,QString>  TagsArgs;
             //! Where the welcome message is stored
             QString                 WelcomeMP = "Project:Huggle/Message";
-            // This is internal only do not prefix it!!
-            QList<QRegExp>          _revertPatterns;
             score_ht                BotScore = -200;
             score_ht                WarningScore = 2000;
             QStringList             WarningTypes;
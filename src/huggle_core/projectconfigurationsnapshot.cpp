@@ -0,0 +1,210 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "projectconfigurationsnapshot.hpp"
+#include "huggleparser.hpp"
+#include "scoretext.hpp"
+#include "syslog.hpp"
+#include <algorithm>
+
+using namespace Huggle;
+
+ProjectConfigurationSnapshot::ProjectConfigurationSnapshot(ProjectConfiguration *config, const QStringList &separators)
+{
+    this->IPScore = config->IPScore;
+    this->BotScore = config->BotScore;
+    this->ForeignUser = config->ForeignUser;
+    this->ScoreUser = config->ScoreUser;
+    this->ScoreTalk = config->ScoreTalk;
+    this->ScoreChange = config->ScoreChange;
+    this->LargeRemoval = config->LargeRemoval;
+    this->ScoreRemoval = config->ScoreRemoval;
+    this->WhitelistScore = config->WhitelistScore;
+    this->ScoreTags = config->ScoreTags;
+    this->ScoreLevel = config->ScoreLevel;
+    this->ScoreWords = config->ScoreWords;
+    this->ScoreParts = config->ScoreParts;
+    this->NoTalkScoreWords = config->NoTalkScoreWords;
+    this->NoTalkScoreParts = config->NoTalkScoreParts;
+    this->Ignores = config->Ignores.toSet();
+    // ignore patterns and assisted summaries are plain strings, not regular expressions
+    this->IgnorePatterns = PatternSet(config->IgnorePatterns, true);
+    this->AssistedPatterns = PatternSet(config->Assisted, true);
+    this->RevertPatterns = PatternSet(config->RevertPatterns);
+    this->DatePrefix = config->Parser_Date_Prefix;
+    this->TemplateAge = config->TemplateAge;
+    QStringList suffixes;
+    foreach (QString suffix, config->Parser_Date_Suffix)
+    {
+        if (!suffix.isEmpty())
+            suffixes.append(QRegularExpression::escape(suffix));
+    }
+    if (!suffixes.isEmpty())
+        this->DateSuffixes = QRegularExpression(suffixes.join("|"), QRegularExpression::OptimizeOnFirstUsageOption);
+    int month = 0;
+    while (month < config->Months.count())
+    {
+        QString name = config->Months.at(month++).toLower();
+        if (!this->months.contains(name))
+            this->months.insert(name, static_cast<byte_ht>(month));
+    }
+    month = 1;
+    while (month < 13)
+    {
+        foreach (QString name, config->AlternativeMonths.value(month))
+        {
+            if (!this->months.contains(name.toLower()))
+                this->months.insert(name.toLower(), static_cast<byte_ht>(month));
+        }
+        month++;
+    }
+    // when more templates match at same position the one with highest level is preferred
+    QList<QPair<int, QString>> templates;
+    foreach (QString definition, config->WarningDefs)
+    {
+        int level = HuggleParser::GetKeyFromSSItem(definition).toInt();
+        QString text = HuggleParser::GetValueFromSSItem(definition);
+        // talk pages are only checked for levels 1 - 4
+        if (level > 0 && level < 5 && !text.isEmpty())
+            templates.append(QPair<int, QString>(level, text));
+    }
+    std::stable_sort(templates.begin(), templates.end(), [](const QPair<int, QString> &a, const QPair<int, QString> &b) { return a.first > b.first; });
+    QStringList alternatives;
+    this->warningLevels.append(0);
+    foreach (const QPair<int, QString> &warning, templates)
+    {
+        alternatives.append("(" + QRegularExpression::escape(warning.second) + ")");
+        this->warningLevels.append(static_cast<byte_ht>(warning.first));
+    }
+    if (!alternatives.isEmpty())
+        this->WarningTemplates = QRegularExpression(alternatives.join("|"), QRegularExpression::OptimizeOnFirstUsageOption);
+    foreach (QString separator, separators)
+    {
+        if (separator.length() != 1)
+        {
+            HUGGLE_WARNING("Ignoring word separator \"" + separator + "\" because it's not a single character");
+            continue;
+        }
+        this->separators += separator;
+    }
+}
+
+bool ProjectConfigurationSnapshot::ContainsWord(const QString &text, const QString &word) const
+{
+    if (word.isEmpty())
+        return false;
+    int length = word.length();
+    int position = text.indexOf(word);
+    // every occurrence of the word needs to be checked, because the first one may be just part of some other word
+    while (position >= 0)
+    {
+        int end = position + length;
+        if ((position == 0 || this->isSeparator(text.at(position - 1))) && (end == text.length() || this->isSeparator(text.at(end))))
+            return true;
+        position = text.indexOf(word, position + 1);
+    }
+    return false;
+}
+
+long ProjectConfigurationSnapshot::MatchWords(const QString &text, const QList<ScoreWord> &words, QStringList *matched) const
+{
+    long score = 0;
+    foreach (const ScoreWord &word, words)
+    {
+        if (this->ContainsWord(text, word.word))
+        {
+            score += word.score;
+            matched->append(word.word);
+        }
+    }
+    return score;
+}
+
+long ProjectConfigurationSnapshot::MatchParts(const QString &text, const QList<ScoreWord> &words, QStringList *matched) const
+{
+    long score = 0;
+    foreach (const ScoreWord &word, words)
+    {
+        if (text.contains(word.word))
+        {
+            score += word.score;
+            matched->append(word.word);
+        }
+    }
+    return score;
+}
+
+long ProjectConfigurationSnapshot::MatchWords(const ScoreText &text, const QList<ScoreWord> &words, QStringList *matched) const
+{
+    long score = 0;
+    foreach (const ScoreWord &word, words)
+    {
+        if (text.ContainsWord(word.word))
+        {
+            score += word.score;
+            matched->append(word.word);
+        }
+    }
+    return score;
+}
+
+long ProjectConfigurationSnapshot::MatchParts(const ScoreText &text, const QList<ScoreWord> &words, QStringList *matched) const
+{
+    long score = 0;
+    foreach (const ScoreWord &word, words)
+    {
+        if (text.Contains(word.word))
+        {
+            score += word.score;
+            matched->append(word.word);
+        }
+    }
+    return score;
+}
+
+const QString &ProjectConfigurationSnapshot::GetSeparators() const
+{
+    return this->separators;
+}
+
+bool ProjectConfigurationSnapshot::IsRevert(const QString &summary) const
+{
+    if (summary.isEmpty())
+        return false;
+    return this->RevertPatterns.Matches(summary);
+}
+
+bool ProjectConfigurationSnapshot::IsIgnored(const QString &page_name) const
+{
+    if (this->Ignores.contains(page_name))
+        return true;
+    return this->IgnorePatterns.Matches(page_name);
+}
+
+bool ProjectConfigurationSnapshot::IsAssisted(const QString &summary) const
+{
+    if (summary.isEmpty())
+        return false;
+    return this->AssistedPatterns.Matches(summary);
+}
+
+byte_ht ProjectConfigurationSnapshot::GetMonth(const QString &name) const
+{
+    return this->months.value(name.toLower(), 0);
+}
+
+byte_ht ProjectConfigurationSnapshot::GetWarningLevel(const QRegularExpressionMatch &match) const
+{
+    // only one alternative can capture, so it's the last group that has something
+    int group = match.lastCapturedIndex();
+    if (group < 1 || group >= this->warningLevels.count())
+        return 0;
+    return this->warningLevels.at(group);
+}
@@ -0,0 +1,110 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef PROJECTCONFIGURATIONSNAPSHOT_HPP
+#define PROJECTCONFIGURATIONSNAPSHOT_HPP
+
+#include "definitions.hpp"
+
+#include <QHash>
+#include <QList>
+#include <QRegularExpression>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "patternset.hpp"
+#include "projectconfiguration.hpp"
+
+namespace Huggle
+{
+    class ScoreText;
+
+    //! Immutable copy of those parts of project configuration that are needed to score edits
+
+    //! ProjectConfiguration is filled in place when it's parsed, which is not safe to do while worker
+    //! threads are scoring edits using it. Scoring therefore doesn't read it directly, it obtains a snapshot
+    //! using WikiSite::GetSnapshot() instead. Snapshot is never modified once it's created, when configuration
+    //! is parsed again a new snapshot is published and threads that still hold the old one finish with it.
+    //! Only the members copied here are safe to read while configuration is being parsed again, anything
+    //! that is read from ProjectConfiguration itself (such as the whitelist) still must not be used by other
+    //! threads during the reload.
+    class HUGGLE_EX_CORE ProjectConfigurationSnapshot
+    {
+        public:
+            /*!
+             * \brief ProjectConfigurationSnapshot compiles the configuration
+             * \param config Configuration to copy data from
+             * \param separators Word separators, every item is expected to be single character
+             */
+            ProjectConfigurationSnapshot(ProjectConfiguration *config, const QStringList &separators);
+            //! Returns true if word is contained in text and it's surrounded by separators or the start / end of text
+            bool ContainsWord(const QString &text, const QString &word) const;
+            //! Sum score of all words from list that are contained in text as whole words, matched words are appended to list
+            long MatchWords(const QString &text, const QList<ScoreWord> &words, QStringList *matched) const;
+            //! Sum score of all words from list that are contained in text, even as part of other words
+            long MatchParts(const QString &text, const QList<ScoreWord> &words, QStringList *matched) const;
+            //! Same as MatchWords, but text was already lower cased and its separators are known
+            long MatchWords(const ScoreText &text, const QList<ScoreWord> &words, QStringList *matched) const;
+            long MatchParts(const ScoreText &text, const QList<ScoreWord> &words, QStringList *matched) const;
+            //! Word separators, every character of the string is one separator
+            const QString &GetSeparators() const;
+            //! Returns true if summary matches some of revert patterns
+            bool IsRevert(const QString &summary) const;
+            //! Returns true if page should be ignored because of its name
+            bool IsIgnored(const QString &page_name) const;
+            //! Returns true if summary was made by some of the assisted tools
+            bool IsAssisted(const QString &summary) const;
+            //! Returns number of month with given name (including alternative names), or 0 if it's unknown
+            byte_ht GetMonth(const QString &name) const;
+            //! Returns level of warning template which matched as last capture group of WarningTemplates
+            byte_ht GetWarningLevel(const QRegularExpressionMatch &match) const;
+
+            score_ht                IPScore;
+            score_ht                BotScore;
+            score_ht                ForeignUser;
+            score_ht                ScoreUser;
+            score_ht                ScoreTalk;
+            score_ht                ScoreChange;
+            score_ht                LargeRemoval;
+            score_ht                ScoreRemoval;
+            long                    WhitelistScore;
+            QHash<QString, int>     ScoreTags;
+            QHash<int, score_ht>    ScoreLevel;
+            QList<ScoreWord>        ScoreWords;
+            QList<ScoreWord>        ScoreParts;
+            QList<ScoreWord>        NoTalkScoreWords;
+            QList<ScoreWord>        NoTalkScoreParts;
+            PatternSet              RevertPatterns;
+            PatternSet              IgnorePatterns;
+            PatternSet              AssistedPatterns;
+            QSet<QString>           Ignores;
+            //! Date suffixes of signatures (like "(UTC)") as one expression
+            QRegularExpression      DateSuffixes;
+            QString                 DatePrefix;
+            int                     TemplateAge;
+            //! All warning templates as one expression, every template is a capture group, highest levels go first
+            QRegularExpression      WarningTemplates;
+        private:
+            bool isSeparator(QChar c) const;
+            QString separators;
+            //! Lower case name of month -> its number
+            QHash<QString, byte_ht> months;
+            //! Level of each capture group of WarningTemplates, first item is the whole match
+            QVector<byte_ht> warningLevels;
+    };
+
+    inline bool ProjectConfigurationSnapshot::isSeparator(QChar c) const
+    {
+        return this->separators.contains(c);
+    }
+}
+
+#endif // PROJECTCONFIGURATIONSNAPSHOT_HPP
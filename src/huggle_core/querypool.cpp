@@ -19,6 +19,7 @@
 #include "query.hpp"
 #include "hooks.hpp"
 #include "message.hpp"
+#include "projectconfigurationsnapshot.hpp"
 #include "syslog.hpp"
 #include "wikiedit.hpp"
 #include "wikisite.hpp"
@@ -87,20 +88,13 @@ void QueryPool::PreProcessEdit(WikiEdit *edit)
     if (edit->Bot)
         edit->User->SetBot(true);
 
-    edit->EditMadeByHuggle = edit->Summary.contains(hcfg->ProjectConfig->EditSuffixOfHuggle);
+    edit->EditMadeByHuggle = edit->Summary.contains(edit->GetSite()->GetProjectConfig()->EditSuffixOfHuggle);
 
-    int x = 0;
-    while (x < Configuration::HuggleConfiguration->ProjectConfig->Assisted.count())
-    {
-        if (edit->Summary.contains(hcfg->ProjectConfig->Assisted.at(x)))
-        {
-            edit->TrustworthEdit = true;
-            break;
-        }
-        x++;
-    }
+    std::shared_ptr<const ProjectConfigurationSnapshot> conf = edit->GetSite()->GetSnapshot();
+    if (conf->IsAssisted(edit->Summary))
+        edit->TrustworthEdit = true;
 
-    if (WikiUtil::IsRevert(edit->Summary))
+    if (conf->IsRevert(edit->Summary))
     {
         edit->IsRevert = true;
         if (edit->GetSite()->Provider != nullptr)
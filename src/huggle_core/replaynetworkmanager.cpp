@@ -0,0 +1,110 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "replaynetworkmanager.hpp"
+#include <QTimer>
+#include <cstring>
+#include "configuration.hpp"
+#include "syslog.hpp"
+
+using namespace Huggle;
+
+ReplayNetworkReply::ReplayNetworkReply(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QObject *parent) : QNetworkReply(parent)
+{
+    this->setOperation(operation);
+    this->setRequest(request);
+    this->setUrl(request.url());
+}
+
+void ReplayNetworkReply::Deliver(const TrafficRecord *record, qint64 delay)
+{
+    if (record == nullptr)
+    {
+        this->setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 404);
+        this->setError(QNetworkReply::ContentNotFoundError, "Request was not found in traffic capture");
+    } else
+    {
+        this->content = record->Data;
+        if (record->HttpStatus)
+            this->setAttribute(QNetworkRequest::HttpStatusCodeAttribute, record->HttpStatus);
+        if (record->Error != QNetworkReply::NoError)
+            this->setError(static_cast<QNetworkReply::NetworkError>(record->Error), record->ErrorString);
+    }
+    this->setHeader(QNetworkRequest::ContentLengthHeader, this->content.size());
+    this->open(QIODevice::ReadOnly);
+    // api query connects to the signals only after the reply is returned, so we always deliver it later
+    QTimer::singleShot(static_cast<int>(delay), this, SLOT(OnDelivery()));
+}
+
+void ReplayNetworkReply::abort()
+{
+    if (this->isFinished())
+        return;
+    this->setError(QNetworkReply::OperationCanceledError, "Operation canceled");
+    this->content.clear();
+    this->setFinished(true);
+    emit finished();
+}
+
+qint64 ReplayNetworkReply::bytesAvailable() const
+{
+    return this->content.size() - this->offset + QNetworkReply::bytesAvailable();
+}
+
+bool ReplayNetworkReply::isSequential() const
+{
+    return true;
+}
+
+qint64 ReplayNetworkReply::readData(char *data, qint64 maxSize)
+{
+    // nothing can be read until the response was delivered
+    if (!this->isFinished() || this->offset >= this->content.size())
+        return this->isFinished() ? -1 : 0;
+    qint64 size = qMin(maxSize, this->content.size() - this->offset);
+    memcpy(data, this->content.constData() + this->offset, static_cast<size_t>(size));
+    this->offset += size;
+    return size;
+}
+
+void ReplayNetworkReply::OnDelivery()
+{
+    // reply may have been aborted in meantime
+    if (this->isFinished())
+        return;
+    this->setFinished(true);
+    if (!this->content.isEmpty())
+        emit readyRead();
+    emit finished();
+}
+
+ReplayNetworkAccessManager::ReplayNetworkAccessManager(TrafficReplay *replay, QObject *parent) : QNetworkAccessManager(parent)
+{
+    this->replay = replay;
+}
+
+QNetworkReply *ReplayNetworkAccessManager::createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+    QByteArray method = op == QNetworkAccessManager::PostOperation ? "POST" : "GET";
+    QByteArray body;
+    if (outgoingData != nullptr)
+        body = outgoingData->readAll();
+    ReplayNetworkReply *reply = new ReplayNetworkReply(op, request, this);
+    TrafficRecord record;
+    if (this->replay->GetResponse(method, request.url().toEncoded(), body, &record))
+    {
+        reply->Deliver(&record, this->replay->GetDelay(record));
+    } else
+    {
+        HUGGLE_DEBUG("Request not found in traffic capture: " + request.url().toString(), 1);
+        reply->Deliver(nullptr, 0);
+    }
+    return reply;
+}
@@ -0,0 +1,57 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef REPLAYNETWORKMANAGER_HPP
+#define REPLAYNETWORKMANAGER_HPP
+
+#include "definitions.hpp"
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include "trafficcapture.hpp"
+
+namespace Huggle
+{
+    //! Reply which contains response loaded from traffic capture
+    class HUGGLE_EX_CORE ReplayNetworkReply : public QNetworkReply
+    {
+            Q_OBJECT
+        public:
+            ReplayNetworkReply(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QObject *parent = nullptr);
+            //! Deliver the response after given time, if record is null the request fails as if it didn't exist
+            void Deliver(const TrafficRecord *record, qint64 delay);
+            void abort();
+            qint64 bytesAvailable() const;
+            bool isSequential() const;
+        protected:
+            qint64 readData(char *data, qint64 maxSize);
+        private slots:
+            void OnDelivery();
+        private:
+            QByteArray content;
+            qint64 offset = 0;
+    };
+
+    //! Network manager which never touches network and serves responses from TrafficReplay::Replay instead
+
+    //! It replaces Query::NetworkManager when huggle is started with --replay
+    class HUGGLE_EX_CORE ReplayNetworkAccessManager : public QNetworkAccessManager
+    {
+            Q_OBJECT
+        public:
+            ReplayNetworkAccessManager(TrafficReplay *replay, QObject *parent = nullptr);
+        protected:
+            QNetworkReply *createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData = nullptr);
+        private:
+            TrafficReplay *replay;
+    };
+}
+
+#endif // REPLAYNETWORKMANAGER_HPP
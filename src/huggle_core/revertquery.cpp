@@ -18,6 +18,8 @@
 #include "localization.hpp"
 #include "historyitem.hpp"
 #include "hooks.hpp"
+#include "hugglefeed.hpp"
+#include "revisiontextcache.hpp"
 #include "syslog.hpp"
 #include "wikisite.hpp"
 #include "wikiuser.hpp"
@@ -156,6 +158,7 @@ void RevertQuery::Kill()
     this->Exit();
     this->CustomStatus = "";
     this->PreflightFinished = false;
+    this->KnownHead = false;
     this->RollingBack = false;
 }
 
@@ -313,13 +316,44 @@ void RevertQuery::Preflight()
             }
         }
     }
+    if (this->OneEditOnly || this->IgnorePreflightCheck)
+    {
+        // result of preflight query would be ignored anyway
+        this->PreflightFinished = true;
+        return;
+    }
+    this->KnownHead = this->isKnownHead();
+    if (this->KnownHead)
+    {
+        // nobody edited the page after this edit as far as we know, if the feed missed something the rollback
+        // fails on mediawiki side, because the page is no longer on top of revisions of this user
+        HUGGLE_DEBUG("Skipping preflight check of " + this->editToBeReverted->Page->PageName + ", revision " +
+                     QString::number(this->editToBeReverted->RevID) + " is the newest one", 2);
+        this->PreflightFinished = true;
+        return;
+    }
     // now we need to retrieve the information about current status of page
     this->qPreflight = new ApiQuery(ActionQuery, this->GetSite());
+    this->qPreflight->Priority = QueryPriority_UserAction;
     this->qPreflight->Parameters = "prop=revisions&rvprop=" + QUrl::toPercentEncoding("ids|flags|timestamp|user|userid|size|sha1|comment")
                                  + "&rvlimit=20&titles=" + QUrl::toPercentEncoding(this->editToBeReverted->Page->PageName);
     this->qPreflight->Process();
 }
 
+bool RevertQuery::isKnownHead()
+{
+    revid_ht head = WIKI_UNKNOWN_REVID;
+    WikiSite *site = this->GetSite();
+    // edits made while the feed is down wouldn't be seen
+    if (HistoryCache::HuggleHistory == nullptr || site->Provider == nullptr || !site->Provider->IsWorking())
+        return false;
+    if (this->editToBeReverted->RevID == WIKI_UNKNOWN_REVID)
+        return false;
+    if (!HistoryCache::HuggleHistory->GetHead(site, this->editToBeReverted->Page->PageName, &head))
+        return false;
+    return head == this->editToBeReverted->RevID;
+}
+
 void RevertQuery::CheckPreflight()
 {
     if (this->OneEditOnly || this->IgnorePreflightCheck)
@@ -472,6 +506,7 @@ bool RevertQuery::CheckRevert()
         item->Type = HistoryRollback;
         item->Result = _l("successful");
         Hooks::WikiEdit_OnNewHistoryItem(item);
+        this->reportLatency();
     }
     this->qRevert->UnregisterConsumer(HUGGLECONSUMER_REVERTQUERY);
     this->qRevert.Delete();
@@ -511,6 +546,7 @@ bool RevertQuery::ProcessRevert()
             return true;
         }
         Syslog::HuggleLogs->DebugLog("Sucessful SR of page " + this->editToBeReverted->Page->PageName);
+        this->reportLatency();
         return true;
     }
     if (this->qRetrieve != nullptr)
@@ -525,8 +561,6 @@ bool RevertQuery::ProcessRevert()
             this->DisplayError("Unable to rollback the edit because previous content couldn't be retrieved");
             return true;
         }
-        QString summary = this->Summary;
-        QString content = "";
         ApiQueryResultNode* info = this->qRetrieve->GetApiQueryResult()->GetNode("rev");
         if (info == nullptr)
         {
@@ -540,31 +574,13 @@ bool RevertQuery::ProcessRevert()
             return true;
         }
         QString rv = info->GetAttribute("revid");
-        if (rv.toInt() != this->SR_RevID)
+        if (rv.toLongLong() != this->SR_RevID)
         {
             this->DisplayError("Unable to rollback the edit because query used to retrieve the content of previous"\
                                " version returned invalid RevID");
             return true;
         }
-        content = info->Value;
-        if (summary.isEmpty())
-            summary = this->GetSite()->GetProjectConfig()->SoftwareRevertDefaultSummary;
-        summary = summary.replace("$1", this->editToBeReverted->User->Username)
-                .replace("$2", this->SR_Target)
-                .replace("$3", QString::number(this->SR_Depth))
-                .replace("$4", QString::number(this->SR_RevID));
-        // we need to make sure there is edit suffix in revert summary for huggle
-        summary = Configuration::GenerateSuffix(summary, this->GetSite()->GetProjectConfig());
-        if (content.isEmpty())
-        {
-            /// \todo LOCALIZE ME
-            this->DisplayError("Cowardly refusing to blank \"" + this->editToBeReverted->Page->PageName +
-                               "\" software rollback was cancelled to prevent damage",
-                               "content was resolved to blank edit");
-            return true;
-        }
-        this->eqSoftwareRollback = WikiUtil::EditPage(this->editToBeReverted->Page, content, summary, this->MinorEdit);
-        this->CustomStatus = _l("editing-page");
+        this->editToTarget(info->Value);
         return false;
     }
     if (this->qHistoryInfo == nullptr || !this->qHistoryInfo->IsProcessed())
@@ -586,17 +602,18 @@ bool RevertQuery::ProcessRevert()
     }
     // if the latest revid doesn't match our revid it means that someone made an edit
     bool passed = true;
-    this->SR_Depth = 0;
     bool new_edits_resv = false;
+    QList<HistoryRevision> revisions;
     foreach (ApiQueryResultNode *e, revs)
     {
+        revisions.append(HistoryRevision::FromApiNode(e, this->editToBeReverted->Page->PageName));
         if (e->Attributes.contains("revid"))
         {
-            if (this->editToBeReverted->RevID == e->GetAttribute("revid").toInt())
+            if (this->editToBeReverted->RevID == e->GetAttribute("revid").toLongLong())
                 continue;
-            if (this->editToBeReverted->RevID != WIKI_UNKNOWN_REVID && e->GetAttribute("revid").toInt() > this->editToBeReverted->RevID)
+            if (this->editToBeReverted->RevID != WIKI_UNKNOWN_REVID && e->GetAttribute("revid").toLongLong() > this->editToBeReverted->RevID)
             {
-                HUGGLE_DEBUG("RevID " + QString::number(e->GetAttribute("revid").toInt()) + " > " + QString::number(this->editToBeReverted->RevID), 2);
+                HUGGLE_DEBUG("RevID " + e->GetAttribute("revid") + " > " + QString::number(this->editToBeReverted->RevID), 2);
                 if (Configuration::HuggleConfiguration->UserConfig->AutomaticallyResolveConflicts &&
                     Configuration::HuggleConfiguration->UserConfig->RevertNewBySame &&
                     e->Attributes.contains("user") &&
@@ -623,18 +640,26 @@ bool RevertQuery::ProcessRevert()
         this->DisplayError(_l("revert-cannotundo", this->editToBeReverted->Page->PageName));
         return true;
     }
+    if (HistoryCache::HuggleHistory)
+        HistoryCache::HuggleHistory->InsertHistory(this->GetSite(), this->editToBeReverted->Page->PageName, revisions);
+    return this->selectTarget(revisions);
+}
+
+bool RevertQuery::selectTarget(const QList<HistoryRevision> &revisions)
+{
+    this->SR_Depth = 0;
     // now we need to find the first revision that was done by some different user
-    //! \todo this list needs to be sorted by RevID
-    foreach (ApiQueryResultNode *node, revs)
+    foreach (HistoryRevision revision, revisions)
     {
-        if (!node->Attributes.contains("revid") || !node->Attributes.contains("user"))
+        if (revision.RevID == WIKI_UNKNOWN_REVID || revision.User.isEmpty())
         {
             // this is fucked up piece of shit
             this->DisplayError("Unable to revert the page " + this->editToBeReverted->Page->PageName + " because mediawiki returned some non-sense");
-            Huggle::Syslog::HuggleLogs->DebugLog("Nonsense: " + this->qHistoryInfo->Result->Data);
+            if (this->qHistoryInfo != nullptr)
+                Huggle::Syslog::HuggleLogs->DebugLog("Nonsense: " + this->qHistoryInfo->Result->Data);
             return true;
         }
-        QString sanitized = WikiUtil::SanitizeUser(node->GetAttribute("user"));
+        QString sanitized = WikiUtil::SanitizeUser(revision.User);
         // in case we are in depth higher than 0 (we passed out own edit) and we want to revert only 1 revision we exit
         if ((this->SR_Depth >= 1 && this->OneEditOnly) || sanitized != this->editToBeReverted->User->Username)
         {
@@ -644,7 +669,7 @@ bool RevertQuery::ProcessRevert()
                                              + sanitized + " != " + this->editToBeReverted->User->Username, 2);
             }
             // we got it, this is the revision we want to revert to
-            this->SR_RevID = node->GetAttribute("revid").toInt();
+            this->SR_RevID = revision.RevID;
             this->SR_Target = sanitized;
             break;
         }
@@ -663,15 +688,58 @@ bool RevertQuery::ProcessRevert()
         this->DisplayError(_l("revert-fail", this->editToBeReverted->Page->PageName, "because no previous version could be retrieved"));
         return true;
     }
+    this->SR_BaseTimestamp = revisions.first().Timestamp;
+    // text of previous revision is often known from computing of local diff
+    QString content;
+    if (RevisionTextCache::HuggleRevisionTexts)
+        content = RevisionTextCache::HuggleRevisionTexts->Get(this->GetSite(), this->editToBeReverted->Page->PageName, this->SR_RevID);
+    if (!content.isEmpty())
+    {
+        this->editToTarget(content);
+        return false;
+    }
     this->CustomStatus = "Retrieving content of previous version";
     // now we need to get the content of page
     this->qRetrieve = new ApiQuery(ActionQuery, this->GetSite());
+    this->qRetrieve->Priority = QueryPriority_UserAction;
     this->qRetrieve->Parameters = "prop=revisions&revids=" + QString::number(this->SR_RevID) + "&rvprop=" +
                                   QUrl::toPercentEncoding("ids|content");
     this->qRetrieve->Process();
     return false;
 }
 
+void RevertQuery::editToTarget(QString content)
+{
+    QString summary = this->Summary;
+    if (summary.isEmpty())
+        summary = this->GetSite()->GetProjectConfig()->SoftwareRevertDefaultSummary;
+    summary = summary.replace("$1", this->editToBeReverted->User->Username)
+            .replace("$2", this->SR_Target)
+            .replace("$3", QString::number(this->SR_Depth))
+            .replace("$4", QString::number(this->SR_RevID));
+    // we need to make sure there is edit suffix in revert summary for huggle
+    summary = Configuration::GenerateSuffix(summary, this->GetSite()->GetProjectConfig());
+    if (content.isEmpty())
+    {
+        /// \todo LOCALIZE ME
+        this->DisplayError("Cowardly refusing to blank \"" + this->editToBeReverted->Page->PageName +
+                           "\" software rollback was cancelled to prevent damage",
+                           "content was resolved to blank edit");
+        return;
+    }
+    this->eqSoftwareRollback = WikiUtil::EditPage(this->editToBeReverted->Page, content, summary, this->MinorEdit, this->SR_BaseTimestamp);
+    this->CustomStatus = _l("editing-page");
+}
+
+void RevertQuery::reportLatency()
+{
+    // Date is the time when user asked for the revert, it's not set for queries which weren't started from interface
+    QDateTime start = this->Date.isValid() ? this->Date : this->StartTime;
+    HUGGLE_DEBUG("Revert of " + this->editToBeReverted->Page->PageName + " finished in " +
+                 QString::number(start.msecsTo(QDateTime::currentDateTime())) + "ms" +
+                 (this->KnownHead ? ", preflight check was skipped" : ""), 1);
+}
+
 void RevertQuery::Rollback()
 {
     if (this->RollingBack)
@@ -739,9 +807,19 @@ QString RevertQuery::QueryTargetToString()
 
 void RevertQuery::Revert()
 {
+    QList<HistoryRevision> revisions;
+    // feed only tells us which revision is the newest, the history itself needs to be known up to it
+    if (this->isKnownHead() && HistoryCache::HuggleHistory->GetHistory(this->GetSite(), this->editToBeReverted->Page->PageName, 20, &revisions) &&
+            revisions.first().RevID == this->editToBeReverted->RevID)
+    {
+        HUGGLE_DEBUG("Using known history of " + this->editToBeReverted->Page->PageName + " for software rollback", 2);
+        this->selectTarget(revisions);
+        return;
+    }
     // Get a list of edits made to this page
     this->qHistoryInfo = new ApiQuery(ActionQuery, this->GetSite());
-    this->qHistoryInfo->Parameters = "prop=revisions&rvprop=" + QUrl::toPercentEncoding("ids|flags|timestamp|user|userid|content|size|sha1|comment")
+    this->qHistoryInfo->Priority = QueryPriority_UserAction;
+    this->qHistoryInfo->Parameters = "prop=revisions&rvprop=" + QUrl::toPercentEncoding("ids|flags|timestamp|user|userid|size|sha1|comment|tags")
                                     + "&rvlimit=20&titles=" + QUrl::toPercentEncoding(this->editToBeReverted->Page->PageName);
     this->qHistoryInfo->Process();
 }
@@ -16,6 +16,7 @@
 #include "apiquery.hpp"
 #include "collectable_smartptr.hpp"
 #include "editquery.hpp"
+#include "historycache.hpp"
 #include "mediawikiobject.hpp"
 #include "wikiedit.hpp"
 #include <QString>
@@ -65,11 +66,18 @@ namespace Huggle
         private:
             void DisplayError(QString error, QString reason = "");
             QString getCustomRevertStatus(bool *failed);
+            //! Returns true if live feed says that the edit we revert is still the newest revision of page
+            bool isKnownHead();
             void Preflight();
             void CheckPreflight();
             bool CheckRevert();
             void Cancel();
             bool ProcessRevert();
+            //! Find the revision made by a different user, revisions need to be sorted from newest
+            bool selectTarget(const QList<HistoryRevision> &revisions);
+            //! Software rollback to content of SR_RevID
+            void editToTarget(QString content);
+            void reportLatency();
             void Rollback();
             void Revert();
             void Exit();
@@ -86,9 +94,13 @@ namespace Huggle
             bool OneEditOnly = false;
             bool RollingBack = false;
             bool PreflightFinished = false;
-            int SR_RevID;
+            //! Preflight check was skipped because the edit was known to be the newest one
+            bool KnownHead = false;
+            revid_ht SR_RevID;
             int SR_Depth;
             QString SR_Target = "";
+            //! Timestamp of newest revision, mediawiki uses it to refuse the edit if someone else changed the page since
+            QString SR_BaseTimestamp;
     };
 
     inline WikiSite *RevertQuery::GetSite()
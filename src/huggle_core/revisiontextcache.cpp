@@ -0,0 +1,140 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "revisiontextcache.hpp"
+#include "wikisite.hpp"
+
+using namespace Huggle;
+
+RevisionTextCache *RevisionTextCache::HuggleRevisionTexts = nullptr;
+
+RevisionTextCache::RevisionTextCache(int max_pages, qint64 max_bytes)
+{
+    this->MaxPages = max_pages;
+    this->MaxBytes = max_bytes;
+}
+
+void RevisionTextCache::Insert(WikiSite *site, const QString &page, revid_ht revid, const QString &text)
+{
+    // text that would take the whole budget is not worth keeping
+    if (revid == WIKI_UNKNOWN_REVID || this->MaxPages < 1 || textSize(text) > this->MaxBytes)
+        return;
+    QString key = makeKey(site, page);
+    this->lock.lock();
+    PageRevisions &revisions = this->pages[key];
+    if (!revisions.RevIDs.contains(revid))
+    {
+        revisions.RevIDs.append(revid);
+        revisions.Texts.append(text);
+        this->size += textSize(text);
+        while (revisions.RevIDs.count() > HUGGLE_REVISION_CACHE_PAGE_REVS)
+        {
+            this->size -= textSize(revisions.Texts.takeFirst());
+            revisions.RevIDs.removeAt(0);
+        }
+    }
+    this->use(key);
+    this->lock.unlock();
+}
+
+bool RevisionTextCache::Contains(WikiSite *site, const QString &page, revid_ht revid)
+{
+    QString key = makeKey(site, page);
+    this->lock.lock();
+    bool result = this->pages.contains(key) && this->pages[key].RevIDs.contains(revid);
+    this->lock.unlock();
+    return result;
+}
+
+QString RevisionTextCache::Get(WikiSite *site, const QString &page, revid_ht revid)
+{
+    QString key = makeKey(site, page);
+    QString result;
+    this->lock.lock();
+    if (this->pages.contains(key))
+    {
+        const PageRevisions &revisions = this->pages[key];
+        int index = revisions.RevIDs.indexOf(revid);
+        if (index >= 0)
+            result = revisions.Texts.at(index);
+    }
+    this->lock.unlock();
+    return result;
+}
+
+bool RevisionTextCache::Touch(WikiSite *site, const QString &page)
+{
+    if (this->MaxPages < 1)
+        return false;
+    QString key = makeKey(site, page);
+    this->lock.lock();
+    bool hot = this->pages.contains(key) || this->seen.contains(key);
+    if (!hot)
+        this->seen.insert(key, true);
+    this->use(key);
+    this->lock.unlock();
+    return hot;
+}
+
+void RevisionTextCache::Clear()
+{
+    this->lock.lock();
+    this->pages.clear();
+    this->seen.clear();
+    this->order.clear();
+    this->size = 0;
+    this->lock.unlock();
+}
+
+int RevisionTextCache::Count()
+{
+    this->lock.lock();
+    int count = this->pages.count();
+    this->lock.unlock();
+    return count;
+}
+
+qint64 RevisionTextCache::GetSize()
+{
+    this->lock.lock();
+    qint64 size = this->size;
+    this->lock.unlock();
+    return size;
+}
+
+QString RevisionTextCache::makeKey(WikiSite *site, const QString &page)
+{
+    return site->Name + "|" + page;
+}
+
+qint64 RevisionTextCache::textSize(const QString &text)
+{
+    return static_cast<qint64>(text.size()) * static_cast<qint64>(sizeof(QChar));
+}
+
+void RevisionTextCache::use(const QString &key)
+{
+    this->order.removeOne(key);
+    this->order.append(key);
+    // page that was just used is last, so it's removed only if it doesn't fit in the budget alone
+    while (!this->order.isEmpty() && (this->order.count() > this->MaxPages || this->size > this->MaxBytes))
+        this->remove(this->order.takeFirst());
+}
+
+void RevisionTextCache::remove(const QString &key)
+{
+    if (this->pages.contains(key))
+    {
+        foreach (QString text, this->pages[key].Texts)
+            this->size -= textSize(text);
+        this->pages.remove(key);
+    }
+    this->seen.remove(key);
+}
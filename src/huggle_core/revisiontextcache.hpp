@@ -0,0 +1,76 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef REVISIONTEXTCACHE_HPP
+#define REVISIONTEXTCACHE_HPP
+
+#include "definitions.hpp"
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+// How many revisions of a single page we keep, we only ever need the previous one in order to diff against it
+#define HUGGLE_REVISION_CACHE_PAGE_REVS 2
+
+namespace Huggle
+{
+    class WikiSite;
+
+    //! Cache of wikitext of latest revisions of pages that were recently edited
+
+    //! Huggle sees most of the edits to busy pages, so if we remember the text of revision we
+    //! retrieved for previous edit, we can compute the diff of next edit locally (see DiffEngine)
+    //! instead of asking mediawiki to do that for us. The cache is bounded by number of pages and by
+    //! size of texts it holds, least recently used pages are removed first.
+    class HUGGLE_EX_CORE RevisionTextCache
+    {
+        public:
+            static RevisionTextCache *HuggleRevisionTexts;
+
+            RevisionTextCache(int max_pages = 200, qint64 max_bytes = 32 * 1024 * 1024);
+            void Insert(WikiSite *site, const QString &page, revid_ht revid, const QString &text);
+            bool Contains(WikiSite *site, const QString &page, revid_ht revid);
+            //! Returns text of revision or empty string if it's not cached
+            QString Get(WikiSite *site, const QString &page, revid_ht revid);
+            /*!
+             * \brief Touch records that the page was edited
+             * \return True if page was edited recently, so it's worth to fetch its text
+             */
+            bool Touch(WikiSite *site, const QString &page);
+            void Clear();
+            int Count();
+            //! Size of all texts in cache in bytes
+            qint64 GetSize();
+            int MaxPages;
+            qint64 MaxBytes;
+        private:
+            class PageRevisions
+            {
+                public:
+                    QList<revid_ht> RevIDs;
+                    QList<QString> Texts;
+            };
+            static QString makeKey(WikiSite *site, const QString &page);
+            static qint64 textSize(const QString &text);
+            void use(const QString &key);
+            void remove(const QString &key);
+            QHash<QString, PageRevisions> pages;
+            //! Pages that were edited recently but we don't have their text yet
+            QHash<QString, bool> seen;
+            //! Keys in order in which they were used, most recent at the end
+            QList<QString> order;
+            qint64 size = 0;
+            QMutex lock;
+    };
+}
+
+#endif // REVISIONTEXTCACHE_HPP
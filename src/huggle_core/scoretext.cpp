@@ -0,0 +1,340 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "scoretext.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HUGGLE_SCORETEXT_SSE2
+    #include <emmintrin.h>
+#endif
+// avx2 is only compiled for functions that are marked for it and used when cpu reports it
+#if defined(HUGGLE_SCORETEXT_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define HUGGLE_SCORETEXT_AVX2
+    #include <immintrin.h>
+#endif
+
+using namespace Huggle;
+
+/*!
+ * Kernel lower cases one block of characters and returns the mask of separators in it, it returns false without
+ * writing anything if the block contains character that needs to be handled separately, which is anything outside
+ * of ASCII and also start of tag or entity when markup is being removed
+ */
+typedef bool (*ScoreTextKernel)(const ushort *source, ushort *target, const ushort *separators, int separator_count, bool markup, quint32 *mask);
+
+class ScoreTextKernelInfo
+{
+    public:
+        QString Name;
+        ScoreTextKernel Process;
+        //! Number of characters in one block
+        int Width;
+};
+
+static bool scalarKernel(const ushort *source, ushort *target, const ushort *separators, int separator_count, bool markup, quint32 *mask)
+{
+    int i = 0;
+    while (i < 8)
+    {
+        ushort c = source[i++];
+        if (c > 0x7f || (markup && (c == '<' || c == '&')))
+            return false;
+    }
+    *mask = 0;
+    i = 0;
+    while (i < 8)
+    {
+        ushort c = source[i];
+        if (c >= 'A' && c <= 'Z')
+            c += 0x20;
+        target[i] = c;
+        int s = 0;
+        while (s < separator_count)
+        {
+            if (separators[s++] == c)
+            {
+                *mask |= 1u << i;
+                break;
+            }
+        }
+        i++;
+    }
+    return true;
+}
+
+#ifdef HUGGLE_SCORETEXT_SSE2
+static bool sse2Kernel(const ushort *source, ushort *target, const ushort *separators, int separator_count, bool markup, quint32 *mask)
+{
+    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    __m128i zero = _mm_setzero_si128();
+    __m128i simple = _mm_cmpeq_epi16(_mm_and_si128(chars, _mm_set1_epi16(static_cast<short>(0xff80))), zero);
+    if (markup)
+    {
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi16(chars, _mm_set1_epi16('<')), _mm_cmpeq_epi16(chars, _mm_set1_epi16('&')));
+        simple = _mm_andnot_si128(special, simple);
+    }
+    if (_mm_movemask_epi8(simple) != 0xffff)
+        return false;
+    // only ASCII is left here, so signed comparison is fine
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi16(chars, _mm_set1_epi16('A' - 1)), _mm_cmplt_epi16(chars, _mm_set1_epi16('Z' + 1)));
+    chars = _mm_add_epi16(chars, _mm_and_si128(upper, _mm_set1_epi16(0x20)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(target), chars);
+    __m128i found = zero;
+    int s = 0;
+    while (s < separator_count)
+        found = _mm_or_si128(found, _mm_cmpeq_epi16(chars, _mm_set1_epi16(static_cast<short>(separators[s++]))));
+    // every 16 bit lane is turned into one byte, so that movemask gives one bit per character
+    *mask = static_cast<quint32>(_mm_movemask_epi8(_mm_packs_epi16(found, zero)));
+    return true;
+}
+#endif
+
+#ifdef HUGGLE_SCORETEXT_AVX2
+__attribute__((target("avx2")))
+static bool avx2Kernel(const ushort *source, ushort *target, const ushort *separators, int separator_count, bool markup, quint32 *mask)
+{
+    __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+    __m256i zero = _mm256_setzero_si256();
+    __m256i simple = _mm256_cmpeq_epi16(_mm256_and_si256(chars, _mm256_set1_epi16(static_cast<short>(0xff80))), zero);
+    if (markup)
+    {
+        __m256i special = _mm256_or_si256(_mm256_cmpeq_epi16(chars, _mm256_set1_epi16('<')), _mm256_cmpeq_epi16(chars, _mm256_set1_epi16('&')));
+        simple = _mm256_andnot_si256(special, simple);
+    }
+    if (static_cast<quint32>(_mm256_movemask_epi8(simple)) != 0xffffffffu)
+        return false;
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi16(chars, _mm256_set1_epi16('A' - 1)), _mm256_cmpgt_epi16(_mm256_set1_epi16('Z' + 1), chars));
+    chars = _mm256_add_epi16(chars, _mm256_and_si256(upper, _mm256_set1_epi16(0x20)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(target), chars);
+    __m256i found = zero;
+    int s = 0;
+    while (s < separator_count)
+        found = _mm256_or_si256(found, _mm256_cmpeq_epi16(chars, _mm256_set1_epi16(static_cast<short>(separators[s++]))));
+    // packing works within each 128 bit half, so characters 0 - 7 end up in bits 0 - 7 and 8 - 15 in bits 16 - 23
+    quint32 packed = static_cast<quint32>(_mm256_movemask_epi8(_mm256_packs_epi16(found, zero)));
+    *mask = (packed & 0xff) | ((packed >> 8) & 0xff00);
+    return true;
+}
+#endif
+
+static ScoreTextKernelInfo selectKernel()
+{
+    ScoreTextKernelInfo kernel;
+    kernel.Name = "scalar";
+    kernel.Process = scalarKernel;
+    kernel.Width = 8;
+#ifdef HUGGLE_SCORETEXT_SSE2
+    kernel.Name = "sse2";
+    kernel.Process = sse2Kernel;
+#endif
+#ifdef HUGGLE_SCORETEXT_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernel.Name = "avx2";
+        kernel.Process = avx2Kernel;
+        kernel.Width = 16;
+    }
+#endif
+    return kernel;
+}
+
+static const ScoreTextKernelInfo &getKernel()
+{
+    static const ScoreTextKernelInfo kernel = selectKernel();
+    return kernel;
+}
+
+//! Decodes html entity at start of source, returns 0 if it isn't one
+static uint decodeEntity(const ushort *source, int length, int *consumed)
+{
+    int end = 1;
+    while (end < length && end < 10 && source[end] != ';')
+        end++;
+    if (end >= length || source[end] != ';')
+        return 0;
+    QString name = QString::fromUtf16(source + 1, end - 1);
+    uint c = 0;
+    if (name == "amp")
+        c = '&';
+    else if (name == "lt")
+        c = '<';
+    else if (name == "gt")
+        c = '>';
+    else if (name == "quot")
+        c = '"';
+    else if (name == "apos")
+        c = '\'';
+    else if (name == "nbsp")
+        c = 0xa0;
+    else if (name.startsWith("#x") || name.startsWith("#X"))
+        c = name.mid(2).toUInt(nullptr, 16);
+    else if (name.startsWith("#"))
+        c = name.mid(1).toUInt(nullptr, 10);
+    if (c == 0 || c > 0x10ffff)
+        return 0;
+    *consumed = end + 1;
+    return c;
+}
+
+QString ScoreText::GetKernel()
+{
+    return getKernel().Name;
+}
+
+ScoreText::ScoreText(const QString &source, const QString &separators, bool diff)
+{
+    foreach (QChar separator, separators)
+        this->separators.append(separator.unicode());
+    // markup and entities only make the text shorter, line breaks between cells take place of the markup
+    int capacity = source.length() + 1;
+    this->text = QString(capacity, Qt::Uninitialized);
+    this->target = reinterpret_cast<ushort*>(this->text.data());
+    this->bitmap.fill(0, capacity / 32 + 2);
+    const ushort *data = source.utf16();
+    if (diff && source.contains("class=\"diff-"))
+    {
+        int position = source.indexOf("diff-addedline");
+        while (position >= 0)
+        {
+            int start = source.indexOf('>', position);
+            if (start < 0)
+                break;
+            start++;
+            int end = source.indexOf("</td>", start);
+            if (end < 0)
+                end = source.length();
+            if (this->length > 0)
+            {
+                // words on different lines must not be joined
+                this->target[this->length] = '\n';
+                this->setSeparators(this->length++, 1, 1);
+            }
+            this->append(data + start, end - start, true);
+            position = source.indexOf("diff-addedline", end);
+        }
+    } else
+    {
+        this->append(data, source.length(), false);
+    }
+    this->text.resize(this->length);
+    this->target = nullptr;
+}
+
+bool ScoreText::IsSeparator(int position) const
+{
+    if (position < 0 || position >= this->length)
+        return true;
+    return (this->bitmap.at(position >> 5) >> (position & 31)) & 1;
+}
+
+bool ScoreText::ContainsWord(const QString &word) const
+{
+    if (word.isEmpty())
+        return false;
+    int length = word.length();
+    int position = this->text.indexOf(word);
+    // every occurrence of the word needs to be checked, because the first one may be just part of some other word
+    while (position >= 0)
+    {
+        if (this->IsSeparator(position - 1) && this->IsSeparator(position + length))
+            return true;
+        position = this->text.indexOf(word, position + 1);
+    }
+    return false;
+}
+
+bool ScoreText::Contains(const QString &part) const
+{
+    return this->text.contains(part);
+}
+
+const QString &ScoreText::GetText() const
+{
+    return this->text;
+}
+
+void ScoreText::append(const ushort *source, int length, bool markup)
+{
+    const ScoreTextKernelInfo &kernel = getKernel();
+    const ushort *separators = this->separators.constData();
+    int separator_count = this->separators.count();
+    int i = 0;
+    while (i < length)
+    {
+        quint32 mask;
+        if (i + kernel.Width <= length && kernel.Process(source + i, this->target + this->length, separators, separator_count, markup, &mask))
+        {
+            this->setSeparators(this->length, mask, kernel.Width);
+            this->length += kernel.Width;
+            i += kernel.Width;
+            continue;
+        }
+        i += this->appendCharacter(source + i, length - i, markup);
+    }
+}
+
+int ScoreText::appendCharacter(const ushort *source, int length, bool markup)
+{
+    ushort c = source[0];
+    if (markup && c == '<')
+    {
+        // tags are dropped without separating the text around them, changed part of a word is wrapped in <ins>
+        int end = 1;
+        while (end < length && source[end] != '>')
+            end++;
+        return qMin(end + 1, length);
+    }
+    if (markup && c == '&')
+    {
+        int consumed = 0;
+        uint decoded = decodeEntity(source, length, &consumed);
+        if (decoded)
+        {
+            this->put(decoded);
+            return consumed;
+        }
+    }
+    if (QChar::isHighSurrogate(c) && length > 1 && QChar::isLowSurrogate(source[1]))
+    {
+        this->put(QChar::surrogateToUcs4(c, source[1]));
+        return 2;
+    }
+    this->put(c);
+    return 1;
+}
+
+void ScoreText::put(uint ucs4)
+{
+    ucs4 = QChar::toLower(ucs4);
+    if (QChar::requiresSurrogates(ucs4))
+    {
+        // surrogates are never separators
+        this->target[this->length++] = QChar::highSurrogate(ucs4);
+        this->target[this->length++] = QChar::lowSurrogate(ucs4);
+        return;
+    }
+    ushort c = static_cast<ushort>(ucs4);
+    this->target[this->length] = c;
+    if (this->separators.contains(c))
+        this->setSeparators(this->length, 1, 1);
+    this->length++;
+}
+
+void ScoreText::setSeparators(int position, quint32 mask, int width)
+{
+    if (!mask)
+        return;
+    int word = position >> 5;
+    int shift = position & 31;
+    this->bitmap[word] |= mask << shift;
+    if (shift + width > 32)
+        this->bitmap[word + 1] |= mask >> (32 - shift);
+}
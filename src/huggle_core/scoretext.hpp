@@ -0,0 +1,60 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef SCORETEXT_HPP
+#define SCORETEXT_HPP
+
+#include "definitions.hpp"
+
+#include <QString>
+#include <QVector>
+
+namespace Huggle
+{
+    //! Text of edit prepared for matching of score words
+
+    //! The text is lower cased and word separators are marked in a bitmap in same pass, so that checking
+    //! the boundaries of a word is a single bit test. When the source is a diff table, only the added lines
+    //! are kept and their html markup is removed, so words in context or in removed lines don't score.
+    //! Blocks of ASCII are processed 8 or 16 characters at once using SSE2 or AVX2, depending on cpu,
+    //! everything else goes through QChar::toLower() one character at a time.
+    class HUGGLE_EX_CORE ScoreText
+    {
+        public:
+            //! Name of kernel that is used on this cpu, "avx2", "sse2" or "scalar"
+            static QString GetKernel();
+
+            /*!
+             * \param source Diff or plain text
+             * \param separators Every character of this string is a word separator
+             * \param diff If true and source is a diff table rendered by mediawiki, only added lines are kept
+             */
+            ScoreText(const QString &source, const QString &separators, bool diff = false);
+            //! Returns true if character at position is a separator, positions outside of text count as separators
+            bool IsSeparator(int position) const;
+            //! Returns true if word is contained in text and it's surrounded by separators or the start / end of text
+            bool ContainsWord(const QString &word) const;
+            bool Contains(const QString &part) const;
+            const QString &GetText() const;
+        private:
+            void append(const ushort *source, int length, bool markup);
+            int appendCharacter(const ushort *source, int length, bool markup);
+            void put(uint ucs4);
+            void setSeparators(int position, quint32 mask, int width);
+            QString text;
+            //! One bit for every character of text
+            QVector<quint32> bitmap;
+            QVector<ushort> separators;
+            ushort *target = nullptr;
+            int length = 0;
+    };
+}
+
+#endif // SCORETEXT_HPP
@@ -83,10 +83,11 @@ QJSValue JSMarshallingHelper::FromEdit(WikiEdit *edit, QJSEngine *engine, int po
     o.setProperty("Bot", QJSValue(edit->Bot));
     o.setProperty("CurrentUserWarningLevel", QJSValue(static_cast<int>(edit->CurrentUserWarningLevel)));
     o.setProperty("Diff", QJSValue(static_cast<int>(edit->Diff)));
-    o.setProperty("DiffText", QJSValue(edit->DiffText));
+    o.setProperty("DiffText", QJSValue(edit->GetDiffText()));
     o.setProperty("DiffText_IsSplit", QJSValue(edit->DiffText_IsSplit));
-    o.setProperty("DiffText_New", QJSValue(edit->DiffText_New));
-    o.setProperty("DiffText_Old", QJSValue(edit->DiffText_Old));
+    // split diffs were never produced, these stay for compatibility with existing scripts
+    o.setProperty("DiffText_New", QJSValue(QString()));
+    o.setProperty("DiffText_Old", QJSValue(QString()));
     o.setProperty("DiffTo", QJSValue(edit->DiffTo));
     o.setProperty("EditMadeByHuggle", QJSValue(edit->EditMadeByHuggle));
     o.setProperty("FullUrl", QJSValue(edit->GetFullUrl()));
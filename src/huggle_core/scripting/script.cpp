@@ -17,6 +17,7 @@
 #include "hugglejs.hpp"
 #include "huggleeditingjs.hpp"
 #include "hugglefeedjs.hpp"
+#include "scriptworker.hpp"
 #include "../wikiedit.hpp"
 #include "../configuration.hpp"
 #include "../localization.hpp"
@@ -25,13 +26,46 @@
 #include "../syslog.hpp"
 #include "../version.hpp"
 #include <climits>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QMutex>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QTimer>
 
 using namespace Huggle;
 
 QList<QString> Script::loadedPaths;
 QHash<QString, Script*> Script::scripts;
+QString Script::prelude;
+
+//! Reads one script file, scripts are independent of each other so that all of them can be read at same time
+class ScriptReader : public QRunnable
+{
+    public:
+        ScriptReader(QString path, QHash<QString, QString> *sources, QMutex *lock)
+        {
+            this->path = path;
+            this->sources = sources;
+            this->lock = lock;
+        }
+        void run()
+        {
+            QFile file(this->path);
+            if (!file.open(QFile::ReadOnly))
+                return;
+            QTextStream stream(&file);
+            QString source = stream.readAll();
+            file.close();
+            this->lock->lock();
+            this->sources->insert(this->path, source);
+            this->lock->unlock();
+        }
+    private:
+        QString path;
+        QHash<QString, QString> *sources;
+        QMutex *lock;
+};
 
 Script *Script::GetScriptByPath(QString path)
 {
@@ -92,6 +126,17 @@ QJSValue Script::ProcessURL(QUrl url)
     return script->ExternalCallback(function_name, parameters);
 }
 
+QHash<QString, QString> Script::ReadSources(QStringList paths)
+{
+    QHash<QString, QString> sources;
+    QMutex lock;
+    QThreadPool pool;
+    foreach (QString path, paths)
+        pool.start(new ScriptReader(path, &sources, &lock));
+    pool.waitForDone();
+    return sources;
+}
+
 Script::Script()
 {
     this->isUnsafe = hcfg->SystemConfig_UnsafeExts;
@@ -107,6 +152,7 @@ Script::~Script()
         Script::loadedPaths.removeAll(this->scriptPath);
     if (this->isLoaded && Script::scripts.contains(this->GetName()))
         Script::scripts.remove(this->scriptName);
+    delete this->worker;
     qDeleteAll(this->classes);
     delete this->memPool;
     delete this->engine;
@@ -455,6 +501,23 @@ bool Script::HookSubscribed(int hook)
     return this->attachedHooks.contains(hook);
 }
 
+QString Script::GetHookFunction(int hook)
+{
+    return this->attachedHooks.value(hook);
+}
+
+ScriptWorker *Script::GetWorker()
+{
+    return this->worker;
+}
+
+qint64 Script::GetCPUTime()
+{
+    if (this->worker)
+        return this->cpuTime + this->worker->GetCPUTime();
+    return this->cpuTime;
+}
+
 int Script::GetHookID(QString hook)
 {
     // Resolve hook ID from string ID
@@ -491,11 +554,13 @@ int Script::GetHookID(QString hook)
 bool Script::loadSource(QString source, QString *error)
 {
     // Prepend the built-in libs
-    source = Resources::GetResource("/huggle/text/ecma/help.js") + source;
-    source = Resources::GetResource("/huggle/text/ecma/huggle.js") + source;
-    source = Resources::GetResource("/huggle/text/ecma/types.js") + source;
+    if (Script::prelude.isEmpty())
+    {
+        Script::prelude = Resources::GetResource("/huggle/text/ecma/types.js") + Resources::GetResource("/huggle/text/ecma/huggle.js") +
+                          Resources::GetResource("/huggle/text/ecma/help.js");
+    }
 
-    this->sourceCode = source;
+    this->sourceCode = Script::prelude + source;
     this->engine = new QJSEngine();
 
     this->script_ptr = this->engine->evaluate(this->sourceCode);
@@ -596,6 +661,12 @@ bool Script::loadSource(QString source, QString *error)
         this->isWorking = false;
         return false;
     }
+    // the worker has its own copy of script, it can't call huggle functions so scripts must ask for it
+    if (hcfg->SystemConfig_ScriptWorkers && info.hasProperty("worker") && info.property("worker").toBool())
+    {
+        HUGGLE_DEBUG1("Starting worker thread for script " + this->GetName());
+        this->worker = new ScriptWorker(this, this->sourceCode);
+    }
     return true;
 }
 
@@ -634,7 +705,10 @@ QJSValue Script::executeFunction(QString function, QJSValueList parameters)
         HUGGLE_ERROR("JS error (" + this->GetName() + "): " + function + " is not a function");
         return fc;
     }
+    QElapsedTimer timer;
+    timer.start();
     QJSValue result = fc.call(parameters);
+    this->cpuTime += timer.elapsed();
     if (result.isError())
     {
         // There was some error during execution
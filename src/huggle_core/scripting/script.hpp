@@ -17,7 +17,9 @@
 
 #include "../definitions.hpp"
 #include "../exception.hpp"
+#include <QHash>
 #include <QJSEngine>
+#include <QStringList>
 #include <QUrl>
 
 // This is here for performance reasons only, we could have a list of attached hooks as list of strings
@@ -45,6 +47,7 @@ namespace Huggle
 {
     class GenericJSClass;
     class Script;
+    class ScriptWorker;
     class WikiEdit;
     class WikiSite;
     class WikiUser;
@@ -93,6 +96,11 @@ namespace Huggle
             static Script *GetScriptByName(QString name);
             static QList<Script*> GetScripts();
             static QJSValue ProcessURL(QUrl url);
+            /*!
+             * \brief ReadSources reads the files of scripts in thread pool, so that they can be passed to LoadSrc
+             * \return Source code of every file which could be read, indexed by its path
+             */
+            static QHash<QString, QString> ReadSources(QStringList paths);
 
             Script();
             virtual ~Script();
@@ -141,10 +149,18 @@ namespace Huggle
             void SubscribeHook(int hook, QString function_name);
             void UnsubscribeHook(int hook);
             bool HookSubscribed(int hook);
+            //! Name of JS function that is subscribed to hook
+            QString GetHookFunction(int hook);
+            //! Worker which runs score and queue hooks of this script, null if they run in main thread
+            ScriptWorker *GetWorker();
+            //! Milliseconds spent in functions of this script, including those running in its worker
+            qint64 GetCPUTime();
             virtual int GetHookID(QString hook);
         protected:
             static QList<QString> loadedPaths;
             static QHash<QString, Script*> scripts;
+            //! Built-in libraries which are prepended to source of every script, read from resources only once
+            static QString prelude;
             bool loadSource(QString source, QString *error);
             bool executeFunctionAsBool(QString function, QJSValueList parameters);
             bool executeFunctionAsBool(QString function);
@@ -159,6 +175,7 @@ namespace Huggle
             //! Makes all functions available to ECMA
             virtual void registerFunctions();
             QJSEngine *engine;
+            ScriptWorker *worker = nullptr;
             ScriptMemPool *memPool;
             QJSValue script_ptr;
             QList<QString> hooksExported;
@@ -175,6 +192,7 @@ namespace Huggle
             bool isWorking;
             bool isLoaded;
             bool isUnsafe;
+            qint64 cpuTime = 0;
             QHash<int, QString> attachedHooks;
     };
 }
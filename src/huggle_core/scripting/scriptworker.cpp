@@ -0,0 +1,316 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU Lesser General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU Lesser General Public License for more details.
+
+#include "scriptworker.hpp"
+#include "jsmarshallinghelper.hpp"
+#include "script.hpp"
+#include "../configuration.hpp"
+#include "../syslog.hpp"
+#include "../wikiedit.hpp"
+#include <QElapsedTimer>
+#include <QJSEngine>
+#include <QThread>
+
+using namespace Huggle;
+
+ScriptWorkerEngine::ScriptWorkerEngine(QString source)
+{
+    this->source = source;
+}
+
+ScriptWorkerEngine::~ScriptWorkerEngine()
+{
+    delete this->engine;
+}
+
+void ScriptWorkerEngine::Queue(int request)
+{
+    this->lock.lock();
+    this->queued.insert(request);
+    this->lock.unlock();
+}
+
+void ScriptWorkerEngine::Cancel(int request)
+{
+    this->lock.lock();
+    if (this->running == request)
+    {
+#if QT_VERSION >= 0x050E00
+        this->engine->setInterrupted(true);
+#endif
+    } else
+    {
+        // request which already finished isn't there, so nothing is kept for it
+        this->queued.remove(request);
+    }
+    this->lock.unlock();
+}
+
+int ScriptWorkerEngine::GetQueued()
+{
+    this->lock.lock();
+    int queued = this->queued.count();
+    this->lock.unlock();
+    return queued;
+}
+
+int ScriptWorkerEngine::GetRunning(qint64 *started)
+{
+    this->lock.lock();
+    int request = this->running;
+    *started = this->runningSince;
+    this->lock.unlock();
+    return request;
+}
+
+void ScriptWorkerEngine::Init()
+{
+    QJSEngine *e = new QJSEngine();
+    QJSValue result = e->evaluate(this->source);
+    this->source.clear();
+    if (result.isError())
+    {
+        delete e;
+        emit this->Loaded(false, "syntax error at line " + QString::number(result.property("lineNumber").toInt()) + ": " + result.toString());
+        return;
+    }
+    this->lock.lock();
+    this->engine = e;
+    this->lock.unlock();
+    emit this->Loaded(true, "");
+}
+
+void ScriptWorkerEngine::Execute(int request, QString function, QVariant edit)
+{
+    this->lock.lock();
+    if (!this->queued.remove(request) || this->engine == nullptr)
+    {
+        this->lock.unlock();
+        return;
+    }
+    this->running = request;
+    this->runningSince = QDateTime::currentMSecsSinceEpoch();
+    this->lock.unlock();
+
+    QElapsedTimer timer;
+    timer.start();
+    QVariant result;
+    QString error;
+    QJSValue fc = this->engine->globalObject().property(function);
+    if (!fc.isCallable())
+    {
+        error = function + " is not a function";
+    } else
+    {
+        QJSValue r = fc.call(QJSValueList() << this->engine->toScriptValue(edit));
+        if (r.isError())
+            error = "line " + QString::number(r.property("lineNumber").toInt()) + ": " + r.toString();
+        else
+            result = r.toVariant();
+    }
+
+    this->lock.lock();
+    this->running = -1;
+#if QT_VERSION >= 0x050E00
+    this->engine->setInterrupted(false);
+#endif
+    this->lock.unlock();
+    emit this->Finished(request, result, error, static_cast<int>(timer.elapsed()));
+}
+
+ScriptWorker::ScriptWorker(Script *script, QString source)
+{
+    this->script = script;
+    this->thread = new QThread();
+    this->engine = new ScriptWorkerEngine(source);
+    this->engine->moveToThread(this->thread);
+    connect(this->thread, SIGNAL(started()), this->engine, SLOT(Init()));
+    // engine must be deleted in its own thread, finished() is still delivered there
+    connect(this->thread, SIGNAL(finished()), this->engine, SLOT(deleteLater()));
+    connect(this, SIGNAL(execute(int,QString,QVariant)), this->engine, SLOT(Execute(int,QString,QVariant)));
+    connect(this->engine, SIGNAL(Loaded(bool,QString)), this, SLOT(OnLoaded(bool,QString)));
+    connect(this->engine, SIGNAL(Finished(int,QVariant,QString,int)), this, SLOT(OnFinished(int,QVariant,QString,int)));
+    this->thread->start();
+}
+
+ScriptWorker::~ScriptWorker()
+{
+    qint64 started;
+    int running = this->engine->GetRunning(&started);
+    if (running >= 0)
+        this->engine->Cancel(running);
+    this->thread->quit();
+    if (!this->thread->wait(static_cast<unsigned long>(qMax(1000, hcfg->SystemConfig_ScriptHookTimeout * 2))))
+    {
+        // hook can't be interrupted by this version of Qt
+        HUGGLE_WARNING("Script worker of " + this->script->GetName() + " didn't stop, terminating it");
+        this->thread->terminate();
+        this->thread->wait();
+    }
+    delete this->thread;
+}
+
+int ScriptWorker::Submit(int hook, WikiEdit *edit)
+{
+    if (!this->working || !this->script->HookSubscribed(hook))
+        return -1;
+    if (this->pending.count() >= HUGGLE_SCRIPT_WORKER_QUEUE)
+    {
+        HUGGLE_DEBUG("Script worker of " + this->script->GetName() + " is too busy, skipping edit " + QString::number(edit->RevID), 2);
+        return -1;
+    }
+    // data are copied using engine of main thread, so that they are same as those given to hooks running there
+    QVariant data = JSMarshallingHelper::FromEdit(edit, this->script->GetEngine(), -1).toVariant();
+    int request = this->lastRequest++;
+    this->pending.insert(request);
+    this->engine->Queue(request);
+    emit this->execute(request, this->script->GetHookFunction(hook), data);
+    return request;
+}
+
+bool ScriptWorker::TakeResult(int request, QVariant *result)
+{
+    this->checkTimeout();
+    if (this->pending.contains(request))
+        return false;
+    *result = this->results.take(request);
+    return true;
+}
+
+bool ScriptWorker::IsWorking()
+{
+    return this->working;
+}
+
+qint64 ScriptWorker::GetCPUTime()
+{
+    return this->cpuTime;
+}
+
+int ScriptWorker::GetTimeouts()
+{
+    return this->timeouts;
+}
+
+int ScriptWorker::GetPending()
+{
+    return this->pending.count();
+}
+
+void ScriptWorker::OnLoaded(bool success, QString error)
+{
+    if (!success)
+        this->stop("unable to load script: " + error);
+}
+
+void ScriptWorker::OnFinished(int request, QVariant result, QString error, int time)
+{
+    this->cpuTime += time;
+    // requests that timed out were already answered
+    if (!this->pending.remove(request))
+        return;
+    if (!error.isEmpty())
+        HUGGLE_ERROR("JS error (" + this->script->GetName() + ", worker): " + error);
+    this->results.insert(request, result);
+}
+
+void ScriptWorker::checkTimeout()
+{
+    if (!this->working)
+        return;
+    qint64 started;
+    int running = this->engine->GetRunning(&started);
+    if (running < 0 || !this->pending.contains(running) ||
+            QDateTime::currentMSecsSinceEpoch() - started < hcfg->SystemConfig_ScriptHookTimeout)
+        return;
+    this->engine->Cancel(running);
+    this->pending.remove(running);
+    this->results.insert(running, QVariant());
+    this->timeouts++;
+    HUGGLE_WARNING("Hook of script " + this->script->GetName() + " didn't finish in " + QString::number(hcfg->SystemConfig_ScriptHookTimeout) + "ms, ignoring it");
+#if QT_VERSION >= 0x050E00
+    if (this->timeouts < HUGGLE_SCRIPT_WORKER_MAX_TIMEOUTS)
+        return;
+#endif
+    this->stop("hooks exceeded the time limit " + QString::number(this->timeouts) + " times");
+}
+
+void ScriptWorker::stop(QString reason)
+{
+    HUGGLE_ERROR("Script worker of " + this->script->GetName() + " was stopped: " + reason);
+    this->working = false;
+    // nothing is going to be answered anymore
+    foreach (int request, this->pending)
+        this->results.insert(request, QVariant());
+    this->pending.clear();
+}
+
+ScriptHookJob::ScriptHookJob(WikiEdit *edit)
+{
+    this->edit = edit;
+    QList<int> hooks;
+    hooks << HUGGLE_SCRIPT_HOOK_EDIT_RESCORE << HUGGLE_SCRIPT_HOOK_EDIT_LOAD_TO_QUEUE;
+    foreach (Script *script, Script::GetScripts())
+    {
+        ScriptWorker *worker = script->GetWorker();
+        if (worker == nullptr || !script->IsWorking())
+            continue;
+        foreach (int hook, hooks)
+        {
+            Request request;
+            request.ID = worker->Submit(hook, edit);
+            if (request.ID < 0)
+                continue;
+            request.Worker = worker;
+            request.ScriptName = script->GetName();
+            request.Hook = hook;
+            this->requests.append(request);
+        }
+    }
+}
+
+bool ScriptHookJob::IsFinished()
+{
+    int i = 0;
+    while (i < this->requests.count())
+    {
+        Request &request = this->requests[i];
+        QVariant result;
+        // worker is gone when its script was unloaded
+        if (!request.Worker.isNull() && !request.Worker->TakeResult(request.ID, &result))
+        {
+            i++;
+            continue;
+        }
+        if (result.isValid())
+        {
+            if (request.Hook == HUGGLE_SCRIPT_HOOK_EDIT_LOAD_TO_QUEUE)
+            {
+                if (!result.toBool())
+                    this->rejected = true;
+            } else if (result.userType() == QMetaType::Int || result.userType() == QMetaType::Double)
+            {
+                int score = result.toInt();
+                if (score)
+                {
+                    this->edit->Score += static_cast<long>(score);
+                    this->edit->PropertyBag.insert("score_js_" + request.ScriptName, score);
+                }
+            }
+        }
+        this->requests.removeAt(i);
+    }
+    return this->requests.isEmpty();
+}
+
+bool ScriptHookJob::IsRejected()
+{
+    return this->rejected;
+}
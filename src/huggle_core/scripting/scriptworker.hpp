@@ -0,0 +1,141 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU Lesser General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU Lesser General Public License for more details.
+
+#ifndef SCRIPTWORKER_HPP
+#define SCRIPTWORKER_HPP
+
+#include "../definitions.hpp"
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+
+// Maximum number of hooks that may wait for one worker, edits are not given to worker which is this far behind
+#define HUGGLE_SCRIPT_WORKER_QUEUE 50
+// Worker is stopped when its hooks exceeded the time limit this many times
+#define HUGGLE_SCRIPT_WORKER_MAX_TIMEOUTS 5
+
+class QJSEngine;
+class QThread;
+
+namespace Huggle
+{
+    class Script;
+    class WikiEdit;
+
+    //! Part of ScriptWorker that lives in its thread, it owns the engine so that nothing else may touch it
+    class HUGGLE_EX_CORE ScriptWorkerEngine : public QObject
+    {
+            Q_OBJECT
+        public:
+            ScriptWorkerEngine(QString source);
+            ~ScriptWorkerEngine();
+            //! Thread safe, request must be queued before it's sent to Execute, requests which weren't queued are skipped
+            void Queue(int request);
+            //! Thread safe, request which is running is interrupted, the one which is waiting is skipped
+            void Cancel(int request);
+            //! Thread safe, number of requests which were queued and didn't start yet
+            int GetQueued();
+            //! Thread safe, returns id of request that is running right now or -1, started is time when it started
+            int GetRunning(qint64 *started);
+        public slots:
+            void Init();
+            void Execute(int request, QString function, QVariant edit);
+        signals:
+            void Loaded(bool success, QString error);
+            void Finished(int request, QVariant result, QString error, int time);
+        private:
+            QJSEngine *engine = nullptr;
+            QString source;
+            //! Requests which wait for execution, cancelled ones are removed so that they are skipped
+            QSet<int> queued;
+            int running = -1;
+            qint64 runningSince = 0;
+            QMutex lock;
+    };
+
+    /*!
+     * \brief ScriptWorker runs score and queue hooks of one script in a thread of its own
+     *
+     * The thread has its own copy of the script in separate engine which has no access to huggle
+     * functions, hooks only get a copy of the edit and return their result, so a slow script
+     * doesn't block the user interface. Scripts need to allow this by setting "worker" in their info.
+     * Every hook has limited time to finish, hooks that run longer are interrupted and their result
+     * is ignored, worker which exceeds the limit too often is stopped.
+     */
+    class HUGGLE_EX_CORE ScriptWorker : public QObject
+    {
+            Q_OBJECT
+        public:
+            ScriptWorker(Script *script, QString source);
+            ~ScriptWorker();
+            //! Queue the hook, returns id of request that is used to take the result, -1 if it wasn't queued
+            int Submit(int hook, WikiEdit *edit);
+            /*!
+             * \brief TakeResult checks if request is done
+             * \param result Result of hook, invalid if it failed or it didn't finish in time
+             * \return True if request is done and its result was removed from worker
+             */
+            bool TakeResult(int request, QVariant *result);
+            bool IsWorking();
+            //! Milliseconds spent in hooks of this worker
+            qint64 GetCPUTime();
+            int GetTimeouts();
+            int GetPending();
+        signals:
+            void execute(int request, QString function, QVariant edit);
+        private slots:
+            void OnLoaded(bool success, QString error);
+            void OnFinished(int request, QVariant result, QString error, int time);
+        private:
+            void checkTimeout();
+            void stop(QString reason);
+            Script *script;
+            QThread *thread;
+            ScriptWorkerEngine *engine;
+            QSet<int> pending;
+            QHash<int, QVariant> results;
+            qint64 cpuTime = 0;
+            int lastRequest = 0;
+            int timeouts = 0;
+            bool working = true;
+    };
+
+    //! Hooks of one edit which were given to script workers, the edit is kept in pipeline until they are done
+    class HUGGLE_EX_CORE ScriptHookJob
+    {
+        public:
+            ScriptHookJob(WikiEdit *edit);
+            //! Collects results of workers, once all of them are known they are applied to the edit
+            bool IsFinished();
+            //! True if some script doesn't want the edit to be loaded to queue
+            bool IsRejected();
+        private:
+            class Request
+            {
+                public:
+                    QPointer<ScriptWorker> Worker;
+                    QString ScriptName;
+                    int Hook;
+                    int ID;
+            };
+            WikiEdit *edit;
+            QList<Request> requests;
+            bool rejected = false;
+    };
+}
+
+#endif // SCRIPTWORKER_HPP
@@ -40,7 +40,7 @@ void Syslog::Log(QString Message, bool TerminalOnly, HuggleLogType Type)
 {
     QString d = QDateTime::currentDateTime().toString();
     QString message = d + "   " + Message;
-    if (Type == HuggleLogType_Error)
+    if (Type == HuggleLogType_Error || this->TerminalStderr)
     {
         std::cerr << message.toStdString() << std::endl;
     } else
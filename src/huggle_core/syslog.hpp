@@ -116,6 +116,8 @@ namespace Huggle
             //! Mutex we lock unwritten logs with so that only 1 thread can write to it
             QMutex *lUnwrittenLogs;
             bool EnableLogWriteBuffer;
+            //! Write all terminal output to stderr, so that stdout can be used for machine readable output
+            bool TerminalStderr = false;
         protected:
             //! Ring log is a buffer that contains system messages
             QList<HuggleLog_Line> RingLog;
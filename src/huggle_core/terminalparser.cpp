@@ -14,6 +14,7 @@
 #include "configuration.hpp"
 #include "core.hpp"
 #include "resources.hpp"
+#include "trafficcapture.hpp"
 using namespace Huggle;
 using namespace std;
 
@@ -81,11 +82,6 @@ bool TerminalParser::Parse()
             Configuration::HuggleConfiguration->SystemConfig_SafeMode = true;
             valid = true;
         }
-        if (text == "--language-test")
-        {
-            Configuration::HuggleConfiguration->SystemConfig_LanguageSanity = true;
-            valid = true;
-        }
         if (text == "--override-conf")
         {
             if (this->args.count() > x + 1 && !this->args.at(x + 1).startsWith("-"))
@@ -143,6 +139,35 @@ bool TerminalParser::Parse()
             }
             valid = true;
         }
+        if (text == "--record" || text == "--replay")
+        {
+            if (this->args.count() > x + 1 && !this->args.at(x + 1).startsWith("-"))
+            {
+                if (text == "--record")
+                    Configuration::HuggleConfiguration->TrafficRecordPath = this->args.at(x + 1);
+                else
+                    Configuration::HuggleConfiguration->TrafficReplayPath = this->args.at(x + 1);
+                valid = true;
+                ++x;
+            } else
+            {
+                cerr << "Parameter " << text.toStdString() << " requires an argument for it to work!" << endl;
+                return true;
+            }
+        }
+        if (text == "--replay-speed")
+        {
+            bool ok = false;
+            if (this->args.count() > x + 1)
+                Configuration::HuggleConfiguration->TrafficReplaySpeed = TrafficReplay::ParseSpeed(this->args.at(x + 1), &ok);
+            if (!ok)
+            {
+                cerr << "Parameter --replay-speed requires a speed, such as 1, 4x or max" << endl;
+                return true;
+            }
+            valid = true;
+            ++x;
+        }
         if (text == "--chroot")
         {
             if (this->args.count() > x + 1 && !this->args.at(x + 1).startsWith("-"))
@@ -266,11 +291,13 @@ void TerminalParser::DisplayHelp()
             "  --login-file:    Read a username and password from plain text file, separated by a colon\n"\
             "  -h | --help:     Display this help\n\n"\
             "Debugging options:\n"\
-            "  --language-test: Will perform CPU expensive language test on startup, which reports\n"\
-            "                   warnings found in localization files. This option is useful for\n"\
-            "                   developers and people who create localization files\n"\
             "  --dot:           Debug on terminal only mode\n"\
             "  --qd [file]:     Write all transferred data to a file\n"\
+            "  --record <file>: Record feed and api traffic with timing to a compressed capture file\n"\
+            "                   the capture contains session tokens, so don't share it publicly\n"\
+            "  --replay <file>: Serve feed and api traffic from capture file instead of network\n"\
+            "  --replay-speed <speed>:\n"\
+            "                   Speed of replay, for example 1 (default), 4x or max\n"\
             "  --override-conf [page]:\n"\
             "                   Will override the wiki configuration path, useful for testing of new config\n"\
             "\nPython related:\n"\
@@ -0,0 +1,295 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "trafficcapture.hpp"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QMutex>
+#include "wikisite.hpp"
+
+using namespace Huggle;
+
+#define TRAFFIC_MAGIC "HGTRAFFIC"
+#define TRAFFIC_VERSION 1
+// Size of uncompressed block after which it's written to disk
+#define TRAFFIC_BLOCK_SIZE 262144
+
+TrafficRecorder *TrafficRecorder::Recorder = nullptr;
+TrafficReplay *TrafficReplay::Replay = nullptr;
+
+QByteArray TrafficRecord::MakeKey(const QByteArray &method, const QByteArray &url, const QByteArray &body)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(method);
+    hash.addData("\n");
+    hash.addData(url);
+    hash.addData("\n");
+    hash.addData(body);
+    return hash.result();
+}
+
+QDataStream &Huggle::operator<<(QDataStream &stream, const TrafficRecord &record)
+{
+    stream << record.Type << record.Time << record.Site << record.Provider << record.Method << record.URL << record.Body
+           << record.Data << record.Duration << record.HttpStatus << record.Error << record.ErrorString << record.Hidden;
+    return stream;
+}
+
+QDataStream &Huggle::operator>>(QDataStream &stream, TrafficRecord &record)
+{
+    stream >> record.Type >> record.Time >> record.Site >> record.Provider >> record.Method >> record.URL >> record.Body
+           >> record.Data >> record.Duration >> record.HttpStatus >> record.Error >> record.ErrorString >> record.Hidden;
+    return stream;
+}
+
+TrafficRecorder::TrafficRecorder()
+{
+    this->lock = new QMutex(QMutex::Recursive);
+}
+
+TrafficRecorder::~TrafficRecorder()
+{
+    this->Close();
+    delete this->lock;
+}
+
+bool TrafficRecorder::Open(QString path, QString *error)
+{
+    QMutexLocker locker(this->lock);
+    if (this->file != nullptr)
+    {
+        *error = "Capture file is already open";
+        return false;
+    }
+    this->file = new QFile(path);
+    if (!this->file->open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        *error = this->file->errorString();
+        delete this->file;
+        this->file = nullptr;
+        return false;
+    }
+    QDataStream header(this->file);
+    header.writeRawData(TRAFFIC_MAGIC, static_cast<int>(qstrlen(TRAFFIC_MAGIC)));
+    header << static_cast<quint32>(TRAFFIC_VERSION);
+    this->stream = new QDataStream(&this->block, QIODevice::WriteOnly);
+    this->clock.start();
+    return true;
+}
+
+void TrafficRecorder::Close()
+{
+    QMutexLocker locker(this->lock);
+    if (this->file == nullptr)
+        return;
+    this->flush();
+    this->file->close();
+    delete this->stream;
+    delete this->file;
+    this->stream = nullptr;
+    this->file = nullptr;
+}
+
+void TrafficRecorder::RecordFeedLine(WikiSite *site, int provider, const QByteArray &line)
+{
+    TrafficRecord record;
+    record.Type = TrafficRecord::TypeFeed;
+    record.Site = site->Name;
+    record.Provider = provider;
+    record.Data = line;
+    QMutexLocker locker(this->lock);
+    if (this->file == nullptr)
+        return;
+    record.Time = this->clock.elapsed();
+    this->write(record);
+}
+
+void TrafficRecorder::RecordRequest(TrafficRecord record)
+{
+    record.Type = TrafficRecord::TypeApi;
+    QMutexLocker locker(this->lock);
+    if (this->file == nullptr)
+        return;
+    record.Time = qMax(static_cast<qint64>(0), this->clock.elapsed() - record.Duration);
+    this->write(record);
+}
+
+unsigned long long TrafficRecorder::GetRecordCount()
+{
+    QMutexLocker locker(this->lock);
+    return this->records;
+}
+
+void TrafficRecorder::write(TrafficRecord &record)
+{
+    *this->stream << record;
+    this->records++;
+    if (this->block.size() >= TRAFFIC_BLOCK_SIZE)
+        this->flush();
+}
+
+void TrafficRecorder::flush()
+{
+    if (this->block.isEmpty())
+        return;
+    QByteArray compressed = qCompress(this->block);
+    QDataStream out(this->file);
+    out << static_cast<quint32>(compressed.size());
+    out.writeRawData(compressed.constData(), compressed.size());
+    this->file->flush();
+    // the stream keeps its position in the buffer, so it has to be recreated
+    delete this->stream;
+    this->block.clear();
+    this->stream = new QDataStream(&this->block, QIODevice::WriteOnly);
+}
+
+double TrafficReplay::ParseSpeed(QString text, bool *ok)
+{
+    text = text.trimmed().toLower();
+    *ok = true;
+    if (text == "max")
+        return 0;
+    if (text.endsWith("x"))
+        text.chop(1);
+    double speed = text.toDouble(ok);
+    if (*ok && speed <= 0)
+        *ok = false;
+    return speed;
+}
+
+TrafficReplay::TrafficReplay(double speed)
+{
+    this->Speed = speed;
+    this->lock = new QMutex(QMutex::Recursive);
+}
+
+TrafficReplay::~TrafficReplay()
+{
+    delete this->lock;
+}
+
+bool TrafficReplay::Load(QString path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        *error = file.errorString();
+        return false;
+    }
+    QDataStream in(&file);
+    QByteArray magic(static_cast<int>(qstrlen(TRAFFIC_MAGIC)), '\0');
+    quint32 version = 0;
+    in.readRawData(magic.data(), magic.size());
+    in >> version;
+    if (magic != TRAFFIC_MAGIC || version != TRAFFIC_VERSION)
+    {
+        *error = "Not a traffic capture file, or unsupported version";
+        return false;
+    }
+    QMutexLocker locker(this->lock);
+    while (!in.atEnd())
+    {
+        quint32 size;
+        in >> size;
+        QByteArray compressed(static_cast<int>(size), '\0');
+        if (in.readRawData(compressed.data(), compressed.size()) != compressed.size())
+        {
+            *error = "Capture file is truncated";
+            return false;
+        }
+        QByteArray block = qUncompress(compressed);
+        if (block.isEmpty())
+        {
+            *error = "Capture file is corrupted";
+            return false;
+        }
+        QDataStream records(block);
+        while (!records.atEnd())
+        {
+            TrafficRecord record;
+            records >> record;
+            if (records.status() != QDataStream::Ok)
+            {
+                *error = "Capture file contains invalid record";
+                return false;
+            }
+            if (record.Type == TrafficRecord::TypeFeed)
+            {
+                if (this->feedStart < 0 || record.Time < this->feedStart)
+                    this->feedStart = record.Time;
+                this->feed[record.Site].append(record);
+            } else
+            {
+                this->responses[TrafficRecord::MakeKey(record.Method, record.URL, record.Body)].append(record);
+            }
+        }
+    }
+    return true;
+}
+
+bool TrafficReplay::GetResponse(const QByteArray &method, const QByteArray &url, const QByteArray &body, TrafficRecord *record)
+{
+    QMutexLocker locker(this->lock);
+    QByteArray key = TrafficRecord::MakeKey(method, url, body);
+    if (!this->responses.contains(key))
+    {
+        // body of hidden queries wasn't recorded
+        key = TrafficRecord::MakeKey(method, url, QByteArray());
+        if (!this->responses.contains(key) || !this->responses[key].first().Hidden)
+        {
+            this->ResponsesMissing++;
+            return false;
+        }
+    }
+    QList<TrafficRecord> &list = this->responses[key];
+    // same request can be made many times with different results, we serve them in the order they were
+    // recorded and keep repeating the last one once we run out of them
+    if (list.count() > 1)
+        *record = list.takeFirst();
+    else
+        *record = list.first();
+    this->ResponsesServed++;
+    return true;
+}
+
+qint64 TrafficReplay::GetDelay(const TrafficRecord &record)
+{
+    if (this->Speed <= 0)
+        return 0;
+    return static_cast<qint64>(record.Duration / this->Speed);
+}
+
+bool TrafficReplay::TakeFeedLine(const QString &site, TrafficRecord *record)
+{
+    QMutexLocker locker(this->lock);
+    if (!this->feed.contains(site) || this->feed[site].isEmpty())
+        return false;
+    if (!this->feedClock.isValid())
+        this->feedClock.start();
+    QList<TrafficRecord> &lines = this->feed[site];
+    if (this->Speed > 0 && (lines.first().Time - this->feedStart) / this->Speed > this->feedClock.elapsed())
+        return false;
+    *record = lines.takeFirst();
+    return true;
+}
+
+bool TrafficReplay::HasFeedLines(const QString &site)
+{
+    QMutexLocker locker(this->lock);
+    return this->feed.contains(site) && !this->feed[site].isEmpty();
+}
+
+QString TrafficReplay::GetStatistics()
+{
+    QMutexLocker locker(this->lock);
+    return "served " + QString::number(this->ResponsesServed) + " responses, " + QString::number(this->ResponsesMissing) +
+           " requests were not found in capture";
+}
@@ -0,0 +1,131 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef TRAFFICCAPTURE_HPP
+#define TRAFFICCAPTURE_HPP
+
+#include "definitions.hpp"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class QDataStream;
+class QFile;
+class QMutex;
+
+namespace Huggle
+{
+    class WikiSite;
+
+    //! One line of recent changes feed or one api request together with its response
+    class HUGGLE_EX_CORE TrafficRecord
+    {
+        public:
+            enum RecordType
+            {
+                TypeFeed = 1,
+                TypeApi = 2
+            };
+
+            //! Key that is used to find response to the same request during replay
+            static QByteArray MakeKey(const QByteArray &method, const QByteArray &url, const QByteArray &body);
+            quint8 Type = TypeFeed;
+            //! Time since start of recording in milliseconds, requests have time when they were sent
+            qint64 Time = 0;
+            QString Site;
+            //! ID of provider which received the feed line
+            qint32 Provider = 0;
+            QByteArray Method;
+            QByteArray URL;
+            QByteArray Body;
+            //! Feed line, or content of response
+            QByteArray Data;
+            //! How long it took to receive the response in milliseconds
+            qint64 Duration = 0;
+            qint32 HttpStatus = 0;
+            //! QNetworkReply::NetworkError of the response
+            qint32 Error = 0;
+            QString ErrorString;
+            //! Body of request contained credentials and wasn't stored
+            bool Hidden = false;
+    };
+
+    HUGGLE_EX_CORE QDataStream &operator<<(QDataStream &stream, const TrafficRecord &record);
+    HUGGLE_EX_CORE QDataStream &operator>>(QDataStream &stream, TrafficRecord &record);
+
+    //! Writes feed lines and api traffic of a session to a capture file
+
+    //! Capture file starts with a header which is followed by blocks of records compressed with
+    //! zlib, so that even long sessions produce files of reasonable size. Capture contains session
+    //! tokens and content of every page that was loaded, but never passwords.
+    class HUGGLE_EX_CORE TrafficRecorder
+    {
+        public:
+            static TrafficRecorder *Recorder;
+
+            TrafficRecorder();
+            ~TrafficRecorder();
+            bool Open(QString path, QString *error);
+            //! Write all remaining records and close the file
+            void Close();
+            void RecordFeedLine(WikiSite *site, int provider, const QByteArray &line);
+            //! Store a finished request, time of record is computed from its duration
+            void RecordRequest(TrafficRecord record);
+            unsigned long long GetRecordCount();
+        private:
+            void write(TrafficRecord &record);
+            void flush();
+            QFile *file = nullptr;
+            QByteArray block;
+            QDataStream *stream = nullptr;
+            QElapsedTimer clock;
+            QMutex *lock;
+            unsigned long long records = 0;
+    };
+
+    //! Serves traffic from a capture file, instead of network
+
+    //! Feed lines are released with same spacing as they were recorded, divided by speed, and responses
+    //! are delayed by their recorded duration, also divided by speed. Speed 0 means as fast as possible.
+    class HUGGLE_EX_CORE TrafficReplay
+    {
+        public:
+            static TrafficReplay *Replay;
+            //! Converts text like 2, 2x or max to speed, max is returned as 0
+            static double ParseSpeed(QString text, bool *ok);
+
+            TrafficReplay(double speed);
+            ~TrafficReplay();
+            bool Load(QString path, QString *error);
+            //! Find recorded response to request, every response is served once except for the last one for each request
+            bool GetResponse(const QByteArray &method, const QByteArray &url, const QByteArray &body, TrafficRecord *record);
+            //! Returns in how many milliseconds the response should be delivered
+            qint64 GetDelay(const TrafficRecord &record);
+            //! Take next feed line of the site if it's due, the feed clock starts with first call of this function
+            bool TakeFeedLine(const QString &site, TrafficRecord *record);
+            bool HasFeedLines(const QString &site);
+            QString GetStatistics();
+            double Speed;
+            unsigned long long ResponsesServed = 0;
+            unsigned long long ResponsesMissing = 0;
+        private:
+            QHash<QByteArray, QList<TrafficRecord> > responses;
+            QHash<QString, QList<TrafficRecord> > feed;
+            QElapsedTimer feedClock;
+            //! Time of the first feed line in capture
+            qint64 feedStart = -1;
+            QMutex *lock;
+    };
+}
+
+#endif // TRAFFICCAPTURE_HPP
@@ -54,7 +54,7 @@ QString sanitize_page_name(QString page_name)
     return page_name;
 }
 
-PendingWarning *Warnings::WarnUser(QString warning_type, RevertQuery *dependency, WikiEdit *edit, bool *report)
+PendingWarning *Warnings::WarnUser(QString warning_type, RevertQuery *dependency, WikiEdit *edit, bool *report, int escalation)
 {
     *report = false;
     if (edit == nullptr)
@@ -137,7 +137,9 @@ PendingWarning *Warnings::WarnUser(QString warning_type, RevertQuery *dependency
         return nullptr;
     }
 
-    edit->User->IncrementWarningLevel();
+    // level never goes over the maximum, so the user is reported only on next warning, like if every edit was warned for
+    while (escalation-- > 0)
+        edit->User->IncrementWarningLevel();
     edit->User->SetLastMessageTime(QDateTime::currentDateTime());
     // We need to update the user so that new user warning level gets propagated everywhere on interface of huggle
     edit->User->Update();
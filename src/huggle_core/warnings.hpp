@@ -61,9 +61,10 @@ namespace Huggle
          * \param dependency If the warnings is depending on some revert you can put a pointer to that here
          * \param edit Pointer to edit this warning is related to
          * \param report This is address of boolean to which value whether user should be reported instead is stored
+         * \param escalation Number of levels the warning is raised by, this is more than 1 when single warning is sent for several edits
          * \return Pointer to a warning object which contains information about the warning
          */
-        HUGGLE_EX_CORE PendingWarning *WarnUser(QString warning_type, RevertQuery *dependency, WikiEdit *edit, bool *report);
+        HUGGLE_EX_CORE PendingWarning *WarnUser(QString warning_type, RevertQuery *dependency, WikiEdit *edit, bool *report, int escalation = 1);
         //! This sends a warning to user no matter if they should receive it or not
         HUGGLE_EX_CORE void ForceWarn(int level, WikiEdit *edit);
         //! Checks all warnings that weren't sent and try to send them
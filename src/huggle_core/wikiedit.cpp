@@ -11,24 +11,47 @@
 #include "wikiedit.hpp"
 #include <QMutex>
 #include <QUrl>
+#include "apiquerycache.hpp"
 #include "apiqueryresult.hpp"
 #include "configuration.hpp"
 #include "hooks.hpp"
 #include "core.hpp"
+#include "diffengine.hpp"
 #include "querypool.hpp"
 #include "exception.hpp"
+#include "historycache.hpp"
 #include "syslog.hpp"
 #include "mediawiki.hpp"
+#include "revisiontextcache.hpp"
+#include "scoretext.hpp"
 #include "wikipage.hpp"
 #include "wikiutil.hpp"
 #include "wikisite.hpp"
 #include "wikiuser.hpp"
 #include "localization.hpp"
+#include "memorypool.hpp"
 
 using namespace Huggle;
 QList<WikiEdit*> WikiEdit::EditList;
 QMutex *WikiEdit::Lock_EditList = new QMutex(QMutex::Recursive);
 
+static MemoryPool *editPool()
+{
+    // pool is never deleted, because instances may outlive any static object
+    static MemoryPool *pool = new MemoryPool("WikiEdit", sizeof(WikiEdit));
+    return pool;
+}
+
+void *WikiEdit::operator new(size_t size)
+{
+    return editPool()->Allocate(size);
+}
+
+void WikiEdit::operator delete(void *ptr, size_t size)
+{
+    editPool()->Free(ptr, size);
+}
+
 WikiEdit::WikiEdit()
 {
     this->Bot = false;
@@ -45,9 +68,10 @@ WikiEdit::WikiEdit()
     this->EditMadeByHuggle = false;
     this->TrustworthEdit = false;
     this->postProcessing = false;
-    this->processingEditInfo = false;
-    this->processingRevs = false;
+    this->SizeIsKnown = false;
+    this->IsValid = true;
     this->DiffText = "";
+    this->DiffText_IsSplit = false;
     this->IsRevert = false;
     this->TPRevBaseTime = "";
     this->Previous = nullptr;
@@ -84,6 +108,7 @@ WikiEdit::~WikiEdit()
             this->Next->Previous = nullptr;
         }
     }
+    delete this->context;
     delete this->User;
     delete this->Page;
 }
@@ -96,6 +121,7 @@ bool WikiEdit::finalizePostProcessing()
         this->processCallback();
         // Remove the callback to ensure that we don't call it more than once
         this->PostprocessCallback = nullptr;
+        this->releaseContext();
         return true;
     }
 
@@ -104,14 +130,14 @@ bool WikiEdit::finalizePostProcessing()
         return false;
     }
 
-    if (this->qCategoriesAndWatched != nullptr && this->qCategoriesAndWatched->IsProcessed())
+    if (this->context->qCategoriesAndWatched != nullptr && this->context->qCategoriesAndWatched->IsProcessed())
     {
-        if (this->qCategoriesAndWatched->IsFailed())
+        if (this->context->qCategoriesAndWatched->IsFailed())
         {
-            Syslog::HuggleLogs->ErrorLog("Unable to fetch categories for page " + this->Page->PageName + ": " + this->qCategoriesAndWatched->GetFailureReason());
+            Syslog::HuggleLogs->ErrorLog("Unable to fetch categories for page " + this->Page->PageName + ": " + this->context->qCategoriesAndWatched->GetFailureReason());
         } else
         {
-            QList<ApiQueryResultNode*> categories = this->qCategoriesAndWatched->GetApiQueryResult()->GetNodes("cl");
+            QList<ApiQueryResultNode*> categories = this->context->qCategoriesAndWatched->GetApiQueryResult()->GetNodes("cl");
             QStringList categoryStringList;
             foreach (ApiQueryResultNode *cat, categories)
             {
@@ -119,24 +145,24 @@ bool WikiEdit::finalizePostProcessing()
             }
             this->Page->SetCategories(categoryStringList);
 
-            ApiQueryResultNode *page = this->qCategoriesAndWatched->GetApiQueryResult()->GetNode("page");
+            ApiQueryResultNode *page = this->context->qCategoriesAndWatched->GetApiQueryResult()->GetNode("page");
             this->Page->SetWatched(page->GetAttribute("watched", "false") != "false");
         }
-        this->qCategoriesAndWatched = nullptr;
+        this->context->qCategoriesAndWatched = nullptr;
     }
 
-    if (this->qFounder != nullptr && this->qFounder->IsProcessed())
+    if (this->context->qFounder != nullptr && this->context->qFounder->IsProcessed())
     {
-        if (this->qFounder->IsFailed())
+        if (this->context->qFounder->IsFailed())
         {
-            Syslog::HuggleLogs->ErrorLog("Failed to retrieve founder for page " + this->Page->PageName + ": " + this->qFounder->GetFailureReason());
+            Syslog::HuggleLogs->ErrorLog("Failed to retrieve founder for page " + this->Page->PageName + ": " + this->context->qFounder->GetFailureReason());
         } else
         {
-            QList<ApiQueryResultNode*> revisions = this->qFounder->GetApiQueryResult()->GetNodes("rev");
+            QList<ApiQueryResultNode*> revisions = this->context->qFounder->GetApiQueryResult()->GetNodes("rev");
             if (revisions.count() == 0)
             {
-                Syslog::HuggleLogs->ErrorLog("Failed to retrieve founder for page " + this->Page->PageName + ": " + this->qFounder->GetFailureReason());
-                HUGGLE_DEBUG(this->qFounder->Result->Data, 1);
+                Syslog::HuggleLogs->ErrorLog("Failed to retrieve founder for page " + this->Page->PageName + ": " + this->context->qFounder->GetFailureReason());
+                HUGGLE_DEBUG(this->context->qFounder->Result->Data, 1);
             }
             else if (revisions.count() == 1)
             {
@@ -148,27 +174,29 @@ bool WikiEdit::finalizePostProcessing()
                 else
                 {
                     this->Page->SetFounder(node->GetAttribute("user"));
+                    if (HistoryCache::HuggleHistory)
+                        HistoryCache::HuggleHistory->SetFounder(this->GetSite(), this->Page->PageName, node->GetAttribute("user"));
                 }
             }
         }
-        this->qFounder = nullptr;
+        this->context->qFounder = nullptr;
     }
 
-    if (this->qUser != nullptr && this->qUser->IsProcessed())
+    if (this->context->qUser != nullptr && this->context->qUser->IsProcessed())
     {
-        if (this->qUser->IsFailed())
+        if (this->context->qUser->IsFailed())
         {
             // it failed for some reason
             Syslog::HuggleLogs->ErrorLog("Unable to fetch user information for " + this->User->Username + ": " +
-                                         this->qUser->GetFailureReason());
+                                         this->context->qUser->GetFailureReason());
             // we can remove this query now
-            this->qUser = nullptr;
+            this->context->qUser = nullptr;
 
         } else
         {
             // we fetch the number of edits, registration and groups of user
-            QList<ApiQueryResultNode*> user_data = this->qUser->GetApiQueryResult()->GetNodes("user");
-            QList<ApiQueryResultNode*> group_data = this->qUser->GetApiQueryResult()->GetNodes("g");
+            QList<ApiQueryResultNode*> user_data = this->context->qUser->GetApiQueryResult()->GetNodes("user");
+            QList<ApiQueryResultNode*> group_data = this->context->qUser->GetApiQueryResult()->GetNodes("g");
             if (user_data.count() > 0)
             {
                 ApiQueryResultNode *user_info_ = user_data.at(0);
@@ -209,24 +237,24 @@ bool WikiEdit::finalizePostProcessing()
                 this->recordScore("BotScore_flag", this->GetSite()->ProjectConfig->BotScore);
             }
             // let's delete it now
-            this->qUser = nullptr;
+            this->context->qUser = nullptr;
         }
     }
 
-    if (this->processingRevs)
+    if (this->context->processingRevs)
     {
         // check if api was processed
-        if (!this->qTalkpage->IsProcessed())
+        if (!this->context->qTalkpage->IsProcessed())
             return false;
 
-        if (this->qTalkpage->IsFailed())
+        if (this->context->qTalkpage->IsFailed())
         {
             Huggle::Syslog::HuggleLogs->Log(_l("wikiedit-tp-fail", this->User->GetTalk()));
         } else
         {
             // parse the talk page now
-            QList<ApiQueryResultNode*> rev_ = this->qTalkpage->GetApiQueryResult()->GetNodes("rev");
-            QList<ApiQueryResultNode*> pages_ = this->qTalkpage->GetApiQueryResult()->GetNodes("page");
+            QList<ApiQueryResultNode*> rev_ = this->context->qTalkpage->GetApiQueryResult()->GetNodes("rev");
+            QList<ApiQueryResultNode*> pages_ = this->context->qTalkpage->GetApiQueryResult()->GetNodes("page");
             bool missing = false;
             if (pages_.count() > 0)
             {
@@ -251,7 +279,7 @@ bool WikiEdit::finalizePostProcessing()
                     // completely accurate but better than nothing
                     this->User->SetLastMessageTime(MediaWiki::FromMWTimestamp(this->TPRevBaseTime));
                 }
-                this->User->TalkPage_SetContents(rv->Value);
+                this->User->TalkPage_SetContents(rv->Value, rv->GetAttribute("revid", QString::number(WIKI_UNKNOWN_REVID)).toLongLong());
             } else
             {
                 if (missing)
@@ -261,32 +289,32 @@ bool WikiEdit::finalizePostProcessing()
                 } else
                 {
                     Huggle::Syslog::HuggleLogs->Log(_l("wikiedit-tp-fail", this->User->GetTalk()));
-                    HUGGLE_DEBUG(this->qTalkpage->Result->Data, 1);
+                    HUGGLE_DEBUG(this->context->qTalkpage->Result->Data, 1);
                 }
             }
         }
-        this->processingRevs = false;
+        this->context->processingRevs = false;
     }
 
-    if (this->processingEditInfo)
+    if (this->context->processingEditInfo)
     {
         // check if api was processed
-        if (!this->qRevisionInfo->IsProcessed())
+        if (!this->context->qRevisionInfo->IsProcessed())
         {
             return false;
         }
 
-        if (this->qRevisionInfo->IsFailed())
+        if (this->context->qRevisionInfo->IsFailed())
         {
             // whoa it ended in error, we need to get rid of this edit somehow now
-            Huggle::Syslog::HuggleLogs->WarningLog("Failed to obtain diff for " + this->Page->PageName + " the error was: " + this->qRevisionInfo->GetFailureReason());
-            this->qRevisionInfo = nullptr;
+            Huggle::Syslog::HuggleLogs->WarningLog("Failed to obtain diff for " + this->Page->PageName + " the error was: " + this->context->qRevisionInfo->GetFailureReason());
             this->postProcessing = false;
+            this->releaseContext();
             return true;
         }
 
         // parse the revision meta-data now
-        QList<ApiQueryResultNode*> revision_data = this->qRevisionInfo->GetApiQueryResult()->GetNodes("rev");
+        QList<ApiQueryResultNode*> revision_data = this->context->qRevisionInfo->GetApiQueryResult()->GetNodes("rev");
         // get last id
         if (revision_data.count() > 0)
         {
@@ -311,6 +339,22 @@ bool WikiEdit::finalizePostProcessing()
                 this->Time = MediaWiki::FromMWTimestamp(revision->GetAttribute("timestamp"));
             if (revision->Attributes.contains("comment"))
                 this->Summary = revision->GetAttribute("comment");
+            // texthidden means the revision was suppressed and we can't see its content
+            bool has_text = this->context->retrievingText && this->IsValid && !revision->Attributes.contains("texthidden");
+            if (has_text && revision->Attributes.contains("revid"))
+                RevisionTextCache::HuggleRevisionTexts->Insert(this->GetSite(), this->Page->PageName, this->RevID, revision->Value);
+            if (this->context->processingLocalDiff && has_text && revision->GetAttribute("parentid").toLongLong() == this->OldID)
+            {
+                QString base = RevisionTextCache::HuggleRevisionTexts->Get(this->GetSite(), this->Page->PageName, this->OldID);
+                QDateTime started = QDateTime::currentDateTime();
+                bool failed = false;
+                this->DiffText = DiffEngine::Diff(base, revision->Value, &failed);
+                if (!failed)
+                {
+                    DiffEngine::RecordHit(started.msecsTo(QDateTime::currentDateTime()));
+                    this->context->processingLocalDiff = false;
+                }
+            }
 
             foreach (ApiQueryResultNode *tags, revision->ChildNodes)
             {
@@ -320,31 +364,44 @@ bool WikiEdit::finalizePostProcessing()
                         this->Tags.append(t->Value);
                 }
             }
+            // every edit from feed goes through here, which keeps histories in cache up to date
+            if (HistoryCache::HuggleHistory && revision->Attributes.contains("revid") && revision->Attributes.contains("user"))
+                HistoryCache::HuggleHistory->Record(this->GetSite(), HistoryRevision::FromApiNode(revision, this->Page->PageName));
         }
 
-        this->qRevisionInfo = nullptr;
-        this->processingEditInfo = false;
+        this->context->qRevisionInfo = nullptr;
+        this->context->processingEditInfo = false;
+        if (this->context->processingLocalDiff)
+        {
+            // We weren't able to make the diff locally, so ask mediawiki for it
+            HUGGLE_DEBUG("Unable to compute local diff of " + this->Page->PageName + ", falling back to action=compare", 2);
+            this->context->processingLocalDiff = false;
+            DiffEngine::RecordMiss();
+            this->context->qDifference = WikiUtil::APIRequest(ActionCompare, this->GetSite(), "fromrev=" + QString::number(this->RevID) + "&torelative=" + this->DiffTo, false, "Diff of " + this->Page->PageName);
+            this->context->processingDiff = true;
+            return false;
+        }
     }
 
-    if (this->processingDiff)
+    if (this->context->processingDiff)
     {
-        if (!this->qDifference->IsProcessed())
+        if (!this->context->qDifference->IsProcessed())
             return false;
 
-        if (this->qDifference->IsFailed())
+        if (this->context->qDifference->IsFailed())
         {
             // We weren't able to retrieve the diff using action=compare so let's keep it empty and let the browser component fallback to alternative method
-            Huggle::Syslog::HuggleLogs->WarningLog("Failed to obtain diff for " + this->Page->PageName + " the error was: " + this->qDifference->GetFailureReason());
-            this->processingDiff = false;
+            Huggle::Syslog::HuggleLogs->WarningLog("Failed to obtain diff for " + this->Page->PageName + " the error was: " + this->context->qDifference->GetFailureReason());
+            this->context->processingDiff = false;
             return false;
         }
 
-        ApiQueryResultNode* diff = this->qDifference->GetApiQueryResult()->GetNode("compare");
+        ApiQueryResultNode* diff = this->context->qDifference->GetApiQueryResult()->GetNode("compare");
         if (diff == nullptr)
         {
             Huggle::Syslog::HuggleLogs->WarningLog("Failed to obtain diff for " + this->Page->PageName + " no diff data in query result");
-            HUGGLE_DEBUG1(this->qDifference->GetApiQueryResult()->Data);
-            this->processingDiff = false;
+            HUGGLE_DEBUG1(this->context->qDifference->GetApiQueryResult()->Data);
+            this->context->processingDiff = false;
             return false;
         }
 
@@ -362,15 +419,16 @@ bool WikiEdit::finalizePostProcessing()
         }
 
         this->DiffText = diff->Value;
+        DiffEngine::RecordRemoteTime(this->context->qDifference->ExecutionTime());
 
-        this->qDifference.Delete();
-        this->processingDiff = false;
+        this->context->qDifference.Delete();
+        this->context->processingDiff = false;
     }
 
-    if (this->qText != nullptr && this->qText->IsProcessed())
+    if (this->context->qText != nullptr && this->context->qText->IsProcessed())
     {
         bool failed = false;
-        QString result = WikiUtil::EvaluateWikiPageContents(this->qText, &failed);
+        QString result = WikiUtil::EvaluateWikiPageContents(this->context->qText, &failed);
         if (failed)
         {
             Syslog::HuggleLogs->ErrorLog("Failed to obtain text of " + this->Page->PageName + ": " + result);
@@ -380,14 +438,14 @@ bool WikiEdit::finalizePostProcessing()
             result.replace("//", "https://");
             this->Page->SetContent(result);
         }
-        this->qText = nullptr;
+        this->context->qText = nullptr;
     }
 
     // check if everything was processed and clean up
-    if (this->processingRevs || this->processingDiff || this->processingEditInfo || this->qUser != nullptr || this->qText != nullptr || this->qFounder != nullptr || this->qCategoriesAndWatched != nullptr)
+    if (this->context->processingRevs || this->context->processingDiff || this->context->processingEditInfo || this->context->qUser != nullptr || this->context->qText != nullptr || this->context->qFounder != nullptr || this->context->qCategoriesAndWatched != nullptr)
         return false;
 
-    this->qTalkpage = nullptr;
+    this->context->qTalkpage = nullptr;
     this->processingByWorkerThread = true;
     WikiEdit_ProcessorThread::EditLock.lock();
     this->RegisterConsumer(HUGGLECONSUMER_PROCESSOR);
@@ -445,90 +503,22 @@ QString WikiEdit::GetPixmap()
     return ":/huggle/pictures/Resources/blob-none.png";
 }
 
-static long ProcessPartsInWikiText(QStringList *list, QString text, QList<ScoreWord> *wl)
-{
-    long rs = 0;
-    foreach (ScoreWord word, *wl)
-    {
-        QString w = word.word;
-        if (text.contains(w))
-        {
-            rs += word.score;
-            list->append(w);
-        }
-    }
-    return rs;
-}
-
-static long ProcessWordsInWikiText(QStringList *list, QString text, QList<ScoreWord> *wl)
-{
-    long rs = 0;
-    foreach (ScoreWord word, *wl)
-    {
-        QString w = word.word;
-        // if there is no such a string in text we can skip it
-        if (!text.contains(w))
-            continue;
-
-        int SD = 0;
-        bool found = false;
-        if (text == w)
-            found = true;
-        while (!found && SD < hcfg->SystemConfig_WordSeparators.count())
-        {
-            if (text.startsWith(w + hcfg->SystemConfig_WordSeparators.at(SD)))
-            {
-                found = true;
-                break;
-            }
-            if (text.endsWith(hcfg->SystemConfig_WordSeparators.at(SD) + w))
-            {
-                found = true;
-                break;
-            }
-            int SL = 0;
-            while (SL < hcfg->SystemConfig_WordSeparators.count())
-            {
-                if (text.contains(hcfg->SystemConfig_WordSeparators.at(SD) + w + hcfg->SystemConfig_WordSeparators.at(SL)))
-                {
-                    found = true;
-                    break;
-                }
-                if (found)
-                    break;
-                ++SL;
-            }
-            ++SD;
-        }
-        if (found)
-        {
-            rs += word.score;
-            list->append(w);
-        }
-    }
-    return rs;
-}
-
 void WikiEdit::ProcessWords()
 {
-    QString text;
-    if (this->DiffText_IsSplit)
-        text = this->DiffText_New.toLower();
-    else
-        text = this->DiffText.toLower();
-    if (text.isEmpty() && this->Page->Contents.length() > 0)
-    {
-        text = this->Page->Contents.toLower();
-    }
-    // we cache the project config pointer
-    ProjectConfiguration *conf = this->GetSite()->GetProjectConfig();
+    // diff of edits that are already in queue may be packed
+    QString diff = this->GetDiffText();
+    // we hold the snapshot so that it can't be replaced while we are using it
+    std::shared_ptr<const ProjectConfigurationSnapshot> conf = this->GetSite()->GetSnapshot();
+    // only added lines of diff are scored, whole page is used when there is no diff
+    bool use_diff = !diff.isEmpty() || this->Page->Contents.isEmpty();
+    ScoreText text(use_diff ? diff : this->Page->Contents, conf->GetSeparators(), use_diff);
     if (!this->Page->IsTalk())
     {
-        this->recordScore("PartsInWikiText_NoTalk", ProcessPartsInWikiText(&this->ScoreWords, text, &conf->NoTalkScoreParts));
-        this->recordScore("WordsInWikiText_NoTalk", ProcessWordsInWikiText(&this->ScoreWords, text, &conf->NoTalkScoreWords));
+        this->recordScore("PartsInWikiText_NoTalk", conf->MatchParts(text, conf->NoTalkScoreParts, &this->ScoreWords));
+        this->recordScore("WordsInWikiText_NoTalk", conf->MatchWords(text, conf->NoTalkScoreWords, &this->ScoreWords));
     }
-    this->recordScore("WordsInWikiText", ProcessWordsInWikiText(&this->ScoreWords, text, &conf->ScoreWords));
-    this->recordScore("PartsInWikiText", ProcessPartsInWikiText(&this->ScoreWords, text, &conf->ScoreParts));
+    this->recordScore("WordsInWikiText", conf->MatchWords(text, conf->ScoreWords, &this->ScoreWords));
+    this->recordScore("PartsInWikiText", conf->MatchParts(text, conf->ScoreParts, &this->ScoreWords));
 }
 
 void WikiEdit::RemoveFromHistoryChain()
@@ -555,6 +545,42 @@ void WikiEdit::RemoveFromHistoryChain()
     }
 }
 
+void WikiEdit::PackDiffText()
+{
+    if (this->DiffText.isEmpty() || this->IsDiffTextPacked())
+        return;
+    // html of diffs is very repetitive, so it usually shrinks to a fraction of the size, which is
+    // stored as utf-8 so that latin text doesn't take 2 bytes per character even before compression
+    this->packedDiffText = qCompress(this->DiffText.toUtf8());
+    this->DiffText = QString();
+}
+
+void WikiEdit::UnpackDiffText()
+{
+    if (!this->IsDiffTextPacked())
+        return;
+    this->DiffText = QString::fromUtf8(qUncompress(this->packedDiffText));
+    this->packedDiffText = QByteArray();
+}
+
+bool WikiEdit::IsDiffTextPacked()
+{
+    return !this->packedDiffText.isEmpty();
+}
+
+QString WikiEdit::GetDiffText()
+{
+    if (!this->IsDiffTextPacked())
+        return this->DiffText;
+    return QString::fromUtf8(qUncompress(this->packedDiffText));
+}
+
+void WikiEdit::releaseContext()
+{
+    delete this->context;
+    this->context = nullptr;
+}
+
 void WikiEdit::processCallback()
 {
     if (this->PostprocessCallback)
@@ -596,81 +622,137 @@ void WikiEdit::PostProcess()
     if (this->Status != Huggle::StatusProcessed)
         throw new Huggle::Exception("Unable to post process an edit that wasn't in processed status", BOOST_CURRENT_FUNCTION);
     this->postProcessing = true;
+    delete this->context;
+    this->context = new PostProcessingContext();
 #ifndef HUGGLE_SDK
     // Send info to other functions
     Hooks::EditBeforePostProcess(this);
 #endif
-    this->qTalkpage = WikiUtil::RetrieveWikiPageContents(this->User->GetTalk(), this->GetSite());
-    HUGGLE_QP_APPEND(this->qTalkpage);
-    this->qTalkpage->Target = "Retrieving tp " + this->User->GetTalk();
-    this->qTalkpage->Process();
+    // this edit changed a talk page, so whatever we have cached about it is obsolete now
+    if (ApiQueryCache::HuggleCache && this->Page->GetNS()->GetCanonicalName() == "User talk")
+        ApiQueryCache::HuggleCache->InvalidatePage(this->GetSite(), this->Page->PageName);
+    this->context->qTalkpage = WikiUtil::RetrieveWikiPageContents(this->User->GetTalk(), this->GetSite());
+    // edits of same user made in short time need the same talk page, so only one of them needs to retrieve it
+    this->context->qTalkpage->Cacheable = true;
+    HUGGLE_QP_APPEND(this->context->qTalkpage);
+    this->context->qTalkpage->Target = "Retrieving tp " + this->User->GetTalk();
+    this->context->qTalkpage->Process();
     if (!this->NewPage)
     {
-        // This query will fetch information about the revision(s) but not the diff itself
-        this->qRevisionInfo = new ApiQuery(ActionQuery, this->GetSite());
-        if (this->RevID != WIKI_UNKNOWN_REVID)
-        {
-            // &rvprop=content can't be used because of fuck up of mediawiki
-            this->qRevisionInfo->Parameters = "prop=revisions&rvprop=" + QUrl::toPercentEncoding("ids|tags|user|timestamp|comment") +
-                                              "&rvlimit=1&rvstartid=" + QString::number(this->RevID) + "&titles=" +
-                                              QUrl::toPercentEncoding(this->Page->PageName);
+        // Pages that are edited often have text of previous revision in cache, so we can diff them locally, for other
+        // pages we only fetch the text if they were edited recently, otherwise we would waste bandwidth
+        if (hcfg->SystemConfig_LocalDiffs && RevisionTextCache::HuggleRevisionTexts && this->RevID != WIKI_UNKNOWN_REVID
+                && !this->IsRangeOfEdits() && this->DiffTo == "prev")
+        {
+            this->context->processingLocalDiff = this->OldID > 0 && RevisionTextCache::HuggleRevisionTexts->Contains(this->GetSite(), this->Page->PageName, this->OldID);
+            this->context->retrievingText = RevisionTextCache::HuggleRevisionTexts->Touch(this->GetSite(), this->Page->PageName) || this->context->processingLocalDiff;
+        }
+        HistoryRevision known;
+        if (!this->context->retrievingText && !this->IsRangeOfEdits() && HistoryCache::HuggleHistory &&
+                HistoryCache::HuggleHistory->GetRevision(this->GetSite(), this->Page->PageName, this->User->Username, this->RevID, &known))
+        {
+            // edit was opened from history or contributions which already told us everything we would ask for
+            this->IsValid = WikiUtil::SanitizeUser(known.User).toUpper() == WikiUtil::SanitizeUser(this->User->Username).toUpper();
+            this->Time = MediaWiki::FromMWTimestamp(known.Timestamp);
+            this->Summary = known.Summary;
+            this->Tags = known.Tags;
         } else
         {
-            this->qRevisionInfo->Parameters = "prop=revisions&rvprop=" + QUrl::toPercentEncoding("ids|tags|user|timestamp|comment") +
-                                              "&rvlimit=1&titles=" + QUrl::toPercentEncoding(this->Page->PageName);
+            // This query will fetch information about the revision(s) but not the diff itself
+            this->context->qRevisionInfo = new ApiQuery(ActionQuery, this->GetSite());
+            if (this->RevID != WIKI_UNKNOWN_REVID)
+            {
+                QString rvprop = "ids|tags|user|timestamp|comment|size";
+                // &rvprop=content can't be used together with diffs because of fuck up of mediawiki, that's why it's only used
+                // when we are going to make the diff ourselves
+                if (this->context->retrievingText)
+                    rvprop += "|content";
+                this->context->qRevisionInfo->Parameters = "prop=revisions&rvprop=" + QUrl::toPercentEncoding(rvprop) +
+                                                  "&rvlimit=1&rvstartid=" + QString::number(this->RevID) + "&titles=" +
+                                                  QUrl::toPercentEncoding(this->Page->PageName);
+            } else
+            {
+                this->context->qRevisionInfo->Parameters = "prop=revisions&rvprop=" + QUrl::toPercentEncoding("ids|tags|user|timestamp|comment|size") +
+                                                  "&rvlimit=1&titles=" + QUrl::toPercentEncoding(this->Page->PageName);
+            }
+            this->context->qRevisionInfo->Target = this->Page->PageName;
+            HUGGLE_QP_APPEND(this->context->qRevisionInfo);
+            this->context->qRevisionInfo->Process();
+            if (hcfg->Verbosity > 0)
+                this->PropertyBag.insert("debug_api_url_rev_info", this->context->qRevisionInfo->GetURL());
+            this->context->processingEditInfo = true;
         }
-        this->qRevisionInfo->Target = this->Page->PageName;
-        HUGGLE_QP_APPEND(this->qRevisionInfo);
-        this->qRevisionInfo->Process();
-        if (hcfg->Verbosity > 0)
-            this->PropertyBag.insert("debug_api_url_rev_info", this->qRevisionInfo->GetURL());
-        this->processingEditInfo = true;
 
         // This query will download the actual diff of edit
-        if (this->RevID != WIKI_UNKNOWN_REVID)
+        if (this->context->processingLocalDiff)
+        {
+            // diff will be computed once we have the text of this revision
+        } else if (this->RevID != WIKI_UNKNOWN_REVID)
         {
             if (!this->IsRangeOfEdits())
-                this->qDifference = WikiUtil::APIRequest(ActionCompare, this->GetSite(), "fromrev=" + QString::number(this->RevID) + "&torelative=" + this->DiffTo, false, "Diff of " + this->Page->PageName);
+                this->context->qDifference = WikiUtil::APIRequest(ActionCompare, this->GetSite(), "fromrev=" + QString::number(this->RevID) + "&torelative=" + this->DiffTo, false, "Diff of " + this->Page->PageName);
             else
-                this->qDifference = WikiUtil::APIRequest(ActionCompare, this->GetSite(), "fromrev=" + QString::number(this->RevID) + "&torev=" + this->DiffTo, false, "Diff of " + this->Page->PageName);
+                this->context->qDifference = WikiUtil::APIRequest(ActionCompare, this->GetSite(), "fromrev=" + QString::number(this->RevID) + "&torev=" + this->DiffTo, false, "Diff of " + this->Page->PageName);
         } else
         {
-            this->qDifference = WikiUtil::APIRequest(ActionCompare, this->GetSite(), "fromtitle=" + QUrl::toPercentEncoding(this->Page->PageName) + "&torelative=" + this->DiffTo, false, "Diff of " + this->Page->PageName);
+            this->context->qDifference = WikiUtil::APIRequest(ActionCompare, this->GetSite(), "fromtitle=" + QUrl::toPercentEncoding(this->Page->PageName) + "&torelative=" + this->DiffTo, false, "Diff of " + this->Page->PageName);
+        }
+        if (!this->context->processingLocalDiff)
+        {
+            if (this->context->retrievingText)
+                DiffEngine::RecordMiss();
+            this->context->processingDiff = true;
         }
-        this->processingDiff = true;
     } else if (this->Page->Contents.isEmpty())
     {
-        this->qText = WikiUtil::RetrieveWikiPageContents(this->Page, true);
-        this->qText->Target = "Retrieving content of " + this->Page->PageName;
-        HUGGLE_QP_APPEND(this->qText);
-        this->qText->Process();
+        this->context->qText = WikiUtil::RetrieveWikiPageContents(this->Page, true);
+        this->context->qText->Target = "Retrieving content of " + this->Page->PageName;
+        HUGGLE_QP_APPEND(this->context->qText);
+        this->context->qText->Process();
     }
-    if (hcfg->UserConfig->RetrieveFounder)
+    QString founder;
+    if (!hcfg->UserConfig->RetrieveFounder)
+    {
+        // founder is not needed
+    } else if (this->NewPage)
+    {
+        // whoever made this edit created the page
+        this->Page->SetFounder(this->User->Username);
+    } else if (HistoryCache::HuggleHistory && HistoryCache::HuggleHistory->GetFounder(this->GetSite(), this->Page->PageName, &founder))
+    {
+        this->Page->SetFounder(founder);
+    } else
     {
-        this->qFounder = new ApiQuery(ActionQuery, this->GetSite());
-        this->qFounder->Parameters = "prop=revisions&titles=" + QUrl::toPercentEncoding(this->Page->PageName) + "&rvdir=newer&rvlimit=1&rvprop=" +
+        this->context->qFounder = new ApiQuery(ActionQuery, this->GetSite());
+        // founder and categories are not needed to score the edit, so they don't hold up other post processing
+        this->context->qFounder->Priority = QueryPriority_Prefetch;
+        this->context->qFounder->Cacheable = true;
+        this->context->qFounder->Parameters = "prop=revisions&titles=" + QUrl::toPercentEncoding(this->Page->PageName) + "&rvdir=newer&rvlimit=1&rvprop=" +
                                      QUrl::toPercentEncoding("ids|user|timestamp");
-        this->qFounder->Target = this->Page->PageName + " (retrieving founder)";
-        HUGGLE_QP_APPEND(this->qFounder);
-        this->qFounder->Process();
+        this->context->qFounder->Target = this->Page->PageName + " (retrieving founder)";
+        HUGGLE_QP_APPEND(this->context->qFounder);
+        this->context->qFounder->Process();
     }
 
     if (hcfg->SystemConfig_CatScansAndWatched)
     {
-        this->qCategoriesAndWatched = new ApiQuery(ActionQuery, this->GetSite());
-        this->qCategoriesAndWatched->Parameters = "prop=" + QUrl::toPercentEncoding("categories|info") + "&titles=" + QUrl::toPercentEncoding(this->Page->PageName) + "&inprop=watched";
-        this->qCategoriesAndWatched->Target = this->Page->PageName + " (retrieving categories+watched)";
-        HUGGLE_QP_APPEND(this->qCategoriesAndWatched);
-        this->qCategoriesAndWatched->Process();
+        this->context->qCategoriesAndWatched = new ApiQuery(ActionQuery, this->GetSite());
+        this->context->qCategoriesAndWatched->Priority = QueryPriority_Prefetch;
+        this->context->qCategoriesAndWatched->Cacheable = true;
+        this->context->qCategoriesAndWatched->Parameters = "prop=" + QUrl::toPercentEncoding("categories|info") + "&titles=" + QUrl::toPercentEncoding(this->Page->PageName) + "&inprop=watched";
+        this->context->qCategoriesAndWatched->Target = this->Page->PageName + " (retrieving categories+watched)";
+        HUGGLE_QP_APPEND(this->context->qCategoriesAndWatched);
+        this->context->qCategoriesAndWatched->Process();
     }
 
-    this->processingRevs = true;
+    this->context->processingRevs = true;
     if (this->User->IsIP())
         return;
-    this->qUser = new ApiQuery(ActionQuery, this->GetSite());
-    this->qUser->Parameters = "list=users&usprop=blockinfo%7Cgroups%7Ceditcount%7Cregistration&ususers="
+    this->context->qUser = new ApiQuery(ActionQuery, this->GetSite());
+    this->context->qUser->Parameters = "list=users&usprop=blockinfo%7Cgroups%7Ceditcount%7Cregistration&ususers="
                                 + QUrl::toPercentEncoding(this->User->Username);
-    this->qUser->Process();
+    this->context->qUser->Cacheable = true;
+    this->context->qUser->Process();
 }
 
 Collectable_SmartPtr<WikiEdit> WikiEdit::FromCacheByRevID(revid_ht revid, QString prev)
@@ -786,7 +868,7 @@ void WikiEdit_ProcessorThread::Process(WikiEdit *edit)
     if (Hooks::EditBeforeScore(edit))
     {
         bool IgnoreWords = false;
-        ProjectConfiguration *conf = edit->GetSite()->GetProjectConfig();
+        std::shared_ptr<const ProjectConfigurationSnapshot> conf = edit->GetSite()->GetSnapshot();
         if (edit->IsRevert)
         {
             if (edit->User->IsIP())
@@ -827,7 +909,7 @@ void WikiEdit_ProcessorThread::Process(WikiEdit *edit)
         foreach (QString tx, edit->Tags)
         {
             if (conf->ScoreTags.contains(tx))
-                edit->recordScore("tag_" + tx, conf->ScoreTags[tx]);
+                edit->recordScore("tag_" + tx, conf->ScoreTags.value(tx));
         }
         if (edit->SizeIsKnown && edit->diffSize < (-1 * conf->LargeRemoval))
             edit->recordScore("ScoreRemoval", conf->ScoreRemoval);
@@ -842,7 +924,7 @@ void WikiEdit_ProcessorThread::Process(WikiEdit *edit)
                 HUGGLE_WARNING("No score present for warning level " + QString::number(warning_level) + " of user " + edit->User->Username + " site " + edit->GetSite()->Name);
             } else
             {
-                edit->recordScore("WarningLevel", conf->ScoreLevel[warning_level]);
+                edit->recordScore("WarningLevel", conf->ScoreLevel.value(warning_level));
             }
         }
         switch(warning_level)
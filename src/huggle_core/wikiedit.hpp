@@ -13,6 +13,7 @@
 
 #include "definitions.hpp"
 
+#include <QByteArray>
 #include <QString>
 #include <QVariant>
 #include <QHash>
@@ -86,6 +87,9 @@ namespace Huggle
             //! This list contains reference to all existing edits in memory
             static QList<WikiEdit*> EditList;
             static QMutex *Lock_EditList;
+            //! Instances are allocated from a MemoryPool, because there are thousands of them and they live only few minutes
+            static void *operator new(size_t size);
+            static void operator delete(void *ptr, size_t size);
 
             //! Creates a new empty wiki edit
             WikiEdit();
@@ -106,58 +110,66 @@ namespace Huggle
             //! Processes all score words in text
             void ProcessWords();
             void RemoveFromHistoryChain();
-            QString ContentModel;
+            //! Compresses the diff text, it's used for edits which are deep in queue and won't be displayed anytime soon
+            void PackDiffText();
+            //! Restores diff text that was compressed by PackDiffText, call this before DiffText is accessed
+            void UnpackDiffText();
+            bool IsDiffTextPacked();
+            //! Returns text of diff even if it's packed, without unpacking the edit
+            QString GetDiffText();
+            // Members are ordered so that the ones read by scoring and queue sorting share the first cache lines
+            //! Revision ID
+            revid_ht RevID;
+            //! Old id
+            revid_ht OldID;
+            //! Diff id - this is probably same as RevID and can be safely removed
+            revid_ht Diff;
+            //! Badness score of this edit
+            long Score = 0;
+            //! This score is used to determine if edit was done in good faith, even if it wasn't OK
+            long GoodfaithScore = 0;
+            //! Indicator whether the edit was processed or not
+            WEStatus Status;
+            //! Current warning level
+            WarningLevel CurrentUserWarningLevel;
             //! Page that was changed by edit
             WikiPage *Page;
             //! User who changed the page
             WikiUser *User;
-            //! Edit is a minor edit
-            bool IsMinor;
+            //! Link to previous edit in huggle history
+            WikiEdit *Previous;
+            //! Link to next edit in huggle history
+            WikiEdit *Next;
+            // Flags read by WikiEdit_ProcessorThread are separate variables, so that main thread can change
+            // the packed ones while the edit is being processed, only flags that are never touched by worker
+            // thread may be added to the bit field. Values are set in constructor, because bit fields can't
+            // have default initializers.
             //! Edit is a bot edit
             bool Bot;
-            //! Edit is a new page
-            bool NewPage;
-            bool SizeIsKnown = false;
-            QString DiffTo = "prev";
-            //! Diff id - this is probably same as RevID and can be safely removed
-            revid_ht Diff;
-            bool IsValid = true;
-            //! Old id
-            revid_ht OldID;
+            bool SizeIsKnown;
             bool IsRevert;
-            //! Revision ID
-            revid_ht RevID;
-            //! Indicator whether the edit was processed or not
-            WEStatus Status;
-            //! Current warning level
-            WarningLevel CurrentUserWarningLevel;
+            bool DiffText_IsSplit;
+            //! Edit is a minor edit
+            bool IsMinor : 1;
+            //! Edit is a new page
+            bool NewPage : 1;
+            bool IsValid : 1;
+            //! If this is true the edit was made by huggle
+            bool EditMadeByHuggle : 1;
+            //! If this is true the edit was made by some other
+            //! tool for vandalism reverting
+            bool TrustworthEdit : 1;
+            //! Edit was made by you
+            bool OwnEdit : 1;
             //! Summary of edit
             QString Summary;
-            //! If diff is split holds a new text of a diff
-            QString DiffText_New;
-            //! If diff is split this holds an old text of a diff
-            QString DiffText_Old;
+            QString ContentModel;
+            QString DiffTo = "prev";
             //! Text of diff, usually formatted in html style returned by mediawiki
             QString DiffText;
-            bool DiffText_IsSplit = false;
             //! Base time of last revision of talk page which is needed to check if someone changed the talk
             //! page meanwhile before we change it
             QString TPRevBaseTime;
-            //! If this is true the edit was made by huggle
-            bool EditMadeByHuggle;
-            //! If this is true the edit was made by some other
-            //! tool for vandalism reverting
-            bool TrustworthEdit;
-            //! Edit was made by you
-            bool OwnEdit;
-            //! Link to previous edit in huggle history
-            WikiEdit *Previous;
-            //! Link to next edit in huggle history
-            WikiEdit *Next;
-            //! Badness score of this edit
-            long Score = 0;
-            //! This score is used to determine if edit was done in good faith, even if it wasn't OK
-            long GoodfaithScore = 0;
             //! Function to call when post processing of edit is finished
             WEPostprocessedCallback PostprocessCallback = nullptr;
             void *PostprocessCallback_Owner = nullptr;
@@ -169,30 +181,50 @@ namespace Huggle
             QStringList ScoreWords;
             QDateTime Time;
         protected:
+            //! Queries and state which are needed only while the edit is being post processed
+
+            //! Every edit that waits in queue or history would otherwise carry 7 query pointers that are null
+            //! for the rest of its life, so these live in separate allocation that is released by
+            //! finalizePostProcessing once the edit is post processed.
+            class PostProcessingContext
+            {
+                public:
+                    Collectable_SmartPtr<ApiQuery> qTalkpage;
+                    //! This is a query used to retrieve information about the user
+                    Collectable_SmartPtr<ApiQuery> qUser;
+                    //! Query that get information about revs
+                    Collectable_SmartPtr<ApiQuery> qRevisionInfo;
+                    Collectable_SmartPtr<ApiQuery> qDifference;
+                    Collectable_SmartPtr<ApiQuery> qFounder;
+                    Collectable_SmartPtr<ApiQuery> qText;
+                    Collectable_SmartPtr<ApiQuery> qCategoriesAndWatched;
+                    bool processingRevs = false;
+                    bool processingEditInfo = false;
+                    bool processingDiff = false;
+                    //! Diff is going to be computed locally from text of this and previous revision (OldID)
+                    bool processingLocalDiff = false;
+                    //! Text of this revision is retrieved together with revision info so that it can be cached
+                    bool retrievingText = false;
+            };
             void processCallback();
             void recordScore(QString name, score_ht score);
             //! This function is called by core
             bool finalizePostProcessing();
+            void releaseContext();
+            //! Exists only between PostProcess and finalizePostProcessing
+            PostProcessingContext *context = nullptr;
+            //! Diff text compressed by PackDiffText, empty if it isn't packed
+            QByteArray packedDiffText;
+            //! Size of change of edit
+            long diffSize;
+            // these are shared with worker thread, so they can't be packed into bit field either
             bool processingByWorkerThread;
-            bool processingRevs;
-            bool processingEditInfo;
-            bool processingDiff = false;
             //! This variable is used by worker thread and needs to be public so that it is working
             bool postProcessing;
             //! This variable is used by worker thread and needs to be public so that it is working
             bool processedByWorkerThread;
-            Collectable_SmartPtr<ApiQuery> qTalkpage;
-            //! This is a query used to retrieve information about the user
-            Collectable_SmartPtr<ApiQuery> qUser;
-            //! Query that get information about revs
-            Collectable_SmartPtr<ApiQuery> qRevisionInfo;
-            Collectable_SmartPtr<ApiQuery> qDifference;
-            Collectable_SmartPtr<ApiQuery> qFounder;
-            Collectable_SmartPtr<ApiQuery> qText;
-            Collectable_SmartPtr<ApiQuery> qCategoriesAndWatched;
-            //! Size of change of edit
-            long diffSize;
             friend class WikiEdit_ProcessorThread;
+            friend class EditPipeline;
             friend class MainWindow;
     };
 
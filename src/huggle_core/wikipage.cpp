@@ -13,8 +13,25 @@
 #include "exception.hpp"
 #include "wikisite.hpp"
 #include "localization.hpp"
+#include "memorypool.hpp"
 using namespace Huggle;
 
+static MemoryPool *pagePool()
+{
+    static MemoryPool *pool = new MemoryPool("WikiPage", sizeof(WikiPage));
+    return pool;
+}
+
+void *WikiPage::operator new(size_t size)
+{
+    return pagePool()->Allocate(size);
+}
+
+void WikiPage::operator delete(void *ptr, size_t size)
+{
+    pagePool()->Free(ptr, size);
+}
+
 WikiPage::WikiPage(WikiSite *site) : MediaWikiObject(site)
 {
     this->PageName = _l("page-unknown");
@@ -26,6 +26,10 @@ namespace Huggle
     class HUGGLE_EX_CORE WikiPage : public MediaWikiObject
     {
         public:
+            //! Pages are allocated from a MemoryPool, because every edit creates its own copy of the page
+            static void *operator new(size_t size);
+            static void operator delete(void *ptr, size_t size);
+
             //! Create new empty instance of wiki page
             WikiPage(WikiSite *site);
             WikiPage(const QString &name, WikiSite *site);
@@ -10,8 +10,11 @@
 
 #include "hugglequeuefilter.hpp"
 #include "wikisite.hpp"
+#include "apiqueryresult.hpp"
 #include "configuration.hpp"
 #include "exception.hpp"
+#include "huggleparser.hpp"
+#include "mediawiki.hpp"
 #include "syslog.hpp"
 using namespace Huggle;
 
@@ -49,6 +52,17 @@ WikiPageNS::~WikiPageNS()
 
 }
 
+//! Snapshot of default configuration, used until configuration of the site is parsed, so that edits
+//! and filters can be checked before that instead of failing
+static std::shared_ptr<const ProjectConfigurationSnapshot> defaultSnapshot(const QString &name)
+{
+    ProjectConfiguration defaults(name);
+    QStringList separators;
+    if (hcfg != nullptr)
+        separators = hcfg->SystemConfig_WordSeparators;
+    return std::shared_ptr<const ProjectConfigurationSnapshot>(new ProjectConfigurationSnapshot(&defaults, separators));
+}
+
 WikiSite::WikiSite(const WikiSite &w)
 {
     QList<int> k_ = w.NamespaceList.keys();
@@ -68,6 +82,7 @@ WikiSite::WikiSite(const WikiSite &w)
     this->ProjectConfig = w.ProjectConfig;
     this->WhiteList = w.WhiteList;
     this->Provider = w.Provider;
+    this->snapshot = std::atomic_load(&w.snapshot);
 }
 
 WikiSite::WikiSite(WikiSite *w)
@@ -89,6 +104,7 @@ WikiSite::WikiSite(WikiSite *w)
     this->SupportHttps = w->SupportHttps;
     this->ScriptPath = w->ScriptPath;
     this->Provider = w->Provider;
+    this->snapshot = std::atomic_load(&w->snapshot);
 }
 
 WikiSite::WikiSite(QString name, QString url)
@@ -102,6 +118,7 @@ WikiSite::WikiSite(QString name, QString url)
     this->SupportHttps = true;
     this->IRCChannel = "#test.wikipedia";
     this->WhiteList = "test.wikipedia";
+    this->snapshot = defaultSnapshot(name);
 }
 
 WikiSite::WikiSite(QString name, QString url, QString path, QString script, bool https, bool oauth, QString channel, QString wl, QString han, bool isrtl)
@@ -117,6 +134,7 @@ WikiSite::WikiSite(QString name, QString url, QString path, QString script, bool
     this->URL = url;
     this->IsRightToLeft = isrtl;
     this->WhiteList = wl;
+    this->snapshot = defaultSnapshot(name);
 }
 
 WikiSite::~WikiSite()
@@ -177,6 +195,21 @@ ProjectConfiguration *WikiSite::GetProjectConfig()
     return this->ProjectConfig;
 }
 
+std::shared_ptr<const ProjectConfigurationSnapshot> WikiSite::GetSnapshot()
+{
+    return std::atomic_load(&this->snapshot);
+}
+
+void WikiSite::PublishSnapshot()
+{
+    std::shared_ptr<const ProjectConfigurationSnapshot> compiled(new ProjectConfigurationSnapshot(this->GetProjectConfig(),
+                                                                                                  hcfg->SystemConfig_WordSeparators));
+    std::atomic_store(&this->snapshot, compiled);
+    // remembered warning levels might have been parsed using different templates or dates
+    HuggleParser::ClearLevelCache();
+    HUGGLE_DEBUG("Published new configuration snapshot for " + this->Name, 2);
+}
+
 UserConfiguration *WikiSite::GetUserConfig()
 {
     if (this->UserConfig == nullptr)
@@ -214,6 +247,68 @@ void WikiSite::ClearNS()
     }
 }
 
+bool WikiSite::ProcessSiteInfo(ApiQueryResult *result)
+{
+    ApiQueryResultNode *g_ = result->GetNode("general");
+    if (g_ == nullptr)
+        return false;
+    if (g_->Attributes.contains("rtl"))
+        this->IsRightToLeft = true;
+
+    if (g_->Attributes.contains("generator"))
+    {
+        QString vr = g_->GetAttribute("generator");
+        if (!vr.contains(" "))
+        {
+            Syslog::HuggleLogs->WarningLog("Mediawiki of " + this->Name + " has some invalid version: " + vr);
+        } else
+        {
+            vr = vr.mid(vr.indexOf(" ") + 1);
+            this->MediawikiVersion = Version(vr);
+            HUGGLE_DEBUG1(this->Name + " mediawiki " + this->MediawikiVersion.ToString());
+            if (this->MediawikiVersion < Version::SupportedMediawiki)
+                Syslog::HuggleLogs->WarningLog("Mediawiki of " + this->Name + " is using version " + this->MediawikiVersion.ToString() +
+                                               " which isn't supported by huggle");
+        }
+    } else
+    {
+        Syslog::HuggleLogs->WarningLog("MediaWiki of " + this->Name + " provides no version");
+    }
+    if (g_->Attributes.contains("time"))
+    {
+        QDateTime server_time = MediaWiki::FromMWTimestamp(g_->GetAttribute("time"));
+        this->GetProjectConfig()->ServerOffset = QDateTime::currentDateTime().secsTo(server_time);
+    }
+    QList<ApiQueryResultNode*> ns = result->GetNodes("ns");
+    if (ns.count() < 1)
+    {
+        Syslog::HuggleLogs->WarningLog(QString("Mediawiki of ") + this->Name + " provided no information about namespaces");
+    } else
+    {
+        // let's prepare a NS list
+        this->ClearNS();
+        int index = 0;
+        while (index < ns.count())
+        {
+            ApiQueryResultNode *node = ns.at(index);
+            index++;
+            if (!node->Attributes.contains("id") || !node->Attributes.contains("canonical"))
+                continue;
+            this->InsertNS(new WikiPageNS(node->GetAttribute("id").toInt(), node->Value, node->GetAttribute("canonical")));
+        }
+    }
+    // extensions
+    this->Extensions.clear();
+    QList<ApiQueryResultNode*> extensionlist = result->GetNodes("ext");
+    foreach(ApiQueryResultNode *ext, extensionlist)
+    {
+        this->Extensions.append(WikiSite_Ext(ext->GetAttribute("name", "unknown"), ext->GetAttribute("type", "unknown"),
+                  ext->GetAttribute("descriptionmsg", "unknown"), ext->GetAttribute("author", "unknown"),
+                  ext->GetAttribute("url", "unknown"), ext->GetAttribute("version", "0")));
+    }
+    return true;
+}
+
 WikiSite_Ext::WikiSite_Ext(QString name, QString type, QString description, QString author, QString url, QString version)
 {
     this->Description = description;
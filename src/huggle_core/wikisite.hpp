@@ -13,14 +13,17 @@
 
 #include "definitions.hpp"
 
+#include <memory>
 #include <QString>
 #include <QHash>
 #include "projectconfiguration.hpp"
+#include "projectconfigurationsnapshot.hpp"
 #include "userconfiguration.hpp"
 #include "version.hpp"
 
 namespace Huggle
 {
+    class ApiQueryResult;
     class HuggleFeed;
     class HuggleQueueFilter;
     //! Namespace (mediawiki)
@@ -101,10 +104,20 @@ namespace Huggle
             WikiPageNS *RetrieveNSFromTitle(QString title);
             WikiPageNS *RetrieveNSByCanonicalName(QString CanonicalName);
             ProjectConfiguration *GetProjectConfig();
+            //! Returns current compiled copy of project configuration, this is safe to call from any thread
+
+            //! Site always has some snapshot, until its configuration is parsed it's made of default values
+            std::shared_ptr<const ProjectConfigurationSnapshot> GetSnapshot();
+            //! Compile project configuration into a new snapshot and replace the current one with it
+            void PublishSnapshot();
             UserConfiguration    *GetUserConfig();
             void InsertNS(WikiPageNS *Ns);
             void RemoveNS(int ns);
             void ClearNS();
+            //! Load version, namespaces and extensions of this site from result of meta=siteinfo query
+
+            //! Returns false if the result doesn't contain general information about the site
+            bool ProcessSiteInfo(ApiQueryResult *result);
             HuggleQueueFilter *CurrentFilter = nullptr;
             //! If this is true it shouldn't be possible to login to wiki without SSL, it may be needed for some WMF sites which now require SSL
             bool ForceSSL = false;
@@ -133,6 +146,9 @@ namespace Huggle
             //! Whether the site supports the ssl
             bool SupportHttps;
             bool IsRightToLeft = false;
+        private:
+            //! Only accessed using atomic operations, so that it can be replaced while other threads read it
+            std::shared_ptr<const ProjectConfigurationSnapshot> snapshot;
     };
 }
 
@@ -15,6 +15,7 @@
 #include "exception.hpp"
 #include "huggleparser.hpp"
 #include "localization.hpp"
+#include "memorypool.hpp"
 #include "hooks.hpp"
 #include "huggleprofiler.hpp"
 #include "syslog.hpp"
@@ -37,6 +38,23 @@ QList<WikiUser*> WikiUser::ProblematicUsers;
 QMutex WikiUser::ProblematicUserListLock(QMutex::Recursive);
 QDateTime WikiUser::InvalidTime = QDateTime::fromMSecsSinceEpoch(2);
 
+static MemoryPool *userPool()
+{
+    // problematic users are kept until the process exits, so the pool can't be a static object
+    static MemoryPool *pool = new MemoryPool("WikiUser", sizeof(WikiUser));
+    return pool;
+}
+
+void *WikiUser::operator new(size_t size)
+{
+    return userPool()->Allocate(size);
+}
+
+void WikiUser::operator delete(void *ptr, size_t size)
+{
+    userPool()->Free(ptr, size);
+}
+
 WikiUser *WikiUser::RetrieveUser(WikiUser *user)
 {
     return WikiUser::RetrieveUser(user->Username, user->GetSite());
@@ -103,6 +121,7 @@ void WikiUser::UpdateUser(WikiUser *us)
             user->talkPageWasRetrieved = us->talkPageWasRetrieved;
             user->dateOfTalkPage = us->dateOfTalkPage;
             user->contentsOfTalkPage = us->contentsOfTalkPage;
+            user->talkPageRevID = us->talkPageRevID;
             if (!us->IsIP() && user->EditCount < 0)
             {
                 user->EditCount = us->EditCount;
@@ -189,6 +208,7 @@ WikiUser::WikiUser(WikiUser *u) : MediaWikiObject(u)
     this->dateOfTalkPage = u->dateOfTalkPage;
     this->IsBlocked = u->IsBlocked;
     this->contentsOfTalkPage = u->contentsOfTalkPage;
+    this->talkPageRevID = u->talkPageRevID;
     this->IsReported = u->IsReported;
     this->talkPageWasRetrieved = u->talkPageWasRetrieved;
     this->whitelistInfo = HUGGLE_WL_UNKNOWN;
@@ -210,6 +230,7 @@ WikiUser::WikiUser(const WikiUser &u) : MediaWikiObject(u)
     this->IsBlocked = u.IsBlocked;
     this->dateOfTalkPage = u.dateOfTalkPage;
     this->contentsOfTalkPage = u.contentsOfTalkPage;
+    this->talkPageRevID = u.talkPageRevID;
     this->talkPageWasRetrieved = u.talkPageWasRetrieved;
     this->whitelistInfo = HUGGLE_WL_UNKNOWN;
     this->isBot = u.isBot;
@@ -262,7 +283,7 @@ bool WikiUser::Resync()
     if (user && user != this)
     {
         this->BadnessScore = user->BadnessScore;
-        this->contentsOfTalkPage = user->TalkPage_GetContents();
+        this->contentsOfTalkPage = user->TalkPage_GetContents(&this->talkPageRevID);
         this->talkPageWasRetrieved = user->talkPageWasRetrieved;
         this->dateOfTalkPage = user->dateOfTalkPage;
         if (user->warningLevel > this->warningLevel)
@@ -278,7 +299,7 @@ bool WikiUser::Resync()
     return false;
 }
 
-QString WikiUser::TalkPage_GetContents()
+QString WikiUser::TalkPage_GetContents(revid_ht *revid)
 {
     HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
     // first we need to lock this object because it might be accessed from another thread in same moment
@@ -292,20 +313,25 @@ QString WikiUser::TalkPage_GetContents()
     {
         // we return a value of user from global db instead of local
         contents = user->contentsOfTalkPage;
+        if (revid != nullptr)
+            *revid = user->talkPageRevID;
         this->userMutex->unlock();
         return contents;
     }
     contents = this->contentsOfTalkPage;
+    if (revid != nullptr)
+        *revid = this->talkPageRevID;
     this->userMutex->unlock();
     return contents;
 }
 
-void WikiUser::TalkPage_SetContents(QString text)
+void WikiUser::TalkPage_SetContents(QString text, revid_ht revid)
 {
     HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
     this->userMutex->lock();
     this->talkPageWasRetrieved = true;
     this->contentsOfTalkPage = text;
+    this->talkPageRevID = revid;
     this->dateOfTalkPage = QDateTime::currentDateTime();
     this->Update();
     this->userMutex->unlock();
@@ -331,10 +357,11 @@ void WikiUser::Update(bool MatchingOnly)
 
 void WikiUser::ParseTP(QDate bt)
 {
-    QString tp = this->TalkPage_GetContents();
+    revid_ht revid = WIKI_UNKNOWN_REVID;
+    QString tp = this->TalkPage_GetContents(&revid);
     if (tp.length() > 0)
     {
-        this->warningLevel = HuggleParser::GetLevel(tp, bt, this->GetSite());
+        this->warningLevel = HuggleParser::GetLevel(tp, bt, this->GetSite(), this->Username, revid);
     }
 }
 
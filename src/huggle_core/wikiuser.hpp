@@ -58,6 +58,9 @@ namespace Huggle
             static QList<WikiUser*> ProblematicUsers;
             static QMutex ProblematicUserListLock;
             static QDateTime InvalidTime;
+            //! Users are allocated from a MemoryPool
+            static void *operator new(size_t size);
+            static void operator delete(void *ptr, size_t size);
 
             WikiUser(WikiSite *site);
             WikiUser(WikiUser *u);
@@ -73,14 +76,16 @@ namespace Huggle
              * Because this function needs to obtain the user from global cache it may be slow,
              * in case you need to use its value multiple times, cache it as QString instead
              * of calling this function repeatedly
+             * \param revid If not null, revision id of the talk page is stored there
              * \return a precached content of this users talk page
              */
-            QString TalkPage_GetContents();
+            QString TalkPage_GetContents(revid_ht *revid = nullptr);
             /*!
              * \brief SetContentsOfTalkPage Change a cache for talk page in local and global cache
              * \param text New content of talk page
+             * \param revid Revision id of the content, if it's known the warning level parsed from it is remembered
              */
-            void TalkPage_SetContents(QString text);
+            void TalkPage_SetContents(QString text, revid_ht revid = WIKI_UNKNOWN_REVID);
             //! Call UpdateUser on current user
             void Update(bool MatchingOnly = false);
             QString UnderscorelessUsername();
@@ -169,6 +174,7 @@ namespace Huggle
             byte_ht whitelistInfo;
             //! In case that we retrieved the talk page during parse of warning level, this string contains it
             QString contentsOfTalkPage;
+            revid_ht talkPageRevID = WIKI_UNKNOWN_REVID;
             bool talkPageWasRetrieved;
             //! This is a date when we retrieved this talk page
             QDateTime dateOfTalkPage;
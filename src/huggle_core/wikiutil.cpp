@@ -25,21 +25,11 @@
 
 using namespace Huggle;
 
-bool WikiUtil::IsRevert(QString Summary)
+bool WikiUtil::IsRevert(QString Summary, WikiSite *site)
 {
-    if (Summary.size() > 0)
-    {
-        int xx = 0;
-        while (xx < Configuration::HuggleConfiguration->ProjectConfig->_revertPatterns.count())
-        {
-            if (Summary.contains(Configuration::HuggleConfiguration->ProjectConfig->_revertPatterns.at(xx)))
-            {
-                return true;
-            }
-            xx++;
-        }
-    }
-    return false;
+    if (site == nullptr)
+        site = Configuration::HuggleConfiguration->Project;
+    return site->GetSnapshot()->IsRevert(Summary);
 }
 
 QString WikiUtil::MonthText(int n, WikiSite *site)
@@ -202,6 +192,7 @@ QString WikiUtil::SanitizeUser(QString username)
 Collectable_SmartPtr<ApiQuery> WikiUtil::Unwatchlist(WikiPage *page)
 {
     ApiQuery *wt = new ApiQuery(ActionUnwatch, page->GetSite());
+    wt->Priority = QueryPriority_Background;
     wt->RegisterConsumer(HUGGLECONSUMER_QP_WATCHLIST);
     wt->UsingPOST = true;
     wt->Target = page->PageName;
@@ -222,6 +213,7 @@ Collectable_SmartPtr<ApiQuery> WikiUtil::Unwatchlist(WikiPage *page)
 Collectable_SmartPtr<ApiQuery> WikiUtil::Watchlist(WikiPage *page)
 {
     ApiQuery *wt = new ApiQuery(ActionWatch, page->GetSite());
+    wt->Priority = QueryPriority_Background;
     wt->RegisterConsumer(HUGGLECONSUMER_QP_WATCHLIST);
     wt->UsingPOST = true;
     wt->Target = page->PageName;
@@ -435,7 +427,7 @@ ApiQuery *WikiUtil::RetrieveWikiPageContents(QString page, WikiSite *site, bool
 ApiQuery *WikiUtil::RetrieveWikiPageContents(WikiPage *page, bool parse)
 {
     // performance hack
-    static QString options = QUrl::toPercentEncoding("timestamp|user|comment|content");
+    static QString options = QUrl::toPercentEncoding("ids|timestamp|user|comment|content");
     ApiQuery *query = new ApiQuery(ActionQuery, page->Site);
     query->Target = "Retrieving contents of " + page->PageName;
     query->Parameters = "prop=revisions&rvlimit=1&rvprop=" + options + "&titles=" + QUrl::toPercentEncoding(page->PageName);
@@ -555,6 +547,7 @@ void WikiUtil::PatrolEdit(WikiEdit *edit)
     }
     if (flaggedrevs)
         query->Parameters += "&flag_accuracy=1";
+    query->Priority = QueryPriority_Background;
 
     HUGGLE_QP_APPEND(query);
     HUGGLE_DEBUG1("Patrolling " + edit->Page->PageName);
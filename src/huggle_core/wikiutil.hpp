@@ -50,7 +50,8 @@ namespace Huggle
          * \return           Pointer to ApiQuery
          */
         HUGGLE_EX_CORE Collectable_SmartPtr<ApiQuery> APIRequest(Action action, WikiSite *site, QString parameters, bool using_post = false, QString target = "");
-        HUGGLE_EX_CORE bool IsRevert(QString Summary);
+        //! Returns true if summary matches revert patterns of the site, if site is null, current project is used
+        HUGGLE_EX_CORE bool IsRevert(QString Summary, WikiSite *site = nullptr);
         //! Return a localized month for a current wiki
         HUGGLE_EX_CORE QString MonthText(int n, WikiSite *site = nullptr);
         /*!
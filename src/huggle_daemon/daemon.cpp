@@ -0,0 +1,605 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "daemon.hpp"
+#include "daemonqueue.hpp"
+#include <iostream>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+#include <QUrl>
+#include <huggle_core/apiquery.hpp>
+#include <huggle_core/apiquerycache.hpp>
+#include <huggle_core/apiqueryresult.hpp>
+#include <huggle_core/configuration.hpp>
+#include <huggle_core/core.hpp>
+#include <huggle_core/editpipeline.hpp>
+#include <huggle_core/exception.hpp>
+#include <huggle_core/gc.hpp>
+#include <huggle_core/hooks.hpp>
+#include <huggle_core/hugglefeed.hpp>
+#include <huggle_core/hugglefeedproviderirc.hpp>
+#include <huggle_core/hugglefeedproviderreplay.hpp>
+#include <huggle_core/hugglefeedproviderwiki.hpp>
+#include <huggle_core/hugglefeedproviderxml.hpp>
+#include <huggle_core/memorypool.hpp>
+#include <huggle_core/networkscheduler.hpp>
+#include <huggle_core/querypool.hpp>
+#include <huggle_core/syslog.hpp>
+#include <huggle_core/trafficcapture.hpp>
+#include <huggle_core/wikiedit.hpp>
+#include <huggle_core/wikipage.hpp>
+#include <huggle_core/wikisite.hpp>
+#include <huggle_core/wikiuser.hpp>
+#include <huggle_core/wlquery.hpp>
+
+using namespace Huggle;
+
+Daemon::Daemon(QObject *parent) : QObject(parent)
+{
+    this->Provider = HUGGLE_FEED_PROVIDER_XMLRPC;
+    this->pipeline = new EditPipeline();
+    this->queue = new DaemonQueue();
+    EditQueue::Primary = this->queue;
+    this->loadTimer = new QTimer(this);
+    this->timer = new QTimer(this);
+    this->statisticsTimer = new QTimer(this);
+    connect(this->loadTimer, SIGNAL(timeout()), this, SLOT(OnLoadTick()));
+    connect(this->timer, SIGNAL(timeout()), this, SLOT(OnTick()));
+    connect(this->statisticsTimer, SIGNAL(timeout()), this, SLOT(OnStatistics()));
+}
+
+Daemon::~Daemon()
+{
+    this->Shutdown();
+}
+
+void Daemon::Start()
+{
+    foreach (WikiSite *site, hcfg->Projects)
+    {
+        // daemon never logs in, so all sites are accessed anonymously and nothing can be changed on them
+        delete site->UserConfig;
+        site->UserConfig = new UserConfiguration();
+        delete site->ProjectConfig;
+        site->ProjectConfig = new ProjectConfiguration(site->Name);
+        site->ProjectConfig->Anonymous = true;
+        site->ProjectConfig->ReadOnly = true;
+        this->steps.insert(site, LoadStepSiteInfo);
+    }
+    // code which doesn't know the site of what it's working with uses configuration of the primary one
+    hcfg->ProjectConfig = hcfg->Project->GetProjectConfig();
+    if (!this->SocketName.isEmpty())
+    {
+        this->server = new QLocalServer();
+        QLocalServer::removeServer(this->SocketName);
+        if (!this->server->listen(this->SocketName))
+        {
+            this->fail("Unable to listen on socket " + this->SocketName + ": " + this->server->errorString());
+            return;
+        }
+        connect(this->server, SIGNAL(newConnection()), this, SLOT(OnConnection()));
+        HUGGLE_LOG("Listening on " + this->server->fullServerName());
+    }
+    // local config file replaces everything that would otherwise be loaded from wiki, including the global config
+    this->globalConfigIsLoaded = !this->ConfigFile.isEmpty();
+    this->loadTimer->start(HUGGLE_TIMER);
+}
+
+void Daemon::Quit(int code)
+{
+    this->loadTimer->stop();
+    this->timer->stop();
+    this->statisticsTimer->stop();
+    if (this->isRunning)
+        HUGGLE_LOG("Shutting down: " + QString(QJsonDocument(this->getStatistics()).toJson(QJsonDocument::Compact)));
+    this->isRunning = false;
+    foreach (QLocalSocket *socket, this->clients)
+        socket->disconnectFromServer();
+    // this may be called before event loop is started, in that case it would be ignored
+    QTimer::singleShot(0, [code]() { QCoreApplication::exit(code); });
+}
+
+void Daemon::Shutdown()
+{
+    if (this->pipeline == nullptr)
+        return;
+    this->loadTimer->stop();
+    this->timer->stop();
+    this->statisticsTimer->stop();
+    foreach (ApiQuery *query, this->queries)
+        query->DecRef();
+    this->queries.clear();
+    foreach (WLQuery *query, this->wlQueries)
+        query->DecRef();
+    this->wlQueries.clear();
+    if (this->qGlobalConfig != nullptr)
+        this->qGlobalConfig->DecRef();
+    this->qGlobalConfig = nullptr;
+    foreach (WikiSite *site, hcfg->Projects)
+    {
+        if (site->Provider && site->Provider->IsWorking())
+            site->Provider->Stop();
+        site->Provider = nullptr;
+    }
+    qDeleteAll(this->feeds);
+    this->feeds.clear();
+    // sockets are owned by server
+    foreach (QLocalSocket *socket, this->clients)
+        socket->disconnect(this);
+    this->clients.clear();
+    this->buffers.clear();
+    delete this->server;
+    this->server = nullptr;
+    delete this->pipeline;
+    this->pipeline = nullptr;
+    if (EditQueue::Primary == this->queue)
+        EditQueue::Primary = nullptr;
+    delete this->queue;
+    this->queue = nullptr;
+}
+
+void Daemon::OnLoadTick()
+{
+    if (!this->globalConfigIsLoaded)
+    {
+        if (!this->loadGlobalConfig())
+            return;
+    }
+    bool done = true;
+    foreach (WikiSite *site, hcfg->Projects)
+    {
+        if (this->steps[site] != LoadStepDone)
+        {
+            this->loadSite(site);
+            // loading failed and daemon is exiting
+            if (!this->loadTimer->isActive())
+                return;
+            done = done && (this->steps[site] == LoadStepDone);
+        }
+    }
+    if (done)
+    {
+        this->loadTimer->stop();
+        this->startProviders();
+    }
+}
+
+void Daemon::OnTick()
+{
+    // same processing as main window does, just without the interface
+    this->pipeline->RetrieveEdits(hcfg->Projects);
+    foreach (WikiEdit *edit, this->pipeline->TakeReadyEdits())
+    {
+        this->queue->AddItem(edit);
+        if (this->queue->Contains(edit))
+        {
+            this->editsQueued++;
+            QJsonObject object = this->editToJson(edit);
+            object.insert("event", QString("edit"));
+            this->send(object);
+        }
+        edit->DecRef();
+    }
+    this->pipeline->FinalizePostProcessing();
+    QueryPool::HugglePool->CheckQueries();
+}
+
+void Daemon::OnStatistics()
+{
+    HUGGLE_LOG("Statistics: " + QString(QJsonDocument(this->getStatistics()).toJson(QJsonDocument::Compact)));
+    HUGGLE_DEBUG1("Network queues: " + NetworkScheduler::HuggleScheduler->GetStatistics());
+    HUGGLE_DEBUG1("Api cache: " + ApiQueryCache::HuggleCache->GetStatistics());
+    HUGGLE_DEBUG1("Memory pools:\n" + MemoryPool::GetStatistics());
+}
+
+void Daemon::OnConnection()
+{
+    while (this->server->hasPendingConnections())
+    {
+        QLocalSocket *socket = this->server->nextPendingConnection();
+        this->clients.append(socket);
+        this->buffers.insert(socket, QByteArray());
+        connect(socket, SIGNAL(readyRead()), this, SLOT(OnReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(OnDisconnected()));
+    }
+}
+
+void Daemon::OnReadyRead()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket*>(QObject::sender());
+    if (socket == nullptr)
+        return;
+    QByteArray buffer = this->buffers.value(socket) + socket->readAll();
+    int end;
+    while ((end = buffer.indexOf('\n')) >= 0)
+    {
+        QString command = QString::fromUtf8(buffer.left(end)).trimmed();
+        buffer.remove(0, end + 1);
+        if (!command.isEmpty())
+            this->processCommand(socket, command);
+    }
+    // client may have disconnected while its commands were processed
+    if (this->buffers.contains(socket))
+        this->buffers.insert(socket, buffer);
+}
+
+void Daemon::OnDisconnected()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket*>(QObject::sender());
+    if (socket == nullptr)
+        return;
+    this->clients.removeAll(socket);
+    this->buffers.remove(socket);
+    socket->deleteLater();
+}
+
+bool Daemon::loadGlobalConfig()
+{
+    if (this->qGlobalConfig == nullptr)
+    {
+        HUGGLE_LOG("Loading global configuration from " + hcfg->GlobalConfigurationWikiAddress);
+        this->qGlobalConfig = new ApiQuery(ActionQuery, hcfg->GlobalWiki);
+        this->qGlobalConfig->IncRef();
+        this->qGlobalConfig->OverrideWiki = hcfg->GlobalConfigurationWikiAddress;
+        this->qGlobalConfig->Parameters = "prop=revisions&rvprop=content&rvlimit=1&titles=" + hcfg->SystemConfig_GlobalConfigYAML;
+        this->qGlobalConfig->Process();
+        return false;
+    }
+    if (!this->qGlobalConfig->IsProcessed())
+        return false;
+    ApiQuery *query = this->qGlobalConfig;
+    this->qGlobalConfig = nullptr;
+    if (query->IsFailed())
+    {
+        this->fail("Unable to load global configuration: " + query->GetFailureReason());
+        query->DecRef();
+        return false;
+    }
+    ApiQueryResultNode *data = query->GetApiQueryResult()->GetNode("rev");
+    if (data == nullptr || !hcfg->ParseGlobalConfig(data->Value))
+    {
+        this->fail("Unable to parse global configuration");
+        query->DecRef();
+        return false;
+    }
+    query->DecRef();
+    if (!hcfg->GlobalConfig_EnableAll)
+    {
+        this->fail("Huggle is disabled in global configuration");
+        return false;
+    }
+    this->globalConfigIsLoaded = true;
+    return true;
+}
+
+void Daemon::loadSite(WikiSite *site)
+{
+    switch (this->steps[site])
+    {
+        case LoadStepSiteInfo:
+            this->loadSiteInfo(site);
+            return;
+        case LoadStepConfig:
+            this->loadConfig(site, false);
+            return;
+        case LoadStepLegacyConfig:
+            this->loadConfig(site, true);
+            return;
+        case LoadStepWhitelist:
+            this->loadWhitelist(site);
+            return;
+        case LoadStepDone:
+            return;
+    }
+}
+
+void Daemon::loadSiteInfo(WikiSite *site)
+{
+    if (!this->queries.contains(site))
+    {
+        HUGGLE_LOG("Loading site info of " + site->Name);
+        ApiQuery *query = new ApiQuery(ActionQuery, site);
+        query->IncRef();
+        query->Parameters = "meta=siteinfo&siprop=" + QUrl::toPercentEncoding("namespaces|general|extensions");
+        query->Process();
+        this->queries.insert(site, query);
+        return;
+    }
+    ApiQuery *query = this->finishedQuery(site);
+    if (query == nullptr)
+        return;
+    if (query->IsFailed())
+        this->fail("Unable to load site info of " + site->Name + ": " + query->GetFailureReason());
+    else if (!site->ProcessSiteInfo(query->GetApiQueryResult()))
+        this->fail("Mediawiki of " + site->Name + " returned no site info");
+    else
+        this->steps[site] = LoadStepConfig;
+    query->DecRef();
+}
+
+void Daemon::loadConfig(WikiSite *site, bool legacy)
+{
+    if (!this->ConfigFile.isEmpty())
+    {
+        QFile file(this->ConfigFile);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            this->fail("Unable to read " + this->ConfigFile);
+            return;
+        }
+        QString text = QString::fromUtf8(file.readAll());
+        file.close();
+        bool yaml = !this->ConfigFile.endsWith(".txt") && !this->ConfigFile.endsWith(".css");
+        if (this->parseConfig(site, text, yaml))
+            this->steps[site] = LoadStepWhitelist;
+        return;
+    }
+    QString page = legacy ? hcfg->GlobalConfig_LocalConfigWikiPath : hcfg->GlobalConfig_LocalConfigYAMLPath;
+    if (!hcfg->GlobalConfig_OverrideConfigYAMLPath.isEmpty() && !legacy)
+        page = hcfg->GlobalConfig_OverrideConfigYAMLPath;
+    if (!this->queries.contains(site))
+    {
+        HUGGLE_LOG("Loading " + page + " of " + site->Name);
+        ApiQuery *query = new ApiQuery(ActionQuery, site);
+        query->IncRef();
+        query->Parameters = "prop=revisions&rvprop=content&rvlimit=1&titles=" + QUrl::toPercentEncoding(page);
+        query->Process();
+        this->queries.insert(site, query);
+        return;
+    }
+    ApiQuery *query = this->finishedQuery(site);
+    if (query == nullptr)
+        return;
+    ApiQueryResultNode *data = nullptr;
+    if (!query->IsFailed())
+        data = query->GetApiQueryResult()->GetNode("rev");
+    if (data == nullptr)
+    {
+        if (legacy)
+        {
+            this->fail("Unable to load configuration of " + site->Name);
+        } else
+        {
+            HUGGLE_WARNING(site->Name + " - YAML configuration not found, falling back to deprecated config page");
+            this->steps[site] = LoadStepLegacyConfig;
+        }
+        query->DecRef();
+        return;
+    }
+    QString text = data->Value;
+    query->DecRef();
+    if (this->parseConfig(site, text, !legacy))
+        this->steps[site] = LoadStepWhitelist;
+}
+
+void Daemon::loadWhitelist(WikiSite *site)
+{
+    if (!hcfg->SystemConfig_WhitelistDisabled && hcfg->GlobalConfig_Whitelist.isEmpty())
+    {
+        HUGGLE_WARNING("There is no whitelist defined in global config, disabling whitelist globally");
+        hcfg->SystemConfig_WhitelistDisabled = true;
+    }
+    // whitelist can only be found using global config
+    if (hcfg->SystemConfig_WhitelistDisabled || !this->ConfigFile.isEmpty())
+    {
+        this->steps[site] = LoadStepDone;
+        return;
+    }
+    if (!this->wlQueries.contains(site))
+    {
+        WLQuery *query = new WLQuery(site);
+        query->IncRef();
+        query->RetryOnTimeoutFailure = false;
+        query->Process();
+        this->wlQueries.insert(site, query);
+        return;
+    }
+    WLQuery *query = this->wlQueries[site];
+    if (!query->IsProcessed())
+        return;
+    this->wlQueries.remove(site);
+    if (query->IsFailed())
+    {
+        HUGGLE_WARNING("Unable to load whitelist of " + site->Name + ": " + query->GetFailureReason());
+    } else
+    {
+        QString list = query->Result->Data;
+        list = list.replace("<!-- list -->", "");
+        site->GetProjectConfig()->WhiteList = list.split("|");
+        site->GetProjectConfig()->WhiteList.removeAll("");
+    }
+    query->DecRef();
+    this->steps[site] = LoadStepDone;
+}
+
+bool Daemon::parseConfig(WikiSite *site, const QString &text, bool yaml)
+{
+    QString reason;
+    bool parsed;
+    if (yaml)
+        parsed = site->GetProjectConfig()->ParseYAML(text, &reason, site);
+    else
+        parsed = site->GetProjectConfig()->Parse(text, &reason, site);
+    if (!parsed)
+    {
+        this->fail("Unable to parse configuration of " + site->Name + ": " + reason);
+        return false;
+    }
+    if (!site->GetProjectConfig()->EnableAll)
+    {
+        this->fail("Huggle is disabled on " + site->Name);
+        return false;
+    }
+    // configuration of the project may turn read only mode off, but daemon has no account to write with
+    site->GetProjectConfig()->ReadOnly = true;
+    return true;
+}
+
+void Daemon::fail(QString reason)
+{
+    HUGGLE_ERROR(reason);
+    this->Quit(1);
+}
+
+void Daemon::startProviders()
+{
+    if (!this->XmlRcsServer.isEmpty())
+        hcfg->GlobalConfig_Xmlrcs = this->XmlRcsServer;
+    if (this->XmlRcsPort)
+        hcfg->GlobalConfig_XmlrcsPort = this->XmlRcsPort;
+    if (!this->IRCServer.isEmpty())
+        hcfg->IRCServer = this->IRCServer;
+    if (this->IRCPort)
+        hcfg->IRCPort = this->IRCPort;
+    foreach (WikiSite *site, hcfg->Projects)
+    {
+        this->feeds.append(new HuggleFeedProviderWiki(site));
+        this->feeds.append(new HuggleFeedProviderIRC(site));
+        this->feeds.append(new HuggleFeedProviderXml(site));
+        if (TrafficReplay::Replay)
+            this->feeds.append(new HuggleFeedProviderReplay(site, TrafficReplay::Replay));
+        Hooks::FeedProvidersOnInit(site);
+        int id = TrafficReplay::Replay ? HUGGLE_FEED_PROVIDER_REPLAY : this->Provider;
+        if (id == HUGGLE_FEED_PROVIDER_IRC && !site->GetProjectConfig()->UseIrc)
+        {
+            HUGGLE_WARNING("IRC feed is not available on " + site->Name + ", using XmlRcs instead");
+            id = HUGGLE_FEED_PROVIDER_XMLRPC;
+        }
+        if (id == HUGGLE_FEED_PROVIDER_XMLRPC && site->XmlRcsName.isEmpty())
+            id = HUGGLE_FEED_PROVIDER_WIKI;
+        site->Provider = HuggleFeed::GetProviderByID(site, id);
+        if (site->Provider == nullptr || !site->Provider->Start())
+        {
+            this->fail("Unable to start feed provider of " + site->Name);
+            return;
+        }
+        HUGGLE_LOG("Started " + site->Provider->ToString() + " feed for " + site->Name);
+    }
+    this->isRunning = true;
+    this->timer->start(HUGGLE_TIMER);
+    if (this->StatisticsInterval > 0)
+        this->statisticsTimer->start(this->StatisticsInterval * 1000);
+}
+
+ApiQuery *Daemon::finishedQuery(WikiSite *site)
+{
+    ApiQuery *query = this->queries[site];
+    if (!query->IsProcessed())
+        return nullptr;
+    this->queries.remove(site);
+    return query;
+}
+
+QJsonObject Daemon::editToJson(WikiEdit *edit)
+{
+    QJsonObject object;
+    object.insert("wiki", edit->GetSite()->Name);
+    object.insert("revid", static_cast<qint64>(edit->RevID));
+    object.insert("oldid", static_cast<qint64>(edit->OldID));
+    object.insert("title", edit->Page->PageName);
+    object.insert("user", edit->User->Username);
+    object.insert("anonymous", edit->User->IsIP());
+    object.insert("score", static_cast<qint64>(edit->Score));
+    object.insert("score_words", QJsonArray::fromStringList(edit->ScoreWords));
+    object.insert("warning_level", static_cast<int>(edit->CurrentUserWarningLevel));
+    object.insert("minor", edit->IsMinor);
+    object.insert("bot", edit->Bot);
+    object.insert("new_page", edit->NewPage);
+    object.insert("revert", edit->IsRevert);
+    if (edit->SizeIsKnown)
+        object.insert("size", static_cast<qint64>(edit->GetSize()));
+    object.insert("summary", edit->Summary);
+    object.insert("time", edit->Time.toUTC().toString(Qt::ISODate));
+    object.insert("url", edit->GetFullUrl());
+    return object;
+}
+
+QJsonObject Daemon::getStatistics()
+{
+    QJsonObject object;
+    object.insert("event", QString("stats"));
+    object.insert("retrieved", static_cast<qint64>(this->pipeline->Retrieved));
+    object.insert("ready", static_cast<qint64>(this->pipeline->Ready));
+    object.insert("filtered", static_cast<qint64>(this->pipeline->Filtered));
+    object.insert("queued", static_cast<qint64>(this->editsQueued));
+    object.insert("pending", this->pipeline->GetPendingCount());
+    object.insert("post_processing", QueryPool::HugglePool->ProcessingEdits.count());
+    object.insert("queue", this->queue->Count());
+    object.insert("latency_avg_ms", this->pipeline->GetAverageLatency());
+    object.insert("latency_max_ms", this->pipeline->GetMaximumLatency());
+    object.insert("queries", QueryPool::HugglePool->RunningQueriesGetCount());
+    GC::gc->Lock->lock();
+    object.insert("gc_objects", GC::gc->list.count());
+    GC::gc->Lock->unlock();
+    QJsonObject feeds;
+    foreach (WikiSite *site, hcfg->Projects)
+    {
+        if (site->Provider != nullptr)
+            feeds.insert(site->Name, site->Provider->GetEditsPerMinute());
+    }
+    object.insert("edits_per_minute", feeds);
+    return object;
+}
+
+void Daemon::send(const QJsonObject &object, QLocalSocket *socket)
+{
+    QByteArray line = QJsonDocument(object).toJson(QJsonDocument::Compact) + "\n";
+    if (socket != nullptr)
+    {
+        socket->write(line);
+        return;
+    }
+    if (this->PrintEdits)
+        std::cout << line.constData() << std::flush;
+    foreach (QLocalSocket *client, this->clients)
+        client->write(line);
+}
+
+void Daemon::processCommand(QLocalSocket *socket, QString command)
+{
+    if (command == "next")
+    {
+        QJsonObject object;
+        WikiEdit *edit = this->queue->Take();
+        if (edit != nullptr)
+        {
+            object = this->editToJson(edit);
+            edit->DecRef();
+        }
+        object.insert("event", QString("next"));
+        this->send(object, socket);
+    } else if (command == "queue")
+    {
+        QJsonArray edits;
+        foreach (WikiEdit *edit, this->queue->Items)
+            edits.append(this->editToJson(edit));
+        QJsonObject object;
+        object.insert("event", QString("queue"));
+        object.insert("edits", edits);
+        this->send(object, socket);
+    } else if (command == "stats")
+    {
+        this->send(this->getStatistics(), socket);
+    } else if (command == "quit")
+    {
+        this->Quit();
+    } else
+    {
+        QJsonObject object;
+        object.insert("event", QString("error"));
+        object.insert("error", QString("Unknown command: " + command));
+        this->send(object, socket);
+    }
+}
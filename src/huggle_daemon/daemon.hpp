@@ -0,0 +1,120 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef DAEMON_HPP
+#define DAEMON_HPP
+
+#include <huggle_core/definitions.hpp>
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class QLocalServer;
+class QLocalSocket;
+class QTimer;
+
+namespace Huggle
+{
+    class ApiQuery;
+    class DaemonQueue;
+    class EditPipeline;
+    class HuggleFeed;
+    class WikiEdit;
+    class WikiSite;
+    class WLQuery;
+
+    //! Runs the edit pipeline of huggle without user interface
+
+    //! Daemon loads configuration of all sites anonymously, starts their feed providers and then
+    //! post processes and scores all edits the same way main window does. Edits that make it
+    //! to queue are written to stdout as JSON, one edit per line, and the queue can be accessed
+    //! by other programs using a local socket. Nothing is ever written to the wiki.
+    class Daemon : public QObject
+    {
+            Q_OBJECT
+        public:
+            Daemon(QObject *parent = nullptr);
+            ~Daemon();
+            //! Start loading of sites in hcfg->Projects, edits are processed once all of them are loaded
+            void Start();
+            //! Release all edits, queries and providers, this must be done before core is shut down
+            void Shutdown();
+            //! Path to file with project configuration that is used instead of the one on wiki
+            QString ConfigFile;
+            //! ID of preferred feed provider, see HUGGLE_FEED_PROVIDER_*
+            int Provider;
+            //! Name of local socket which clients can use to access the queue, empty disables it
+            QString SocketName;
+            //! Write every edit that enters the queue to stdout
+            bool PrintEdits = true;
+            //! How often statistics are written to stderr, in seconds
+            int StatisticsInterval = 0;
+            //! Overrides of feed servers, which are applied after global config is loaded
+            QString XmlRcsServer;
+            int XmlRcsPort = 0;
+            QString IRCServer;
+            int IRCPort = 0;
+        public slots:
+            //! Stop processing of edits and exit the event loop
+            void Quit(int code = 0);
+        private slots:
+            void OnLoadTick();
+            void OnTick();
+            void OnStatistics();
+            void OnConnection();
+            void OnReadyRead();
+            void OnDisconnected();
+        private:
+            enum LoadStep
+            {
+                LoadStepSiteInfo,
+                LoadStepConfig,
+                LoadStepLegacyConfig,
+                LoadStepWhitelist,
+                LoadStepDone
+            };
+            bool loadGlobalConfig();
+            void loadSite(WikiSite *site);
+            void loadSiteInfo(WikiSite *site);
+            void loadConfig(WikiSite *site, bool legacy);
+            void loadWhitelist(WikiSite *site);
+            bool parseConfig(WikiSite *site, const QString &text, bool yaml);
+            void fail(QString reason);
+            void startProviders();
+            //! Take finished query of the site, returns nullptr if it's still running
+            ApiQuery *finishedQuery(WikiSite *site);
+            QJsonObject editToJson(WikiEdit *edit);
+            QJsonObject getStatistics();
+            void send(const QJsonObject &object, QLocalSocket *socket = nullptr);
+            void processCommand(QLocalSocket *socket, QString command);
+            EditPipeline *pipeline;
+            DaemonQueue *queue;
+            QTimer *loadTimer;
+            QTimer *timer;
+            QTimer *statisticsTimer;
+            QLocalServer *server = nullptr;
+            QList<HuggleFeed*> feeds;
+            QList<QLocalSocket*> clients;
+            QHash<QLocalSocket*, QByteArray> buffers;
+            ApiQuery *qGlobalConfig = nullptr;
+            bool globalConfigIsLoaded = false;
+            QHash<WikiSite*, LoadStep> steps;
+            QHash<WikiSite*, ApiQuery*> queries;
+            QHash<WikiSite*, WLQuery*> wlQueries;
+            bool isRunning = false;
+            unsigned long long editsQueued = 0;
+    };
+}
+
+#endif // DAEMON_HPP
@@ -0,0 +1,157 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "daemonqueue.hpp"
+#include <huggle_core/configuration.hpp>
+#include <huggle_core/exception.hpp>
+#include <huggle_core/hooks.hpp>
+#include <huggle_core/syslog.hpp>
+#include <huggle_core/userconfiguration.hpp>
+#include <huggle_core/wikiedit.hpp>
+#include <huggle_core/wikipage.hpp>
+
+using namespace Huggle;
+
+DaemonQueue::DaemonQueue()
+{
+
+}
+
+DaemonQueue::~DaemonQueue()
+{
+    while (!this->Items.isEmpty())
+        this->remove(0);
+}
+
+void DaemonQueue::AddItem(WikiEdit *edit)
+{
+    if (edit == nullptr)
+        throw new Huggle::NullPointerException("WikiEdit *edit", BOOST_CURRENT_FUNCTION);
+
+    if (!edit->IsPostProcessed())
+        throw new Huggle::Exception("Insert of non processed edit to queue", BOOST_CURRENT_FUNCTION);
+
+    if (!edit->IsValid)
+    {
+        HUGGLE_DEBUG1("Not inserting edit " + edit->Page->PageName + " because it's broken");
+        return;
+    }
+
+    if (!Hooks::OnEditLoadToQueue(edit))
+    {
+        HUGGLE_DEBUG("Queue: extension hook rejected edit " + edit->Page->PageName, 3);
+        return;
+    }
+
+    if (hcfg->UserConfig->EnableMaxScore && (hcfg->UserConfig->MaxScore < edit->Score))
+        return;
+
+    if (hcfg->UserConfig->EnableMinScore && (hcfg->UserConfig->MinScore > edit->Score))
+        return;
+
+    if (hcfg->UserConfig->TruncateEdits)
+        this->DeleteOlder(edit);
+
+    // edits with same score keep the order in which they arrived
+    int index = 0;
+    while (index < this->Items.count() && this->Items.at(index)->Score >= edit->Score)
+        index++;
+    if (index >= hcfg->SystemConfig_QueueSize)
+        return;
+    edit->RegisterConsumer(HUGGLECONSUMER_QUEUE);
+    this->Items.insert(index, edit);
+    while (this->Items.count() > hcfg->SystemConfig_QueueSize)
+        this->remove(this->Items.count() - 1);
+}
+
+int DaemonQueue::DeleteByScore(long Score)
+{
+    int result = 0;
+    int index = 0;
+    while (index < this->Items.count())
+    {
+        if (this->Items.at(index)->Score < Score)
+        {
+            this->remove(index);
+            result++;
+            continue;
+        }
+        index++;
+    }
+    return result;
+}
+
+bool DaemonQueue::DeleteByRevID(revid_ht RevID, WikiSite *site)
+{
+    int index = 0;
+    while (index < this->Items.count())
+    {
+        WikiEdit *edit = this->Items.at(index);
+        if (edit->RevID == RevID && edit->GetSite() == site)
+        {
+            this->remove(index);
+            return true;
+        }
+        index++;
+    }
+    return false;
+}
+
+void DaemonQueue::DeleteOlder(WikiEdit *edit)
+{
+    int index = 0;
+    while (index < this->Items.count())
+    {
+        WikiEdit *item = this->Items.at(index);
+        if (edit->RevID > item->RevID && edit->GetSite() == item->GetSite() && edit->Page->SanitizedName() == item->Page->SanitizedName())
+        {
+            HUGGLE_DEBUG("Deleting old edit to page " + item->Page->PageName, 3);
+            this->remove(index);
+            continue;
+        }
+        index++;
+    }
+}
+
+WikiEdit *DaemonQueue::GetWikiEditByRevID(revid_ht RevID, WikiSite *site)
+{
+    foreach (WikiEdit *edit, this->Items)
+    {
+        if (edit->RevID == RevID && edit->GetSite() == site)
+            return edit;
+    }
+    return nullptr;
+}
+
+bool DaemonQueue::Contains(WikiEdit *edit)
+{
+    return this->Items.contains(edit);
+}
+
+WikiEdit *DaemonQueue::Take()
+{
+    if (this->Items.isEmpty())
+        return nullptr;
+    WikiEdit *edit = this->Items.takeFirst();
+    edit->IncRef();
+    edit->UnregisterConsumer(HUGGLECONSUMER_QUEUE);
+    return edit;
+}
+
+int DaemonQueue::Count()
+{
+    return this->Items.count();
+}
+
+void DaemonQueue::remove(int index)
+{
+    WikiEdit *edit = this->Items.takeAt(index);
+    edit->UnregisterConsumer(HUGGLECONSUMER_QUEUE);
+}
@@ -0,0 +1,45 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef DAEMONQUEUE_HPP
+#define DAEMONQUEUE_HPP
+
+#include <huggle_core/definitions.hpp>
+
+#include <QList>
+#include <huggle_core/editqueue.hpp>
+
+namespace Huggle
+{
+    //! Queue of edits without any user interface
+
+    //! Edits are kept sorted by score, the worst edit first, and the queue never grows over
+    //! the size of queue in system config, edits with lowest score are dropped instead.
+    class DaemonQueue : public EditQueue
+    {
+        public:
+            DaemonQueue();
+            ~DaemonQueue();
+            void AddItem(WikiEdit *edit);
+            int DeleteByScore(long Score);
+            bool DeleteByRevID(revid_ht RevID, WikiSite *site);
+            void DeleteOlder(WikiEdit *edit);
+            WikiEdit *GetWikiEditByRevID(revid_ht RevID, WikiSite *site);
+            bool Contains(WikiEdit *edit);
+            //! Remove the edit with highest score from queue, caller must release it using DecRef()
+            WikiEdit *Take();
+            int Count();
+            QList<WikiEdit*> Items;
+        private:
+            void remove(int index);
+    };
+}
+
+#endif // DAEMONQUEUE_HPP
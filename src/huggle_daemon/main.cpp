@@ -0,0 +1,210 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+// Headless huggle which scores edits from recent changes feed without the interface, edits that
+// would be inserted to queue are written to stdout as JSON lines, logs go to stderr.
+
+#include <huggle_core/definitions.hpp>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTimer>
+#include <huggle_core/configuration.hpp>
+#include <huggle_core/core.hpp>
+#include <huggle_core/exception.hpp>
+#include <huggle_core/hugglefeed.hpp>
+#include <huggle_core/syslog.hpp>
+#include <huggle_core/trafficcapture.hpp>
+#include <huggle_core/userconfiguration.hpp>
+#include <huggle_core/wikisite.hpp>
+#include <huggle_l10n/huggle_l10n.hpp>
+#include "daemon.hpp"
+
+using namespace Huggle;
+
+static bool splitServer(QString text, QString *server, int *port)
+{
+    int colon = text.lastIndexOf(':');
+    if (colon < 0)
+    {
+        *server = text;
+        return true;
+    }
+    bool ok;
+    *server = text.left(colon);
+    *port = text.mid(colon + 1).toInt(&ok);
+    return ok;
+}
+
+static int Fatal(Huggle::Exception *fail)
+{
+    Huggle::Syslog::HuggleLogs->ErrorLog("FATAL: Unhandled exception occured, description: " + fail->Message
+                                         + "\nSource: " + fail->Source + "\nStack: " + fail->StackTrace);
+    delete Huggle::Core::HuggleCore;
+    return fail->ErrorCode;
+}
+
+int main(int argc, char *argv[])
+{
+    int ReturnCode = 0;
+    try
+    {
+        QCoreApplication application(argc, argv);
+        QCoreApplication::setApplicationName("Huggle");
+        QCoreApplication::setOrganizationName("Wikimedia");
+        QCommandLineParser parser;
+        parser.setApplicationDescription("Huggle daemon, scores edits of wikis without user interface");
+        parser.addHelpOption();
+        QCommandLineOption wiki("wiki", "Name of wiki from wiki list, can be used more than once", "name");
+        QCommandLineOption url("url", "Override address of wiki, or define a new one, for example enwiki=127.0.0.1:8080/", "name=url");
+        QCommandLineOption no_ssl("no-ssl", "Don't use https to access wikis");
+        QCommandLineOption provider("provider", "Feed provider: xmlrcs, irc or wiki", "provider", "xmlrcs");
+        QCommandLineOption xmlrcs("xmlrcs", "Address of XmlRcs server", "host:port");
+        QCommandLineOption irc("irc", "Address of irc server", "host:port");
+        QCommandLineOption config_file("config-file", "Local project configuration used instead of the one on wiki, "
+                                                      "files ending with .txt are parsed as old style config", "path");
+        QCommandLineOption socket("socket", "Name of local socket which provides access to queue", "name");
+        QCommandLineOption min_score("min-score", "Edits with lower score are not inserted to queue", "score");
+        QCommandLineOption queue_size("queue-size", "Maximal number of edits in queue", "edits");
+        QCommandLineOption quiet("quiet", "Don't write edits to stdout, only to clients of socket");
+        QCommandLineOption statistics("statistics", "Write statistics to stderr every n seconds", "seconds", "0");
+        QCommandLineOption duration("duration", "Exit after n seconds", "seconds", "0");
+        QCommandLineOption record("record", "Record feed and api traffic to a capture file", "file");
+        QCommandLineOption replay("replay", "Serve feed and api traffic from a capture file instead of network", "file");
+        QCommandLineOption replay_speed("replay-speed", "Speed of replay, for example 1, 4x or max", "speed", "1");
+        QCommandLineOption verbose("v", "Increase verbosity");
+        parser.addOptions(QList<QCommandLineOption>() << wiki << url << no_ssl << provider << xmlrcs << irc << config_file << socket
+                                                      << min_score << queue_size << quiet << statistics << duration << record
+                                                      << replay << replay_speed << verbose);
+        parser.process(application);
+
+        // stdout only contains the edits, so that it can be piped to other programs
+        Syslog::HuggleLogs->TerminalStderr = true;
+        Syslog::HuggleLogs->EnableLogWriteBuffer = false;
+        Configuration::HuggleConfiguration = new Configuration();
+        hcfg->Verbosity += static_cast<unsigned int>(parser.optionNames().count("v"));
+        hcfg->TrafficRecordPath = parser.value(record);
+        hcfg->TrafficReplayPath = parser.value(replay);
+        bool speed_ok;
+        hcfg->TrafficReplaySpeed = TrafficReplay::ParseSpeed(parser.value(replay_speed), &speed_ok);
+        if (!speed_ok)
+        {
+            HUGGLE_ERROR("Invalid replay speed: " + parser.value(replay_speed));
+            return 1;
+        }
+        Huggle_l10n::Init();
+        Core::HuggleCore = new Core();
+        Core::HuggleCore->Init();
+        if (parser.isSet(no_ssl))
+            hcfg->SystemConfig_UsingSSL = false;
+
+        foreach (QString override, parser.values(url))
+        {
+            QString name = override.section('=', 0, 0);
+            QString address = override.section('=', 1);
+            if (name.isEmpty() || address.isEmpty())
+            {
+                HUGGLE_ERROR("Invalid url: " + override);
+                return 1;
+            }
+            if (!address.endsWith("/"))
+                address += "/";
+            WikiSite *site = nullptr;
+            foreach (WikiSite *project, hcfg->ProjectList)
+            {
+                if (project->Name == name)
+                    site = project;
+            }
+            if (site == nullptr)
+            {
+                site = new WikiSite(name, address);
+                site->XmlRcsName = address.left(address.indexOf('/'));
+                hcfg->ProjectList.append(site);
+            }
+            site->URL = address;
+        }
+        QStringList wikis = parser.values(wiki);
+        if (wikis.isEmpty())
+            wikis << "enwiki";
+        hcfg->Projects.clear();
+        foreach (QString name, wikis)
+        {
+            WikiSite *site = nullptr;
+            foreach (WikiSite *project, hcfg->ProjectList)
+            {
+                if (project->Name == name)
+                    site = project;
+            }
+            if (site == nullptr)
+            {
+                HUGGLE_ERROR("There is no such wiki: " + name);
+                return 1;
+            }
+            if (!hcfg->Projects.contains(site))
+                hcfg->Projects << site;
+        }
+        hcfg->Project = hcfg->Projects.at(0);
+        hcfg->SystemConfig_Multiple = hcfg->Projects.count() > 1;
+        if (parser.isSet(min_score))
+        {
+            hcfg->UserConfig->EnableMinScore = true;
+            hcfg->UserConfig->MinScore = parser.value(min_score).toLong();
+        }
+        if (parser.isSet(queue_size))
+            hcfg->SystemConfig_QueueSize = qMax(1, parser.value(queue_size).toInt());
+
+        Daemon daemon;
+        QString feed = parser.value(provider);
+        if (feed == "irc")
+        {
+            daemon.Provider = HUGGLE_FEED_PROVIDER_IRC;
+        } else if (feed == "wiki")
+        {
+            daemon.Provider = HUGGLE_FEED_PROVIDER_WIKI;
+        } else if (feed != "xmlrcs")
+        {
+            HUGGLE_ERROR("Unknown provider: " + feed);
+            return 1;
+        }
+        if (parser.isSet(xmlrcs) && !splitServer(parser.value(xmlrcs), &daemon.XmlRcsServer, &daemon.XmlRcsPort))
+        {
+            HUGGLE_ERROR("Invalid address of XmlRcs: " + parser.value(xmlrcs));
+            return 1;
+        }
+        if (parser.isSet(irc) && !splitServer(parser.value(irc), &daemon.IRCServer, &daemon.IRCPort))
+        {
+            HUGGLE_ERROR("Invalid address of irc: " + parser.value(irc));
+            return 1;
+        }
+        daemon.ConfigFile = parser.value(config_file);
+        daemon.SocketName = parser.value(socket);
+        daemon.PrintEdits = !parser.isSet(quiet);
+        daemon.StatisticsInterval = parser.value(statistics).toInt();
+        if (parser.value(duration).toInt() > 0)
+            QTimer::singleShot(parser.value(duration).toInt() * 1000, &daemon, SLOT(Quit()));
+        daemon.Start();
+
+        ReturnCode = application.exec();
+        // daemon holds edits and providers which need to be released before core is shut down
+        daemon.Shutdown();
+        if (Core::HuggleCore->Running)
+            Core::HuggleCore->Shutdown();
+        delete Core::HuggleCore;
+        return ReturnCode;
+    } catch (Huggle::Exception *fail)
+    {
+        ReturnCode = Fatal(fail);
+        delete fail;
+        return ReturnCode;
+    } catch (Huggle::Exception& fail)
+    {
+        return Fatal(&fail);
+    }
+}
@@ -0,0 +1,172 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+// Compiles xml localization files into one catalog, so that huggle doesn't need to parse xml of
+// every language on startup. It's executed by build, usage: huggle_l10nc <catalog> <file.xml>...
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+#include <QTextStream>
+#include <QXmlStreamReader>
+#include "../l10ncatalog.hpp"
+
+class CompiledMessage
+{
+    public:
+        quint32 Key;
+        quint8 Flags;
+        QByteArray Text;
+};
+
+class CompiledLanguage
+{
+    public:
+        QString Name;
+        //! Name of language which is displayed to user, this is the "name" message
+        QString Title;
+        bool RTL = false;
+        QList<CompiledMessage> Messages;
+};
+
+static QStringList keys;
+static QHash<QString, quint32> keyIDs;
+
+static quint32 internKey(const QString &key)
+{
+    if (keyIDs.contains(key))
+        return keyIDs[key];
+    quint32 id = static_cast<quint32>(keys.count());
+    keys.append(key);
+    keyIDs.insert(key, id);
+    return id;
+}
+
+static bool compileLanguage(const QString &path, CompiledLanguage *language, QTextStream &err)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        err << "Unable to open " << path << endl;
+        return false;
+    }
+    language->Name = QFileInfo(path).completeBaseName();
+    language->Title = language->Name;
+    QSet<QString> defined;
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd())
+    {
+        if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != "string")
+            continue;
+        QXmlStreamAttributes attributes = xml.attributes();
+        QString name = attributes.value("name").toString();
+        bool fuzzy = attributes.value("fuzzy") == "true";
+        QString text = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+        if (!attributes.hasAttribute("name"))
+        {
+            err << "Warning: " << path << " contains key with no name" << endl;
+            continue;
+        }
+        if (name == "isrtl")
+        {
+            language->RTL = text.toLower() == "true";
+            continue;
+        }
+        if (defined.contains(name))
+        {
+            err << "Warning: " << path << " contains more than 1 definition for " << name << endl;
+            continue;
+        }
+        defined.insert(name);
+        text.replace("\\\"", "\"").replace("\\'", "'");
+        if (name == "name" && !fuzzy)
+            language->Title = text;
+        CompiledMessage message;
+        message.Key = internKey(name);
+        message.Flags = fuzzy ? HUGGLE_L10N_FLAG_FUZZY : 0;
+        message.Text = text.toUtf8();
+        language->Messages.append(message);
+    }
+    if (xml.hasError())
+    {
+        err << path << ":" << xml.lineNumber() << ": " << xml.errorString() << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QTextStream err(stderr);
+    if (argc < 3)
+    {
+        err << "Usage: huggle_l10nc <catalog> <file.xml>..." << endl;
+        return 1;
+    }
+    // english goes first so that keys of all messages used by huggle get lowest ids
+    QStringList files;
+    for (int i = 2; i < argc; i++)
+    {
+        QString path = QString::fromLocal8Bit(argv[i]);
+        if (QFileInfo(path).completeBaseName() == "en")
+            files.prepend(path);
+        else
+            files.append(path);
+    }
+    QList<CompiledLanguage> languages;
+    foreach (QString path, files)
+    {
+        CompiledLanguage language;
+        if (!compileLanguage(path, &language, err))
+            return 2;
+        languages.append(language);
+    }
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QDataStream data_stream(&buffer);
+    data_stream.setVersion(QDataStream::Qt_5_0);
+    QList<quint32> offsets;
+    foreach (CompiledLanguage language, languages)
+    {
+        offsets.append(static_cast<quint32>(buffer.pos()));
+        data_stream << static_cast<quint32>(language.Messages.count());
+        foreach (CompiledMessage message, language.Messages)
+            data_stream << message.Key << message.Flags << message.Text;
+    }
+    buffer.close();
+
+    QFile catalog(QString::fromLocal8Bit(argv[1]));
+    if (!catalog.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        err << "Unable to write " << catalog.fileName() << endl;
+        return 3;
+    }
+    QDataStream stream(&catalog);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << static_cast<quint32>(HUGGLE_L10N_CATALOG_MAGIC) << static_cast<quint32>(HUGGLE_L10N_CATALOG_VERSION) << keys;
+    stream << static_cast<quint32>(languages.count());
+    int index = 0;
+    while (index < languages.count())
+    {
+        const CompiledLanguage &language = languages.at(index);
+        stream << language.Name << language.Title << language.RTL << offsets.at(index);
+        index++;
+    }
+    stream.writeRawData(data.constData(), data.size());
+    catalog.close();
+    return 0;
+}
@@ -0,0 +1,33 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef L10NCATALOG_HPP
+#define L10NCATALOG_HPP
+
+// Format of the localization catalog which is produced by huggle_l10nc from xml files in
+// Localization folder during build and read by Huggle::Localizations.
+//
+// Everything is written using QDataStream (Qt_5_0):
+//   quint32 magic, quint32 version
+//   QStringList keys                   - every key is stored only once, its index is the id of key
+//   quint32 count of languages
+//   for every language:
+//     QString name, QString title, bool rtl, quint32 offset of its messages in data section
+//   data section, for every language:
+//     quint32 count of messages
+//     for every message: quint32 id of key, quint8 flags, QByteArray text in utf-8
+
+#define HUGGLE_L10N_CATALOG_MAGIC       0x48474C4E
+#define HUGGLE_L10N_CATALOG_VERSION     1
+#define HUGGLE_L10N_CATALOG_PATH        ":/huggle/text/Localization/catalog.bin"
+//! Message is marked as fuzzy in translatewiki, it's used only when huggle runs with --fuzzy
+#define HUGGLE_L10N_FLAG_FUZZY          1
+
+#endif // L10NCATALOG_HPP
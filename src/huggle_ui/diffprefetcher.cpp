@@ -0,0 +1,213 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "diffprefetcher.hpp"
+#include <huggle_core/configuration.hpp>
+#include <huggle_core/syslog.hpp>
+#include <huggle_core/wikipage.hpp>
+#include "genericbrowser.hpp"
+
+#ifdef HUGGLE_WEBEN
+    #include "web_engine/huggleweb.hpp"
+#else
+    #include "webkit/huggleweb.hpp"
+#endif
+
+using namespace Huggle;
+
+DiffPrefetcher::DiffPrefetcher(QObject *parent) : QObject(parent)
+{
+
+}
+
+DiffPrefetcher::~DiffPrefetcher()
+{
+    while (!this->items.isEmpty())
+        delete this->items.takeFirst().Browser;
+    while (!this->idle.isEmpty())
+        delete this->idle.takeFirst();
+}
+
+void DiffPrefetcher::Refresh(QList<WikiEdit*> edits, QSize size)
+{
+    int limit = hcfg->SystemConfig_PrefetchDiffs;
+    qint64 memory_limit = static_cast<qint64>(hcfg->SystemConfig_PrefetchMemoryLimit) * 1024;
+    // Drop everything that isn't on top of queue anymore, or that was rendered with outdated header
+    int index = 0;
+    while (index < this->items.count())
+    {
+        const Item &item = this->items.at(index);
+        int position = edits.indexOf(item.Edit.GetPtr());
+        if (position < 0 || position >= limit || item.NewMessage != hcfg->NewMessage)
+        {
+            this->drop(index);
+            continue;
+        }
+        index++;
+    }
+    index = 0;
+    while (index < edits.count() && index < limit)
+    {
+        WikiEdit *edit = edits.at(index++);
+        if (!canPrefetch(edit))
+            continue;
+        bool known = false;
+        foreach (Item item, this->items)
+        {
+            if (item.Edit.GetPtr() == edit)
+            {
+                known = true;
+                break;
+            }
+        }
+        if (known)
+            continue;
+        qint64 edit_size = estimateSize(edit);
+        if (this->memoryUsage + edit_size > memory_limit)
+        {
+            HUGGLE_DEBUG("Not prefetching " + edit->Page->PageName + ", memory limit for prefetched diffs was reached", 3);
+            break;
+        }
+        Item item;
+        item.Edit = edit;
+        item.Browser = this->getBrowser();
+        item.Size = edit_size;
+        item.Loaded = false;
+        item.NewMessage = hcfg->NewMessage;
+        item.Browser->resize(size);
+        this->items.append(item);
+        this->memoryUsage += edit_size;
+        item.Browser->DisplayDiff(edit);
+    }
+}
+
+GenericBrowser *DiffPrefetcher::Take(WikiEdit *edit, bool *loaded)
+{
+    int index = 0;
+    while (index < this->items.count())
+    {
+        if (this->items.at(index).Edit.GetPtr() == edit)
+        {
+            Item item = this->items.takeAt(index);
+            this->memoryUsage -= item.Size;
+            disconnect(item.Browser, SIGNAL(LoadFinished(bool)), this, SLOT(OnLoadFinished(bool)));
+            if (loaded)
+                *loaded = item.Loaded;
+            return item.Browser;
+        }
+        index++;
+    }
+    return nullptr;
+}
+
+void DiffPrefetcher::Release(GenericBrowser *browser)
+{
+    browser->hide();
+    browser->setParent(nullptr);
+    browser->CurrentEdit = nullptr;
+    if (this->idle.count() >= hcfg->SystemConfig_PrefetchDiffs)
+    {
+        browser->deleteLater();
+        return;
+    }
+    this->idle.append(browser);
+}
+
+void DiffPrefetcher::Clear()
+{
+    while (!this->items.isEmpty())
+        this->drop(0);
+}
+
+int DiffPrefetcher::Count()
+{
+    return this->items.count();
+}
+
+qint64 DiffPrefetcher::GetMemoryUsage()
+{
+    return this->memoryUsage;
+}
+
+void DiffPrefetcher::RecordDisplayTime(qint64 time, bool prefetched)
+{
+    int type = prefetched ? 1 : 0;
+    this->displayTime[type] += time;
+    this->displayCount[type]++;
+}
+
+qint64 DiffPrefetcher::GetAverageDisplayTime(bool prefetched)
+{
+    int type = prefetched ? 1 : 0;
+    if (!this->displayCount[type])
+        return -1;
+    return this->displayTime[type] / this->displayCount[type];
+}
+
+void DiffPrefetcher::OnLoadFinished(bool ok)
+{
+    Q_UNUSED(ok);
+    GenericBrowser *browser = (GenericBrowser*)QObject::sender();
+    int index = 0;
+    while (index < this->items.count())
+    {
+        if (this->items.at(index).Browser == browser)
+        {
+            this->items[index].Loaded = true;
+            return;
+        }
+        index++;
+    }
+}
+
+bool DiffPrefetcher::canPrefetch(WikiEdit *edit)
+{
+    if (!edit->IsPostProcessed() || edit->Page == nullptr)
+        return false;
+    // Edits without diff text would be loaded from the wiki by browser, which we don't want to do in background
+    if (edit->NewPage)
+        return !edit->Page->Contents.isEmpty();
+    return !edit->DiffText.isEmpty() || edit->IsDiffTextPacked();
+}
+
+qint64 DiffPrefetcher::estimateSize(WikiEdit *edit)
+{
+    // html is stored in utf-16 and web engine keeps a copy of it as well, headers are small compared to diff text
+    if (edit->NewPage)
+        return edit->Page->Contents.size() * 4;
+    // the diff is going to be rendered right after this anyway, so there is no point in keeping it packed
+    edit->UnpackDiffText();
+    return edit->DiffText.size() * 4;
+}
+
+GenericBrowser *DiffPrefetcher::getBrowser()
+{
+    GenericBrowser *browser;
+    if (!this->idle.isEmpty())
+    {
+        browser = this->idle.takeFirst();
+    } else
+    {
+        browser = new HuggleWeb();
+    }
+    // Browser needs to be "visible" otherwise the engine doesn't do layout of the page
+    browser->setAttribute(Qt::WA_DontShowOnScreen, true);
+    browser->show();
+    connect(browser, SIGNAL(LoadFinished(bool)), this, SLOT(OnLoadFinished(bool)));
+    return browser;
+}
+
+void DiffPrefetcher::drop(int index)
+{
+    Item item = this->items.takeAt(index);
+    this->memoryUsage -= item.Size;
+    disconnect(item.Browser, SIGNAL(LoadFinished(bool)), this, SLOT(OnLoadFinished(bool)));
+    this->Release(item.Browser);
+}
@@ -0,0 +1,84 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef DIFFPREFETCHER_HPP
+#define DIFFPREFETCHER_HPP
+
+#include <huggle_core/definitions.hpp>
+
+#include <QObject>
+#include <QList>
+#include <QSize>
+#include <huggle_core/collectable_smartptr.hpp>
+#include <huggle_core/wikiedit.hpp>
+
+namespace Huggle
+{
+    class GenericBrowser;
+
+    //! Renders diffs of edits which are on top of the queue in hidden browsers
+
+    //! Browsers are kept in a small pool, when user moves to next edit which was already
+    //! rendered, main window only swaps the browser widget instead of rendering the
+    //! diff from scratch. Number of prerendered edits is controlled by SystemConfig_PrefetchDiffs
+    //! and total size of prerendered html by SystemConfig_PrefetchMemoryLimit (in kB).
+    class HUGGLE_EX_UI DiffPrefetcher : public QObject
+    {
+            Q_OBJECT
+        public:
+            DiffPrefetcher(QObject *parent = nullptr);
+            ~DiffPrefetcher();
+            /*!
+             * \brief Refresh makes sure that given edits are prerendered, other prerendered edits are dropped
+             * \param edits List of edits in order in which they are going to be displayed
+             * \param size Size of visible browser, hidden browsers are resized to it so that layout doesn't change on swap
+             */
+            void Refresh(QList<WikiEdit*> edits, QSize size);
+            /*!
+             * \brief Take removes the browser in which edit was prerendered from the pool
+             * \param edit
+             * \param loaded Set to true if browser already finished the rendering
+             * \return Browser or null if this edit wasn't prerendered, caller owns the browser
+             */
+            GenericBrowser *Take(WikiEdit *edit, bool *loaded = nullptr);
+            //! Return a browser that is no longer displayed back to pool so that it can be reused
+            void Release(GenericBrowser *browser);
+            //! Drop all prerendered edits, this needs to be called when something that affects all diffs changes
+            void Clear();
+            int Count();
+            qint64 GetMemoryUsage();
+            //! Record how long it took to display an edit since user requested it
+            void RecordDisplayTime(qint64 time, bool prefetched);
+            qint64 GetAverageDisplayTime(bool prefetched);
+        private slots:
+            void OnLoadFinished(bool ok);
+        private:
+            class Item
+            {
+                public:
+                    Collectable_SmartPtr<WikiEdit> Edit;
+                    GenericBrowser *Browser;
+                    qint64 Size;
+                    bool Loaded;
+                    bool NewMessage;
+            };
+            static bool canPrefetch(WikiEdit *edit);
+            static qint64 estimateSize(WikiEdit *edit);
+            GenericBrowser *getBrowser();
+            void drop(int index);
+            QList<Item> items;
+            QList<GenericBrowser*> idle;
+            qint64 memoryUsage = 0;
+            qint64 displayTime[2] = { 0, 0 };
+            qint64 displayCount[2] = { 0, 0 };
+    };
+}
+
+#endif // DIFFPREFETCHER_HPP
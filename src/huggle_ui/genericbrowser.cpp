@@ -129,6 +129,8 @@ void GenericBrowser::DisplayDiff(WikiEdit *edit)
         this->DisplayNewPageEdit(edit);
         return;
     }
+    // edits that were deep in queue have their diff compressed
+    edit->UnpackDiffText();
     if (!edit->DiffText.length())
     {
         Huggle::Syslog::HuggleLogs->WarningLog("unable to retrieve diff for edit " + edit->Page->PageName + " fallback to web rendering");
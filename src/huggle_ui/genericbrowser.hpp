@@ -63,6 +63,10 @@ namespace Huggle
             static QString Encode(const QString &string);
             Collectable_SmartPtr<WikiEdit> CurrentEdit;
 
+        signals:
+            //! Emitted when the browser finished loading of a page or rendering of html
+            void LoadFinished(bool ok);
+
         private:
             virtual QString GetShortcut();
             QString CurrentPage;
@@ -14,6 +14,7 @@
 #include <huggle_core/apiqueryresult.hpp>
 #include <huggle_core/configuration.hpp>
 #include <huggle_core/exception.hpp>
+#include <huggle_core/historycache.hpp>
 #include <huggle_core/localization.hpp>
 #include <huggle_core/resources.hpp>
 #ifdef HUGGLE_WEBEN
@@ -89,8 +90,17 @@ void HistoryForm::Read()
 {
     //this->ui->pushButton->setText(Localizations::HuggleLocalizations->nullptrze("historyform-retrieving-history"));
     this->ui->pushButton->hide();
+    QList<HistoryRevision> revisions;
+    if (HistoryCache::HuggleHistory && HistoryCache::HuggleHistory->GetHistory(this->CurrentEdit->GetSite(), this->CurrentEdit->Page->PageName,
+                                                                               static_cast<int>(hcfg->UserConfig->HistoryMax), &revisions))
+    {
+        HUGGLE_DEBUG("History of " + this->CurrentEdit->Page->PageName + " was loaded from cache", 2);
+        this->Clear();
+        this->ShowRevisions(revisions);
+        return;
+    }
     this->query = new ApiQuery(ActionQuery, this->CurrentEdit->GetSite());
-    this->query->Parameters = "prop=revisions&rvprop=" + QUrl::toPercentEncoding("ids|flags|timestamp|user|userid|size|sha1|comment") + "&rvlimit=" +
+    this->query->Parameters = "prop=revisions&rvprop=" + QUrl::toPercentEncoding("ids|flags|timestamp|user|userid|size|sha1|comment|tags") + "&rvlimit=" +
         QString::number(hcfg->UserConfig->HistoryMax) + "&titles=" + QUrl::toPercentEncoding(this->CurrentEdit->Page->PageName);
     this->query->Process();
     delete this->t1;
@@ -154,38 +164,44 @@ void HistoryForm::onTick01()
         this->t1->stop();
         return;
     }
+    QList<HistoryRevision> revisions;
+    foreach (ApiQueryResultNode *rv, this->query->GetApiQueryResult()->GetNodes("rev"))
+    {
+        if (rv->Attributes.contains("revid"))
+            revisions.append(HistoryRevision::FromApiNode(rv, this->CurrentEdit->Page->PageName));
+    }
+    if (HistoryCache::HuggleHistory)
+        HistoryCache::HuggleHistory->InsertHistory(this->query->GetSite(), this->CurrentEdit->Page->PageName, revisions);
+    this->query = nullptr;
+    this->t1->stop();
+    this->ShowRevisions(revisions);
+}
+
+void HistoryForm::ShowRevisions(const QList<HistoryRevision> &revisions)
+{
     bool IsLatest = false;
-    QList<ApiQueryResultNode*> revision_data = this->query->GetApiQueryResult()->GetNodes("rev");
     int x = 0;
-    while (x < revision_data.count())
+    while (x < revisions.count())
     {
-        ApiQueryResultNode *rv = revision_data.at(x);
-        WikiPageHistoryItem *item = new WikiPageHistoryItem(this->query->GetSite());
-        if (rv->Attributes.contains("revid"))
-        {
-            item->RevID = rv->GetAttribute("revid");
-        }
-        else
-        {
-            x++;
-            continue;
-        }
+        const HistoryRevision &rv = revisions.at(x);
+        WikiPageHistoryItem *item = new WikiPageHistoryItem(this->CurrentEdit->GetSite());
+        item->RevID = QString::number(rv.RevID);
         bool founder = false;
         item->Name = this->CurrentEdit->Page->PageName;
         item->Site = this->CurrentEdit->GetSite();
-        if (rv->Attributes.contains("user"))
-            item->User = rv->GetAttribute("user");
-        if (rv->Attributes.contains("size"))
-            item->Size = rv->GetAttribute("size");
-        if (rv->Attributes.contains("timestamp"))
-            item->Date = rv->GetAttribute("timestamp");
-        if (rv->Attributes.contains("comment") && !rv->GetAttribute("comment").isEmpty())
-            item->Summary = rv->GetAttribute("comment");
+        if (!rv.User.isEmpty())
+            item->User = rv.User;
+        if (rv.Size >= 0)
+            item->Size = QString::number(rv.Size);
+        if (!rv.Timestamp.isEmpty())
+            item->Date = rv.Timestamp;
+        if (!rv.Summary.isEmpty())
+            item->Summary = rv.Summary;
         this->ui->tableWidget->insertRow(x);
         QIcon icon(":/huggle/pictures/Resources/blob-none.png");
         if (this->CurrentEdit->Page->FounderKnown() && WikiUser::CompareUsernames(item->User, this->CurrentEdit->Page->GetFounder()))
             founder = true;
-        if (WikiUtil::IsRevert(item->Summary))
+        if (WikiUtil::IsRevert(item->Summary, this->CurrentEdit->GetSite()))
         {
             item->Type = EditType_Revert;
             icon = QIcon(":/huggle/pictures/Resources/blob-revert.png");
@@ -261,8 +277,6 @@ void HistoryForm::onTick01()
         x++;
     }
     this->ui->tableWidget->resizeRowsToContents();
-    this->query = nullptr;
-    this->t1->stop();
     if (!this->CurrentEdit->NewPage && !Configuration::HuggleConfiguration->ForceNoEditJump && !IsLatest)
     {
         if (Configuration::HuggleConfiguration->UserConfig->LastEdit)
@@ -16,6 +16,7 @@
 #include <QDockWidget>
 #include <huggle_core/apiquery.hpp>
 #include <huggle_core/edittype.hpp>
+#include <huggle_core/historycache.hpp>
 #include <huggle_core/mediawikiobject.hpp>
 #include <huggle_core/wikiedit.hpp>
 #include <huggle_core/collectable_smartptr.hpp>
@@ -73,6 +74,8 @@ namespace Huggle
 
         private:
             void Clear();
+            //! Fill the table with history of current page, revisions are sorted from newest
+            void ShowRevisions(const QList<HistoryRevision> &revisions);
             void Display(int row, QString html, bool turtlemode = false);
             //! Make the selected row bold
             void MakeSelectedRowBold();
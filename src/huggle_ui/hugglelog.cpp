@@ -9,15 +9,24 @@
 //GNU General Public License for more details.
 
 #include "hugglelog.hpp"
+#include <QApplication>
+#include <QClipboard>
 #include <QDateTime>
-#include <QCursor>
+#include <QMenu>
 #include <QMutex>
+#include <QScrollBar>
+#include <algorithm>
+#include <huggle_core/configuration.hpp>
 #include <huggle_core/localization.hpp>
 #include <huggle_core/exception.hpp>
 #include <huggle_core/generic.hpp>
 #include <huggle_core/syslog.hpp>
+#include "hugglelogmodel.hpp"
 #include "ui_hugglelog.h"
 
+// New lines are handed over to the view at most once per this many milliseconds
+#define HUGGLE_LOG_FRAME 100
+
 using namespace Huggle;
 
 HuggleLog::HuggleLog(QWidget *parent) : QDockWidget(parent), ui(new Ui::HuggleLog)
@@ -25,8 +34,14 @@ HuggleLog::HuggleLog(QWidget *parent) : QDockWidget(parent), ui(new Ui::HuggleLo
     this->ui->setupUi(this);
     this->setWindowTitle(_l("logs-widget-name"));
     this->lock = new QMutex(QMutex::Recursive);
-    this->ui->textEdit->setUndoRedoEnabled(false);
-    this->ui->textEdit->resize(this->ui->textEdit->width(), 60);
+    this->model = new HuggleLogModel(Configuration::HuggleConfiguration->SystemConfig_RingLogMaxSize, this);
+    this->ui->listView->setModel(this->model);
+    this->ui->listView->setItemDelegate(new HuggleLogDelegate(this->ui->listView));
+    // all lines have same height, so the view doesn't need to measure rows that are not visible
+    this->ui->listView->setUniformItemSizes(true);
+    this->ui->listView->setContextMenuPolicy(Qt::CustomContextMenu);
+    this->ui->listView->resize(this->ui->listView->width(), 60);
+    connect(this->ui->listView, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(ContextMenu(QPoint)));
     this->Modified = false;
 }
 
@@ -39,16 +54,21 @@ HuggleLog::~HuggleLog()
 void HuggleLog::InsertText(HuggleLog_Line line)
 {
     this->lock->lock();
-    // we don't want to have too much text here because that makes the rendering too slow
-    while (this->Text.count() > 82)
-    {
-        this->Text.removeAt(0);
-    }
     this->Text.append(line);
     this->lock->unlock();
     this->Modified = true;
 }
 
+void HuggleLog::InsertText(const QList<HuggleLog_Line> &lines)
+{
+    if (lines.isEmpty())
+        return;
+    this->lock->lock();
+    this->Text.append(lines);
+    this->lock->unlock();
+    this->Modified = true;
+}
+
 QString HuggleLog::Format(HuggleLog_Line line)
 {
     QString color = "";
@@ -78,21 +98,45 @@ QString HuggleLog::Format(HuggleLog_Line line)
 
 void HuggleLog::Render()
 {
-    if (this->Modified)
+    if (!this->Modified)
+        return;
+    if (this->lastRender.isValid() && !this->lastRender.hasExpired(HUGGLE_LOG_FRAME))
+        return;
+    this->lock->lock();
+    QList<HuggleLog_Line> lines = this->Text;
+    this->Text.clear();
+    this->Modified = false;
+    this->lock->unlock();
+    this->lastRender.start();
+    QScrollBar *scroll = this->ui->listView->verticalScrollBar();
+    // if user scrolled down to read older lines, we keep them where they are
+    bool follow = scroll->value() == scroll->minimum();
+    int previous = scroll->value();
+    this->model->Insert(lines);
+    if (follow)
+        this->ui->listView->scrollToTop();
+    else
+        // new rows were inserted above the visible ones, view scrolls per item so we move by their count
+        scroll->setValue(previous + qMin(lines.count(), this->model->GetCapacity()));
+}
+
+void HuggleLog::ContextMenu(const QPoint &position)
+{
+    QPoint g_ = this->ui->listView->mapToGlobal(position);
+    QMenu menu;
+    QAction *copy = new QAction(_l("copy"), &menu);
+    menu.addAction(copy);
+    QAction *selection = menu.exec(g_);
+    if (selection == copy)
     {
-        int id = 0;
         QString t = "";
-        this->lock->lock();
-        while (id < this->Text.count())
-        {
-            t = Format(this->Text.at(id)) + "<br>\n" + t;
-            id++;
-        }
-        this->Modified = false;
-        this->lock->unlock();
-        this->ui->textEdit->clear();
-        this->ui->textEdit->appendHtml(t);
-        this->ui->textEdit->moveCursor(QTextCursor::Start);
+        QModelIndexList selected = this->ui->listView->selectionModel()->selectedIndexes();
+        // rows are displayed newest first, but the text in clipboard should read like a log file
+        std::sort(selected.begin(), selected.end());
+        int i = selected.count();
+        while (i-- > 0)
+            t += selected.at(i).data(HUGGLE_LOG_ROLE_DATE).toString() + "  " + selected.at(i).data().toString() + "\n";
+        if (!t.isEmpty())
+            QApplication::clipboard()->setText(t);
     }
 }
-
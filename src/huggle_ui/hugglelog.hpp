@@ -16,7 +16,7 @@
 #include <QString>
 #include <QList>
 #include <QDockWidget>
-
+#include <QElapsedTimer>
 
 class QMutex;
 
@@ -28,8 +28,12 @@ namespace Ui
 namespace Huggle
 {
     class HuggleLog_Line;
+    class HuggleLogModel;
 
     //! This window contains all the messages that are stored in ring log
+
+    //! Lines are only queued by InsertText, Render hands them over to the model in one batch and not
+    //! more often than once per HUGGLE_LOG_FRAME, so a burst of debug messages costs a single repaint.
     class HUGGLE_EX_UI HuggleLog : public QDockWidget
     {
             Q_OBJECT
@@ -37,13 +41,21 @@ namespace Huggle
             explicit HuggleLog(QWidget *parent = 0);
             ~HuggleLog();
             void InsertText(HuggleLog_Line line);
+            //! Insert lines sorted from oldest to newest
+            void InsertText(const QList<HuggleLog_Line> &lines);
             QString Format(HuggleLog_Line line);
             void Render();
             bool Modified;
 
+        private slots:
+            void ContextMenu(const QPoint &position);
+
         private:
             QMutex *lock;
+            //! Lines which were inserted since last render
             QList<HuggleLog_Line> Text;
+            HuggleLogModel *model;
+            QElapsedTimer lastRender;
             Ui::HuggleLog *ui;
     };
 }
@@ -0,0 +1,136 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "hugglelogmodel.hpp"
+#include <QApplication>
+#include <QPainter>
+
+using namespace Huggle;
+
+HuggleLogModel::HuggleLogModel(int capacity, QObject *parent) : QAbstractListModel(parent)
+{
+    this->ring.resize(qMax(1, capacity));
+}
+
+int HuggleLogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return this->count;
+}
+
+QVariant HuggleLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= this->count)
+        return QVariant();
+    const HuggleLogRow &row = this->ring.at(this->position(index.row()));
+    switch (role)
+    {
+        case Qt::DisplayRole:
+        case Qt::ToolTipRole:
+            return row.Text;
+        case HUGGLE_LOG_ROLE_DATE:
+            return row.Date;
+        case HUGGLE_LOG_ROLE_TYPE:
+            return static_cast<int>(row.Type);
+    }
+    return QVariant();
+}
+
+void HuggleLogModel::Insert(const QList<HuggleLog_Line> &lines)
+{
+    int capacity = this->ring.size();
+    if (lines.isEmpty())
+        return;
+    // lines which would be overwritten by newer lines from same batch are never displayed
+    int skip = qMax(0, lines.count() - capacity);
+    int inserted = lines.count() - skip;
+    int overflow = this->count + inserted - capacity;
+    if (overflow > 0)
+    {
+        // oldest lines are in last rows and their slots in ring are the ones which are going to be overwritten
+        this->beginRemoveRows(QModelIndex(), this->count - overflow, this->count - 1);
+        this->count -= overflow;
+        this->endRemoveRows();
+    }
+    this->beginInsertRows(QModelIndex(), 0, inserted - 1);
+    int i = skip;
+    while (i < lines.count())
+    {
+        const HuggleLog_Line &line = lines.at(i++);
+        HuggleLogRow &row = this->ring[this->head];
+        row.Date = line.Date;
+        row.Text = line.Text;
+        row.Type = line.Type;
+        this->head = (this->head + 1) % capacity;
+    }
+    this->count += inserted;
+    this->endInsertRows();
+}
+
+int HuggleLogModel::GetCapacity()
+{
+    return this->ring.size();
+}
+
+int HuggleLogModel::position(int row) const
+{
+    return (this->head - 1 - row + this->ring.size()) % this->ring.size();
+}
+
+HuggleLogDelegate::HuggleLogDelegate(QObject *parent) : QStyledItemDelegate(parent)
+{
+
+}
+
+void HuggleLogDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    QStyleOptionViewItem opt = option;
+    this->initStyleOption(&opt, index);
+    QString text = opt.text;
+    // let the style paint background, selection and focus, text is painted here
+    opt.text = QString();
+    QStyle *style = opt.widget != nullptr ? opt.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, opt.widget);
+
+    QString date = index.data(HUGGLE_LOG_ROLE_DATE).toString() + "  ";
+    QColor color = opt.palette.color(QPalette::Text);
+    QColor date_color = QColor("blue");
+    if (opt.state & QStyle::State_Selected)
+    {
+        color = opt.palette.color(QPalette::HighlightedText);
+        date_color = color;
+    } else
+    {
+        switch (static_cast<HuggleLogType>(index.data(HUGGLE_LOG_ROLE_TYPE).toInt()))
+        {
+            case HuggleLogType_Debug:
+                color = QColor("green");
+                break;
+            case HuggleLogType_Warn:
+                color = QColor("orange");
+                break;
+            case HuggleLogType_Error:
+                color = QColor("red");
+                break;
+            case HuggleLogType_Normal:
+                break;
+        }
+    }
+    QRect rect = opt.rect.adjusted(2, 0, -2, 0);
+    painter->save();
+    painter->setFont(opt.font);
+    painter->setPen(date_color);
+    painter->drawText(rect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, date);
+    rect.setLeft(rect.left() + opt.fontMetrics.width(date));
+    painter->setPen(color);
+    painter->drawText(rect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, text);
+    painter->restore();
+}
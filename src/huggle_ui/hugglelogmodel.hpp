@@ -0,0 +1,69 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef HUGGLELOGMODEL_HPP
+#define HUGGLELOGMODEL_HPP
+
+#include <huggle_core/definitions.hpp>
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QString>
+#include <QStyledItemDelegate>
+#include <QVector>
+#include <huggle_core/syslog.hpp>
+
+// Role which contains date of log line, display role contains only the text
+#define HUGGLE_LOG_ROLE_DATE Qt::UserRole + 1
+#define HUGGLE_LOG_ROLE_TYPE Qt::UserRole + 2
+
+namespace Huggle
+{
+    class HuggleLogRow
+    {
+        public:
+            QString Date;
+            QString Text;
+            HuggleLogType Type = HuggleLogType_Normal;
+    };
+
+    //! Lines of system log, newest line is in first row
+
+    //! Lines are stored in a ring of fixed capacity, so adding a line never moves the others and when
+    //! the ring is full the oldest lines are overwritten. Views are told only about inserted and dropped
+    //! rows, which means that text of lines which were displayed before doesn't need to be laid out again.
+    class HuggleLogModel : public QAbstractListModel
+    {
+            Q_OBJECT
+        public:
+            HuggleLogModel(int capacity, QObject *parent = nullptr);
+            int rowCount(const QModelIndex &parent = QModelIndex()) const;
+            QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+            //! Insert lines, they need to be sorted from oldest to newest
+            void Insert(const QList<HuggleLog_Line> &lines);
+            int GetCapacity();
+        private:
+            int position(int row) const;
+            QVector<HuggleLogRow> ring;
+            //! Position where the next line is written
+            int head = 0;
+            int count = 0;
+    };
+
+    //! Paints the date and the text of log line with different colors without parsing any html
+    class HuggleLogDelegate : public QStyledItemDelegate
+    {
+        public:
+            HuggleLogDelegate(QObject *parent = nullptr);
+            void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+    };
+}
+
+#endif // HUGGLELOGMODEL_HPP
@@ -166,6 +166,23 @@ void HuggleQueue::AddItem(WikiEdit *edit)
     this->Items.append(label);
     this->RedrawTitle();
 
+    // only few edits on top of queue are going to be displayed anytime soon, the others keep their diff compressed
+    // until they get there, because of that it's enough to pack the new edit or the one that it pushed down
+    int limit = hcfg->SystemConfig_QueueUnpackedDiffs;
+    if (limit > 0)
+    {
+        int position = this->ui->itemList->indexOf(label);
+        if (position >= limit)
+        {
+            edit->PackDiffText();
+        } else if (limit < this->ui->itemList->count() - 1)
+        {
+            HuggleQueueItemLabel *pushed = (HuggleQueueItemLabel*)this->ui->itemList->itemAt(limit)->widget();
+            if (pushed != nullptr && pushed->Edit != nullptr)
+                pushed->Edit->PackDiffText();
+        }
+    }
+
     if (hcfg->SystemConfig_PlaySoundOnQueue && edit->Score >= hcfg->SystemConfig_PlaySoundQueueScore)
         Resources::PlayEmbeddedSoundFile("not1.wav");
 }
@@ -189,6 +206,23 @@ bool HuggleQueue::Next()
     return true;
 }
 
+QList<WikiEdit*> HuggleQueue::GetTop(int count)
+{
+    QList<WikiEdit*> result;
+    int c = 0;
+    // last item of the layout is a spacer
+    while (c < this->ui->itemList->count() - 1 && result.count() < count)
+    {
+        QLayoutItem *i = this->ui->itemList->itemAt(c++);
+        if (i == this->ui->verticalSpacer)
+            break;
+        HuggleQueueItemLabel *label = (HuggleQueueItemLabel*)i->widget();
+        if (label && label->Edit != nullptr)
+            result.append(label->Edit.GetPtr());
+    }
+    return result;
+}
+
 WikiEdit *HuggleQueue::GetWikiEditByRevID(revid_ht RevID, WikiSite *site)
 {
     HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
@@ -65,6 +65,8 @@ namespace Huggle
             //! Switch and render next edit in queue
             bool Next();
             WikiEdit *GetWikiEditByRevID(revid_ht RevID, WikiSite *site);
+            //! Returns up to count edits in order in which they are going to be displayed
+            QList<WikiEdit*> GetTop(int count);
             void Sort();
             void SortItemByEdit(WikiEdit *e);
             void Trim(unsigned int i);
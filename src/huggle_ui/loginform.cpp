@@ -10,6 +10,7 @@
 
 #include <huggle_core/apiqueryresult.hpp>
 #include <huggle_core/configuration.hpp>
+#include <huggle_core/configurationcache.hpp>
 #include <huggle_core/core.hpp>
 #include <huggle_core/exception.hpp>
 #include <huggle_core/generic.hpp>
@@ -43,9 +44,82 @@
 #define LOGINFORM_USERCONFIG 5
 #define LOGINFORM_USERINFO 6
 #define LOGINFORM_YAMLCONFIG 7
+#define LOGINFORM_CONFIGCHECK 8
+// Global config is not a step of any site, but other steps depend on it
+#define LOGINFORM_GLOBALCONFIG -1
 
 using namespace Huggle;
 
+// Steps in order in which they are displayed, old project config (LOGINFORM_LOCALCONFIG) is only a fallback of YAML config
+static const int LoginSteps[] = { LOGINFORM_LOGIN, LOGINFORM_SITEINFO, LOGINFORM_WHITELIST, LOGINFORM_CONFIGCHECK,
+                                  LOGINFORM_YAMLCONFIG, LOGINFORM_USERCONFIG, LOGINFORM_USERINFO };
+static const int LoginStepCount = 7;
+
+static QList<int> LoginStepDependencies(int step)
+{
+    QList<int> dependencies;
+    switch (step)
+    {
+        case LOGINFORM_SITEINFO:
+            dependencies << LOGINFORM_LOGIN;
+            break;
+        case LOGINFORM_WHITELIST:
+        case LOGINFORM_CONFIGCHECK:
+            // these need to know the location of pages from global config, and wikis that are read restricted
+            // don't let us read anything until we are logged in
+            dependencies << LOGINFORM_GLOBALCONFIG << LOGINFORM_LOGIN;
+            break;
+        case LOGINFORM_YAMLCONFIG:
+            // config is either loaded from cache or downloaded, depending on result of the check
+            dependencies << LOGINFORM_GLOBALCONFIG << LOGINFORM_LOGIN << LOGINFORM_CONFIGCHECK;
+            break;
+        case LOGINFORM_USERCONFIG:
+            // login may change the username, so we need to wait for it before we know where the user config is
+            dependencies << LOGINFORM_LOGIN << LOGINFORM_YAMLCONFIG << LOGINFORM_CONFIGCHECK;
+            break;
+        case LOGINFORM_USERINFO:
+            // user info is checked against requirements defined in project config
+            dependencies << LOGINFORM_LOGIN << LOGINFORM_YAMLCONFIG;
+            break;
+    }
+    return dependencies;
+}
+
+static QString LoginStepName(int step)
+{
+    switch (step)
+    {
+        case LOGINFORM_LOGIN:
+            return "login";
+        case LOGINFORM_SITEINFO:
+            return "site info";
+        case LOGINFORM_WHITELIST:
+            return "whitelist";
+        case LOGINFORM_CONFIGCHECK:
+            return "config cache check";
+        case LOGINFORM_YAMLCONFIG:
+            return "project config";
+        case LOGINFORM_USERCONFIG:
+            return "user config";
+        case LOGINFORM_USERINFO:
+            return "user info";
+    }
+    return "unknown";
+}
+
+static QString ProjectYamlConfigPage()
+{
+    if (!hcfg->GlobalConfig_OverrideConfigYAMLPath.isEmpty())
+        hcfg->GlobalConfig_LocalConfigYAMLPath = hcfg->GlobalConfig_OverrideConfigYAMLPath;
+    return hcfg->GlobalConfig_LocalConfigYAMLPath;
+}
+
+static QString UserConfigPage()
+{
+    QString page = hcfg->GlobalConfig_UserConf;
+    return page.replace("$1", hcfg->SystemConfig_Username);
+}
+
 LoginForm::LoginForm(QWidget *parent) : HW("login", this, parent), ui(new Ui::Login)
 {
     HUGGLE_PROFILER_RESET;
@@ -248,7 +322,24 @@ void LoginForm::removeQueries()
     Sites = this->qSiteInfo.keys();
     foreach (WikiSite* st, Sites)
         this->qSiteInfo[st]->DecRef();
+    Sites = this->qProjectConfig.keys();
+    foreach (WikiSite* st, Sites)
+        this->qProjectConfig[st]->DecRef();
+    Sites = this->qUserConfig.keys();
+    foreach (WikiSite* st, Sites)
+        this->qUserConfig[st]->DecRef();
+    Sites = this->qUserInfo.keys();
+    foreach (WikiSite* st, Sites)
+        this->qUserInfo[st]->DecRef();
+    Sites = this->qConfigCheck.keys();
+    foreach (WikiSite* st, Sites)
+        this->qConfigCheck[st]->DecRef();
     this->qSiteInfo.clear();
+    this->qProjectConfig.clear();
+    this->qUserConfig.clear();
+    this->qUserInfo.clear();
+    this->qConfigCheck.clear();
+    this->currentConfigPages.clear();
     this->qTokenInfo.clear();
     this->qApproval.clear();
     this->wlQueries.clear();
@@ -491,11 +582,12 @@ void LoginForm::pressOK()
     LoadingForm::IsKilled = false;
     // set new status for all projects
     this->usingOldUserConfig.clear();
+    this->usingOldProjectConfig.clear();
     this->Statuses.clear();
     hcfg->ProjectString.clear();
-    this->processedLogin.clear();
-    this->processedSiteinfos.clear();
-    this->processedWL.clear();
+    this->steps.clear();
+    this->stepStartTime.clear();
+    this->stepTime.clear();
     foreach (WikiSite *wiki, hcfg->Projects)
     {
         delete wiki->UserConfig;
@@ -504,10 +596,12 @@ void LoginForm::pressOK()
         delete wiki->ProjectConfig;
         wiki->ProjectConfig = new ProjectConfiguration(wiki->Name);
         this->usingOldUserConfig.insert(wiki, false);
+        this->usingOldProjectConfig.insert(wiki, false);
         this->Statuses.insert(wiki, LoggingIn);
-        this->processedLogin.insert(wiki, false);
-        this->processedSiteinfos.insert(wiki, false);
-        this->processedWL.insert(wiki, false);
+        this->steps.insert(wiki, QHash<int, LoginStepStatus>());
+        int step = 0;
+        while (step < LoginStepCount)
+            this->steps[wiki].insert(LoginSteps[step++], LoginStepWaiting);
     }
     hcfg->UserConfig = hcfg->Project->GetUserConfig();
     hcfg->ProjectConfig = hcfg->Project->GetProjectConfig();
@@ -541,7 +635,8 @@ void LoginForm::pressOK()
     this->loadingFormGlobalConfigRow = this->loadingForm_LastRow;
     this->loadingForm->Insert(this->loadingForm_LastRow, _l("login-progress-global"), LoadingForm_Icon_Waiting);
     this->loadingForm_LastRow++;
-    // First of all, we need to login to the site
+    // Login to all sites and global config are started on first tick, rest of the steps follow as soon as they can
+    this->loginStartTime = QDateTime::currentDateTime();
     this->timer->start(HUGGLE_TIMER);
 }
 
@@ -625,6 +720,7 @@ bool LoginForm::retrieveGlobalConfig()
                     return false;
                 }
                 this->globalConfigIsLoaded = true;
+                this->globalConfigTime = this->qConfig->ExecutionTime();
                 this->loadingForm->ModifyIcon(this->loadingFormGlobalConfigRow, LoadingForm_Icon_Success);
                 return true;
             }
@@ -711,19 +807,9 @@ void LoginForm::finishLogin(WikiSite *site)
     {
         this->LoginQueries.remove(site);
         query->DecRef();
-        ApiQuery *qr = new ApiQuery(ActionQuery, site);
-        this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_SITEINFO), LoadingForm_Icon_Loading);
-        this->qSiteInfo.insert(site, qr);
-        qr->IncRef();
         this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_LOGIN), LoadingForm_Icon_Success);
-        qr->Parameters = "meta=siteinfo&siprop=" + QUrl::toPercentEncoding("namespaces|general|extensions|restrictions|usergroups");
-        qr->Process();
-        qr = new ApiQuery(ActionQuery, site);
-        this->qTokenInfo.insert(site, qr);
-        qr->IncRef();
-        qr->Parameters = "meta=tokens&type=" + QUrl::toPercentEncoding("csrf|patrol|rollback|watch");
-        qr->Process();
-        this->Statuses[site] = RetrievingProjectYAMLConfig;
+        this->Statuses[site] = LoggedIn;
+        this->finishStep(site, LOGINFORM_LOGIN);
     }
     // Let other huggle continue login process for other projects if there are some
     this->qCurrentLoginRequest = nullptr;
@@ -740,7 +826,7 @@ void LoginForm::retrieveWhitelist(WikiSite *site)
     if (hcfg->SystemConfig_WhitelistDisabled)
     {
         this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_WHITELIST), LoadingForm_Icon_Failed);
-        this->processedWL[site] = true;
+        this->finishStep(site, LOGINFORM_WHITELIST);
         return;
     }
     if (this->wlQueries.contains(site))
@@ -760,7 +846,7 @@ void LoginForm::retrieveWhitelist(WikiSite *site)
                 site->GetProjectConfig()->WhiteList = list.split("|");
                 site->GetProjectConfig()->WhiteList.removeAll("");
             }
-            this->processedWL[site] = true;
+            this->finishStep(site, LOGINFORM_WHITELIST);
             this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_WHITELIST), LoadingForm_Icon_Success);
             query->DecRef();
         }
@@ -776,9 +862,9 @@ void LoginForm::retrieveWhitelist(WikiSite *site)
 
 void LoginForm::retrieveProjectYamlConfig(WikiSite *site)
 {
-    if (this->LoginQueries.contains(site))
+    if (this->qProjectConfig.contains(site))
     {
-        ApiQuery *query = this->LoginQueries[site];
+        ApiQuery *query = this->qProjectConfig[site];
         if (query->IsProcessed())
         {
             if (query->IsFailed())
@@ -795,56 +881,125 @@ void LoginForm::retrieveProjectYamlConfig(WikiSite *site)
                 return;
             }
             QString value = data->Value;
-            this->LoginQueries.remove(site);
+            ConfigurationCache::StoreFromQuery(site, ProjectYamlConfigPage(), query);
+            this->qProjectConfig.remove(site);
             query->DecRef();
-            if (site->ProjectConfig == nullptr)
-                throw new Huggle::NullPointerException("site->ProjectConfig", BOOST_CURRENT_FUNCTION);
-            QString reason;
-            if (site->GetProjectConfig()->ParseYAML(value, &reason, site))
-            {
-                if (!site->GetProjectConfig()->EnableAll)
-                {
-                    this->displayError(_l("login-error-projdisabled", site->Name));
-                    return;
-                }
-                this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_YAMLCONFIG), LoadingForm_Icon_Success);
-                this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_LOCALCONFIG), LoadingForm_Icon_Success);
-                this->Statuses[site] = RetrievingUserConfig;
-                return;
-            } else
-            {
-                this->displayError(_l("login-error-config", site->Name, reason));
-                return;
-            }
+            this->parseProjectYamlConfig(site, value);
         }
         return;
     }
     this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_YAMLCONFIG), LoadingForm_Icon_Loading);
+    QString page = ProjectYamlConfigPage();
+    QString text;
+    if (this->loadCachedConfig(site, page, &text))
+    {
+        this->parseProjectYamlConfig(site, text);
+        return;
+    }
     ApiQuery *query = new ApiQuery(ActionQuery, site);
     query->IncRef();
-    if (!hcfg->GlobalConfig_OverrideConfigYAMLPath.isEmpty())
-        hcfg->GlobalConfig_LocalConfigYAMLPath = hcfg->GlobalConfig_OverrideConfigYAMLPath;
-    query->Parameters = "prop=revisions&rvprop=content&rvlimit=1&titles=" + hcfg->GlobalConfig_LocalConfigYAMLPath;
+    query->Parameters = "prop=revisions&rvprop=ids%7Ccontent&rvlimit=1&titles=" + QUrl::toPercentEncoding(page);
     query->Process();
-    this->LoginQueries.insert(site, query);
+    this->qProjectConfig.insert(site, query);
+}
+
+void LoginForm::parseProjectYamlConfig(WikiSite *site, const QString &text)
+{
+    if (site->ProjectConfig == nullptr)
+        throw new Huggle::NullPointerException("site->ProjectConfig", BOOST_CURRENT_FUNCTION);
+    QString reason;
+    if (!site->GetProjectConfig()->ParseYAML(text, &reason, site))
+    {
+        // don't load the broken page from cache next time
+        ConfigurationCache::Remove(site, ProjectYamlConfigPage());
+        this->displayError(_l("login-error-config", site->Name, reason));
+        return;
+    }
+    if (!site->GetProjectConfig()->EnableAll)
+    {
+        this->displayError(_l("login-error-projdisabled", site->Name));
+        return;
+    }
+    this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_YAMLCONFIG), LoadingForm_Icon_Success);
+    this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_LOCALCONFIG), LoadingForm_Icon_Success);
+    this->finishStep(site, LOGINFORM_YAMLCONFIG);
+}
+
+void LoginForm::checkConfigCache(WikiSite *site)
+{
+    if (this->qConfigCheck.contains(site))
+    {
+        ApiQuery *query = this->qConfigCheck[site];
+        if (!query->IsProcessed())
+            return;
+        this->qConfigCheck.remove(site);
+        QStringList pages;
+        pages << ProjectYamlConfigPage() << UserConfigPage();
+        foreach (QString page, pages)
+        {
+            ConfigurationCache::Entry entry;
+            if (ConfigurationCache::Get(site, page, &entry) && ConfigurationCache::IsCurrent(query, entry))
+                this->currentConfigPages[site].append(page);
+        }
+        if (query->IsFailed())
+            HUGGLE_DEBUG1("Unable to check config cache of " + site->Name + ": " + query->GetFailureReason());
+        query->DecRef();
+        this->finishStep(site, LOGINFORM_CONFIGCHECK);
+        return;
+    }
+    this->currentConfigPages.insert(site, QStringList());
+    // Collect ids of all cached pages so that all of them are checked using one query
+    QStringList page_ids;
+    QStringList pages;
+    pages << ProjectYamlConfigPage() << UserConfigPage();
+    foreach (QString page, pages)
+    {
+        ConfigurationCache::Entry entry;
+        if (ConfigurationCache::Get(site, page, &entry))
+            page_ids << QString::number(entry.PageID);
+    }
+    if (page_ids.isEmpty())
+    {
+        this->finishStep(site, LOGINFORM_CONFIGCHECK);
+        return;
+    }
+    ApiQuery *query = new ApiQuery(ActionQuery, site);
+    query->IncRef();
+    query->Parameters = "prop=info&pageids=" + QUrl::toPercentEncoding(page_ids.join("|"));
+    query->Process();
+    this->qConfigCheck.insert(site, query);
+}
+
+bool LoginForm::loadCachedConfig(WikiSite *site, const QString &page, QString *text)
+{
+    ConfigurationCache::Entry entry;
+    if (!this->currentConfigPages[site].contains(page) || !ConfigurationCache::Get(site, page, &entry))
+    {
+        ConfigurationCache::RecordMiss();
+        return false;
+    }
+    HUGGLE_DEBUG1("Loaded " + page + " of " + site->Name + " from cache (revision " + QString::number(entry.RevID) + ")");
+    ConfigurationCache::RecordHit();
+    *text = entry.Text;
+    return true;
 }
 
 void LoginForm::fallbackToLegacyConfig(WikiSite *site)
 {
-    ApiQuery *query = this->LoginQueries[site];
+    ApiQuery *query = this->qProjectConfig[site];
     query->DecRef();
     Syslog::HuggleLogs->WarningLog(site->Name + " - YAML configuration not found, falling back to deprecated config page");
-    this->LoginQueries.remove(site);
-    this->Statuses[site] = RetrievingProjectOldConfig;
+    this->qProjectConfig.remove(site);
+    this->usingOldProjectConfig[site] = true;
     this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_YAMLCONFIG), LoadingForm_Icon_Failed);
     this->retrieveProjectConfig(site);
 }
 
 void LoginForm::retrieveProjectConfig(WikiSite *site)
 {
-    if (this->LoginQueries.contains(site))
+    if (this->qProjectConfig.contains(site))
     {
-        ApiQuery *query = this->LoginQueries[site];
+        ApiQuery *query = this->qProjectConfig[site];
         if (query->IsProcessed())
         {
             if (query->IsFailed())
@@ -859,7 +1014,7 @@ void LoginForm::retrieveProjectConfig(WikiSite *site)
                 return;
             }
             QString value = data->Value;
-            this->LoginQueries.remove(site);
+            this->qProjectConfig.remove(site);
             query->DecRef();
             // since now data may be deleted
             if (site->ProjectConfig == nullptr)
@@ -873,7 +1028,7 @@ void LoginForm::retrieveProjectConfig(WikiSite *site)
                     return;
                 }
                 this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_LOCALCONFIG), LoadingForm_Icon_Success);
-                this->Statuses[site] = RetrievingUserConfig;
+                this->finishStep(site, LOGINFORM_YAMLCONFIG);
                 return;
             } else
             {
@@ -888,14 +1043,14 @@ void LoginForm::retrieveProjectConfig(WikiSite *site)
     query->IncRef();
     query->Parameters = "prop=revisions&rvprop=content&rvlimit=1&titles=" + hcfg->GlobalConfig_LocalConfigWikiPath;
     query->Process();
-    this->LoginQueries.insert(site, query);
+    this->qProjectConfig.insert(site, query);
 }
 
 void LoginForm::retrieveUserConfig(WikiSite *site)
 {
-    if (this->LoginQueries.contains(site))
+    if (this->qUserConfig.contains(site))
     {
-        ApiQuery *q = this->LoginQueries[site];
+        ApiQuery *q = this->qUserConfig[site];
         if (q->IsProcessed())
         {
             if (q->IsFailed())
@@ -918,7 +1073,7 @@ void LoginForm::retrieveUserConfig(WikiSite *site)
                     q->DecRef();
                     // let's get an old configuration instead
                     q = new ApiQuery(ActionQuery, site);
-                    this->LoginQueries[site] = q;
+                    this->qUserConfig[site] = q;
                     q->IncRef();
                     QString page = hcfg->GlobalConfig_UserConf_old;
                     page = page.replace("$1", hcfg->SystemConfig_Username);
@@ -930,8 +1085,8 @@ void LoginForm::retrieveUserConfig(WikiSite *site)
                 {
                     // we don't care if user config is missing or not
                     q->DecRef();
-                    this->LoginQueries.remove(site);
-                    this->Statuses[site] = RetrievingUser;
+                    this->qUserConfig.remove(site);
+                    this->finishStep(site, LOGINFORM_USERCONFIG);
                     return;
                 }
                 HUGGLE_DEBUG1(q->Result->Data);
@@ -939,49 +1094,63 @@ void LoginForm::retrieveUserConfig(WikiSite *site)
                 return;
             }
             QString val_ = data->Value;
-            this->LoginQueries.remove(site);
+            // old config pages are converted on every start, so there is no point in caching them
+            if (!this->usingOldUserConfig[site])
+                ConfigurationCache::StoreFromQuery(site, UserConfigPage(), q);
+            this->qUserConfig.remove(site);
             q->DecRef();
-            if (this->usingOldUserConfig[site])
-            {
-                if (!site->GetUserConfig()->Parse(val_, site->GetProjectConfig(), site == hcfg->Project))
-                {
-                    Syslog::HuggleLogs->DebugLog(val_);
-                    this->displayError(_l("login-fail-parse-config", site->Name));
-                    return;
-                }
-                Syslog::HuggleLogs->DebugLog("We successfully loaded and converted the old config for " + site->Name + " (huggle.css) :)");
-            } else
-            {
-                QString error;
-                if (!site->GetUserConfig()->ParseYAML(val_, site->GetProjectConfig(), site == hcfg->Project, &error))
-                {
-                    Syslog::HuggleLogs->DebugLog(val_);
-                    this->displayError(_l("login-fail-parse-config-yaml", site->Name, error));
-                    return;
-                }
-            }
-            if (!site->ProjectConfig->EnableAll)
-            {
-                this->displayError(_l("login-fail-enable-true", site->Name));
-                return;
-            }
-            hcfg->NormalizeConf(site);
-            this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_USERCONFIG), LoadingForm_Icon_Success);
-            this->Statuses[site] = RetrievingUser;
+            this->parseUserConfig(site, val_);
             return;
         }
         return;
     }
     this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_USERCONFIG), LoadingForm_Icon_Loading);
+    QString page = UserConfigPage();
+    QString text;
+    if (this->loadCachedConfig(site, page, &text))
+    {
+        this->parseUserConfig(site, text);
+        return;
+    }
     ApiQuery *query = new ApiQuery(ActionQuery, site);
     query->IncRef();
-    this->LoginQueries.insert(site, query);
-    QString page = hcfg->GlobalConfig_UserConf;
-    page = page.replace("$1", hcfg->SystemConfig_Username);
-    query->Parameters = "prop=revisions&rvprop=content&rvlimit=1&titles=" + QUrl::toPercentEncoding(page);
+    this->qUserConfig.insert(site, query);
+    query->Parameters = "prop=revisions&rvprop=ids%7Ccontent&rvlimit=1&titles=" + QUrl::toPercentEncoding(page);
     query->Process();
 }
 
+void LoginForm::parseUserConfig(WikiSite *site, const QString &text)
+{
+    if (this->usingOldUserConfig[site])
+    {
+        if (!site->GetUserConfig()->Parse(text, site->GetProjectConfig(), site == hcfg->Project))
+        {
+            Syslog::HuggleLogs->DebugLog(text);
+            this->displayError(_l("login-fail-parse-config", site->Name));
+            return;
+        }
+        Syslog::HuggleLogs->DebugLog("We successfully loaded and converted the old config for " + site->Name + " (huggle.css) :)");
+    } else
+    {
+        QString error;
+        if (!site->GetUserConfig()->ParseYAML(text, site->GetProjectConfig(), site == hcfg->Project, &error))
+        {
+            ConfigurationCache::Remove(site, UserConfigPage());
+            Syslog::HuggleLogs->DebugLog(text);
+            this->displayError(_l("login-fail-parse-config-yaml", site->Name, error));
+            return;
+        }
+    }
+    if (!site->ProjectConfig->EnableAll)
+    {
+        this->displayError(_l("login-fail-enable-true", site->Name));
+        return;
+    }
+    hcfg->NormalizeConf(site);
+    this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_USERCONFIG), LoadingForm_Icon_Success);
+    this->finishStep(site, LOGINFORM_USERCONFIG);
+}
+
 void LoginForm::retrieveUserInfo(WikiSite *site)
 {
     // check approval page
@@ -1030,15 +1199,14 @@ void LoginForm::retrieveUserInfo(WikiSite *site)
                 }
             }
             this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_USERINFO), LoadingForm_Icon_Success);
-            this->processedLogin[site] = true;
-            this->Statuses[site] = LoginDone;
+            this->finishStep(site, LOGINFORM_USERINFO);
         }
         return;
     }
 
-    if (this->LoginQueries.contains(site))
+    if (this->qUserInfo.contains(site))
     {
-        ApiQuery *query = this->LoginQueries[site];
+        ApiQuery *query = this->qUserInfo[site];
         if (query->IsProcessed())
         {
             if (query->IsFailed())
@@ -1078,7 +1246,7 @@ void LoginForm::retrieveUserInfo(WikiSite *site)
                 }
             }
             // remove the query
-            this->LoginQueries.remove(site);
+            this->qUserInfo.remove(site);
             ApiQueryResultNode* ui = query->GetApiQueryResult()->GetNode("userinfo");
             if (!ui)
             {
@@ -1129,8 +1297,7 @@ void LoginForm::retrieveUserInfo(WikiSite *site)
                 return;
             }
             this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_USERINFO), LoadingForm_Icon_Success);
-            this->processedLogin[site] = true;
-            this->Statuses[site] = LoginDone;
+            this->finishStep(site, LOGINFORM_USERINFO);
         }
         return;
     }
@@ -1140,7 +1307,7 @@ void LoginForm::retrieveUserInfo(WikiSite *site)
     // now we can retrieve some information about user for this project
     temp->Parameters = "meta=userinfo&uiprop=" + QUrl::toPercentEncoding("rights|registrationdate|editcount");
     temp->Process();
-    this->LoginQueries.insert(site, temp);
+    this->qUserInfo.insert(site, temp);
 }
 
 void LoginForm::developerMode()
@@ -1162,6 +1329,22 @@ void LoginForm::developerMode()
 
 void LoginForm::processSiteInfo(WikiSite *site)
 {
+    if (!this->qSiteInfo.contains(site))
+    {
+        // site info and tokens are retrieved together, tokens are only available once we are logged in
+        ApiQuery *qr = new ApiQuery(ActionQuery, site);
+        this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_SITEINFO), LoadingForm_Icon_Loading);
+        this->qSiteInfo.insert(site, qr);
+        qr->IncRef();
+        qr->Parameters = "meta=siteinfo&siprop=" + QUrl::toPercentEncoding("namespaces|general|extensions|restrictions|usergroups");
+        qr->Process();
+        qr = new ApiQuery(ActionQuery, site);
+        this->qTokenInfo.insert(site, qr);
+        qr->IncRef();
+        qr->Parameters = "meta=tokens&type=" + QUrl::toPercentEncoding("csrf|patrol|rollback|watch");
+        qr->Process();
+        return;
+    }
     if (this->qTokenInfo.contains(site) && this->qSiteInfo.contains(site)
             && this->qTokenInfo[site]->IsProcessed() && this->qSiteInfo[site]->IsProcessed())
     {
@@ -1217,69 +1400,14 @@ void LoginForm::processSiteInfo(WikiSite *site)
         // we can remove the query no matter if it was finished or not
         this->qTokenInfo[site]->DecRef();
         this->qTokenInfo.remove(site);
-        ApiQueryResultNode *g_ = this->qSiteInfo[site]->GetApiQueryResult()->GetNode("general");
-        if( g_ == nullptr )
+        if (!site->ProcessSiteInfo(this->qSiteInfo[site]->GetApiQueryResult()))
         {
             this->displayError(_l("login-no-site-info-returned"));
             return;
         }
-        if (g_->Attributes.contains("rtl"))
-            site->IsRightToLeft = true;
-
-        if (g_->Attributes.contains("generator"))
-        {
-            QString vr = g_->GetAttribute("generator");
-            if (!vr.contains(" "))
-            {
-                Syslog::HuggleLogs->WarningLog("Mediawiki of " + site->Name + " has some invalid version: " + vr);
-            } else
-            {
-                vr = vr.mid(vr.indexOf(" ") + 1);
-                site->MediawikiVersion = Version(vr);
-                HUGGLE_DEBUG1(site->Name + " mediawiki " + site->MediawikiVersion.ToString());
-                if (site->MediawikiVersion < Version::SupportedMediawiki)
-                    Syslog::HuggleLogs->WarningLog("Mediawiki of " + site->Name + " is using version " + site->MediawikiVersion.ToString() +
-                                                   " which isn't supported by huggle");
-            }
-        } else
-        {
-            Syslog::HuggleLogs->WarningLog("MediaWiki of " + site->Name + " provides no version");
-        }
-        if (g_->Attributes.contains("time"))
-        {
-            QDateTime server_time = MediaWiki::FromMWTimestamp(g_->GetAttribute("time"));
-            site->GetProjectConfig()->ServerOffset = QDateTime::currentDateTime().secsTo(server_time);
-        }
-        QList<ApiQueryResultNode*> ns = this->qSiteInfo[site]->GetApiQueryResult()->GetNodes("ns");
-        if (ns.count() < 1)
-        {
-            Syslog::HuggleLogs->WarningLog(QString("Mediawiki of ") + site->Name + " provided no information about namespaces");
-        } else
-        {
-            // let's prepare a NS list
-            site->ClearNS();
-            int index = 0;
-            while (index < ns.count())
-            {
-                ApiQueryResultNode *node = ns.at(index);
-                index++;
-                if (!node->Attributes.contains("id") || !node->Attributes.contains("canonical"))
-                    continue;
-                site->InsertNS(new WikiPageNS(node->GetAttribute("id").toInt(), node->Value, node->GetAttribute("canonical")));
-            }
-        }
-        // extensions
-        site->Extensions.clear();
-        QList<ApiQueryResultNode*> extensionlist = this->qSiteInfo[site]->GetApiQueryResult()->GetNodes("ext");
-        foreach(ApiQueryResultNode *ext, extensionlist)
-        {
-            site->Extensions.append(WikiSite_Ext(ext->GetAttribute("name", "unknown"), ext->GetAttribute("type", "unknown"),
-                      ext->GetAttribute("descriptionmsg", "unknown"), ext->GetAttribute("author", "unknown"),
-                      ext->GetAttribute("url", "unknown"), ext->GetAttribute("version", "0")));
-        }
-        this->processedSiteinfos[site] = true;
         this->qSiteInfo[site]->DecRef();
         this->qSiteInfo.remove(site);
+        this->finishStep(site, LOGINFORM_SITEINFO);
         this->loadingForm->ModifyIcon(this->GetRowIDForSite(site, LOGINFORM_SITEINFO), LoadingForm_Icon_Success);
     }
 }
@@ -1295,15 +1423,9 @@ void LoginForm::displayError(QString message)
 void LoginForm::finishLogin()
 {
     // let's check if all processes are finished
-    foreach (WikiSite *xx, hcfg->Projects)
-    {
-        if (!this->processedWL[xx]) return;
-        if (!this->processedLogin[xx]) return;
-        if (this->Statuses[xx] != LoginDone) return;
-        if (!this->processedSiteinfos[xx]) return;
-    }
-    if (!this->globalConfigIsLoaded)
+    if (!this->globalConfigIsLoaded || !this->allStepsFinished())
         return;
+    this->reportStepTimes();
     QString pw = "";
     this->loginFinished = true;
     foreach (WikiSite *site, hcfg->Projects)
@@ -1427,84 +1549,162 @@ void LoginForm::OnTimerTick()
     }
     if (!this->loginInProgress)
         return;
-    if (!this->globalConfigIsLoaded && !this->retrieveGlobalConfig())
-        return;
+    // global config is retrieved in parallel to login, only steps that need it are waiting for it
+    if (!this->globalConfigIsLoaded)
+    {
+        this->retrieveGlobalConfig();
+        if (!this->loginInProgress)
+            return;
+    }
     // let's check status for every single project
     foreach (WikiSite *site, hcfg->Projects)
     {
         if (!this->Statuses.contains(site))
             throw new Huggle::Exception("There is no such a wiki in statuses list", BOOST_CURRENT_FUNCTION);
-        if (!this->globalConfigIsLoaded)
+        this->runSteps(site);
+        // in case that any step failed, the login was cancelled
+        if (!this->loginInProgress)
+            return;
+        if (this->Statuses[site] == LoginFailed)
+        {
+            this->enableForm();
+            this->timer->stop();
+            this->ui->ButtonOK->setText(_l("login-start"));
+            return;
+        }
+    }
+    this->finishLogin();
+}
+
+void LoginForm::runSteps(WikiSite *site)
+{
+    int index = 0;
+    while (index < LoginStepCount && this->loginInProgress)
+    {
+        int step = LoginSteps[index++];
+        LoginStepStatus status = this->steps[site][step];
+        if (status == LoginStepFinished)
+            continue;
+        if (status == LoginStepWaiting)
         {
-            // we need to skip these unless it's login
-            switch(this->Statuses[site])
+            bool ready = true;
+            foreach (int dependency, LoginStepDependencies(step))
             {
+                if (!this->stepIsFinished(site, dependency))
+                {
+                    ready = false;
+                    break;
+                }
+            }
+            if (!ready)
+                continue;
+            // Check if there isn't any ongoing request to login to other project, per https://phabricator.wikimedia.org/T195109
+            // in case there is some we need to wait because MW doesn't support simultaneous logins to multiple projects
+            if (step == LOGINFORM_LOGIN && !hcfg->SystemConfig_ParallelLogin && this->qCurrentLoginRequest != nullptr
+                    && this->qCurrentLoginRequest->GetSite() != site)
+                continue;
+            this->steps[site][step] = LoginStepRunning;
+            this->stepStartTime[site][step] = QDateTime::currentDateTime();
+        }
+        this->runStep(site, step);
+    }
+}
+
+void LoginForm::runStep(WikiSite *site, int step)
+{
+    switch (step)
+    {
+        case LOGINFORM_LOGIN:
+            switch (this->Statuses[site])
+            {
+                case LoggingIn:
+                    this->performLogin(site);
+                    break;
+                case WaitingForLoginQuery:
+                    this->performLoginPart2(site);
+                    break;
+                case WaitingForToken:
+                    this->finishLogin(site);
+                    break;
                 case LoggedIn:
                 case Nothing:
                 case Cancelling:
                 case LoginFailed:
-                case LoginDone:
-                case LoggingIn:
-                case WaitingForLoginQuery:
-                case WaitingForToken:
                     break;
-                case RetrievingProjectYAMLConfig:
-                case RetrievingProjectOldConfig:
-                case RetrievingUserConfig:
-                case RetrievingUser:
-                    continue;
             }
-        }
-        // Check if there isn't any ongoing request to login to other project, per https://phabricator.wikimedia.org/T195109
-        // in case there is some we need to wait because MW doesn't support simultaneous logins to multiple projects
-        if (!hcfg->SystemConfig_ParallelLogin && this->qCurrentLoginRequest != nullptr && this->qCurrentLoginRequest->GetSite() != site)
-                continue;
-
-        switch(this->Statuses[site])
-        {
-            case LoggingIn:
-                this->performLogin(site);
-                break;
-            case WaitingForLoginQuery:
-                this->performLoginPart2(site);
-                break;
-            case WaitingForToken:
-                this->finishLogin(site);
-                break;
-            case RetrievingProjectOldConfig:
+            break;
+        case LOGINFORM_SITEINFO:
+            this->processSiteInfo(site);
+            break;
+        case LOGINFORM_WHITELIST:
+            this->retrieveWhitelist(site);
+            break;
+        case LOGINFORM_CONFIGCHECK:
+            this->checkConfigCache(site);
+            break;
+        case LOGINFORM_YAMLCONFIG:
+            if (this->usingOldProjectConfig[site])
                 this->retrieveProjectConfig(site);
-                break;
-            case RetrievingProjectYAMLConfig:
+            else
                 this->retrieveProjectYamlConfig(site);
-                break;
-            case RetrievingUserConfig:
-                this->retrieveUserConfig(site);
-                break;
-            case RetrievingUser:
-                retrieveUserInfo(site);
-                break;
-            case LoggedIn:
-            case Nothing:
-            case Cancelling:
-            case LoginFailed:
-            case LoginDone:
-                break;
-        }
-        if (this->globalConfigIsLoaded)
+            break;
+        case LOGINFORM_USERCONFIG:
+            this->retrieveUserConfig(site);
+            break;
+        case LOGINFORM_USERINFO:
+            this->retrieveUserInfo(site);
+            break;
+    }
+}
+
+bool LoginForm::stepIsFinished(WikiSite *site, int step)
+{
+    if (step == LOGINFORM_GLOBALCONFIG)
+        return this->globalConfigIsLoaded;
+    return this->steps[site][step] == LoginStepFinished;
+}
+
+void LoginForm::finishStep(WikiSite *site, int step)
+{
+    this->steps[site][step] = LoginStepFinished;
+    this->stepTime[site][step] = this->stepStartTime[site][step].msecsTo(QDateTime::currentDateTime());
+    HUGGLE_DEBUG(site->Name + ": " + LoginStepName(step) + " finished in " + QString::number(this->stepTime[site][step]) + "ms", 2);
+}
+
+bool LoginForm::allStepsFinished()
+{
+    foreach (WikiSite *site, hcfg->Projects)
+    {
+        int index = 0;
+        while (index < LoginStepCount)
         {
-            if (!this->processedWL[site])
-                this->retrieveWhitelist(site);
-            if (this->qSiteInfo.contains(site))
-                this->processSiteInfo(site);
+            if (!this->stepIsFinished(site, LoginSteps[index++]))
+                return false;
         }
-        if (this->Statuses[site] == LoginFailed)
+    }
+    return true;
+}
+
+void LoginForm::reportStepTimes()
+{
+    Syslog::HuggleLogs->Log("Login finished in " + QString::number(this->loginStartTime.msecsTo(QDateTime::currentDateTime())) +
+                            "ms, global config took " + QString::number(this->globalConfigTime) + "ms");
+    if (hcfg->SystemConfig_ConfigCache)
+    {
+        Syslog::HuggleLogs->Log("Configuration pages loaded from cache: " + QString::number(ConfigurationCache::GetHits()) + ", downloaded: " +
+                                QString::number(ConfigurationCache::GetMisses()));
+    }
+    foreach (WikiSite *site, hcfg->Projects)
+    {
+        QStringList times;
+        int index = 0;
+        while (index < LoginStepCount)
         {
-            this->enableForm();
-            this->timer->stop();
-            this->ui->ButtonOK->setText(_l("login-start"));
+            int step = LoginSteps[index++];
+            times << LoginStepName(step) + ": " + QString::number(this->stepTime[site][step]) + "ms";
         }
+        Syslog::HuggleLogs->Log(site->Name + " - " + times.join(", "));
     }
-    this->finishLogin();
 }
 
 void LoginForm::on_pushButton_clicked()
@@ -17,7 +17,9 @@
 
 #include <huggle_core/collectable_smartptr.hpp>
 #include <QThread>
+#include <QDateTime>
 #include <QHash>
+#include <QStringList>
 #include <QTimer>
 #include "hw.hpp"
 
@@ -30,20 +32,23 @@ namespace Ui
 
 namespace Huggle
 {
+    //! Status of login to a site, other parts of login process are tracked as steps, see LoginForm::runStep()
     enum Status
     {
-        RetrievingUserConfig,
-        RetrievingProjectYAMLConfig,
-        RetrievingProjectOldConfig,
         LoggingIn,
         WaitingForLoginQuery,
         WaitingForToken,
         LoggedIn,
         Nothing,
         Cancelling,
-        LoginFailed,
-        RetrievingUser,
-        LoginDone
+        LoginFailed
+    };
+
+    enum LoginStepStatus
+    {
+        LoginStepWaiting,
+        LoginStepRunning,
+        LoginStepFinished
     };
 
     class ApiQuery;
@@ -53,6 +58,10 @@ namespace Huggle
     class WikiSite;
 
     //! Window that is displayed as first when huggle is started, letting user login to one or more wikis
+
+    //! Login is split into steps (login itself, site info, whitelist, config cache check, project config, user config and user info)
+    //! which form a dependency graph, every step of every site is started as soon as steps it depends on are
+    //! finished, so that independent steps of all sites run at same time. Time of every step is logged.
     class HUGGLE_EX_UI LoginForm : public HW
     {
             Q_OBJECT
@@ -107,11 +116,24 @@ namespace Huggle
             void finishLogin(WikiSite *site);
             void retrieveWhitelist(WikiSite *site);
             void retrieveProjectYamlConfig(WikiSite *site);
+            void parseProjectYamlConfig(WikiSite *site, const QString &text);
             void fallbackToLegacyConfig(WikiSite *site);
             void retrieveProjectConfig(WikiSite *site);
             bool retrieveGlobalConfig();
             void retrieveUserConfig(WikiSite *site);
+            void parseUserConfig(WikiSite *site, const QString &text);
+            //! Check which of configuration pages stored in local cache are still current, using one query per site
+            void checkConfigCache(WikiSite *site);
+            //! Returns true and the text of page in case that the cached copy was verified to be current
+            bool loadCachedConfig(WikiSite *site, const QString &page, QString *text);
             void retrieveUserInfo(WikiSite *site);
+            //! Start or poll all steps of login for given site which have their dependencies finished
+            void runSteps(WikiSite *site);
+            void runStep(WikiSite *site, int step);
+            bool stepIsFinished(WikiSite *site, int step);
+            void finishStep(WikiSite *site, int step);
+            bool allStepsFinished();
+            void reportStepTimes();
             void developerMode();
             bool isDeveloperMode();
             void processSiteInfo(WikiSite *site);
@@ -132,11 +154,19 @@ namespace Huggle
             int loadingFormGlobalConfigRow = 0;
             QList <QCheckBox*> project_CheckBoxens;
             QTimer *timer;
-            QHash<WikiSite*, bool> processedWL;
             bool Refreshing = false;
-            QHash<WikiSite*, bool> processedSiteinfos;
-            QHash<WikiSite*, bool> processedLogin;
+            QHash<WikiSite*, QHash<int, LoginStepStatus>> steps;
+            QHash<WikiSite*, QHash<int, QDateTime>> stepStartTime;
+            QHash<WikiSite*, QHash<int, qint64>> stepTime;
+            QDateTime loginStartTime;
+            qint64 globalConfigTime = 0;
             QHash<WikiSite*, ApiQuery*> qApproval;
+            QHash<WikiSite*, ApiQuery*> qProjectConfig;
+            QHash<WikiSite*, ApiQuery*> qUserConfig;
+            QHash<WikiSite*, ApiQuery*> qUserInfo;
+            QHash<WikiSite*, ApiQuery*> qConfigCheck;
+            //! Configuration pages which have current revision in cache
+            QHash<WikiSite*, QStringList> currentConfigPages;
             QHash<WikiSite*, WLQuery*> wlQueries;
             QHash<WikiSite*, ApiQuery*> qSiteInfo;
             QHash<WikiSite*, ApiQuery*> qTokenInfo;
@@ -156,6 +186,8 @@ namespace Huggle
             QHash<WikiSite*, QString> loginTokens;
             //! for RetrievePrivateConfig, if we should try to load from old config pages
             QHash <WikiSite*,bool> usingOldUserConfig;
+            //! YAML config of project is missing, so we use the old config page
+            QHash <WikiSite*,bool> usingOldProjectConfig;
     };
 }
 
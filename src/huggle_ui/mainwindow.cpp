@@ -12,6 +12,7 @@
 #include "blockuserform.hpp"
 #include "custommessage.hpp"
 #include "deleteform.hpp"
+#include "diffprefetcher.hpp"
 #include "editbar.hpp"
 #include "editform.hpp"
 #include "history.hpp"
@@ -46,8 +47,11 @@
 #include "queuehelp.hpp"
 #include <huggle_core/apiquery.hpp>
 #include <huggle_core/apiqueryresult.hpp>
+#include <huggle_core/bulkrevert.hpp>
 #include <huggle_core/events.hpp>
 #include <huggle_core/configuration.hpp>
+#include <huggle_core/diffengine.hpp>
+#include <huggle_core/editpipeline.hpp>
 #include <huggle_core/generic.hpp>
 #include <huggle_core/gc.hpp>
 #include <huggle_core/querypool.hpp>
@@ -55,6 +59,7 @@
 #include <huggle_core/hugglefeedproviderwiki.hpp>
 #include <huggle_core/hugglefeedproviderirc.hpp>
 #include <huggle_core/hugglefeedproviderxml.hpp>
+#include <huggle_core/hugglefeedproviderreplay.hpp>
 #include <huggle_core/huggleparser.hpp>
 #include <huggle_core/huggleprofiler.hpp>
 
@@ -72,6 +77,7 @@
 #include <huggle_core/exception.hpp>
 #include <huggle_core/localization.hpp>
 #include <huggle_core/syslog.hpp>
+#include <huggle_core/trafficcapture.hpp>
 #include <huggle_core/sleeper.hpp>
 #include <huggle_core/wikiuser.hpp>
 #include <huggle_core/wikisite.hpp>
@@ -126,10 +132,12 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     this->Queries = new ProcessList(this);
     this->SystemLog = new HuggleLog(this);
     this->createBrowserTab(_l("main-tab-welcome-title"), 0);
+    this->prefetcher = new DiffPrefetcher(this);
     this->TrayIcon.setIcon(this->windowIcon());
     this->TrayIcon.show();
     this->TrayIcon.setToolTip("Huggle");
     this->Queue1 = new HuggleQueue(this);
+    this->Pipeline = new EditPipeline();
     this->wEditBar = new EditBar(this);
     this->_History = new History(this);
     this->wHistory = new HistoryForm(this);
@@ -220,8 +228,13 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
         this->huggleFeeds.append(new HuggleFeedProviderWiki(site));
         this->huggleFeeds.append(new HuggleFeedProviderIRC(site));
         this->huggleFeeds.append(new HuggleFeedProviderXml(site));
+        if (TrafficReplay::Replay)
+            this->huggleFeeds.append(new HuggleFeedProviderReplay(site, TrafficReplay::Replay));
         Hooks::FeedProvidersOnInit(site);
-        this->ChangeProvider(site, hcfg->UserConfig->PreferredProvider);
+        if (TrafficReplay::Replay)
+            this->ChangeProvider(site, HUGGLE_FEED_PROVIDER_REPLAY);
+        else
+            this->ChangeProvider(site, hcfg->UserConfig->PreferredProvider);
     }
     if (hcfg->DeveloperMode)
     {
@@ -325,6 +338,9 @@ MainWindow::~MainWindow()
         this->RevertStack.at(0)->DecRef();
         this->RevertStack.removeAt(0);
     }
+    // prefetcher owns hidden browsers which need to be removed together with other browsers
+    delete this->prefetcher;
+    this->prefetcher = nullptr;
     while (this->Browsers.count())
     {
         delete this->Browsers.at(0);
@@ -354,6 +370,7 @@ MainWindow::~MainWindow()
     delete this->fScoreWord;
     delete this->fWhitelist;
     delete this->Ignore;
+    delete this->Pipeline;
     delete this->Queue1;
     delete this->SystemLog;
     delete this->Status;
@@ -425,6 +442,7 @@ void MainWindow::EnableEditing(bool enabled)
     this->ui->actionRevert_currently_displayed_edit_warn_user_and_stay_on_page->setEnabled(enabled);
     this->ui->actionRevert_only_this_revision->setEnabled(enabled);
     this->ui->actionRevert_only_this_revision_assuming_good_faith->setEnabled(enabled);
+    this->ui->actionRevert_all_edits_of_user_and_warn->setEnabled(enabled);
     this->ui->actionTag_2->setEnabled(enabled);
     this->ui->actionWarn_the_user->setEnabled(enabled);
     this->ui->actionPatrol->setEnabled(enabled);
@@ -545,8 +563,20 @@ void MainWindow::ProcessEdit(WikiEdit *e, bool IgnoreHistory, bool KeepHistory,
     Configuration::HuggleConfiguration->ForceNoEditJump = ForcedJump;
     this->CurrentEdit = e;
     this->editLoadDateTime = QDateTime::currentDateTime();
-    this->Browser->DisplayDiff(e);
+    bool loaded = false;
+    GenericBrowser *prerendered = nullptr;
+    if (this->prefetcher)
+        prerendered = this->prefetcher->Take(e, &loaded);
+    this->displayPrefetched = prerendered != nullptr;
+    if (prerendered)
+        this->swapBrowser(prerendered);
+    else
+        this->Browser->DisplayDiff(e);
+    this->waitingForDisplay = !loaded;
+    if (loaded)
+        this->prefetcher->RecordDisplayTime(this->editLoadDateTime.msecsTo(QDateTime::currentDateTime()), true);
     this->Render(KeepHistory, KeepUser);
+    this->refreshPrefetch();
     e->DecRef();
 }
 
@@ -701,7 +731,15 @@ void MainWindow::UpdateStatusBarData()
         statistics_ = " <font color=" + color + ">" + _l("main-stat", counter_params) + "</font>";
     }
     if (hcfg->Verbosity > 0)
+    {
         statistics_ += " QGC: " + QString::number(GC::gc->list.count()) + " U: " + QString::number(WikiUser::ProblematicUsers.count());
+        if (this->prefetcher && (this->prefetcher->GetAverageDisplayTime(true) >= 0 || this->prefetcher->GetAverageDisplayTime(false) >= 0))
+            statistics_ += " TTD: " + QString::number(this->prefetcher->GetAverageDisplayTime(true)) + "/" +
+                           QString::number(this->prefetcher->GetAverageDisplayTime(false)) + "ms";
+        if (hcfg->SystemConfig_LocalDiffs)
+            statistics_ += " LD: " + QString::number(DiffEngine::GetHits()) + " (" + QString::number(DiffEngine::GetHitRate(), 'f', 1) + "%, " +
+                           QString::number(DiffEngine::GetSavedTime()) + "ms)";
+    }
     params << statistics_ << this->GetCurrentWikiSite()->Name;
     QString status_text = _l("main-status-bar", params);
 #ifdef HUGGLE_METRICS
@@ -1253,13 +1291,13 @@ bool MainWindow::preflightCheck(WikiEdit *_e)
     return true;
 }
 
-bool MainWindow::Warn(QString warning_type, RevertQuery *dependency, WikiEdit *related_edit)
+bool MainWindow::Warn(QString warning_type, RevertQuery *dependency, WikiEdit *related_edit, int escalation)
 {
     if (related_edit == nullptr)
         return false;
     bool report_user = false;
     // Call to WarnUser will change report_user to true in case that user already reached max warning level
-    PendingWarning *ptr_warning = Warnings::WarnUser(warning_type, dependency, related_edit, &report_user);
+    PendingWarning *ptr_warning = Warnings::WarnUser(warning_type, dependency, related_edit, &report_user, escalation);
     if (report_user)
     {
         // User already reached maximum level, so we need to report them instead - check if current project supports reporting,
@@ -1353,6 +1391,7 @@ void MainWindow::createBrowserTab(QString name, int index)
     QWidget *tab = new QWidget(this);
     HuggleWeb *web = new HuggleWeb();
     this->Browsers.append(web);
+    connect(web, SIGNAL(LoadFinished(bool)), this, SLOT(OnBrowserLoadFinished(bool)));
     QVBoxLayout *lay = new QVBoxLayout(tab);
     lay->setSizeConstraint(QLayout::SetNoConstraint);
     tab->setLayout(lay);
@@ -1367,6 +1406,46 @@ void MainWindow::createBrowserTab(QString name, int index)
     this->Browser->RenderHtml(Resources::GetNewTabHTML());
 }
 
+void MainWindow::swapBrowser(GenericBrowser *browser)
+{
+    GenericBrowser *old = this->Browser;
+    QWidget *tab = this->ui->tabWidget->currentWidget();
+    if (!tab || tab->layout()->indexOf(old) < 0)
+        throw new Huggle::Exception("Current browser is not in current tab", BOOST_CURRENT_FUNCTION);
+    tab->layout()->replaceWidget(old, browser);
+    browser->setAttribute(Qt::WA_DontShowOnScreen, false);
+    browser->show();
+    int index = this->Browsers.indexOf(old);
+    if (index >= 0)
+        this->Browsers[index] = browser;
+    this->Browser = browser;
+    disconnect(old, SIGNAL(LoadFinished(bool)), this, SLOT(OnBrowserLoadFinished(bool)));
+    connect(browser, SIGNAL(LoadFinished(bool)), this, SLOT(OnBrowserLoadFinished(bool)));
+    this->prefetcher->Release(old);
+}
+
+void MainWindow::refreshPrefetch()
+{
+    if (!this->prefetcher || this->ShuttingDown)
+        return;
+    if (hcfg->SystemConfig_PrefetchDiffs < 1)
+    {
+        if (this->prefetcher->Count())
+            this->prefetcher->Clear();
+        return;
+    }
+    this->prefetcher->Refresh(this->Queue1->GetTop(hcfg->SystemConfig_PrefetchDiffs), this->Browser->size());
+}
+
+void MainWindow::OnBrowserLoadFinished(bool ok)
+{
+    Q_UNUSED(ok);
+    if (!this->waitingForDisplay || QObject::sender() != this->Browser)
+        return;
+    this->waitingForDisplay = false;
+    this->prefetcher->RecordDisplayTime(this->editLoadDateTime.msecsTo(QDateTime::currentDateTime()), this->displayPrefetched);
+}
+
 void MainWindow::changeCurrentBrowserTabTitle(QString name)
 {
     this->ui->tabWidget->setTabText(this->ui->tabWidget->currentIndex(), Generic::ShrinkText(name, 20, false, 3));
@@ -1491,70 +1570,16 @@ void MainWindow::OnMainTimerTick()
             this->ResumeQueue();
     }
     if (RetrieveEdit)
+        this->Pipeline->RetrieveEdits(Configuration::HuggleConfiguration->Projects);
+    // postprocessed edits can be added to queue
+    foreach (WikiEdit *edit, this->Pipeline->TakeReadyEdits())
     {
-        bool full = true;
-        while (full)
-        {
-            full = false;
-            foreach (WikiSite *wiki, Configuration::HuggleConfiguration->Projects)
-            {
-                if (!wiki->Provider->ContainsEdit())
-                    continue;
-
-                // we take the edit and start post processing it
-                WikiEdit *edit = wiki->Provider->RetrieveEdit();
-                if (edit != nullptr)
-                {
-                    QueryPool::HugglePool->PostProcessEdit(edit);
-                    edit->RegisterConsumer(HUGGLECONSUMER_MAINPEND);
-                    edit->DecRef();
-                    this->PendingEdits.append(edit);
-                }
-
-                if (!full && wiki->Provider->ContainsEdit())
-                    full = true;
-            }
-        }
-    }
-    if (this->PendingEdits.count() > 0)
-    {
-        // postprocessed edits can be added to queue
-        int c = 0;
-        while (c < this->PendingEdits.count())
-        {
-            if (this->PendingEdits.at(c)->IsReady() && this->PendingEdits.at(c)->IsPostProcessed())
-            {
-                WikiEdit *edit = this->PendingEdits.at(c);
-                Hooks::WikiEdit_ScoreJS(edit);
-                // We need to check the edit against filter once more, because some of the checks work
-                // only on post processed edits
-                if (edit->GetSite()->CurrentFilter->Matches(edit))
-                    this->Queue1->AddItem(edit);
-                this->PendingEdits.removeAt(c);
-                edit->UnregisterConsumer(HUGGLECONSUMER_MAINPEND);
-            } else
-            {
-                c++;
-            }
-        }
+        this->Queue1->AddItem(edit);
+        edit->DecRef();
     }
+    this->refreshPrefetch();
     // let's refresh the edits that are being post processed
-    if (QueryPool::HugglePool->ProcessingEdits.count() > 0)
-    {
-        int Edit = 0;
-        while (Edit < QueryPool::HugglePool->ProcessingEdits.count())
-        {
-            WikiEdit *e = QueryPool::HugglePool->ProcessingEdits.at(Edit);
-            if (e->finalizePostProcessing())
-            {
-                QueryPool::HugglePool->ProcessingEdits.removeAt(Edit);
-                e->UnregisterConsumer(HUGGLECONSUMER_CORE_POSTPROCESS);
-            } else
-            {
-                Edit++;
-            }
-        }
-    }
+    this->Pipeline->FinalizePostProcessing();
     QueryPool::HugglePool->CheckQueries();
     if (this->SystemLog->isVisible())
     {
@@ -1564,11 +1589,7 @@ void MainWindow::OnMainTimerTick()
         logs.append(Syslog::HuggleLogs->UnwrittenLogs);
         Syslog::HuggleLogs->UnwrittenLogs.clear();
         Syslog::HuggleLogs->lUnwrittenLogs->unlock();
-        while (logs.count())
-        {
-            this->SystemLog->InsertText(logs.at(0));
-            logs.removeFirst();
-        }
+        this->SystemLog->InsertText(logs);
     }
     this->Queries->RemoveExpired();
     if (this->OnNext_EvPage != nullptr && this->qNext != nullptr && this->qNext->IsProcessed())
@@ -2099,6 +2120,7 @@ void MainWindow::Localize()
     this->ui->actionContribution_browser->setText(_l("main-user-contribution-browser"));
     this->ui->actionRevert_only_this_revision_assuming_good_faith->setText(_l("main-revision-revert-agf"));
     this->ui->actionRevert_only_this_revision->setText(_l("main-revision-revert-only-this"));
+    this->ui->actionRevert_all_edits_of_user_and_warn->setText(_l("main-revision-revert-all-warn"));
 
     // arrows icons should be mirrored for RTL languages
     if (Localizations::HuggleLocalizations->IsRTL())
@@ -3317,6 +3339,46 @@ void MainWindow::on_actionRevert_only_this_revision_assuming_good_faith_triggere
     this->RevertAgf(true);
 }
 
+void MainWindow::on_actionRevert_all_edits_of_user_and_warn_triggered()
+{
+    if (!this->EditingChecks() || !this->CheckRevertable())
+        return;
+    if (!this->CurrentEdit->IsPostProcessed() || !this->preflightCheck(this->CurrentEdit))
+        return;
+    // edits must be held before the list is unlocked, GC could delete them otherwise
+    QList<Collectable_SmartPtr<WikiEdit>> edits;
+    WikiEdit::Lock_EditList->lock();
+    foreach (WikiEdit *edit, WikiEdit::EditList)
+    {
+        if (edit->GetSite() == this->CurrentEdit->GetSite() && edit->User->EqualTo(this->CurrentEdit->User))
+            edits.append(Collectable_SmartPtr<WikiEdit>(edit));
+    }
+    WikiEdit::Lock_EditList->unlock();
+    this->CurrentEdit->User->Resync();
+    Hooks::OnRevert(this->CurrentEdit);
+    BulkRevert *bulk = new BulkRevert(edits, "", this->CurrentEdit->GetSite()->GetProjectConfig()->DefaultTemplate, this);
+    connect(bulk, SIGNAL(Finished(BulkRevert*)), this, SLOT(OnBulkRevertFinished(BulkRevert*)));
+    if (!bulk->Process())
+    {
+        delete bulk;
+        return;
+    }
+    Syslog::HuggleLogs->Log(_l("main-bulk-revert-start", QString::number(bulk->GetCount()), this->CurrentEdit->User->Username));
+    this->DisplayNext();
+}
+
+void MainWindow::OnBulkRevertFinished(BulkRevert *bulk)
+{
+    QStringList parameters;
+    parameters << QString::number(bulk->GetReverted()) << QString::number(bulk->GetCount()) << bulk->GetUser()->Username
+               << QString::number(bulk->GetWallTime());
+    Syslog::HuggleLogs->Log(_l("main-bulk-revert-done", parameters));
+    // one warning for all pages, raised by as many levels as there were reverts
+    if (bulk->GetLatestReverted() != nullptr)
+        this->Warn(bulk->WarningType, nullptr, bulk->GetLatestReverted(), bulk->GetReverted());
+    bulk->deleteLater();
+}
+
 void MainWindow::on_tabWidget_currentChanged(int index)
 {
     int in = this->ui->tabWidget->count() - 1;
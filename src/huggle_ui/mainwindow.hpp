@@ -51,8 +51,11 @@ namespace Huggle
 {
     class AboutForm;
     class BlockUserForm;
+    class BulkRevert;
     class DeleteForm;
+    class DiffPrefetcher;
     class EditBar;
+    class EditPipeline;
     class HuggleLog;
     class History;
     class HistoryItem;
@@ -148,9 +151,10 @@ namespace Huggle
              * \param warning_type - type of warning to send
              * \param dependency - in case this warning is depending on some revert, put a pointer to it there
              * \param related_edit - edit in question
+             * \param escalation - number of edits this warning is sent for
              * \return true on success, otherwise false
              */
-            bool Warn(QString warning_type, RevertQuery *dependency, WikiEdit *related_edit);
+            bool Warn(QString warning_type, RevertQuery *dependency, WikiEdit *related_edit, int escalation = 1);
             void EnableDev();
             //! Send a template to user no matter if they can be messaged or not
             void ForceWarn(int level);
@@ -205,8 +209,8 @@ namespace Huggle
             void GoBackward();
             void ShowToolTip(QString text);
             void ShutdownForm();
-            //! List of edits that are being saved
-            QList<WikiEdit*> PendingEdits;
+            //! Edits that were retrieved from providers and are being post processed before they go to queue
+            EditPipeline *Pipeline;
             //! Pointer to syslog
             HuggleLog *SystemLog;
             bool QueueIsNowPaused = false;
@@ -275,6 +279,7 @@ namespace Huggle
             void on_actionAbout_triggered();
             void OnMainTimerTick();
             void OnTimerTick0();
+            void OnBrowserLoadFinished(bool ok);
             void on_actionNext_triggered();
             void on_actionNext_2_triggered();
             void on_actionWarn_triggered();
@@ -366,6 +371,8 @@ namespace Huggle
             void on_actionMy_Contributions_triggered();
             void Go();
             void on_actionRevert_only_this_revision_assuming_good_faith_triggered();
+            void on_actionRevert_all_edits_of_user_and_warn_triggered();
+            void OnBulkRevertFinished(BulkRevert *bulk);
             void on_tabWidget_currentChanged(int index);
             void on_actionClose_current_tab_triggered();
             void on_actionOpen_new_tab_triggered();
@@ -410,6 +417,9 @@ namespace Huggle
             void finishRestore();
             void createBrowserTab(QString name, int index);
             void changeCurrentBrowserTabTitle(QString name);
+            //! Replace browser in current tab with a browser in which the diff was prerendered
+            void swapBrowser(GenericBrowser *browser);
+            void refreshPrefetch();
             //! When any button to warn current user is pressed it call this function
             void triggerWarn();
             //! When any button to welcome current user is pressed it call this function
@@ -443,6 +453,10 @@ namespace Huggle
             QToolButton *rwToolButtonMenu = nullptr;
             QToolButton *welcomeToolButtonMenu = nullptr;
             QDateTime editLoadDateTime;
+            DiffPrefetcher *prefetcher = nullptr;
+            //! True if we are waiting for browser to render current edit, used to measure time to display
+            bool waitingForDisplay = false;
+            bool displayPrefetched = false;
             QString RestoreEdit_RevertReason;
             ReloginForm *fRelogin = nullptr;
             QTimer *wlt = nullptr;
@@ -11,12 +11,15 @@
 #include "processlist.hpp"
 #include <QMenu>
 #include <QClipboard>
+#include <huggle_core/apiquerycache.hpp>
 #include <huggle_core/configuration.hpp>
 #include <huggle_core/core.hpp>
 #include <huggle_core/events.hpp>
 #include <huggle_core/exception.hpp>
 #include <huggle_core/huggleprofiler.hpp>
 #include <huggle_core/localization.hpp>
+#include <huggle_core/networkscheduler.hpp>
+#include "processlistmodel.hpp"
 #include "ui_processlist.h"
 
 using namespace Huggle;
@@ -29,47 +32,39 @@ ProcessList::ProcessList(QWidget *parent) : QDockWidget(parent), ui(new Ui::Proc
     this->IsDebuged = hcfg->Verbosity > 0;
     header << _l("id") << _l("type") << _l("target") << _l("status");
     if (this->IsDebuged)
-    {
-        this->ui->tableWidget->setColumnCount(6);
         header << "Url" << "Debug info";
-    } else
-    {
-        this->ui->tableWidget->setColumnCount(4);
-    }
-    this->ui->tableWidget->setContextMenuPolicy(Qt::CustomContextMenu);
-    this->ui->tableWidget->setHorizontalHeaderLabels(header);
-    this->ui->tableWidget->verticalHeader()->setVisible(false);
-    this->ui->tableWidget->horizontalHeader()->setSelectionBehavior(QAbstractItemView::SelectRows);
-    this->ui->tableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    connect(this->ui->tableWidget, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(ContextMenu(QPoint)));
+    this->model = new ProcessListModel(this->IsDebuged, this);
+    this->model->SetHeader(header);
+    this->ui->tableView->setModel(this->model);
+    this->ui->tableView->setContextMenuPolicy(Qt::CustomContextMenu);
+    this->ui->tableView->verticalHeader()->setVisible(false);
+    // rows contain single line of text, so they don't need to be measured every time they change
+    this->ui->tableView->verticalHeader()->setDefaultSectionSize(this->ui->tableView->fontMetrics().height() + 4);
+    this->ui->tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    connect(this->ui->tableView, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(ContextMenu(QPoint)));
     if (Configuration::HuggleConfiguration->SystemConfig_DynamicColsInList)
     {
-#if QT_VERSION >= 0x050000
-// Qt5 code
-        this->ui->tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-#else
-// Qt4 code
-        this->ui->tableWidget->horizontalHeader()->setResizeMode(QHeaderView::ResizeToContents);
-#endif
+        this->ui->tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
     } else
     {
-        this->ui->tableWidget->setColumnWidth(0, 60);
-        this->ui->tableWidget->setColumnWidth(1, 200);
-        this->ui->tableWidget->setColumnWidth(2, 200);
-        this->ui->tableWidget->setColumnWidth(3, 80);
+        this->ui->tableView->setColumnWidth(0, 60);
+        this->ui->tableView->setColumnWidth(1, 200);
+        this->ui->tableView->setColumnWidth(2, 200);
+        this->ui->tableView->setColumnWidth(3, 80);
         if (this->IsDebuged)
-            this->ui->tableWidget->setColumnWidth(4, 800);
+            this->ui->tableView->setColumnWidth(4, 800);
     }
-    this->ui->tableWidget->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
-    this->ui->tableWidget->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
-    this->ui->tableWidget->setShowGrid(false);
+    this->ui->tableView->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
+    this->ui->tableView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    this->ui->tableView->setShowGrid(false);
+    this->ui->labelScheduler->setVisible(this->IsDebuged);
     connect(Events::Global, SIGNAL(QueryPool_Remove(Query*)), this, SLOT(OnQueryPoolRemove(Query*)));
     connect(Events::Global, SIGNAL(QueryPool_Update(Query*)), this, SLOT(OnQueryPoolUpdate(Query*)));
-    this->Removed = new QList<ProcessListRemovedItem*>();
 }
 
 ProcessList::~ProcessList()
 {
+    delete this->model;
     delete this->ui;
 }
 
@@ -80,128 +75,51 @@ void ProcessList::InsertQuery(Collectable_SmartPtr<Query> query)
     {
         throw new Huggle::NullPointerException("Collectable_SmartPtr<Query> query", BOOST_CURRENT_FUNCTION);
     }
-    int size = this->ui->tableWidget->rowCount();
-    this->ui->tableWidget->insertRow(size);
-    this->ui->tableWidget->setItem(size, 0, new QTableWidgetItem(QString::number(query->QueryID())));
-    this->ui->tableWidget->setItem(size, 1, new QTableWidgetItem(query->QueryTypeToString()));
-    this->ui->tableWidget->setItem(size, 2, new QTableWidgetItem(query->QueryTargetToString()));
-    this->ui->tableWidget->setItem(size, 3, new QTableWidgetItem(query->QueryStatusToString()));
-    if (this->IsDebuged)
-    {
-        this->ui->tableWidget->setItem(size, 4, new QTableWidgetItem(query->DebugURL()));
-        this->ui->tableWidget->setItem(size, 5, new QTableWidgetItem(query->GetFailureReason()));
-    }
-    this->ui->tableWidget->resizeRowToContents(size);
+    this->model->UpdateQuery(query.GetPtr());
 }
 
 void ProcessList::Clear()
 {
-    delete this->Removed;
-    this->ui->tableWidget->clear();
+    this->model->Clear();
 }
 
 bool ProcessList::ContainsQuery(Query *query)
 {
     HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
-    return GetItem(query) != -1;
+    return this->model->ContainsQuery(query);
 }
 
 void ProcessList::RemoveQuery(Query *query)
 {
     HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
-    if (!IsExpired(query))
-    {
-        this->Removed->append(new ProcessListRemovedItem(query->QueryID()));
-    }
+    this->model->RemoveQuery(query);
 }
 
 void ProcessList::UpdateQuery(Query *query)
 {
     HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
-    int query_ = GetItem(query);
-    if (query_ == -1)
-    {
-        this->InsertQuery(query);
-        return;
-    }
-
-    this->ui->tableWidget->setItem(query_, 0, new QTableWidgetItem(QString::number(query->QueryID())));
-    this->ui->tableWidget->setItem(query_, 1, new QTableWidgetItem(query->QueryTypeToString()));
-    this->ui->tableWidget->setItem(query_, 2, new QTableWidgetItem(query->QueryTargetToString()));
-    this->ui->tableWidget->setItem(query_, 3, new QTableWidgetItem(query->QueryStatusToString()));
-    if (this->IsDebuged)
-    {
-        this->ui->tableWidget->setItem(query_, 4, new QTableWidgetItem(query->DebugURL()));
-        this->ui->tableWidget->setItem(query_, 5, new QTableWidgetItem(query->GetFailureReason()));
-    }
-    this->ui->tableWidget->resizeRowToContents(query_);
-}
-
-bool ProcessList::IsExpired(Query *q)
-{
-    HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
-    foreach(ProcessListRemovedItem *item, *this->Removed)
-        if ((unsigned int) item->GetID() == q->QueryID())
-            return true;
-
-    return false;
+    this->model->UpdateQuery(query);
 }
 
 void ProcessList::RemoveExpired()
 {
-    if (this->Removed->count() == 0)
-        return;
-
-    QList<ProcessListRemovedItem*> rm;
-    foreach (ProcessListRemovedItem *item, *this->Removed)
-        if (item->Expired(this->IsDebuged))
-            rm.append(item);
-
-    foreach (ProcessListRemovedItem *item, rm)
-    {
-        this->Removed->removeOne(item);
-        int row = this->GetItem(item->GetID());
-        if (row != -1)
-            this->ui->tableWidget->removeRow(row);
-
-        delete item;
-    }
-}
-
-int ProcessList::GetItem(Query *q)
-{
-    HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
-    int curr = 0;
-    int size = this->ui->tableWidget->rowCount();
-    while (curr < size)
+    // queue waits of scheduler are only interesting for people who debug huggle
+    if (this->IsDebuged && NetworkScheduler::HuggleScheduler != nullptr)
     {
-        if (this->ui->tableWidget->item(curr,0)->text() == QString::number(q->QueryID()))
-            return curr;
-
-        curr++;
+        QString statistics = NetworkScheduler::HuggleScheduler->GetStatistics();
+        if (ApiQueryCache::HuggleCache != nullptr)
+            statistics += "\nCache: " + ApiQueryCache::HuggleCache->GetStatistics();
+        this->ui->labelScheduler->setText(statistics);
     }
-    return -1;
-}
-
-int ProcessList::GetItem(int Id)
-{
-    HUGGLE_PROFILER_INCRCALL(BOOST_CURRENT_FUNCTION);
-    int curr = 0;
-    int size = this->ui->tableWidget->rowCount();
-    while (curr < size)
-    {
-        if (this->ui->tableWidget->item(curr,0)->text() == QString::number(Id))
-        {
-            return curr;
-        }
-        curr++;
-    }
-    return -1;
+    if (this->IsDebuged)
+        this->model->RemoveExpired(120);
+    else
+        this->model->RemoveExpired(hcfg->SystemConfig_QueryListTimeLimit);
 }
 
 void ProcessList::ContextMenu(const QPoint &position)
 {
-    QPoint g_ = this->ui->tableWidget->mapToGlobal(position);
+    QPoint g_ = this->ui->tableView->mapToGlobal(position);
     QMenu menu;
     QAction *copy = new QAction(_l("copy"), &menu);
     menu.addAction(copy);
@@ -209,8 +127,8 @@ void ProcessList::ContextMenu(const QPoint &position)
     if (selection == copy)
     {
         QString t = "";
-        foreach (QTableWidgetItem *text, this->ui->tableWidget->selectedItems())
-            t += text->text() + "\n";
+        foreach (QModelIndex index, this->ui->tableView->selectionModel()->selectedIndexes())
+            t += index.data().toString() + "\n";
         if (!t.isEmpty())
             QApplication::clipboard()->setText(t);
     }
@@ -225,21 +143,3 @@ void ProcessList::OnQueryPoolUpdate(Query *q)
 {
     this->UpdateQuery(q);
 }
-
-ProcessListRemovedItem::ProcessListRemovedItem(int ID)
-{
-    this->id = ID;
-    this->time = QDateTime::currentDateTime();
-}
-
-int ProcessListRemovedItem::GetID()
-{
-    return this->id;
-}
-
-bool ProcessListRemovedItem::Expired(bool Debug)
-{
-    if (Debug)
-        return this->time < QDateTime::currentDateTime().addSecs(-120);
-    return this->time < QDateTime::currentDateTime().addSecs(-hcfg->SystemConfig_QueryListTimeLimit);
-}
@@ -13,9 +13,6 @@
 
 #include <huggle_core/definitions.hpp>
 
-#include <QList>
-#include <QTableWidgetItem>
-#include <QDateTime>
 #include <QHeaderView>
 #include <QDockWidget>
 #include <huggle_core/collectable_smartptr.hpp>
@@ -28,20 +25,7 @@ namespace Ui
 
 namespace Huggle
 {
-    //! Removed item that was in the process list
-
-    //! When you remove an item it should stay in list for some time so that user can notice it finished and that's
-    //! why we store it to separate object and for that we have this class ;)
-    class ProcessListRemovedItem
-    {
-        private:
-            QDateTime time;
-            int id;
-        public:
-            ProcessListRemovedItem(int ID);
-            int GetID();
-            bool Expired(bool Debug);
-    };
+    class ProcessListModel;
 
     //! List of processes in a main window
 
@@ -69,11 +53,8 @@ namespace Huggle
             void OnQueryPoolRemove(Query *q);
             void OnQueryPoolUpdate(Query *q);
         private:
-            int GetItem(Query *q);
-            int GetItem(int Id);
-            bool IsExpired(Query *q);
             bool IsDebuged;
-            QList<ProcessListRemovedItem*> *Removed;
+            ProcessListModel *model;
             Ui::ProcessList *ui;
     };
 }
@@ -0,0 +1,219 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "processlistmodel.hpp"
+#include <QTimer>
+#include <algorithm>
+#include <functional>
+#include <huggle_core/query.hpp>
+
+// Changes are delivered to views at most once per this many milliseconds
+#define HUGGLE_PROCESSLIST_FRAME 40
+
+using namespace Huggle;
+
+static bool updateRow(ProcessListRow &row, Query *query, bool debug)
+{
+    QString type = query->QueryTypeToString();
+    QString target = query->QueryTargetToString();
+    QString status = query->QueryStatusToString();
+    bool changed = row.Type != type || row.Target != target || row.Status != status;
+    row.Type = type;
+    row.Target = target;
+    row.Status = status;
+    if (debug)
+    {
+        QString url = query->DebugURL();
+        QString failure = query->GetFailureReason();
+        changed = changed || row.URL != url || row.Debug != failure;
+        row.URL = url;
+        row.Debug = failure;
+    }
+    return changed;
+}
+
+ProcessListModel::ProcessListModel(bool debug, QObject *parent) : QAbstractTableModel(parent)
+{
+    this->debug = debug;
+    this->flushTimer = new QTimer(this);
+    this->flushTimer->setSingleShot(true);
+    this->flushTimer->setInterval(HUGGLE_PROCESSLIST_FRAME);
+    connect(this->flushTimer, &QTimer::timeout, this, &ProcessListModel::Flush);
+}
+
+ProcessListModel::~ProcessListModel()
+{
+    delete this->flushTimer;
+}
+
+int ProcessListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return this->rows.count();
+}
+
+int ProcessListModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return this->debug ? 6 : 4;
+}
+
+QVariant ProcessListModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid() || index.row() >= this->rows.count())
+        return QVariant();
+    const ProcessListRow &row = this->rows.at(index.row());
+    switch (index.column())
+    {
+        case 0:
+            return row.ID;
+        case 1:
+            return row.Type;
+        case 2:
+            return row.Target;
+        case 3:
+            return row.Status;
+        case 4:
+            return row.URL;
+        case 5:
+            return row.Debug;
+    }
+    return QVariant();
+}
+
+QVariant ProcessListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal || section >= this->header.count())
+        return QVariant();
+    return this->header.at(section);
+}
+
+void ProcessListModel::SetHeader(QStringList header)
+{
+    this->header = header;
+    emit this->headerDataChanged(Qt::Horizontal, 0, this->columnCount() - 1);
+}
+
+void ProcessListModel::UpdateQuery(Query *query)
+{
+    int row = this->index.value(query->QueryID(), -1);
+    if (row < 0)
+    {
+        row = this->rows.count();
+        this->beginInsertRows(QModelIndex(), row, row);
+        this->rows.append(ProcessListRow());
+        this->rows[row].ID = query->QueryID();
+        updateRow(this->rows[row], query, this->debug);
+        this->index.insert(query->QueryID(), row);
+        this->endInsertRows();
+        return;
+    }
+    if (updateRow(this->rows[row], query, this->debug))
+        this->markDirty(row);
+}
+
+void ProcessListModel::RemoveQuery(Query *query)
+{
+    int row = this->index.value(query->QueryID(), -1);
+    if (row < 0 || !this->rows.at(row).Removed.isNull())
+        return;
+    this->rows[row].Removed = QDateTime::currentDateTime();
+    this->removed.append(query->QueryID());
+}
+
+bool ProcessListModel::ContainsQuery(Query *query)
+{
+    return this->index.contains(query->QueryID());
+}
+
+void ProcessListModel::RemoveExpired(int seconds)
+{
+    if (this->removed.isEmpty())
+        return;
+    QDateTime limit = QDateTime::currentDateTime().addSecs(-seconds);
+    QList<int> expired;
+    while (!this->removed.isEmpty())
+    {
+        int row = this->index.value(this->removed.first(), -1);
+        if (row >= 0 && this->rows.at(row).Removed >= limit)
+            break;
+        this->removed.removeFirst();
+        if (row >= 0)
+            expired.append(row);
+    }
+    if (expired.isEmpty())
+        return;
+    // dirty rows are remembered by position which is going to change
+    this->Flush();
+    // rows are removed from the bottom so that positions of rows which are yet to be removed stay same,
+    // queries that finished at similar time are usually next to each other so they are removed as one range
+    std::sort(expired.begin(), expired.end(), std::greater<int>());
+    int i = 0;
+    while (i < expired.count())
+    {
+        int last = expired.at(i);
+        int first = last;
+        i++;
+        while (i < expired.count() && expired.at(i) == first - 1)
+        {
+            first--;
+            i++;
+        }
+        this->beginRemoveRows(QModelIndex(), first, last);
+        this->rows.remove(first, last - first + 1);
+        this->endRemoveRows();
+    }
+    this->rebuildIndex();
+}
+
+void ProcessListModel::Clear()
+{
+    this->beginResetModel();
+    this->rows.clear();
+    this->index.clear();
+    this->removed.clear();
+    this->firstDirty = -1;
+    this->lastDirty = -1;
+    this->flushTimer->stop();
+    this->endResetModel();
+}
+
+void ProcessListModel::Flush()
+{
+    this->flushTimer->stop();
+    if (this->firstDirty < 0)
+        return;
+    emit this->dataChanged(this->createIndex(this->firstDirty, 0), this->createIndex(this->lastDirty, this->columnCount() - 1));
+    this->firstDirty = -1;
+    this->lastDirty = -1;
+}
+
+void ProcessListModel::markDirty(int row)
+{
+    if (this->firstDirty < 0 || row < this->firstDirty)
+        this->firstDirty = row;
+    if (row > this->lastDirty)
+        this->lastDirty = row;
+    if (!this->flushTimer->isActive())
+        this->flushTimer->start();
+}
+
+void ProcessListModel::rebuildIndex()
+{
+    this->index.clear();
+    int row = 0;
+    while (row < this->rows.count())
+    {
+        this->index.insert(this->rows.at(row).ID, row);
+        row++;
+    }
+}
@@ -0,0 +1,86 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef PROCESSLISTMODEL_HPP
+#define PROCESSLISTMODEL_HPP
+
+#include <huggle_core/definitions.hpp>
+
+#include <QAbstractTableModel>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QTimer;
+
+namespace Huggle
+{
+    class Query;
+
+    //! Row of process list, it holds copy of texts so that it can stay in list after the query is deleted
+    class ProcessListRow
+    {
+        public:
+            unsigned int ID;
+            QString Type;
+            QString Target;
+            QString Status;
+            QString URL;
+            QString Debug;
+            //! Time when query was removed from pool, null while it's running
+            QDateTime Removed;
+    };
+
+    //! Model of queries displayed in process list
+
+    //! Query pool reports every running query few times a second, so rows are found using a hash
+    //! of query ids and changed rows are only marked as dirty. Views are notified about all rows that
+    //! changed since last frame using single dataChanged signal.
+    class ProcessListModel : public QAbstractTableModel
+    {
+            Q_OBJECT
+        public:
+            ProcessListModel(bool debug, QObject *parent = nullptr);
+            ~ProcessListModel();
+            int rowCount(const QModelIndex &parent = QModelIndex()) const;
+            int columnCount(const QModelIndex &parent = QModelIndex()) const;
+            QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+            QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+            void SetHeader(QStringList header);
+            //! Insert the query or update its row if it's already in list
+            void UpdateQuery(Query *query);
+            //! Mark the query as finished, it's removed from list once it expires
+            void RemoveQuery(Query *query);
+            bool ContainsQuery(Query *query);
+            //! Remove rows of queries that finished long time ago
+            void RemoveExpired(int seconds);
+            void Clear();
+            //! Emit dataChanged for rows which changed since last call
+            void Flush();
+        private:
+            void markDirty(int row);
+            void rebuildIndex();
+            bool debug;
+            QStringList header;
+            QVector<ProcessListRow> rows;
+            //! Query ID -> row
+            QHash<unsigned int, int> index;
+            //! IDs of removed queries in order they were removed, which is also order in which they expire
+            QList<unsigned int> removed;
+            int firstDirty = -1;
+            int lastDirty = -1;
+            QTimer *flushTimer;
+    };
+}
+
+#endif // PROCESSLISTMODEL_HPP
@@ -23,6 +23,7 @@
 #include <huggle_core/generic.hpp>
 #include <huggle_core/webserverquery.hpp>
 #include <huggle_core/scripting/script.hpp>
+#include <huggle_core/scripting/scriptworker.hpp>
 
 using namespace Huggle;
 
@@ -30,7 +31,7 @@ ScriptingManager::ScriptingManager(QWidget *parent) : QDialog(parent), ui(new Ui
 {
     this->ui->setupUi(this);
     QStringList headers;
-    headers << "Name" << "Author" << "Version" << "Is working" << "Description" << "Path";
+    headers << "Name" << "Author" << "Version" << "Is working" << "CPU time" << "Description" << "Path";
     this->ui->tableWidget->setColumnCount(headers.count());
     this->ui->tableWidget->verticalHeader()->setVisible(false);
     this->ui->tableWidget->horizontalHeader()->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -60,8 +61,20 @@ void ScriptingManager::Reload()
         this->ui->tableWidget->setItem(row, 1, new QTableWidgetItem(sx->GetAuthor()));
         this->ui->tableWidget->setItem(row, 2, new QTableWidgetItem(sx->GetVersion()));
         this->ui->tableWidget->setItem(row, 3, new QTableWidgetItem(Generic::Bool2String(sx->IsWorking())));
-        this->ui->tableWidget->setItem(row, 4, new QTableWidgetItem(sx->GetDescription()));
-        this->ui->tableWidget->setItem(row, 5, new QTableWidgetItem(sx->GetPath()));
+        QString cpu_time = QString::number(sx->GetCPUTime()) + "ms";
+        ScriptWorker *worker = sx->GetWorker();
+        if (worker)
+        {
+            cpu_time += " (worker";
+            if (!worker->IsWorking())
+                cpu_time += ", stopped";
+            else if (worker->GetTimeouts())
+                cpu_time += ", " + QString::number(worker->GetTimeouts()) + " timeouts";
+            cpu_time += ")";
+        }
+        this->ui->tableWidget->setItem(row, 4, new QTableWidgetItem(cpu_time));
+        this->ui->tableWidget->setItem(row, 5, new QTableWidgetItem(sx->GetDescription()));
+        this->ui->tableWidget->setItem(row, 6, new QTableWidgetItem(sx->GetPath()));
     }
     this->ui->tableWidget->resizeColumnsToContents();
     this->ui->tableWidget->resizeRowsToContents();
@@ -17,6 +17,7 @@
 #include <QAction>
 #include <QMenu>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QCoreApplication>
 #include <huggle_core/configuration.hpp>
 #include <huggle_core/generic.hpp>
@@ -63,21 +64,32 @@ void UiScript::Autostart()
         }
     }
 #endif
+    QStringList scripts;
     foreach (QString name, extensions)
     {
-        QString lower_name = name.toLower();
-        if (lower_name.endsWith(".js"))
+        if (name.toLower().endsWith(".js"))
+            scripts << name;
+    }
+    // files are read in parallel, but engines must be created here because they belong to main thread
+    QHash<QString, QString> sources = Script::ReadSources(scripts);
+    foreach (QString name, scripts)
+    {
+        QString er;
+        if (!sources.contains(name))
+        {
+            HUGGLE_ERROR("Failed to load a JS script (" + name + "): Unable to read file: " + name);
+            continue;
+        }
+        QElapsedTimer load_time;
+        load_time.start();
+        UiScript *script = new UiScript();
+        if (script->LoadSrc(name, sources[name], &er))
+        {
+            HUGGLE_LOG("Loaded JS script: " + name + " (" + QString::number(load_time.elapsed()) + "ms)");
+        } else
         {
-            QString er;
-            UiScript *script = new UiScript();
-            if (script->Load(name, &er))
-            {
-                HUGGLE_LOG("Loaded JS script: " + name);
-            } else
-            {
-                HUGGLE_ERROR("Failed to load a JS script (" + name + "): " + er);
-                delete script;
-            }
+            HUGGLE_ERROR("Failed to load a JS script (" + name + "): " + er);
+            delete script;
         }
     }
 }
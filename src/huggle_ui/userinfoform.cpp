@@ -13,9 +13,12 @@
 #include "mainwindow.hpp"
 #include "ui_userinfoform.h"
 #include "uihooks.hpp"
-#include <QtXml>
+#include <QTimer>
+#include <QUrl>
+#include <huggle_core/apiqueryresult.hpp>
 #include <huggle_core/configuration.hpp>
 #include <huggle_core/exception.hpp>
+#include <huggle_core/historycache.hpp>
 #include <huggle_core/hooks.hpp>
 #include <huggle_core/localization.hpp>
 #ifdef HUGGLE_WEBEN
@@ -28,6 +31,8 @@
 #include <huggle_core/wikiuser.hpp>
 #include <huggle_core/wikipage.hpp>
 
+// Number of contributions that are displayed
+#define HUGGLE_USERINFO_CONTRIBS 20
 
 using namespace Huggle;
 
@@ -102,10 +107,20 @@ void UserinfoForm::Read()
 {
     if (!UiHooks::ContribBoxBeforeQuery(this->User, this))
         return;
+    QList<HistoryRevision> contributions;
+    if (HistoryCache::HuggleHistory && HistoryCache::HuggleHistory->GetContributions(this->User->GetSite(), this->User->Username,
+                                                                                     HUGGLE_USERINFO_CONTRIBS, &contributions))
+    {
+        HUGGLE_DEBUG("Contributions of " + this->User->Username + " were loaded from cache", 2);
+        ui->pushButton->hide();
+        this->ShowContributions(contributions);
+        return;
+    }
     this->qContributions = new ApiQuery(ActionQuery, this->User->GetSite());
     this->qContributions->Target = "Retrieving contributions of " + this->User->Username;
     this->qContributions->Parameters = "list=usercontribs&ucuser=" + QUrl::toPercentEncoding(this->User->Username) +
-                                       "&ucprop=flags%7Ccomment%7Ctimestamp%7Ctitle%7Cids%7Csize&uclimit=20";
+                                       "&ucprop=flags%7Ccomment%7Ctimestamp%7Ctitle%7Cids%7Csize%7Ctags&uclimit=" +
+                                       QString::number(HUGGLE_USERINFO_CONTRIBS);
     QueryPool::HugglePool->AppendQuery(this->qContributions);
     ui->pushButton->hide();
     this->qContributions->Process();
@@ -142,84 +157,62 @@ void UserinfoForm::OnTick()
             this->qContributions.Delete();
             return;
         }
-        QDomDocument d;
-        d.setContent(this->qContributions->Result->Data);
-        QDomNodeList results = d.elementsByTagName("item");
-        int xx = 0;
-        if (results.count() > 0)
+        QList<HistoryRevision> contributions;
+        foreach (ApiQueryResultNode *item, this->qContributions->GetApiQueryResult()->GetNodes("item"))
         {
-            //QColor xb;
-            //bool xt = false;
-            while (results.count() > xx)
-            {
-                QDomElement edit = results.at(xx).toElement();
-                if (!edit.attributes().contains("user"))
-                    continue;
-                UserInfoFormHistoryItem item(this->User->GetSite());
-                item.Top = edit.attributes().contains("top");
-                item.Name = this->User->Username;
-                if (this->User->IsIP())
-                {
-                    item.Type = EditType_Anon;
-                }
-                if (this->User->IsReported)
-                    item.Type = EditType_Reported;
-                if (this->User->IsBlocked)
-                    item.Type = EditType_Blocked;
-                /*if (item.Top)
-                {
-                    // set a different color for edits that are top
-                    if (xt)
-                        xb = QColor(110, 202, 250);
-                    else
-                        xb = QColor(120, 222, 250);
-                } else
-                {
-                    if (xt)
-                        xb = QColor(206, 202, 250);
-                    else
-                        xb = QColor(224, 222, 250);
-                }*/
-                //xt = !xt;
-                item.Page = "unknown page";
-                if (edit.attributes().contains("title"))
-                    item.Page = edit.attribute("title");
-                item.Date = "unknown time";
-                if (edit.attributes().contains("timestamp"))
-                    item.Date = edit.attribute("timestamp");
-                if (edit.attributes().contains("revid"))
-                    item.RevID = edit.attribute("revid");
-                int last = this->ui->tableWidget->rowCount();
-                this->ui->tableWidget->insertRow(last);
-                QFont font;
-                if (item.Top)
-                {
-                    font.setBold(true);
-                }
-                QTableWidgetItem *q = new QTableWidgetItem(item.Page);
-                //q->setBackgroundColor(xb);
-                //q->setTextColor(QColor(0, 0, 0));
-                q->setFont(font);
-                this->ui->tableWidget->setItem(last, 0, q);
-                q = new QTableWidgetItem(item.Date);
-                //q->setTextColor(QColor(0, 0, 0));
-                //q->setBackgroundColor(xb);
-                this->ui->tableWidget->setItem(last, 1, q);
-                q = new QTableWidgetItem(item.RevID);
-                //q->setTextColor(QColor(0, 0, 0));
-                //q->setBackgroundColor(xb);
-                this->Items.append(item);
-                this->ui->tableWidget->setItem(last, 2, q);
-                xx++;
-            }
-        } else
-            Syslog::HuggleLogs->ErrorLog(_l("user-history-fail", this->User->Username));
-        this->ui->tableWidget->resizeRowsToContents();
-        MainWindow::HuggleMain->wEditBar->RefreshUser();
+            if (item->Attributes.contains("user"))
+                contributions.append(HistoryRevision::FromApiNode(item));
+        }
         this->qContributions.Delete();
         this->timer->stop();
-        UiHooks::ContribBoxAfterQuery(this->User, this);
+        if (contributions.isEmpty())
+        {
+            Syslog::HuggleLogs->ErrorLog(_l("user-history-fail", this->User->Username));
+        } else if (HistoryCache::HuggleHistory)
+        {
+            HistoryCache::HuggleHistory->InsertContributions(this->User->GetSite(), this->User->Username, contributions,
+                                                             contributions.count() < HUGGLE_USERINFO_CONTRIBS);
+        }
+        this->ShowContributions(contributions);
+    }
+}
+
+void UserinfoForm::ShowContributions(const QList<HistoryRevision> &contributions)
+{
+    foreach (HistoryRevision contribution, contributions)
+    {
+        UserInfoFormHistoryItem item(this->User->GetSite());
+        item.Top = contribution.Top;
+        item.Name = this->User->Username;
+        if (this->User->IsIP())
+            item.Type = EditType_Anon;
+        if (this->User->IsReported)
+            item.Type = EditType_Reported;
+        if (this->User->IsBlocked)
+            item.Type = EditType_Blocked;
+        item.Page = "unknown page";
+        if (!contribution.Page.isEmpty())
+            item.Page = contribution.Page;
+        item.Date = "unknown time";
+        if (!contribution.Timestamp.isEmpty())
+            item.Date = contribution.Timestamp;
+        if (contribution.RevID != WIKI_UNKNOWN_REVID)
+            item.RevID = QString::number(contribution.RevID);
+        item.Summary = contribution.Summary;
+        int last = this->ui->tableWidget->rowCount();
+        this->ui->tableWidget->insertRow(last);
+        QFont font;
+        font.setBold(item.Top);
+        QTableWidgetItem *q = new QTableWidgetItem(item.Page);
+        q->setFont(font);
+        this->ui->tableWidget->setItem(last, 0, q);
+        this->ui->tableWidget->setItem(last, 1, new QTableWidgetItem(item.Date));
+        this->ui->tableWidget->setItem(last, 2, new QTableWidgetItem(item.RevID));
+        this->Items.append(item);
     }
+    this->ui->tableWidget->resizeRowsToContents();
+    MainWindow::HuggleMain->wEditBar->RefreshUser();
+    UiHooks::ContribBoxAfterQuery(this->User, this);
 }
 
 void UserinfoForm::JumpToSpecificContrib(long revid, QString page)
@@ -19,6 +19,7 @@
 #include <huggle_core/apiquery.hpp>
 #include <huggle_core/collectable_smartptr.hpp>
 #include <huggle_core/edittype.hpp>
+#include <huggle_core/historycache.hpp>
 #include <huggle_core/mediawikiobject.hpp>
 #include <huggle_core/wikiedit.hpp>
 
@@ -71,6 +72,8 @@ namespace Huggle
             void on_tableWidget_clicked(const QModelIndex &index);
 
         private:
+            //! Fill the table with contributions, sorted from newest
+            void ShowContributions(const QList<HistoryRevision> &contributions);
             Ui::UserinfoForm *ui;
             WikiUser *User;
             Collectable_SmartPtr<WikiEdit> edit;
@@ -20,6 +20,7 @@ HuggleWeb::HuggleWeb(QWidget *parent) : GenericBrowser(parent), ui(new Ui::Huggl
     this->ui->label->setVisible(false);
     this->ui->lineEdit->setVisible(false);
     this->ui->webView->setPage(new HuggleWebEnginePage());
+    connect(this->ui->webView, SIGNAL(loadFinished(bool)), this, SIGNAL(LoadFinished(bool)));
 }
 
 HuggleWeb::~HuggleWeb()
@@ -17,6 +17,7 @@ using namespace Huggle;
 HuggleWeb::HuggleWeb(QWidget *parent) : GenericBrowser(parent), ui(new Ui::HuggleWeb)
 {
     this->ui->setupUi(this);
+    connect(this->ui->webView, SIGNAL(loadFinished(bool)), this, SIGNAL(LoadFinished(bool)));
 }
 
 HuggleWeb::~HuggleWeb()
@@ -0,0 +1,371 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QString>
+#include <QtTest>
+#include <QtXml>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryFile>
+#include <huggle_core/apiqueryresult.hpp>
+#include <huggle_core/collectable.hpp>
+#include <huggle_core/configuration.hpp>
+#include <huggle_core/diffengine.hpp>
+#include <huggle_core/gc.hpp>
+#include <huggle_core/huggleparser.hpp>
+#include <huggle_core/hugglefeedproviderirc.hpp>
+#include <huggle_core/hugglefeedproviderxml.hpp>
+#include <huggle_core/hugglequeuefilter.hpp>
+#include <huggle_core/projectconfiguration.hpp>
+#include <huggle_core/projectconfigurationsnapshot.hpp>
+#include <huggle_core/scoretext.hpp>
+#include <huggle_core/version.hpp>
+#include <huggle_core/wikiedit.hpp>
+#include <huggle_core/wikipage.hpp>
+#include <huggle_core/wikisite.hpp>
+#include <huggle_core/wikiuser.hpp>
+
+// Number of users in the list of problematic users when looking them up
+#define BENCHMARK_USERS     10000
+// Number of collectables that are created for every run of garbage collector
+#define BENCHMARK_GC_ITEMS  1000
+
+static QString readFixture(QString name)
+{
+    QFile file(":/benchmark/" + name);
+    if (!file.open(QIODevice::ReadOnly))
+        qFatal("Unable to open fixture %s", name.toUtf8().constData());
+    QString text = QString::fromUtf8(file.readAll());
+    file.close();
+    return text;
+}
+
+static void releaseEdit(Huggle::WikiEdit *edit)
+{
+    edit->DecRef();
+    edit->SafeDelete();
+}
+
+class BenchmarkCollectable : public Huggle::Collectable
+{
+};
+
+//! Benchmarks of code that runs for every edit that comes from the feed
+
+//! Run tst_benchmark --json results.json to get the results in a file that can be compared between commits
+class HuggleBenchmark : public QObject
+{
+    Q_OBJECT
+
+    public:
+        HuggleBenchmark();
+        ~HuggleBenchmark();
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void benchmarkProcessWords();
+        void benchmarkScoreWordsToLower();
+        void benchmarkScoreWordsScoreText();
+        void benchmarkApiQueryResultProcess();
+        void benchmarkIrcDecode();
+        void benchmarkXmlRcsDecode();
+        void benchmarkTalkPageLevel();
+        void benchmarkQueueFilter();
+        void benchmarkGCDeleteOld();
+        //! Measures cost of consumer changes that every edit goes through on its way to queue
+        void benchmarkCollectableConsumers();
+        void benchmarkRetrieveUser();
+
+    private:
+        Huggle::WikiSite *site;
+        QList<Huggle::WikiEdit*> feedEdits;
+        //! Diff of two recorded revisions, rendered the same way as mediawiki does it
+        QString diff;
+};
+
+HuggleBenchmark::HuggleBenchmark()
+{
+    Huggle::Configuration::HuggleConfiguration = new Huggle::Configuration();
+    this->site = new Huggle::WikiSite("en", "en.wikipedia");
+    this->site->XmlRcsName = "en.wikipedia.org";
+    Huggle::Configuration::HuggleConfiguration->Project = this->site;
+    Huggle::Configuration::HuggleConfiguration->ProjectConfig = new Huggle::ProjectConfiguration("enwiki");
+    this->site->ProjectConfig = Huggle::Configuration::HuggleConfiguration->ProjectConfig;
+    Huggle::Configuration::HuggleConfiguration->SystemConfig_WordSeparators << " " << "." << "," << "(" << ")" << ":" << ";" << "!"
+                                                                              << "?" << "/" << "<" << ">" << "[" << "]";
+    Huggle::GC::gc = new Huggle::GC();
+    // collection needs to run only in this thread, otherwise benchmarks would be measuring a race with it
+    Huggle::GC::gc->Stop();
+}
+
+HuggleBenchmark::~HuggleBenchmark()
+{
+    delete Huggle::GC::gc;
+    Huggle::GC::gc = nullptr;
+    delete Huggle::Configuration::HuggleConfiguration;
+}
+
+void HuggleBenchmark::initTestCase()
+{
+    this->site->ProjectConfig->Parse(readFixture("config.txt"), nullptr, this->site);
+    this->site->PublishSnapshot();
+    // edits for the queue filter are decoded only once
+    foreach (QString line, readFixture("irc.txt").split("\n", QString::SkipEmptyParts))
+    {
+        Huggle::WikiEdit *edit = Huggle::HuggleFeedProviderIRC::DecodeLine(line, this->site);
+        if (edit != nullptr)
+            this->feedEdits.append(edit);
+    }
+    QVERIFY2(this->feedEdits.count() > 0, "No edits were decoded from irc fixture");
+    this->diff = Huggle::DiffEngine::Diff(readFixture("page02.txt"), readFixture("page04.txt") + "\nyou all suck lol poop");
+}
+
+void HuggleBenchmark::cleanupTestCase()
+{
+    foreach (Huggle::WikiEdit *edit, this->feedEdits)
+        releaseEdit(edit);
+    this->feedEdits.clear();
+}
+
+void HuggleBenchmark::benchmarkProcessWords()
+{
+    Huggle::WikiEdit *edit = new Huggle::WikiEdit();
+    edit->Page = new Huggle::WikiPage("Intellectual property", this->site);
+    edit->User = new Huggle::WikiUser("203.0.113.45", this->site);
+    edit->DiffText = this->diff;
+    QBENCHMARK
+    {
+        edit->Score = 0;
+        edit->ScoreWords.clear();
+        edit->ProcessWords();
+    }
+    QVERIFY(edit->Score != 0);
+    delete edit;
+}
+
+void HuggleBenchmark::benchmarkScoreWordsToLower()
+{
+    // words used to be matched against the whole diff like this, it's kept to compare it with ScoreText
+    std::shared_ptr<const Huggle::ProjectConfigurationSnapshot> conf = this->site->GetSnapshot();
+    QStringList matched;
+    QBENCHMARK
+    {
+        matched.clear();
+        QString text = this->diff.toLower();
+        conf->MatchWords(text, conf->ScoreWords, &matched);
+        conf->MatchParts(text, conf->ScoreParts, &matched);
+    }
+    QVERIFY(!matched.isEmpty());
+}
+
+void HuggleBenchmark::benchmarkScoreWordsScoreText()
+{
+    std::shared_ptr<const Huggle::ProjectConfigurationSnapshot> conf = this->site->GetSnapshot();
+    QStringList matched;
+    QBENCHMARK
+    {
+        matched.clear();
+        Huggle::ScoreText text(this->diff, conf->GetSeparators(), true);
+        conf->MatchWords(text, conf->ScoreWords, &matched);
+        conf->MatchParts(text, conf->ScoreParts, &matched);
+    }
+    // the line appended in initTestCase is the only one that is certainly added, so its words must be found
+    QVERIFY2(matched.contains("suck") && matched.contains("poop"), "Words of added line were not found in diff");
+}
+
+void HuggleBenchmark::benchmarkApiQueryResultProcess()
+{
+    QString data = readFixture("apiresult.xml");
+    QBENCHMARK
+    {
+        Huggle::ApiQueryResult result;
+        result.Data = data;
+        result.Process();
+    }
+}
+
+void HuggleBenchmark::benchmarkIrcDecode()
+{
+    QStringList lines = readFixture("irc.txt").split("\n", QString::SkipEmptyParts);
+    QBENCHMARK
+    {
+        foreach (QString line, lines)
+        {
+            Huggle::WikiEdit *edit = Huggle::HuggleFeedProviderIRC::DecodeLine(line, this->site);
+            if (edit != nullptr)
+                releaseEdit(edit);
+        }
+    }
+}
+
+void HuggleBenchmark::benchmarkXmlRcsDecode()
+{
+    QStringList lines = readFixture("xmlrcs.txt").split("\n", QString::SkipEmptyParts);
+    QBENCHMARK
+    {
+        foreach (QString line, lines)
+        {
+            QDomDocument input;
+            input.setContent(line);
+            bool valid;
+            Huggle::WikiEdit *edit = Huggle::HuggleFeedProviderXml::DecodeEdit(input.firstChild().toElement(), this->site, &valid);
+            if (edit != nullptr)
+                releaseEdit(edit);
+        }
+    }
+}
+
+void HuggleBenchmark::benchmarkTalkPageLevel()
+{
+    QString text = readFixture("tp0015.txt");
+    QBENCHMARK
+    {
+        Huggle::HuggleParser::GetLevel(text, QDate(2014, 5, 16), this->site);
+    }
+}
+
+void HuggleBenchmark::benchmarkQueueFilter()
+{
+    Huggle::HuggleQueueFilter filter;
+    QBENCHMARK
+    {
+        foreach (Huggle::WikiEdit *edit, this->feedEdits)
+            filter.Matches(edit);
+    }
+}
+
+void HuggleBenchmark::benchmarkGCDeleteOld()
+{
+    QBENCHMARK
+    {
+        int item = 0;
+        while (item++ < BENCHMARK_GC_ITEMS)
+        {
+            BenchmarkCollectable *collectable = new BenchmarkCollectable();
+            collectable->RegisterConsumer(HUGGLECONSUMER_CORE);
+            collectable->UnregisterConsumer(HUGGLECONSUMER_CORE);
+        }
+        Huggle::GC::gc->DeleteOld();
+    }
+}
+
+void HuggleBenchmark::benchmarkCollectableConsumers()
+{
+    BenchmarkCollectable *item = new BenchmarkCollectable();
+    // every iteration ends with no consumers, so next one reclaims the object
+    item->SetReclaimable();
+    QBENCHMARK
+    {
+        item->RegisterConsumer(HUGGLECONSUMER_MAINPEND);
+        item->RegisterConsumer(HUGGLECONSUMER_QP_UNCHECKED);
+        item->UnregisterConsumer(HUGGLECONSUMER_MAINPEND);
+        item->RegisterConsumer(HUGGLECONSUMER_CORE_POSTPROCESS);
+        item->UnregisterConsumer(HUGGLECONSUMER_QP_UNCHECKED);
+        item->RegisterConsumer(HUGGLECONSUMER_PROCESSOR);
+        item->UnregisterConsumer(HUGGLECONSUMER_CORE_POSTPROCESS);
+        item->RegisterConsumer(HUGGLECONSUMER_QUEUE);
+        item->UnregisterConsumer(HUGGLECONSUMER_PROCESSOR);
+        item->HasSomeConsumers();
+        item->UnregisterConsumer(HUGGLECONSUMER_QUEUE);
+    }
+    QVERIFY(item->SafeDelete());
+}
+
+void HuggleBenchmark::benchmarkRetrieveUser()
+{
+    int user = 0;
+    while (user < BENCHMARK_USERS)
+        Huggle::WikiUser::ProblematicUsers.append(new Huggle::WikiUser("User " + QString::number(user++), this->site));
+    QString last = "User " + QString::number(BENCHMARK_USERS - 1);
+    QBENCHMARK
+    {
+        Huggle::WikiUser::RetrieveUser(last, this->site);
+        Huggle::WikiUser::RetrieveUser("Unknown user", this->site);
+    }
+    QVERIFY(Huggle::WikiUser::RetrieveUser(last, this->site) != nullptr);
+    qDeleteAll(Huggle::WikiUser::ProblematicUsers);
+    Huggle::WikiUser::ProblematicUsers.clear();
+}
+
+//! Convert the xml log of QTest to json with one object per benchmark
+static bool writeJson(QString xml_path, QString json_path)
+{
+    QFile xml(xml_path);
+    if (!xml.open(QIODevice::ReadOnly))
+        return false;
+    QDomDocument document;
+    document.setContent(&xml);
+    xml.close();
+    QJsonArray results;
+    QDomNodeList functions = document.elementsByTagName("TestFunction");
+    int index = 0;
+    while (index < functions.count())
+    {
+        QDomElement function = functions.at(index++).toElement();
+        QDomNodeList benchmarks = function.elementsByTagName("BenchmarkResult");
+        int result = 0;
+        while (result < benchmarks.count())
+        {
+            QDomElement benchmark = benchmarks.at(result++).toElement();
+            QJsonObject item;
+            item.insert("name", function.attribute("name"));
+            item.insert("tag", benchmark.attribute("tag"));
+            item.insert("metric", benchmark.attribute("metric"));
+            item.insert("value", benchmark.attribute("value").toDouble());
+            item.insert("iterations", benchmark.attribute("iterations").toInt());
+            results.append(item);
+        }
+    }
+    QJsonObject root;
+    root.insert("version", QString(HUGGLE_VERSION));
+    root.insert("qt", QString(qVersion()));
+    root.insert("time", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert("benchmarks", results);
+    QFile json(json_path);
+    if (!json.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    json.write(QJsonDocument(root).toJson());
+    json.close();
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QStringList arguments = application.arguments();
+    QString json_path;
+    int json = arguments.indexOf("--json");
+    if (json > 0 && json + 1 < arguments.count())
+    {
+        json_path = arguments.at(json + 1);
+        arguments.removeAt(json + 1);
+        arguments.removeAt(json);
+    }
+    HuggleBenchmark benchmark;
+    if (json_path.isEmpty())
+        return QTest::qExec(&benchmark, arguments);
+    // QTest has no json logger, so we let it write xml which is converted afterwards
+    QTemporaryFile xml;
+    if (!xml.open())
+        return 1;
+    xml.close();
+    arguments << "-o" << xml.fileName() + ",xml" << "-o" << "-,txt";
+    int result = QTest::qExec(&benchmark, arguments);
+    if (!writeJson(xml.fileName(), json_path))
+    {
+        qWarning("Unable to write %s", json_path.toUtf8().constData());
+        return 1;
+    }
+    return result;
+}
+
+#include "tst_benchmark.moc"
@@ -0,0 +1,283 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "feedgenerator.hpp"
+#include <QDateTime>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+using namespace Huggle;
+
+// How often the timer checks if some edits should be sent, in milliseconds
+#define FEED_TICK 10
+
+static double randomRoll()
+{
+    return static_cast<double>(qrand()) / RAND_MAX;
+}
+
+//! Random index in range 0 - count, lower numbers are much more likely than higher
+static int randomSkewed(int count)
+{
+    double roll = randomRoll();
+    return qMin(count - 1, static_cast<int>(roll * roll * roll * count));
+}
+
+static const QStringList summaries = QStringList() << "" << "" << "typo" << "/* History */ expanded" << "Undid revision by vandal"
+                                                   << "ref" << "/* External links */ " << "added image" << "lol" << "fix";
+
+FeedGenerator::FeedGenerator(Protocol protocol, QObject *parent) : QObject(parent)
+{
+    this->protocol = protocol;
+    this->server = new QTcpServer(this);
+    this->timer = new QTimer(this);
+    connect(this->server, SIGNAL(newConnection()), this, SLOT(OnConnection()));
+    connect(this->timer, SIGNAL(timeout()), this, SLOT(OnTick()));
+}
+
+FeedGenerator::~FeedGenerator()
+{
+    delete this->timer;
+    delete this->server;
+}
+
+bool FeedGenerator::Listen(quint16 port)
+{
+    if (!this->server->listen(QHostAddress::LocalHost, port))
+        return false;
+    this->timer->start(FEED_TICK);
+    return true;
+}
+
+quint16 FeedGenerator::GetPort()
+{
+    return this->server->serverPort();
+}
+
+void FeedGenerator::SetRate(double edits_per_second)
+{
+    // restart the clock so that the new rate applies from now on and doesn't catch up with the old one
+    this->rate = edits_per_second;
+    this->generated = 0;
+    if (this->clock.isValid())
+        this->clock.restart();
+}
+
+QString FeedGenerator::GetStatistics()
+{
+    return "subscribers: " + QString::number(this->subscribers.count()) + " edits: " + QString::number(this->EditsSent) +
+           " sent: " + QString::number(this->BytesSent / 1024) + "kB";
+}
+
+void FeedGenerator::OnConnection()
+{
+    while (this->server->hasPendingConnections())
+    {
+        QTcpSocket *socket = this->server->nextPendingConnection();
+        this->buffers.insert(socket, QByteArray());
+        connect(socket, SIGNAL(readyRead()), this, SLOT(OnReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(OnDisconnected()));
+        if (this->protocol == ProtocolIRC)
+            this->send(socket, ":mock.irc NOTICE * :*** Looking up your hostname\r\n");
+    }
+}
+
+void FeedGenerator::OnReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(QObject::sender());
+    if (socket == nullptr)
+        return;
+    QByteArray buffer = this->buffers.value(socket) + socket->readAll();
+    int end;
+    while ((end = buffer.indexOf('\n')) >= 0)
+    {
+        QString line = QString::fromUtf8(buffer.left(end)).trimmed();
+        buffer.remove(0, end + 1);
+        if (!line.isEmpty())
+            this->processLine(socket, line);
+    }
+    // client may have disconnected while its commands were processed
+    if (this->buffers.contains(socket))
+        this->buffers.insert(socket, buffer);
+}
+
+void FeedGenerator::OnDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(QObject::sender());
+    if (socket == nullptr)
+        return;
+    this->subscribers.removeAll(socket);
+    this->buffers.remove(socket);
+    this->nicks.remove(socket);
+    socket->deleteLater();
+}
+
+void FeedGenerator::OnTick()
+{
+    if (this->subscribers.isEmpty())
+        return;
+    if (!this->clock.isValid())
+    {
+        this->clock.start();
+        this->generated = 0;
+    }
+    qint64 due = static_cast<qint64>(this->clock.elapsed() * this->rate / 1000);
+    while (this->generated < due)
+    {
+        int size_change;
+        bool new_page;
+        MockRevision revision = this->generateEdit(&size_change, &new_page);
+        emit EditGenerated(revision);
+        QByteArray data;
+        if (this->protocol == ProtocolXmlRcs)
+            data = this->formatXmlRcs(revision, size_change, new_page);
+        else
+            data = this->formatIRC(revision, size_change, new_page);
+        foreach (QTcpSocket *socket, this->subscribers)
+            this->send(socket, data);
+        this->generated++;
+        this->EditsSent++;
+    }
+}
+
+MockRevision FeedGenerator::generateEdit(int *size_change, bool *new_page)
+{
+    MockRevision revision;
+    int page = randomSkewed(this->Pages);
+    int user = randomSkewed(this->Users);
+    double ns_roll = randomRoll();
+    if (ns_roll < 0.1)
+    {
+        revision.NS = 3;
+        revision.Title = "User talk:Mock user " + QString::number(randomSkewed(this->Users));
+    } else if (ns_roll < 0.15)
+    {
+        revision.NS = 1;
+        revision.Title = "Talk:Mock page " + QString::number(page);
+    } else
+    {
+        revision.Title = "Mock page " + QString::number(page);
+    }
+    if (randomRoll() < this->AnonymousRatio)
+        revision.User = "10." + QString::number(user / 65536) + "." + QString::number((user / 256) % 256) + "." + QString::number(user % 256);
+    else
+        revision.User = "Mock user " + QString::number(user);
+    *new_page = !this->pages.contains(revision.Title) && randomRoll() < this->NewPageRatio;
+    *size_change = (qrand() % 1000) - 500;
+    revision.RevID = ++this->lastRevID;
+    revision.Time = QDateTime::currentDateTimeUtc();
+    revision.Summary = summaries.at(qrand() % summaries.count());
+    if (*new_page)
+    {
+        revision.ParentID = 0;
+        *size_change = qAbs(*size_change) + 100;
+        revision.Size = *size_change;
+    } else
+    {
+        // page that exists on a mock wiki was edited before, even if the feed didn't announce it
+        MockRevision previous = this->pages.value(revision.Title);
+        revision.ParentID = previous.RevID ? previous.RevID : revision.RevID - 1000000;
+        revision.PageID = previous.PageID;
+        revision.Size = qMax(0, (previous.RevID ? previous.Size : 5000) + *size_change);
+    }
+    if (!revision.PageID)
+        revision.PageID = qHash(revision.Title) % 50000000;
+    this->pages.insert(revision.Title, revision);
+    return revision;
+}
+
+QByteArray FeedGenerator::formatXmlRcs(const MockRevision &revision, int size_change, bool new_page)
+{
+    QString line = "<edit wiki=\"" + this->Wiki + "\" server_name=\"" + this->ServerName + "\" revid=\"" + QString::number(revision.RevID) +
+                   "\" oldid=\"" + QString::number(revision.ParentID) + "\" summary=\"" + revision.Summary.toHtmlEscaped() +
+                   "\" title=\"" + revision.Title.toHtmlEscaped() + "\" namespace=\"" + QString::number(revision.NS) +
+                   "\" user=\"" + revision.User.toHtmlEscaped() + "\" bot=\"False\" patrolled=\"False\" minor=\"False\" type=\"" +
+                   QString(new_page ? "new" : "edit") + "\" length_new=\"" + QString::number(revision.Size) + "\" length_old=\"" +
+                   QString::number(revision.Size - size_change) + "\" timestamp=\"" +
+                   QString::number(revision.Time.toMSecsSinceEpoch() / 1000) + "\"></edit>\n";
+    return line.toUtf8();
+}
+
+QByteArray FeedGenerator::formatIRC(const MockRevision &revision, int size_change, bool new_page)
+{
+    QString c = QString(QChar(003));
+    QString url = "https://" + this->ServerName + "/w/index.php?";
+    if (new_page)
+        url += "oldid=" + QString::number(revision.RevID);
+    else
+        url += "diff=" + QString::number(revision.RevID) + "&oldid=" + QString::number(revision.ParentID);
+    QString size = (size_change >= 0 ? "+" : "") + QString::number(size_change);
+    QString line = c + "14[[" + c + "07" + revision.Title + c + "14]]" + c + "4 " + QString(new_page ? "N" : "") + c + "10 " + c + "02" +
+                   url + c + " " + c + "5*" + c + " " + c + "03" + revision.User + c + " " + c + "5*" + c + " (" + size + ") " +
+                   c + "10" + revision.Summary + c;
+    return QString(":rc!~rc@mock.irc PRIVMSG " + this->Channel + " :" + line + "\r\n").toUtf8();
+}
+
+void FeedGenerator::processLine(QTcpSocket *socket, QString line)
+{
+    if (this->protocol == ProtocolXmlRcs)
+    {
+        if (line == "ping")
+        {
+            this->send(socket, "<pong></pong>\n");
+        } else if (line.startsWith("S "))
+        {
+            if (line.mid(2).trimmed() != this->ServerName)
+            {
+                this->send(socket, "<error>Unknown wiki</error>\n");
+                return;
+            }
+            if (!this->subscribers.contains(socket))
+                this->subscribers.append(socket);
+            this->send(socket, "<ok></ok>\n");
+        } else if (line.startsWith("D "))
+        {
+            this->subscribers.removeAll(socket);
+            this->send(socket, "<ok></ok>\n");
+        } else if (line != "pong")
+        {
+            this->send(socket, "<error>Unknown command</error>\n");
+        }
+        return;
+    }
+    QString command = line.section(' ', 0, 0).toUpper();
+    if (command == "NICK")
+    {
+        this->nicks.insert(socket, line.section(' ', 1, 1));
+    } else if (command == "USER")
+    {
+        QString nick = this->nicks.value(socket, "huggle");
+        this->send(socket, QString(":mock.irc 001 " + nick + " :Welcome to mock irc\r\n"
+                                   ":mock.irc 376 " + nick + " :End of /MOTD command.\r\n").toUtf8());
+    } else if (command == "PING")
+    {
+        this->send(socket, QString(":mock.irc PONG mock.irc " + line.section(' ', 1) + "\r\n").toUtf8());
+    } else if (command == "JOIN")
+    {
+        QString nick = this->nicks.value(socket, "huggle");
+        this->send(socket, QString(":" + nick + "!huggle@localhost JOIN " + this->Channel + "\r\n"
+                                   ":mock.irc 353 " + nick + " = " + this->Channel + " :" + nick + " rc\r\n"
+                                   ":mock.irc 366 " + nick + " " + this->Channel + " :End of /NAMES list.\r\n").toUtf8());
+        if (!this->subscribers.contains(socket))
+            this->subscribers.append(socket);
+    } else if (command == "QUIT")
+    {
+        this->subscribers.removeAll(socket);
+        socket->disconnectFromHost();
+    }
+}
+
+void FeedGenerator::send(QTcpSocket *socket, const QByteArray &data)
+{
+    this->BytesSent += data.size();
+    socket->write(data);
+}
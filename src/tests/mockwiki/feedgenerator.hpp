@@ -0,0 +1,92 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef FEEDGENERATOR_HPP
+#define FEEDGENERATOR_HPP
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include "mockwikiserver.hpp"
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+
+namespace Huggle
+{
+    //! Server which pretends to be XmlRcs or wikimedia irc and sends generated edits at given rate
+
+    //! Every connected client which subscribed to the feed receives same edits. Pages and users are
+    //! picked from fixed pools, some of them much more often than others, so that huggle has to deal
+    //! with repeated edits to same page and by same user the same way it does on a real wiki.
+    class FeedGenerator : public QObject
+    {
+            Q_OBJECT
+        public:
+            enum Protocol
+            {
+                ProtocolXmlRcs,
+                ProtocolIRC
+            };
+
+            FeedGenerator(Protocol protocol, QObject *parent = nullptr);
+            ~FeedGenerator();
+            bool Listen(quint16 port);
+            quint16 GetPort();
+            //! Change number of edits that are sent every second
+            void SetRate(double edits_per_second);
+            QString GetStatistics();
+            //! Name of wiki in XmlRcs and host name in urls of irc feed
+            QString ServerName = "en.wikipedia.org";
+            QString Wiki = "enwiki";
+            QString Channel = "#en.wikipedia";
+            //! Probability (0 - 1) that edit is made by anonymous user
+            double AnonymousRatio = 0.3;
+            //! Probability (0 - 1) that edit creates a new page
+            double NewPageRatio = 0.05;
+            int Pages = 5000;
+            int Users = 2000;
+            qint64 EditsSent = 0;
+            qint64 BytesSent = 0;
+        signals:
+            //! Emitted for every edit before it's sent, so that mock api knows about it
+            void EditGenerated(const Huggle::MockRevision &revision);
+        private slots:
+            void OnConnection();
+            void OnReadyRead();
+            void OnDisconnected();
+            void OnTick();
+        private:
+            MockRevision generateEdit(int *size_change, bool *new_page);
+            QByteArray formatXmlRcs(const MockRevision &revision, int size_change, bool new_page);
+            QByteArray formatIRC(const MockRevision &revision, int size_change, bool new_page);
+            void processLine(QTcpSocket *socket, QString line);
+            void send(QTcpSocket *socket, const QByteArray &data);
+            Protocol protocol;
+            QTcpServer *server;
+            QTimer *timer;
+            //! Clients which receive the edits
+            QList<QTcpSocket*> subscribers;
+            QHash<QTcpSocket*, QByteArray> buffers;
+            QHash<QTcpSocket*, QString> nicks;
+            //! Measures time since first client subscribed, edits are generated only when someone listens
+            QElapsedTimer clock;
+            qint64 generated = 0;
+            double rate = 10;
+            qint64 lastRevID = 800000000;
+            QHash<QString, MockRevision> pages;
+    };
+}
+
+#endif // FEEDGENERATOR_HPP
@@ -0,0 +1,99 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+// Mock of mediawiki api and of recent changes feed, which is used to measure how huggle
+// performs under load without a live wiki and without network access. Point huggle to
+// http://127.0.0.1:<api-port>/w/ with ssl disabled and to the feed on 127.0.0.1:<feed-port>.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QTime>
+#include <QTimer>
+#include "feedgenerator.hpp"
+#include "mockwikiserver.hpp"
+
+using namespace Huggle;
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    application.setApplicationName("huggle_mockwiki");
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Mock mediawiki api and recent changes feed for testing of huggle");
+    parser.addHelpOption();
+    QCommandLineOption api_port("api-port", "Port of mock api", "port", "8080");
+    QCommandLineOption feed("feed", "Type of feed, xmlrcs or irc", "type", "xmlrcs");
+    QCommandLineOption feed_port("feed-port", "Port of feed (default 8822 for xmlrcs, 6667 for irc)", "port");
+    QCommandLineOption rate("rate", "Edits per second sent by feed", "edits", "10");
+    QCommandLineOption latency("latency", "Delay of every api response", "ms", "0");
+    QCommandLineOption jitter("jitter", "Random delay added to latency", "ms", "0");
+    QCommandLineOption http_errors("http-errors", "Percentage of api requests that fail with http 503", "percent", "0");
+    QCommandLineOption api_errors("api-errors", "Percentage of api requests that return maxlag error", "percent", "0");
+    QCommandLineOption responses("responses", "Folder with recorded responses that replace built-in ones", "path");
+    QCommandLineOption pages("pages", "Number of distinct pages that are edited", "count", "5000");
+    QCommandLineOption users("users", "Number of distinct users who edit", "count", "2000");
+    QCommandLineOption anonymous("anonymous", "Percentage of edits made by anonymous users", "percent", "30");
+    QCommandLineOption statistics("statistics", "Print statistics every n seconds, 0 disables it", "seconds", "10");
+    parser.addOptions(QList<QCommandLineOption>() << api_port << feed << feed_port << rate << latency << jitter << http_errors
+                                                  << api_errors << responses << pages << users << anonymous << statistics);
+    parser.process(application);
+    qsrand(QTime::currentTime().msec());
+    QTextStream out(stdout);
+
+    MockWikiServer api;
+    api.Latency = parser.value(latency).toInt();
+    api.Jitter = parser.value(jitter).toInt();
+    api.HttpErrorRate = parser.value(http_errors).toDouble() / 100;
+    api.ApiErrorRate = parser.value(api_errors).toDouble() / 100;
+    if (parser.isSet(responses))
+        out << "Loaded " << api.LoadResponses(parser.value(responses)) << " recorded responses" << endl;
+    if (!api.Listen(static_cast<quint16>(parser.value(api_port).toUInt())))
+    {
+        out << "Unable to listen on port " << parser.value(api_port) << endl;
+        return 1;
+    }
+
+    FeedGenerator::Protocol protocol = FeedGenerator::ProtocolXmlRcs;
+    quint16 default_port = 8822;
+    if (parser.value(feed) == "irc")
+    {
+        protocol = FeedGenerator::ProtocolIRC;
+        default_port = 6667;
+    } else if (parser.value(feed) != "xmlrcs")
+    {
+        out << "Unknown feed type: " << parser.value(feed) << endl;
+        return 1;
+    }
+    FeedGenerator generator(protocol);
+    generator.SetRate(parser.value(rate).toDouble());
+    generator.Pages = qMax(1, parser.value(pages).toInt());
+    generator.Users = qMax(1, parser.value(users).toInt());
+    generator.AnonymousRatio = parser.value(anonymous).toDouble() / 100;
+    QObject::connect(&generator, &FeedGenerator::EditGenerated, &api, &MockWikiServer::RegisterRevision);
+    quint16 port = parser.isSet(feed_port) ? static_cast<quint16>(parser.value(feed_port).toUInt()) : default_port;
+    if (!generator.Listen(port))
+    {
+        out << "Unable to listen on port " << port << endl;
+        return 1;
+    }
+    out << "Api listening on http://127.0.0.1:" << api.GetPort() << "/w/api.php" << endl;
+    out << parser.value(feed) << " feed listening on 127.0.0.1:" << generator.GetPort() << " sending " << parser.value(rate)
+        << " edits per second" << endl;
+
+    QTimer printer;
+    QObject::connect(&printer, &QTimer::timeout, [&]()
+    {
+        out << "feed " << generator.GetStatistics() << endl << "api " << api.GetStatistics() << endl;
+    });
+    if (parser.value(statistics).toInt() > 0)
+        printer.start(parser.value(statistics).toInt() * 1000);
+    return application.exec();
+}
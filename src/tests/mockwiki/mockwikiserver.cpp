@@ -0,0 +1,339 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "mockwikiserver.hpp"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QPair>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+
+using namespace Huggle;
+
+static double randomRoll()
+{
+    return static_cast<double>(qrand()) / RAND_MAX;
+}
+
+MockWikiServer::MockWikiServer(QObject *parent) : QObject(parent)
+{
+    this->server = new QTcpServer(this);
+    connect(this->server, SIGNAL(newConnection()), this, SLOT(OnConnection()));
+    this->LoadResponses(":/mockwiki/responses");
+}
+
+MockWikiServer::~MockWikiServer()
+{
+    delete this->server;
+}
+
+bool MockWikiServer::Listen(quint16 port)
+{
+    return this->server->listen(QHostAddress::LocalHost, port);
+}
+
+quint16 MockWikiServer::GetPort()
+{
+    return this->server->serverPort();
+}
+
+int MockWikiServer::LoadResponses(QString path)
+{
+    QDir directory(path);
+    int loaded = 0;
+    foreach (QString name, directory.entryList(QStringList("*.xml"), QDir::Files))
+    {
+        QFile file(directory.filePath(name));
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            qWarning("Unable to read %s", file.fileName().toUtf8().constData());
+            continue;
+        }
+        this->responses.insert(name.left(name.length() - 4), QString::fromUtf8(file.readAll()).trimmed());
+        file.close();
+        loaded++;
+    }
+    return loaded;
+}
+
+void MockWikiServer::RegisterRevision(const MockRevision &revision)
+{
+    if (this->revisions.contains(revision.RevID))
+        return;
+    this->revisions.insert(revision.RevID, revision);
+    this->revisionOrder.append(revision.RevID);
+    this->latest.insert(revision.Title, revision.RevID);
+    if (revision.RevID > this->lastRevID)
+        this->lastRevID = revision.RevID;
+    while (this->revisionOrder.count() > this->RevisionLimit)
+    {
+        qint64 oldest = this->revisionOrder.takeFirst();
+        QString title = this->revisions.value(oldest).Title;
+        if (this->latest.value(title) == oldest)
+            this->latest.remove(title);
+        this->revisions.remove(oldest);
+    }
+}
+
+QString MockWikiServer::GetStatistics()
+{
+    QString result = "requests: " + QString::number(this->TotalRequests) + " errors: " + QString::number(this->Errors) +
+                     " sent: " + QString::number(this->BytesSent / 1024) + "kB";
+    QStringList names = this->Requests.keys();
+    names.sort();
+    foreach (QString name, names)
+        result += "\n  " + name + ": " + QString::number(this->Requests[name]);
+    return result;
+}
+
+void MockWikiServer::OnConnection()
+{
+    while (this->server->hasPendingConnections())
+    {
+        QTcpSocket *socket = this->server->nextPendingConnection();
+        this->buffers.insert(socket, QByteArray());
+        connect(socket, SIGNAL(readyRead()), this, SLOT(OnReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(OnDisconnected()));
+    }
+}
+
+void MockWikiServer::OnReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(QObject::sender());
+    if (socket == nullptr)
+        return;
+    QByteArray &buffer = this->buffers[socket];
+    buffer += socket->readAll();
+    // one read may contain more requests or just a part of one
+    while (true)
+    {
+        int header_end = buffer.indexOf("\r\n\r\n");
+        if (header_end < 0)
+            return;
+        QList<QByteArray> lines = buffer.left(header_end).split('\n');
+        QList<QByteArray> request_line = lines.at(0).trimmed().split(' ');
+        int content_length = 0;
+        bool keep_alive = !request_line.last().endsWith("1.0");
+        int line = 1;
+        while (line < lines.count())
+        {
+            QByteArray header = lines.at(line++).trimmed();
+            int separator = header.indexOf(':');
+            if (separator < 0)
+                continue;
+            QByteArray name = header.left(separator).trimmed().toLower();
+            QByteArray value = header.mid(separator + 1).trimmed();
+            if (name == "content-length")
+                content_length = value.toInt();
+            else if (name == "connection")
+                keep_alive = value.toLower() != "close";
+        }
+        if (buffer.size() < header_end + 4 + content_length)
+            return;
+        QByteArray body = buffer.mid(header_end + 4, content_length);
+        buffer.remove(0, header_end + 4 + content_length);
+        if (request_line.count() < 3)
+        {
+            this->reply(socket, 400, "Bad request", false);
+            return;
+        }
+        QUrl url(QString::fromUtf8(request_line.at(1)));
+        QUrlQuery parameters(url.query(QUrl::FullyEncoded));
+        // post data are form encoded, where spaces are sent as +
+        body.replace('+', "%20");
+        QUrlQuery post(QString::fromUtf8(body));
+        QList<QPair<QString, QString> > items = post.queryItems(QUrl::FullyEncoded);
+        int item = 0;
+        while (item < items.count())
+        {
+            parameters.addQueryItem(items.at(item).first, items.at(item).second);
+            item++;
+        }
+        int status = 200;
+        QByteArray response = this->getResponse(parameters, &status);
+        int delay = this->Latency;
+        if (this->Jitter > 0)
+            delay += qrand() % this->Jitter;
+        if (delay <= 0)
+        {
+            this->reply(socket, status, response, keep_alive);
+            if (!keep_alive)
+                return;
+            continue;
+        }
+        QPointer<QTcpSocket> target(socket);
+        QTimer *timer = new QTimer(this);
+        timer->setSingleShot(true);
+        connect(timer, &QTimer::timeout, [this, timer, target, status, response, keep_alive]()
+        {
+            if (!target.isNull())
+                this->reply(target.data(), status, response, keep_alive);
+            timer->deleteLater();
+        });
+        timer->start(delay);
+    }
+}
+
+void MockWikiServer::OnDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(QObject::sender());
+    if (socket == nullptr)
+        return;
+    this->buffers.remove(socket);
+    socket->deleteLater();
+}
+
+QString MockWikiServer::getResponseName(const QUrlQuery &parameters)
+{
+    QString action = parameters.queryItemValue("action");
+    if (action != "query")
+        return action;
+    QStringList modules;
+    foreach (QString name, QStringList() << "prop" << "list" << "meta")
+        modules += parameters.queryItemValue(name, QUrl::FullyDecoded).split("|", QString::SkipEmptyParts);
+    modules.sort();
+    QString name = "query." + modules.join("+");
+    if (this->responses.contains(name))
+        return name;
+    // if there is no response for this combination of modules, try to answer at least the first one
+    foreach (QString module, modules)
+    {
+        if (this->responses.contains("query." + module))
+            return "query." + module;
+    }
+    return name;
+}
+
+QByteArray MockWikiServer::getResponse(const QUrlQuery &parameters, int *status)
+{
+    QString name = this->getResponseName(parameters);
+    this->TotalRequests++;
+    this->Requests[name]++;
+    *status = 200;
+    if (this->HttpErrorRate > 0 && randomRoll() < this->HttpErrorRate)
+    {
+        this->Errors++;
+        *status = 503;
+        return "<html><body>Service Unavailable</body></html>";
+    }
+    if (this->ApiErrorRate > 0 && randomRoll() < this->ApiErrorRate)
+    {
+        this->Errors++;
+        return "<?xml version=\"1.0\"?><api><error code=\"maxlag\" info=\"Waiting for mock: 5 seconds lagged\" /></api>";
+    }
+    if (!this->responses.contains(name))
+    {
+        this->Errors++;
+        return QString("<?xml version=\"1.0\"?><api><error code=\"unknown_action\" info=\"No recorded response for " +
+                       name.toHtmlEscaped() + "\" /></api>").toUtf8();
+    }
+    MockRevision revision;
+    const MockRevision *known = this->findRevision(parameters);
+    if (known != nullptr)
+    {
+        revision = *known;
+    } else
+    {
+        revision.RevID = ++this->lastRevID;
+        revision.ParentID = revision.RevID - 1;
+        revision.Title = parameters.queryItemValue("titles", QUrl::FullyDecoded).section('|', 0, 0);
+        if (revision.Title.isEmpty())
+            revision.Title = parameters.queryItemValue("title", QUrl::FullyDecoded);
+        if (revision.Title.isEmpty())
+            revision.Title = "Mock page";
+        revision.User = "Mock user";
+        revision.Time = QDateTime::currentDateTimeUtc();
+    }
+    qint64 new_revid = 0;
+    QString action = parameters.queryItemValue("action");
+    if (action == "edit" || action == "rollback")
+    {
+        // changes made by huggle become the latest revision, so that following queries see them
+        MockRevision change = revision;
+        change.ParentID = revision.RevID;
+        change.RevID = new_revid = ++this->lastRevID;
+        change.User = "Mock user";
+        change.Summary = parameters.queryItemValue("summary", QUrl::FullyDecoded);
+        change.Time = QDateTime::currentDateTimeUtc();
+        this->RegisterRevision(change);
+    }
+    QByteArray result = this->expand(this->responses[name], parameters, revision, new_revid).toUtf8();
+    this->BytesSent += result.size();
+    return result;
+}
+
+QString MockWikiServer::expand(QString text, const QUrlQuery &parameters, const MockRevision &revision, qint64 new_revid)
+{
+    QString user = parameters.queryItemValue("ususers", QUrl::FullyDecoded).section('|', 0, 0);
+    if (user.isEmpty())
+        user = revision.User;
+    QHash<QString, QString> values;
+    values.insert("title", revision.Title);
+    values.insert("ns", QString::number(revision.NS));
+    values.insert("pageid", QString::number(revision.PageID ? revision.PageID : qHash(revision.Title) % 50000000));
+    values.insert("revid", QString::number(revision.RevID));
+    values.insert("parentid", QString::number(revision.ParentID));
+    values.insert("newrevid", QString::number(new_revid));
+    values.insert("user", revision.User);
+    values.insert("comment", revision.Summary);
+    values.insert("size", QString::number(revision.Size));
+    values.insert("timestamp", revision.Time.toUTC().toString("yyyy-MM-ddThh:mm:ssZ"));
+    values.insert("sha1", QCryptographicHash::hash(QByteArray::number(revision.RevID), QCryptographicHash::Sha1).toHex());
+    values.insert("content", "Content of revision " + QString::number(revision.RevID) + " of " + revision.Title);
+    values.insert("ususers", user);
+    values.insert("userid", QString::number(qHash(user) % 10000000));
+    // edit count decides if user is new, so let's have some variety in it
+    values.insert("editcount", QString::number(qHash(user) % 3 == 0 ? 0 : qHash(user) % 2000));
+    values.insert("token", QCryptographicHash::hash(QByteArray::number(qrand()), QCryptographicHash::Md5).toHex());
+    QHash<QString, QString>::const_iterator value = values.constBegin();
+    while (value != values.constEnd())
+    {
+        text.replace("{" + value.key() + "}", value.value().toHtmlEscaped());
+        ++value;
+    }
+    return text;
+}
+
+const MockRevision *MockWikiServer::findRevision(const QUrlQuery &parameters)
+{
+    foreach (QString name, QStringList() << "revids" << "rvstartid" << "fromrev" << "revid" << "oldid")
+    {
+        qint64 revid = parameters.queryItemValue(name, QUrl::FullyDecoded).section('|', 0, 0).toLongLong();
+        if (revid > 0 && this->revisions.contains(revid))
+            return &this->revisions[revid];
+    }
+    foreach (QString name, QStringList() << "titles" << "title" << "fromtitle" << "page")
+    {
+        QString title = parameters.queryItemValue(name, QUrl::FullyDecoded).section('|', 0, 0).replace("_", " ");
+        if (!title.isEmpty() && this->latest.contains(title))
+            return &this->revisions[this->latest[title]];
+    }
+    return nullptr;
+}
+
+void MockWikiServer::reply(QTcpSocket *socket, int status, const QByteArray &body, bool keep_alive)
+{
+    QByteArray reason = "OK";
+    if (status == 400)
+        reason = "Bad Request";
+    else if (status == 503)
+        reason = "Service Unavailable";
+    QByteArray header = "HTTP/1.1 " + QByteArray::number(status) + " " + reason + "\r\n"
+                        "Content-Type: text/xml; charset=utf-8\r\n"
+                        "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                        "Connection: " + QByteArray(keep_alive ? "keep-alive" : "close") + "\r\n\r\n";
+    socket->write(header + body);
+    if (!keep_alive)
+        socket->disconnectFromHost();
+}
@@ -0,0 +1,101 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef MOCKWIKISERVER_HPP
+#define MOCKWIKISERVER_HPP
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QUrlQuery>
+
+class QTcpServer;
+class QTcpSocket;
+
+namespace Huggle
+{
+    //! Revision that was announced by feed generator, mock api answers queries about it
+    class MockRevision
+    {
+        public:
+            qint64 RevID = 0;
+            qint64 ParentID = 0;
+            qint64 PageID = 0;
+            int NS = 0;
+            QString Title;
+            QString User;
+            QString Summary;
+            int Size = 0;
+            QDateTime Time;
+    };
+
+    //! Stand-in for api.php of mediawiki which is used to measure huggle without a live wiki
+
+    //! Every request is answered with a recorded response which is picked by action and by the
+    //! modules that were requested (for example query.revisions.xml or query.categories+info.xml),
+    //! placeholders like {title} or {revid} are filled in from parameters of the request and from
+    //! revisions that were announced by feed generator, so that huggle sees consistent data.
+    //! Responses can be delayed and some of them can be turned into errors on purpose.
+    class MockWikiServer : public QObject
+    {
+            Q_OBJECT
+        public:
+            MockWikiServer(QObject *parent = nullptr);
+            ~MockWikiServer();
+            bool Listen(quint16 port);
+            quint16 GetPort();
+            //! Load recorded responses from a folder, these replace the built-in ones with same name
+            int LoadResponses(QString path);
+            void RegisterRevision(const MockRevision &revision);
+            //! Returns number of requests per response name and other counters in a printable form
+            QString GetStatistics();
+            //! Delay of every response in milliseconds
+            int Latency = 0;
+            //! Random delay in milliseconds which is added on top of latency
+            int Jitter = 0;
+            //! Probability (0 - 1) that the request fails with http error
+            double HttpErrorRate = 0;
+            //! Probability (0 - 1) that the request returns api error
+            double ApiErrorRate = 0;
+            //! How many announced revisions are remembered
+            int RevisionLimit = 200000;
+            QHash<QString, qint64> Requests;
+            qint64 TotalRequests = 0;
+            qint64 Errors = 0;
+            qint64 BytesSent = 0;
+        private slots:
+            void OnConnection();
+            void OnReadyRead();
+            void OnDisconnected();
+        private:
+            //! Returns name of recorded response that matches the request
+            QString getResponseName(const QUrlQuery &parameters);
+            QByteArray getResponse(const QUrlQuery &parameters, int *status);
+            QString expand(QString text, const QUrlQuery &parameters, const MockRevision &revision, qint64 new_revid);
+            //! Find the revision that request is about, either by its id or by title of page
+            const MockRevision *findRevision(const QUrlQuery &parameters);
+            void reply(QTcpSocket *socket, int status, const QByteArray &body, bool keep_alive);
+            QTcpServer *server;
+            QHash<QTcpSocket*, QByteArray> buffers;
+            QHash<QString, QString> responses;
+            QHash<qint64, MockRevision> revisions;
+            //! Order in which revisions were announced, used to drop oldest ones
+            QList<qint64> revisionOrder;
+            //! Latest revision of every page
+            QHash<QString, qint64> latest;
+            qint64 lastRevID = 900000000;
+    };
+}
+
+#endif // MOCKWIKISERVER_HPP
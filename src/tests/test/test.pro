@@ -5,7 +5,7 @@
 #-------------------------------------------------
 
 CONFIG += c++11 qt
-QT       += network opengl core gui webkit xml testlib
+QT       += network opengl core gui webkit xml qml testlib
 
 greaterThan(QT_MAJOR_VERSION, 4) {
     QT += widgets webkitwidgets
@@ -12,15 +12,31 @@
 #include <iostream>
 #include <QtTest>
 #include <huggle_core/huggleparser.hpp>
+#include <huggle_core/apiquery.hpp>
+#include <huggle_core/apiquerycache.hpp>
+#include <huggle_core/apiqueryresult.hpp>
+#include <huggle_core/bulkrevert.hpp>
+#include <huggle_core/collectable.hpp>
 #include <huggle_core/configuration.hpp>
+#include <huggle_core/diffengine.hpp>
 #include <huggle_core/generic.hpp>
+#include <huggle_core/historycache.hpp>
+#include <huggle_core/localization.hpp>
+#include <huggle_core/memorypool.hpp>
+#include <huggle_core/patternset.hpp>
+#include <huggle_core/revisiontextcache.hpp>
+#include <huggle_core/scripting/script.hpp>
+#include <huggle_core/scripting/scriptworker.hpp>
+#include <huggle_core/scoretext.hpp>
 #include <huggle_core/wikiedit.hpp>
 #include <huggle_core/wikipage.hpp>
 #include <huggle_core/wikisite.hpp>
 #include <huggle_core/sleeper.hpp>
 #include <huggle_core/terminalparser.hpp>
+#include <huggle_core/trafficcapture.hpp>
 #include <huggle_core/wikiuser.hpp>
 #include <huggle_core/version.hpp>
+#include <huggle_l10n/huggle_l10n.hpp>
 
 static void testTalkPageWarningParser(QString id, QDate date, int level);
 //! This is a unit test
@@ -48,14 +64,41 @@ class HuggleTest : public QObject
         void testCaseTalkPageParser0013() { testTalkPageWarningParser("0013", QDate(2014, 5, 13), 2); }
         void testCaseTalkPageParser0014() { testTalkPageWarningParser("0014", QDate(2014, 5, 13), 4); }
         void testCaseTalkPageParser0015() { testTalkPageWarningParser("0015", QDate(2014, 5, 16), 1); }
+        void testCaseTalkPageLevelCache();
         //! Test if IsIP returns true for users who are IP's
         void testCaseWikiUserCheckIP();
         void testCaseTerminalParser();
         void testCaseConfigurationParse_YAML();
         void testCaseConfigurationParse_QL();
         void testCaseScores();
+        void testCaseScoreText();
         void testCaseVersionComparison();
         void testCaseGenerics();
+        void testCaseDiffEngine();
+        void testCaseApiCacheSubjects();
+        //! Result must not be served from cache once it's older than SystemConfig_ApiCacheTTL
+        void testCaseApiCacheExpiry();
+        //! Identical queries that are running at same time are sent only once and all of them get the result
+        void testCaseApiCacheCoalescing();
+        //! Result must be dropped when huggle edits a page it's about
+        void testCaseApiCacheInvalidation();
+        void testCaseHistoryCache();
+        void testCaseRevisionTextCache();
+        void testCaseCollectableConsumers();
+        //! Bulk revert must pick only the newest edit of every page, rollback reverts the older ones with it
+        void testCaseBulkRevertSelection();
+        void testCasePatternSet();
+        void testCaseSiteInfo();
+        void testCaseTrafficCapture();
+        void testCaseMemoryPool();
+        //! Request that is cancelled while it waits is skipped, cancelling finished request leaves nothing behind
+        void testCaseScriptWorkerCancel();
+        //! Hook that runs too long is ignored and worker is stopped once it happens too often
+        void testCaseScriptWorkerTimeout();
+        //! Score and rejection returned by worker hooks are applied to the edit
+        void testCaseScriptHookJob();
+        //! Loads the compiled localization catalog and reports keys that are missing or untranslated in languages
+        void testCaseLanguages();
 };
 
 HuggleTest::HuggleTest()
@@ -120,6 +163,24 @@ static void testTalkPageWarningParser(QString id, QDate date, int level)
 
 }
 
+void HuggleTest::testCaseTalkPageLevelCache()
+{
+    QFile file(":/test/wikipage/tp0001.txt");
+    file.open(QIODevice::ReadOnly);
+    QString text = QString(file.readAll());
+    file.close();
+    Huggle::WikiSite *site = Huggle::Configuration::HuggleConfiguration->Project;
+    QDate date(2014, 4, 1);
+    Huggle::HuggleParser::ClearLevelCache();
+    QVERIFY2(Huggle::HuggleParser::GetLevel(text, date, site, "Foo", 100) == 3, "Invalid level of talk page");
+    // same revision of talk page is not parsed again
+    QVERIFY2(Huggle::HuggleParser::GetLevel("", date, site, "Foo", 100) == 3, "Level was not remembered");
+    QVERIFY2(Huggle::HuggleParser::GetLevel("", date, site, "Foo", 101) == 0, "Level was remembered for different revision");
+    QVERIFY2(Huggle::HuggleParser::GetLevel("", date, site, "Foo", WIKI_UNKNOWN_REVID) == 0, "Level was remembered for unknown revision");
+    Huggle::HuggleParser::ClearLevelCache();
+    QVERIFY2(Huggle::HuggleParser::GetLevel("", date, site, "Foo", 100) == 0, "Level was not forgotten");
+}
+
 void HuggleTest::testCaseScores()
 {
     Huggle::Configuration::HuggleConfiguration->ProjectConfig->ScoreWords.clear();
@@ -130,6 +191,7 @@ void HuggleTest::testCaseScores()
     Huggle::Configuration::HuggleConfiguration->ProjectConfig->ScoreWords.append(new Huggle::ScoreWord("suck", 60));
     Huggle::Configuration::HuggleConfiguration->ProjectConfig->ScoreWords.append(new Huggle::ScoreWord("ass", 60));
     Huggle::Configuration::HuggleConfiguration->SystemConfig_WordSeparators << " " << "." << "," << "(" << ")" << ":" << ";" << "!" << "?" << "/";
+    Huggle::Configuration::HuggleConfiguration->Project->PublishSnapshot();
     Huggle::GC::gc = new Huggle::GC();
     Huggle::WikiEdit *edit = new Huggle::WikiEdit();
     edit->Page = new Huggle::WikiPage("test", hcfg->Project);
@@ -201,6 +263,13 @@ void HuggleTest::testCaseScores()
     edit->ProcessWords();
     delete vf;
     QVERIFY2(edit->Score == 10, QString("26 Invalid result for score words: " + QString::number(edit->Score)).toUtf8().data());
+    // edits deep in queue keep the diff compressed, it must come back unchanged
+    QString diff = edit->DiffText;
+    edit->PackDiffText();
+    QVERIFY2(edit->IsDiffTextPacked() && edit->DiffText.isEmpty(), "27 Diff text was not packed");
+    QVERIFY2(edit->GetDiffText() == diff, "28 Packed diff text doesn't match the original");
+    edit->UnpackDiffText();
+    QVERIFY2(!edit->IsDiffTextPacked() && edit->DiffText == diff, "29 Unpacked diff text doesn't match the original");
     edit->SafeDelete();
     Huggle::GC::gc->Stop();
     while (Huggle::GC::gc->IsRunning())
@@ -209,6 +278,36 @@ void HuggleTest::testCaseScores()
     Huggle::GC::gc = NULL;
 }
 
+void HuggleTest::testCaseScoreText()
+{
+    QString separators = " .,()!";
+    // long enough to go through the vector kernels, with characters outside of ASCII in between
+    QString plain = QString::fromUtf8("The QUICK brown Fox (jumps) over the LAZY dog, Žluťoučký KŮŇ úpěl ĎÁBELSKÉ ódy! END.");
+    // letter outside of basic plane is stored as surrogate pair
+    uint deseret = 0x10400;
+    plain += " " + QString::fromUcs4(&deseret, 1);
+    Huggle::ScoreText text(plain, separators);
+    QVERIFY2(text.GetText() == plain.toLower(), ("01 Text was not lower cased: " + text.GetText()).toUtf8().data());
+    int position = 0;
+    while (position < text.GetText().length())
+    {
+        QVERIFY2(text.IsSeparator(position) == separators.contains(text.GetText().at(position)), ("02 Wrong separator at " + QString::number(position)).toUtf8().data());
+        position++;
+    }
+    QVERIFY2(text.IsSeparator(-1) && text.IsSeparator(text.GetText().length()), "03 Start and end of text are not separators");
+    QVERIFY2(text.ContainsWord("fox") && text.ContainsWord("jumps") && text.ContainsWord(QString::fromUtf8("žluťoučký")), "04 Word was not found");
+    QVERIFY2(!text.ContainsWord("qui") && !text.ContainsWord("azy"), "05 Part of word was matched as word");
+    // plain text stays as it is even when it's said to be diff
+    Huggle::ScoreText markup("<b>Bold</b> &amp;", separators, true);
+    QVERIFY2(markup.GetText() == "<b>bold</b> &amp;", "06 Markup was removed from text which isn't diff");
+
+    QString diff = Huggle::DiffEngine::Diff("Intro line stays\nThis VANDAL line goes away\nOutro", "Intro line stays\nSome NEW text with A & B and <tag> in it\nOutro");
+    Huggle::ScoreText added(diff, separators, true);
+    QVERIFY2(added.GetText().contains("some new text with a & b and <tag> in it"), ("07 Added line is missing: " + added.GetText()).toUtf8().data());
+    QVERIFY2(!added.GetText().contains("vandal") && !added.GetText().contains("intro") && !added.GetText().contains("outro"), ("08 Text which wasn't added was kept: " + added.GetText()).toUtf8().data());
+    QVERIFY2(!added.GetText().contains("diff-") && !added.GetText().contains("<div>"), "09 Markup of diff was kept");
+    QVERIFY2(added.ContainsWord("new") && !added.ContainsWord("vandal"), "10 Invalid result for words in diff");
+}
 
 void HuggleTest::testCaseWikiUserCheckIP()
 {
@@ -291,6 +390,539 @@ void HuggleTest::testCaseGenerics()
     QVERIFY2(Huggle::Generic::SafeBool("TRUE") == true, "Invalid conversion of string to bool");
 }
 
-QTEST_APPLESS_MAIN(HuggleTest)
+void HuggleTest::testCaseDiffEngine()
+{
+    QString text = "Line one\nLine two\nLine three\nLine four";
+    QVERIFY2(Huggle::DiffEngine::Diff(text, text).isEmpty(), "Diff of identical texts is not empty");
+    QString diff = Huggle::DiffEngine::Diff(text, "Line one\nLine 2\nLine three\nLine four");
+    QVERIFY2(diff.contains("<del class=\"diffchange diffchange-inline\">two</del>"), "Changed word was not marked as deleted");
+    QVERIFY2(diff.contains("<ins class=\"diffchange diffchange-inline\">2</ins>"), "Changed word was not marked as inserted");
+    diff = Huggle::DiffEngine::Diff(text, text + "\n<b>vandalism</b>");
+    QVERIFY2(diff.contains("diff-addedline\"><div>&lt;b&gt;vandalism&lt;/b&gt;</div>"), "Added line is missing in diff");
+    QVERIFY2(!diff.contains("diff-deletedline"), "Diff contains a deleted line that wasn't removed");
+    QVERIFY2(Huggle::DiffEngine::Tokenize("Hello, world  again").join("") == "Hello, world  again", "Tokens don't produce original text");
+    QVERIFY2(Huggle::DiffEngine::Tokenize("Hello, world").count() == 4, "Invalid number of tokens");
+}
+
+void HuggleTest::testCaseApiCacheSubjects()
+{
+    QStringList subjects = Huggle::ApiQueryCache::GetSubjects("enwiki", "prop=revisions&rvlimit=1&titles=User_talk%3AExample%7CFoo");
+    QVERIFY2(subjects.count() == 2, "Invalid number of subjects");
+    QVERIFY2(subjects.contains("enwiki|User talk:Example"), "Title was not normalized");
+    QVERIFY2(subjects.contains("enwiki|Foo"), "Second title is missing");
+    subjects = Huggle::ApiQueryCache::GetSubjects("enwiki", "list=users&usprop=groups&ususers=127.0.0.1");
+    QVERIFY2(subjects.count() == 1 && subjects.first() == "enwiki|~user:127.0.0.1", "User subject is wrong");
+    QVERIFY2(Huggle::ApiQueryCache::GetSubjects("enwiki", "meta=tokens&type=rollback").isEmpty(), "Query without pages has subjects");
+}
+
+static Huggle::ApiQuery *makeCacheableQuery(QString parameters)
+{
+    // query is never processed, so it's handed over to cache the way ApiQuery::Process would do it
+    Huggle::ApiQuery *query = new Huggle::ApiQuery(Huggle::ActionQuery, Huggle::Configuration::HuggleConfiguration->Project);
+    query->Cacheable = true;
+    query->URL = "https://en.wikipedia.org/w/api.php?action=query&" + parameters + "&format=xml";
+    query->Result = new Huggle::ApiQueryResult();
+    return query;
+}
+
+void HuggleTest::testCaseApiCacheExpiry()
+{
+    int ttl = Huggle::Configuration::HuggleConfiguration->SystemConfig_ApiCacheTTL;
+    Huggle::Configuration::HuggleConfiguration->SystemConfig_ApiCacheTTL = 1;
+    Huggle::ApiQueryCache cache;
+    Huggle::ApiQuery *first = makeCacheableQuery("prop=revisions&titles=Foo");
+    QVERIFY2(!cache.Fetch(first), "Query was not sent even though cache is empty");
+    first->Result->Data = "<api><page title=\"Foo\" /></api>";
+    cache.Complete(first);
+    Huggle::ApiQuery *second = makeCacheableQuery("titles=Foo&prop=revisions");
+    QVERIFY2(cache.Fetch(second), "Fresh result was not taken from cache");
+    QVERIFY2(second->Result->Data == first->Result->Data, "Cached result is different");
+    QVERIFY2(cache.GetHits() == 1, "Invalid number of hits");
+    QTest::qSleep(2100);
+    Huggle::ApiQuery *third = makeCacheableQuery("prop=revisions&titles=Foo");
+    QVERIFY2(!cache.Fetch(third), "Expired result was taken from cache");
+    QVERIFY2(third->Result->Data.isEmpty(), "Expired result was given to query");
+    QVERIFY2(cache.GetMisses() == 2, "Invalid number of misses");
+    Huggle::Configuration::HuggleConfiguration->SystemConfig_ApiCacheTTL = ttl;
+    delete first;
+    delete second;
+    delete third;
+}
+
+void HuggleTest::testCaseApiCacheCoalescing()
+{
+    Huggle::ApiQueryCache cache;
+    Huggle::ApiQuery *first = makeCacheableQuery("list=users&ususers=127.0.0.1");
+    Huggle::ApiQuery *second = makeCacheableQuery("list=users&ususers=127.0.0.1");
+    Huggle::ApiQuery *third = makeCacheableQuery("list=users&ususers=127.0.0.1");
+    Huggle::ApiQuery *other = makeCacheableQuery("list=users&ususers=127.0.0.2");
+    QVERIFY2(!cache.Fetch(first), "First query was not sent");
+    QVERIFY2(cache.Fetch(second), "Identical query was sent while first one is running");
+    QVERIFY2(cache.Fetch(third), "Identical query was sent while first one is running");
+    QVERIFY2(!cache.Fetch(other), "Different query was attached to running one");
+    QVERIFY2(cache.GetCoalesced() == 2, "Invalid number of coalesced queries");
+    QVERIFY2(second->Result->Data.isEmpty(), "Attached query finished before the running one");
+    first->Result->Data = "<api><user name=\"127.0.0.1\" /></api>";
+    cache.Complete(first);
+    QVERIFY2(second->Result->Data == first->Result->Data, "Attached query didn't get the result");
+    QVERIFY2(third->Result->Data == first->Result->Data, "Attached query didn't get the result");
+    QVERIFY2(second->IsProcessed() && !second->IsFailed(), "Attached query is not finished");
+    QVERIFY2(other->Result->Data.isEmpty(), "Result was shared with different query");
+    // failure of running query is passed to attached ones and nothing is cached
+    Huggle::ApiQuery *failed = makeCacheableQuery("list=users&ususers=127.0.0.3");
+    Huggle::ApiQuery *attached = makeCacheableQuery("list=users&ususers=127.0.0.3");
+    QVERIFY2(!cache.Fetch(failed), "First query was not sent");
+    QVERIFY2(cache.Fetch(attached), "Identical query was sent while first one is running");
+    failed->Result->SetError(HUGGLE_EKILLED, "Killed");
+    cache.Complete(failed);
+    QVERIFY2(attached->IsFailed(), "Failure was not passed to attached query");
+    Huggle::ApiQuery *retry = makeCacheableQuery("list=users&ususers=127.0.0.3");
+    QVERIFY2(!cache.Fetch(retry), "Failed result was cached");
+    delete first;
+    delete second;
+    delete third;
+    delete other;
+    delete failed;
+    delete attached;
+    delete retry;
+}
+
+void HuggleTest::testCaseApiCacheInvalidation()
+{
+    Huggle::ApiQueryCache cache;
+    Huggle::ApiQuery *talk = makeCacheableQuery("prop=revisions&titles=User_talk%3AExample");
+    Huggle::ApiQuery *page = makeCacheableQuery("prop=revisions&titles=Foo");
+    cache.Fetch(talk);
+    cache.Fetch(page);
+    talk->Result->Data = "<api><page title=\"User talk:Example\" /></api>";
+    page->Result->Data = "<api><page title=\"Foo\" /></api>";
+    cache.Complete(talk);
+    cache.Complete(page);
+    // edit made by huggle itself
+    Huggle::ApiQuery *edit = new Huggle::ApiQuery(Huggle::ActionEdit, Huggle::Configuration::HuggleConfiguration->Project);
+    edit->Parameters = "title=User_talk%3AExample&text=Hello&token=abc";
+    cache.InvalidateQuery(edit);
+    Huggle::ApiQuery *talk_again = makeCacheableQuery("prop=revisions&titles=User_talk%3AExample");
+    QVERIFY2(!cache.Fetch(talk_again), "Result of edited page was taken from cache");
+    Huggle::ApiQuery *page_again = makeCacheableQuery("prop=revisions&titles=Foo");
+    QVERIFY2(cache.Fetch(page_again), "Result of page that was not edited was dropped");
+    // change of page that was seen in the feed, WikiEdit does this for talk pages
+    cache.InvalidatePage(Huggle::Configuration::HuggleConfiguration->Project, "Foo");
+    Huggle::ApiQuery *page_third = makeCacheableQuery("prop=revisions&titles=Foo");
+    QVERIFY2(!cache.Fetch(page_third), "Result of changed page was taken from cache");
+    delete talk;
+    delete page;
+    delete edit;
+    delete talk_again;
+    delete page_again;
+    delete page_third;
+}
+
+static QString makeWorkerScript(QString name, QString hooks)
+{
+    return "function ext_get_info() { var info = {}; info.name = \"" + name + "\"; info.author = \"test\"; "
+           "info.description = \"test\"; info.version = \"1.0.0\"; info.worker = true; return info; }\n"
+           "function ext_is_working() { return true; }\n"
+           "function ext_init() { " + hooks + " return true; }\n"
+           // busy loop is bounded so that worker can finish even with Qt which can't interrupt it
+           "function slow(edit) { var start = Date.now(); while (Date.now() - start < 700) {} return 1; }\n"
+           "function score(edit) { return edit.Summary.indexOf(\"spam\") >= 0 ? 200 : 0; }\n"
+           "function queue(edit) { return edit.Summary.indexOf(\"ignore\") < 0; }\n";
+}
+
+static Huggle::Script *loadWorkerScript(QString name, QString hooks)
+{
+    bool workers = hcfg->SystemConfig_ScriptWorkers;
+    hcfg->SystemConfig_ScriptWorkers = true;
+    Huggle::Script *script = new Huggle::Script();
+    QString error;
+    if (!script->LoadSrc("test/" + name, makeWorkerScript(name, hooks), &error))
+        QWARN(error.toUtf8().data());
+    hcfg->SystemConfig_ScriptWorkers = workers;
+    return script;
+}
+
+void HuggleTest::testCaseScriptWorkerCancel()
+{
+    Huggle::ScriptWorkerEngine engine(makeWorkerScript("worker_cancel", ""));
+    QSignalSpy finished(&engine, SIGNAL(Finished(int,QVariant,QString,int)));
+    engine.Init();
+    QVariantMap edit;
+    edit.insert("Summary", "spam");
+    engine.Queue(1);
+    engine.Queue(2);
+    engine.Cancel(2);
+    QVERIFY2(engine.GetQueued() == 1, "Cancelled request is still queued");
+    engine.Execute(1, "score", edit);
+    engine.Execute(2, "score", edit);
+    QVERIFY2(finished.count() == 1, "Cancelled request was executed");
+    QVERIFY2(finished.at(0).at(0).toInt() == 1 && finished.at(0).at(1).toInt() == 200, "Invalid result of request");
+    // timeout may cancel request that has just finished
+    engine.Cancel(1);
+    engine.Cancel(3);
+    QVERIFY2(engine.GetQueued() == 0, "Cancelling request which isn't queued left it in engine");
+    engine.Execute(3, "score", edit);
+    QVERIFY2(finished.count() == 1, "Request which wasn't queued was executed");
+}
+
+void HuggleTest::testCaseScriptWorkerTimeout()
+{
+    int timeout = hcfg->SystemConfig_ScriptHookTimeout;
+    hcfg->SystemConfig_ScriptHookTimeout = 100;
+    Huggle::Script *script = loadWorkerScript("worker_slow", "huggle.register_hook(\"edit_rescore\", \"slow\");");
+    Huggle::ScriptWorker *worker = script->GetWorker();
+    QVERIFY2(worker != nullptr, "Worker was not started");
+    Huggle::WikiEdit *edit = new Huggle::WikiEdit();
+    edit->Page = new Huggle::WikiPage("test", hcfg->Project);
+    edit->User = new Huggle::WikiUser("Harry, the vandal", hcfg->Project);
+    QVariant result;
+    int request = worker->Submit(HUGGLE_SCRIPT_HOOK_EDIT_RESCORE, edit);
+    QVERIFY2(request >= 0, "Hook was not submitted");
+    QTRY_VERIFY_WITH_TIMEOUT(worker->TakeResult(request, &result), 5000);
+    QVERIFY2(!result.isValid(), "Result of hook which timed out was used");
+    QVERIFY2(worker->GetTimeouts() == 1, "Timeout was not counted");
+#if QT_VERSION >= 0x050E00
+    QVERIFY2(worker->IsWorking(), "Worker was stopped after first timeout");
+    while (worker->GetTimeouts() < HUGGLE_SCRIPT_WORKER_MAX_TIMEOUTS)
+    {
+        QVERIFY2(worker->IsWorking(), "Worker was stopped before reaching the limit of timeouts");
+        request = worker->Submit(HUGGLE_SCRIPT_HOOK_EDIT_RESCORE, edit);
+        QVERIFY2(request >= 0, "Hook was not submitted");
+        QTRY_VERIFY_WITH_TIMEOUT(worker->TakeResult(request, &result), 5000);
+        QVERIFY2(!result.isValid(), "Result of hook which timed out was used");
+    }
+#endif
+    // without support for interrupting hooks worker is stopped after first timeout
+    QVERIFY2(!worker->IsWorking(), "Worker was not stopped");
+    QVERIFY2(worker->Submit(HUGGLE_SCRIPT_HOOK_EDIT_RESCORE, edit) < 0, "Stopped worker accepted a hook");
+    delete script;
+    hcfg->SystemConfig_ScriptHookTimeout = timeout;
+    delete edit;
+}
+
+void HuggleTest::testCaseScriptHookJob()
+{
+    Huggle::Script *script = loadWorkerScript("worker_score", "huggle.register_hook(\"edit_rescore\", \"score\"); "
+                                                              "huggle.register_hook(\"edit_load_to_queue\", \"queue\");");
+    QVERIFY2(script->GetWorker() != nullptr, "Worker was not started");
+    Huggle::WikiEdit *spam = new Huggle::WikiEdit();
+    spam->Page = new Huggle::WikiPage("test", hcfg->Project);
+    spam->User = new Huggle::WikiUser("Harry, the vandal", hcfg->Project);
+    spam->Summary = "spam";
+    spam->Score = 10;
+    Huggle::ScriptHookJob spam_job(spam);
+    QTRY_VERIFY_WITH_TIMEOUT(spam_job.IsFinished(), 5000);
+    QVERIFY2(!spam_job.IsRejected(), "Edit was rejected");
+    QVERIFY2(spam->Score == 210, QString("Invalid score: " + QString::number(spam->Score)).toUtf8().data());
+    QVERIFY2(spam->PropertyBag.value("score_js_worker_score").toInt() == 200, "Score of script was not stored");
+    Huggle::WikiEdit *ignored = new Huggle::WikiEdit();
+    ignored->Page = new Huggle::WikiPage("test", hcfg->Project);
+    ignored->User = new Huggle::WikiUser("Harry, the vandal", hcfg->Project);
+    ignored->Summary = "ignore";
+    ignored->Score = 10;
+    Huggle::ScriptHookJob ignored_job(ignored);
+    QTRY_VERIFY_WITH_TIMEOUT(ignored_job.IsFinished(), 5000);
+    QVERIFY2(ignored_job.IsRejected(), "Edit was not rejected");
+    QVERIFY2(ignored->Score == 10, "Zero score changed the edit");
+    QVERIFY2(!ignored->PropertyBag.contains("score_js_worker_score"), "Zero score was stored");
+    delete script;
+    delete spam;
+    delete ignored;
+}
+
+static Huggle::HistoryRevision makeRevision(revid_ht revid, revid_ht parent, QString page, QString user)
+{
+    Huggle::HistoryRevision revision;
+    revision.RevID = revid;
+    revision.ParentID = parent;
+    revision.Page = page;
+    revision.User = user;
+    return revision;
+}
+
+void HuggleTest::testCaseHistoryCache()
+{
+    Huggle::WikiSite site("test", "test.wikipedia.org/");
+    Huggle::HistoryCache cache(10);
+    QList<Huggle::HistoryRevision> revisions;
+    revisions << makeRevision(3, 2, "Foo", "Bob") << makeRevision(2, 1, "Foo", "Bob") << makeRevision(1, 0, "Foo", "Alice");
+    cache.InsertHistory(&site, "Foo", revisions);
+    QList<Huggle::HistoryRevision> history;
+    QVERIFY2(cache.GetHistory(&site, "Foo", 50, &history) && history.count() == 3, "Whole history of page wasn't returned");
+    QString founder;
+    QVERIFY2(cache.GetFounder(&site, "Foo", &founder) && founder == "Alice", "Founder wasn't taken from first revision");
+    cache.Record(&site, makeRevision(4, 3, "Foo", "Carol"));
+    QVERIFY2(cache.GetHistory(&site, "Foo", 2, &history) && history.count() == 2 && history.first().RevID == 4, "Edit from feed is not in history");
+    cache.Record(&site, makeRevision(6, 5, "Foo", "Carol"));
+    QVERIFY2(!cache.GetHistory(&site, "Foo", 2, &history), "History with missing revision was returned");
+    Huggle::HistoryRevision revision;
+    QVERIFY2(cache.GetRevision(&site, "Foo", "Bob", 2, &revision) && revision.User == "Bob", "Known revision wasn't found");
+
+    QList<Huggle::HistoryRevision> contributions;
+    contributions << makeRevision(10, 9, "Bar", "Dave");
+    contributions[0].Top = true;
+    cache.InsertContributions(&site, "Dave", contributions, true);
+    QVERIFY2(!cache.GetContributions(&site, "Erin", 20, &contributions), "Unknown user has contributions");
+    cache.Record(&site, makeRevision(11, 10, "Bar", "Erin"));
+    cache.Record(&site, makeRevision(12, 4, "Foo", "Dave"));
+    QVERIFY2(cache.GetContributions(&site, "Dave", 20, &contributions) && contributions.count() == 2, "Edit from feed is not in contributions");
+    QVERIFY2(contributions.at(0).RevID == 12 && contributions.at(0).Top, "Newest contribution is not on top");
+    QVERIFY2(!contributions.at(1).Top, "Contribution is still on top after someone else edited the page");
+
+    revid_ht head = WIKI_UNKNOWN_REVID;
+    QVERIFY2(cache.GetHead(&site, "Foo", &head) && head == 12, "Head of page doesn't follow recorded revisions");
+    QVERIFY2(!cache.GetHead(&site, "Baz", &head), "Unknown page has a head");
+    cache.RecordHead(&site, "Baz", 20);
+    cache.RecordHead(&site, "Baz", 19);
+    QVERIFY2(cache.GetHead(&site, "Baz", &head) && head == 20, "Older revision from feed replaced the head");
+    Huggle::HistoryCache disabled(10, 0);
+    disabled.RecordHead(&site, "Baz", 20);
+    QVERIFY2(!disabled.GetHead(&site, "Baz", &head), "Head is returned although it's disabled");
+}
+
+void HuggleTest::testCasePatternSet()
+{
+    QStringList patterns;
+    patterns << "[Rr]evert(ed|ing)" << "(\\w)\\1{3}" << "^Undid revision";
+    Huggle::PatternSet set(patterns);
+    QVERIFY2(set.Match("Reverted edits by Example") == 0, "First pattern didn't match");
+    QVERIFY2(set.Match("aaaa") == 1, "Pattern with back reference didn't match");
+    QVERIFY2(set.Match("Undid revision 1 by Example") == 2, "Last pattern didn't match");
+    QVERIFY2(!set.Matches("Fixed typo"), "Summary matched although it shouldn't");
+    QVERIFY2(set.Match("zzzz, reverted") == 1, "Earlier match of standalone pattern didn't win");
+    QVERIFY2(set.Match("Undid revision 1, zzzz") == 2, "Earlier match of combined pattern didn't win");
+    Huggle::PatternSet literal(QStringList() << "(Twinkle)", true);
+    QVERIFY2(literal.Matches("Warning (Twinkle)") && !literal.Matches("Twinkle"), "Literal patterns are not escaped");
+}
+
+void HuggleTest::testCaseSiteInfo()
+{
+    Huggle::WikiSite site("test", "test.wikipedia.org/");
+    // edits may arrive before configuration of site is parsed
+    QVERIFY2(site.GetSnapshot() != nullptr && !site.GetSnapshot()->IsRevert("Reverted edits"), "Site has no default snapshot");
+    site.ProjectConfig = new Huggle::ProjectConfiguration("test");
+    Huggle::ApiQueryResult *result = new Huggle::ApiQueryResult();
+    result->Data = "<api><query><general generator=\"MediaWiki 1.31.0\" rtl=\"\" />"
+                   "<namespaces><ns id=\"0\" canonical=\"\"></ns><ns id=\"3\" canonical=\"User talk\">User talk</ns></namespaces>"
+                   "<extensions><ext name=\"AbuseFilter\" type=\"other\" /></extensions></query></api>";
+    result->Process();
+    QVERIFY2(site.ProcessSiteInfo(result), "Site info was not processed");
+    QVERIFY2(site.IsRightToLeft, "Site is not right to left");
+    QVERIFY2(site.MediawikiVersion.GetMajor() == 1 && site.MediawikiVersion.GetMinor() == 31, "Invalid version of mediawiki");
+    QVERIFY2(site.NamespaceList.count() == 2 && site.NamespaceList[3]->IsTalkPage(), "Namespaces were not loaded");
+    QVERIFY2(site.Extensions.count() == 1 && site.Extensions.at(0).Name == "AbuseFilter", "Extensions were not loaded");
+    delete result;
+    result = new Huggle::ApiQueryResult();
+    result->Data = "<api><query></query></api>";
+    result->Process();
+    QVERIFY2(!site.ProcessSiteInfo(result), "Empty site info was processed");
+    delete result;
+}
+
+void HuggleTest::testCaseTrafficCapture()
+{
+    QTemporaryFile capture;
+    QVERIFY2(capture.open(), "Unable to create temporary file");
+    QString error;
+    Huggle::WikiSite site("test", "test.wikipedia.org/");
+    Huggle::TrafficRecorder recorder;
+    QVERIFY2(recorder.Open(capture.fileName(), &error), error.toUtf8().constData());
+    recorder.RecordFeedLine(&site, 2, "<edit type=\"edit\"></edit>");
+    Huggle::TrafficRecord request;
+    request.Method = "GET";
+    request.URL = "https://test.wikipedia.org/w/api.php?action=query";
+    request.Data = "first";
+    recorder.RecordRequest(request);
+    request.Data = "second";
+    recorder.RecordRequest(request);
+    request.Method = "POST";
+    request.Hidden = true;
+    request.Data = "login";
+    recorder.RecordRequest(request);
+    recorder.Close();
+
+    bool ok;
+    QVERIFY2(Huggle::TrafficReplay::ParseSpeed("max", &ok) == 0 && ok, "Invalid parsing of max speed");
+    QVERIFY2(Huggle::TrafficReplay::ParseSpeed("4x", &ok) == 4 && ok, "Invalid parsing of speed");
+    Huggle::TrafficReplay::ParseSpeed("-1", &ok);
+    QVERIFY2(!ok, "Negative speed was accepted");
+    Huggle::TrafficReplay replay(0);
+    QVERIFY2(replay.Load(capture.fileName(), &error), error.toUtf8().constData());
+    Huggle::TrafficRecord record;
+    QVERIFY2(replay.TakeFeedLine("test", &record) && record.Provider == 2 && record.Data.startsWith("<edit"), "Feed line was not replayed");
+    QVERIFY2(!replay.TakeFeedLine("test", &record), "Feed line was replayed twice");
+    QVERIFY2(replay.GetResponse("GET", request.URL, "", &record) && record.Data == "first", "Invalid first response");
+    QVERIFY2(replay.GetResponse("GET", request.URL, "", &record) && record.Data == "second", "Invalid second response");
+    QVERIFY2(replay.GetResponse("GET", request.URL, "", &record) && record.Data == "second", "Last response was not repeated");
+    QVERIFY2(replay.GetResponse("POST", request.URL, "password=secret", &record) && record.Data == "login", "Hidden request was not found");
+    QVERIFY2(!replay.GetResponse("GET", "https://test.wikipedia.org/", "", &record), "Unknown request was found");
+    QVERIFY2(replay.ResponsesServed == 4 && replay.ResponsesMissing == 1, "Invalid statistics of replay");
+}
+
+void HuggleTest::testCaseMemoryPool()
+{
+    Huggle::MemoryPool pool("test", 24, 4);
+    void *first = pool.Allocate(24);
+    void *second = pool.Allocate(24);
+    QVERIFY2(first != second, "Same slot was allocated twice");
+    pool.Free(first, 24);
+    QVERIFY2(pool.Allocate(24) == first, "Freed slot was not reused");
+    void *other = pool.Allocate(100);
+    pool.Free(other, 100);
+    QVERIFY2(pool.Allocations == 3 && pool.Living == 2 && pool.PeakLiving == 2, "Invalid statistics of pool");
+    QVERIFY2(pool.HeapAllocations == 2, "Objects of pool were allocated on heap");
+    pool.Free(first, 24);
+    pool.Free(second, 24);
+
+    Huggle::MemoryArena arena(64);
+    char *a = static_cast<char*>(arena.Allocate(10));
+    char *b = static_cast<char*>(arena.Allocate(10));
+    QVERIFY2(b > a && b - a < 64, "Arena didn't allocate from same chunk");
+    arena.Allocate(1000);
+    QVERIFY2(static_cast<char*>(arena.Allocate(10)) > b, "Large allocation replaced current chunk of arena");
+    QVERIFY2(arena.GetSize() >= 1030, "Size of arena doesn't include all allocations");
+}
+
+void HuggleTest::testCaseLanguages()
+{
+    // custom localization files in home folder would be used instead of the catalog otherwise
+    bool safe_mode = hcfg->SystemConfig_SafeMode;
+    hcfg->SystemConfig_SafeMode = true;
+    Huggle::Huggle_l10n::Init();
+    Huggle::Localizations *localizations = new Huggle::Localizations();
+    QVERIFY2(localizations->LoadCatalog(Huggle::Huggle_l10n::GetLocalizations()), "Unable to load localization catalog");
+    Huggle::Language *english = localizations->LocalizationData.at(Huggle::Localizations::EnglishID);
+    QVERIFY2(english->LanguageName == "en" && english->IsLoaded, "English was not loaded");
+    int loaded = 0;
+    foreach (Huggle::Language *language, localizations->LocalizationData)
+    {
+        if (language->IsLoaded)
+            loaded++;
+    }
+    QVERIFY2(loaded == 1, "Languages were loaded before they were needed");
+    QVERIFY2(localizations->Localize("ok") == "OK", "Invalid text of english message");
+    QVERIFY2(localizations->Localize("[[ok]]") == "OK", "Message in brackets was not found");
+    QVERIFY2(localizations->Localize("no-instant", "enwiki", "Bob").contains("Bob"), "Parameter was not replaced");
+    QVERIFY2(localizations->KeyExists("ok") && !localizations->KeyExists("this-key-does-not-exist"), "Invalid result of KeyExists");
+
+    // this used to be Core::TestLanguages, translations are never complete, so missing and untranslated keys
+    // are reported as warnings, the test only fails when language has no message translated at all, which
+    // means that its file wasn't parsed correctly
+    QStringList keys = localizations->GetKeys();
+    int english_messages = english->Messages.count();
+    foreach (Huggle::Language *language, localizations->LocalizationData)
+    {
+        if (language == english)
+            continue;
+        QVERIFY2(localizations->GetLanguage(language->LanguageName) == language && language->IsLoaded,
+                 QString("Language " + language->LanguageName + " was not loaded").toUtf8().data());
+        QStringList missing;
+        QStringList identical;
+        int translated = 0;
+        int id = 0;
+        while (id < english_messages && id < keys.count())
+        {
+            if (!english->Messages.at(id).isEmpty())
+            {
+                if (id >= language->Messages.count() || language->Messages.at(id).isEmpty())
+                    missing.append(keys.at(id));
+                else if (language->Messages.at(id) == english->Messages.at(id))
+                    identical.append(keys.at(id));
+                else
+                    translated++;
+            }
+            id++;
+        }
+        if (!missing.isEmpty())
+            QWARN(QString("Language " + language->LanguageName + " is missing keys: " + missing.join(", ")).toUtf8().data());
+        if (!identical.isEmpty())
+            QWARN(QString("Language " + language->LanguageName + " has keys identical to english version: " + identical.join(", ")).toUtf8().data());
+        QVERIFY2(translated > 0, QString("Language " + language->LanguageName + " has no translated messages").toUtf8().data());
+    }
+    localizations->PreferredLanguage = "de";
+    QVERIFY2(localizations->Localize("this-key-does-not-exist") == "this-key-does-not-exist", "Missing key didn't return the key");
+    delete localizations;
+    hcfg->SystemConfig_SafeMode = safe_mode;
+}
+
+class TestCollectable : public Huggle::Collectable
+{
+};
+
+void HuggleTest::testCaseRevisionTextCache()
+{
+    // 2 bytes per character, so the budget holds 3 texts of 100 characters
+    Huggle::RevisionTextCache cache(10, 600);
+    QString text(100, 'x');
+    cache.Insert(hcfg->Project, "Foo", 1, text);
+    cache.Insert(hcfg->Project, "Foo", 2, text);
+    cache.Insert(hcfg->Project, "Foo", 3, text);
+    QVERIFY2(!cache.Contains(hcfg->Project, "Foo", 1) && cache.Contains(hcfg->Project, "Foo", 3), "Oldest revision of page was kept");
+    QVERIFY2(cache.GetSize() == 400, QString("Invalid size of cache: " + QString::number(cache.GetSize())).toUtf8().data());
+    cache.Insert(hcfg->Project, "Bar", 10, text);
+    cache.Insert(hcfg->Project, "Baz", 20, text);
+    QVERIFY2(cache.Count() == 2 && !cache.Contains(hcfg->Project, "Foo", 3), "Least recently used page was not removed to fit in budget");
+    QVERIFY2(cache.GetSize() <= 600, "Cache exceeded its budget");
+    cache.Insert(hcfg->Project, "Huge", 30, QString(1000, 'x'));
+    QVERIFY2(!cache.Contains(hcfg->Project, "Huge", 30) && cache.Count() == 2, "Text bigger than whole budget was cached");
+    cache.Clear();
+    QVERIFY2(cache.GetSize() == 0, "Size of cache was not reset");
+}
+
+void HuggleTest::testCaseCollectableConsumers()
+{
+    TestCollectable *item = new TestCollectable();
+    QVERIFY2(!item->HasSomeConsumers(), "New collectable has consumers");
+    item->RegisterConsumer(HUGGLECONSUMER_QUEUE);
+    item->RegisterConsumer(HUGGLECONSUMER_QUEUE);
+    item->RegisterConsumer(800);
+    item->RegisterConsumer("extension");
+    QVERIFY2(item->IsManaged(), "Collectable with consumers is not managed");
+    item->UnregisterConsumer(HUGGLECONSUMER_QUEUE);
+    item->UnregisterConsumer(800);
+    QVERIFY2(item->HasSomeConsumers(), "String consumer was lost");
+    item->UnregisterConsumer("extension");
+    QVERIFY2(!item->HasSomeConsumers(), "Consumers were not removed");
+    QVERIFY2(item->SafeDelete(), "Collectable without consumers was not deleted");
+}
+
+static Huggle::WikiEdit *bulkRevertEdit(QString page, revid_ht revid, bool post_processed = true)
+{
+    Huggle::WikiEdit *edit = new Huggle::WikiEdit();
+    edit->Page = new Huggle::WikiPage(page, hcfg->Project);
+    edit->User = new Huggle::WikiUser("Harry, the vandal", hcfg->Project);
+    edit->RevID = revid;
+    if (post_processed)
+        edit->Status = Huggle::StatusPostProcessed;
+    return edit;
+}
+
+void HuggleTest::testCaseBulkRevertSelection()
+{
+    QList<Huggle::WikiEdit*> created;
+    created << bulkRevertEdit("Foo", 10) << bulkRevertEdit("Foo", 30) << bulkRevertEdit("Foo", 20)
+            << bulkRevertEdit("Bar", 15) << bulkRevertEdit("Bar", 40, false)
+            << bulkRevertEdit("Baz", 50) << bulkRevertEdit("Qux", WIKI_UNKNOWN_REVID);
+    // new pages can't be rolled back
+    created.at(5)->NewPage = true;
+    QList<Huggle::Collectable_SmartPtr<Huggle::WikiEdit>> edits;
+    foreach (Huggle::WikiEdit *edit, created)
+        edits.append(Huggle::Collectable_SmartPtr<Huggle::WikiEdit>(edit));
+    Huggle::BulkRevert *bulk = new Huggle::BulkRevert(edits, "", "");
+    QVERIFY2(bulk->GetCount() == 2, QString("Invalid number of pages to revert: " + QString::number(bulk->GetCount())).toUtf8().data());
+    foreach (Huggle::Collectable_SmartPtr<Huggle::WikiEdit> edit, bulk->GetEdits())
+    {
+        if (edit->Page->PageName == "Foo")
+            QVERIFY2(edit->RevID == 30, "Newest edit of page was not selected");
+        else
+            QVERIFY2(edit->Page->PageName == "Bar" && edit->RevID == 15, "Edit that is not post processed was selected");
+    }
+    delete bulk;
+    edits.clear();
+    foreach (Huggle::WikiEdit *edit, created)
+        QVERIFY2(edit->SafeDelete(), "Edit is still held by bulk revert");
+}
+
+QTEST_GUILESS_MAIN(HuggleTest)
 
 #include "tst_testmain.moc"